@@ -240,6 +240,12 @@ index_opts_decode(struct index_opts *opts, const char *map,
 			 "less than or equal to 1");
 		return -1;
 	}
+	if (opts->ttl < 0) {
+		diag_set(ClientError, ER_WRONG_INDEX_OPTIONS,
+			 BOX_INDEX_FIELD_OPTS,
+			 "ttl must be greater than or equal to 0");
+		return -1;
+	}
 	return 0;
 }
 
@@ -501,6 +507,24 @@ field_def_decode(struct field_def *field, const char **data,
 				    "string, scalar and any fields"));
 		return -1;
 	}
+	if (field->compression == compression_type_MAX) {
+		diag_set(ClientError, errcode, tt_cstr(space_name, name_len),
+			 tt_sprintf("field %d has unknown compression type",
+				    fieldno + TUPLE_INDEX_BASE));
+		return -1;
+	}
+	if (field->compression != COMPRESSION_TYPE_NONE &&
+	    field->type != FIELD_TYPE_STRING &&
+	    field->type != FIELD_TYPE_VARBINARY &&
+	    field->type != FIELD_TYPE_ARRAY &&
+	    field->type != FIELD_TYPE_MAP &&
+	    field->type != FIELD_TYPE_ANY) {
+		diag_set(ClientError, errcode, tt_cstr(space_name, name_len),
+			 tt_sprintf("compression is reasonable only for "
+				    "string, varbinary, array, map and any "
+				    "fields"));
+		return -1;
+	}
 
 	const char *dv = field->default_value;
 	if (dv != NULL) {
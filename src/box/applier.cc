@@ -31,6 +31,8 @@
 #include "applier.h"
 
 #include <msgpuck.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 #include "xlog.h"
 #include "fiber.h"
@@ -56,7 +58,14 @@
 #include "scoped_guard.h"
 #include "txn_limbo.h"
 #include "journal.h"
+#include "histogram.h"
+#include "rmean.h"
 #include "raft.h"
+#include "assoc.h"
+#include "index.h"
+#include "engine.h"
+#include "memtx_engine.h"
+#include "fio.h"
 #include "small/static.h"
 #include "tt_static.h"
 #include "memory.h"
@@ -199,7 +208,8 @@ applier_writer_f(va_list ap)
 		try {
 			applier->has_acks_to_send = false;
 			struct xrow_header xrow;
-			xrow_encode_vclock(&xrow, &replicaset.vclock);
+			xrow_encode_ack(&xrow, &replicaset.vclock,
+					applier->echo_tm);
 			/*
 			 * For relay lag statistics we report last
 			 * written transaction timestamp in tm field.
@@ -325,6 +335,25 @@ apply_nop(struct xrow_header *row)
 	return process_nop(&request);
 }
 
+/**
+ * Authenticate the client with the credentials from the URI on
+ * a connection that has just received the given greeting.
+ */
+static void
+applier_authenticate(struct iostream *io, struct ibuf *ibuf,
+		     const struct uri *uri, const struct greeting *greeting)
+{
+	struct xrow_header row;
+	xrow_encode_auth_xc(&row, greeting->salt, greeting->salt_len,
+			    uri->login, strlen(uri->login),
+			    uri->password != NULL ? uri->password : "",
+			    uri->password != NULL ? strlen(uri->password) : 0);
+	coio_write_xrow(io, &row);
+	coio_read_xrow(io, ibuf, &row);
+	if (row.type != IPROTO_OK)
+		xrow_decode_error_xc(&row); /* auth failed */
+}
+
 /**
  * Connect to a remote host and authenticate the client.
  */
@@ -422,15 +451,8 @@ applier_connect(struct applier *applier)
 
 	/* Authenticate */
 	applier_set_state(applier, APPLIER_AUTH);
-	xrow_encode_auth_xc(&row, greeting.salt, greeting.salt_len, uri->login,
-			    strlen(uri->login),
-			    uri->password != NULL ? uri->password : "",
-			    uri->password != NULL ? strlen(uri->password) : 0);
-	coio_write_xrow(io, &row);
-	coio_read_xrow(io, ibuf, &row);
+	applier_authenticate(io, ibuf, uri, &greeting);
 	applier->last_row_time = ev_monotonic_now(loop());
-	if (row.type != IPROTO_OK)
-		xrow_decode_error_xc(&row); /* auth failed */
 
 	/* auth succeeded */
 	say_info("authenticated");
@@ -438,6 +460,217 @@ done:
 	applier_set_state(applier, APPLIER_READY);
 }
 
+enum {
+	/** Size of a chunk of a checkpoint file read at once. */
+	APPLIER_FILE_CHUNK_SIZE = 1024 * 1024,
+};
+
+/**
+ * Receive the checkpoint file the master sends instead of initial
+ * join rows and load it the same way memtx loads a local checkpoint
+ * on recovery. The file is written to the memtx directory as an
+ * in-progress snapshot and removed once loaded.
+ */
+static void
+applier_recv_checkpoint(struct applier *applier, uint64_t size)
+{
+	struct iostream *io = &applier->io;
+	struct ibuf *ibuf = &applier->ibuf;
+	struct memtx_engine *memtx =
+		(struct memtx_engine *)engine_by_name("memtx");
+	int64_t signature = vclock_sum(&replicaset.vclock);
+	char filename[PATH_MAX];
+	strlcpy(filename, xdir_format_filename(&memtx->snap_dir, signature,
+					       INPROGRESS), sizeof(filename));
+	say_info("receiving checkpoint of %llu bytes to `%s'",
+		 (unsigned long long)size, filename);
+
+	int fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0)
+		tnt_raise(SystemError, "failed to create '%s'", filename);
+	auto file_guard = make_scoped_guard([&] {
+		if (fd >= 0)
+			close(fd);
+		unlink(filename);
+	});
+	uint64_t left = size;
+	while (left > 0) {
+		if (ibuf_used(ibuf) == 0) {
+			ibuf_reserve_xc(ibuf, APPLIER_FILE_CHUNK_SIZE);
+			coio_breadn(io, ibuf, 1);
+		}
+		size_t chunk = MIN(left, (uint64_t)ibuf_used(ibuf));
+		if (fio_writen(fd, ibuf->rpos, chunk) != 0)
+			tnt_raise(SystemError, "failed to write '%s'",
+				  filename);
+		ibuf->rpos += chunk;
+		left -= chunk;
+		applier->last_row_time = ev_monotonic_now(loop());
+	}
+	close(fd);
+	fd = -1;
+
+	say_info("checkpoint received, loading");
+	if (memtx_engine_recover_snapshot_file(memtx, filename,
+					       signature, true) != 0)
+		diag_raise();
+}
+
+/** An additional connection to receive initial data over. */
+struct applier_join_stream {
+	/** Applier the stream belongs to. */
+	struct applier *applier;
+	/** Id of the join, received from the master. */
+	uint32_t join_id;
+	/** Number of rows received over the stream. */
+	uint64_t row_count;
+	/** Fiber receiving rows. */
+	struct fiber *fiber;
+};
+
+/**
+ * Receive a part of initial data over a new connection to the
+ * master the applier is joining from.
+ */
+static void
+applier_join_stream(struct applier_join_stream *stream)
+{
+	struct applier *applier = stream->applier;
+	struct uri *uri = &applier->uri;
+	struct iostream io;
+	struct ibuf ibuf;
+	struct xrow_header row;
+	char greetingbuf[IPROTO_GREETING_SIZE];
+
+	int fd = coio_connect(uri->host != NULL ? uri->host : "",
+			      uri->service != NULL ? uri->service : "",
+			      uri->host_hint, NULL, NULL);
+	if (fd < 0)
+		diag_raise();
+	if (iostream_create(&io, fd, &applier->io_ctx) != 0) {
+		close(fd);
+		diag_raise();
+	}
+	ibuf_create(&ibuf, &cord()->slabc, 1024);
+	auto io_guard = make_scoped_guard([&] {
+		iostream_destroy(&io);
+		ibuf_destroy(&ibuf);
+	});
+	if (coio_readn(&io, greetingbuf, IPROTO_GREETING_SIZE) < 0)
+		diag_raise();
+	struct greeting greeting;
+	if (greeting_decode(greetingbuf, &greeting) != 0)
+		tnt_raise(LoggedError, ER_PROTOCOL, "Invalid greeting");
+	if (!tt_uuid_is_equal(&greeting.uuid, &applier->uuid)) {
+		tnt_raise(ClientError, ER_PROTOCOL,
+			  "Join stream connected to another instance");
+	}
+	if (uri->login != NULL)
+		applier_authenticate(&io, &ibuf, uri, &greeting);
+
+	xrow_encode_join_stream_xc(&row, &INSTANCE_UUID, stream->join_id);
+	coio_write_xrow(&io, &row);
+	while (true) {
+		coio_read_xrow(&io, &ibuf, &row);
+		applier->last_row_time = ev_monotonic_now(loop());
+		if (iproto_type_is_dml(row.type)) {
+			if (apply_snapshot_row(&row) != 0)
+				diag_raise();
+			stream->row_count++;
+		} else if (row.type == IPROTO_OK) {
+			break;
+		} else if (iproto_type_is_error(row.type)) {
+			xrow_decode_error_xc(&row);
+		} else {
+			tnt_raise(ClientError, ER_UNKNOWN_REQUEST_TYPE,
+				  (uint32_t)row.type);
+		}
+	}
+}
+
+static int
+applier_join_stream_f(va_list ap)
+{
+	struct applier_join_stream *stream =
+		va_arg(ap, struct applier_join_stream *);
+	try {
+		applier_join_stream(stream);
+	} catch (Exception *) {
+		return -1;
+	}
+	return 0;
+}
+
+/**
+ * Open additional connections to receive the rest of initial data
+ * over, as requested by the master. Started streams are stored in
+ * @a streams, @a count is incremented for each of them.
+ */
+static void
+applier_start_join_streams(struct applier *applier,
+			   const struct xrow_header *row,
+			   struct applier_join_stream *streams, int *count)
+{
+	uint64_t file_size;
+	uint32_t join_streams;
+	uint32_t join_id;
+	xrow_decode_join_snapshot_xc(row, &file_size, &join_streams,
+				     &join_id);
+	join_streams = MIN(join_streams,
+			   (uint32_t)REPLICATION_JOIN_STREAMS_MAX);
+	say_info("receiving initial data over %u connections",
+		 (unsigned)join_streams);
+	/* One of the connections is the main one. */
+	while (*count < (int)join_streams - 1) {
+		struct applier_join_stream *stream = &streams[*count];
+		stream->applier = applier;
+		stream->join_id = join_id;
+		stream->row_count = 0;
+		stream->fiber = fiber_new_xc("applier_join",
+					     applier_join_stream_f);
+		fiber_set_joinable(stream->fiber, true);
+		fiber_start(stream->fiber, stream);
+		++*count;
+	}
+}
+
+/**
+ * Wait for additional join streams to receive all their rows and
+ * return the number of the rows. The first error a stream fails
+ * with is raised. Joined streams are removed from @a streams.
+ */
+static uint64_t
+applier_wait_join_streams(struct applier_join_stream *streams, int *count)
+{
+	uint64_t row_count = 0;
+	while (*count > 0) {
+		struct applier_join_stream *stream = &streams[--*count];
+		if (fiber_join(stream->fiber) != 0)
+			diag_raise();
+		row_count += stream->row_count;
+	}
+	return row_count;
+}
+
+/**
+ * Cancel additional join streams and wait for them to stop.
+ * Preserves the fiber diagnostics area as it's called while
+ * an error is being raised.
+ */
+static void
+applier_cancel_join_streams(struct applier_join_stream *streams, int count)
+{
+	struct diag diag;
+	diag_create(&diag);
+	diag_move(diag_get(), &diag);
+	for (int i = 0; i < count; i++) {
+		fiber_cancel(streams[i].fiber);
+		fiber_join(streams[i].fiber);
+	}
+	diag_move(&diag, diag_get());
+	diag_destroy(&diag);
+}
+
 static uint64_t
 applier_wait_snapshot(struct applier *applier)
 {
@@ -489,12 +722,26 @@ applier_wait_snapshot(struct applier *applier)
 					  (uint32_t)row.type);
 			}
 		} while (row.type != IPROTO_JOIN_SNAPSHOT);
+		uint64_t file_size;
+		uint32_t join_streams;
+		uint32_t join_id;
+		xrow_decode_join_snapshot_xc(&row, &file_size, &join_streams,
+					     &join_id);
+		if (file_size > 0)
+			applier_recv_checkpoint(applier, file_size);
 		coio_read_xrow(io, ibuf, &row);
 	}
 
 	/*
-	 * Receive initial data.
+	 * Receive initial data. The master may ask to receive its
+	 * part over additional connections after sending system
+	 * spaces.
 	 */
+	struct applier_join_stream streams[REPLICATION_JOIN_STREAMS_MAX];
+	int stream_count = 0;
+	auto streams_guard = make_scoped_guard([&] {
+		applier_cancel_join_streams(streams, stream_count);
+	});
 	uint64_t row_count = 0;
 	while (true) {
 		applier->last_row_time = ev_monotonic_now(loop());
@@ -505,7 +752,12 @@ applier_wait_snapshot(struct applier *applier)
 				say_info_ratelimited("%.1fM rows received",
 						     row_count / 1e6);
 			}
+		} else if (row.type == IPROTO_JOIN_SNAPSHOT) {
+			applier_start_join_streams(applier, &row, streams,
+						   &stream_count);
 		} else if (row.type == IPROTO_OK) {
+			row_count += applier_wait_join_streams(streams,
+							       &stream_count);
 			if (applier->version_id < version_id(1, 7, 0)) {
 				/*
 				 * This is the start vclock if the
@@ -584,6 +836,8 @@ struct applier_tx {
 	struct stailq_entry next;
 	/** The transaction rows. */
 	struct stailq rows;
+	/** Value of applier::lag when the transaction was received. */
+	double lag;
 };
 
 /** A callback for row allocation used by tx thread. */
@@ -718,7 +972,9 @@ applier_join(struct applier *applier)
 	struct xrow_header row;
 	uint64_t row_count;
 
-	xrow_encode_join_xc(&row, &INSTANCE_UUID);
+	xrow_encode_join_xc(&row, &INSTANCE_UUID,
+			    replication_join_from_checkpoint,
+			    replication_join_streams);
 	coio_write_xrow(io, &row);
 
 	applier_set_state(applier, APPLIER_INITIAL_JOIN);
@@ -754,7 +1010,9 @@ applier_read_tx_row(struct applier *applier, const struct applier_read_ctx *ctx,
 
 	ERROR_INJECT_YIELD(ERRINJ_APPLIER_READ_TX_ROW_DELAY);
 
-	coio_read_xrow_timeout_xc(io, ctx->ibuf, row, timeout);
+	size_t size = coio_read_xrow_timeout_xc(io, ctx->ibuf, row, timeout);
+	rmean_collect(applier->rmean, REPLICATION_STAT_ROWS, 1);
+	rmean_collect(applier->rmean, REPLICATION_STAT_BYTES, size);
 
 	if (row->tm > 0)
 		applier->lag = ev_now(loop()) - row->tm;
@@ -917,6 +1175,10 @@ replica_txn_wal_write_cb(struct replica_cb_data *rcb)
 	struct replica *r = replica_by_id(rcb->replica_id);
 	if (likely(r != NULL))
 		r->applier_txn_last_tm = rcb->txn_last_tm;
+	if (likely(r != NULL) && r->applier != NULL && rcb->txn_last_tm > 0) {
+		latency_collect(&r->applier->apply_latency,
+				ev_now(loop()) - rcb->txn_last_tm);
+	}
 }
 
 static int
@@ -1034,9 +1296,13 @@ applier_handle_raft_request(struct applier *applier, struct raft_request *req)
 	return box_raft_process(req, applier->instance_id);
 }
 
-static int
-apply_plain_tx(uint32_t replica_id, struct stailq *rows,
-	       bool skip_conflict, bool use_triggers)
+/**
+ * Begin a transaction and apply all the rows to it. Returns the
+ * transaction ready to be committed or NULL on error.
+ */
+static struct txn *
+apply_plain_tx_begin(uint32_t replica_id, struct stailq *rows,
+		     bool skip_conflict, bool use_triggers)
 {
 	/*
 	 * Explicitly begin the transaction so that we can
@@ -1047,7 +1313,7 @@ apply_plain_tx(uint32_t replica_id, struct stailq *rows,
 	struct txn *txn = txn_begin();
 	struct applier_tx_row *item;
 	if (txn == NULL)
-		 return -1;
+		 return NULL;
 
 	stailq_foreach_entry(item, rows, next) {
 		struct xrow_header *row = &item->row;
@@ -1128,11 +1394,21 @@ apply_plain_tx(uint32_t replica_id, struct stailq *rows,
 		trigger_create(on_wal_write, applier_txn_wal_write_cb, rcb, NULL);
 		txn_on_wal_write(txn, on_wal_write);
 	}
-
-	return txn_commit_try_async(txn);
+	return txn;
 fail:
 	txn_abort(txn);
-	return -1;
+	return NULL;
+}
+
+static int
+apply_plain_tx(uint32_t replica_id, struct stailq *rows,
+	       bool skip_conflict, bool use_triggers)
+{
+	struct txn *txn = apply_plain_tx_begin(replica_id, rows,
+					       skip_conflict, use_triggers);
+	if (txn == NULL)
+		return -1;
+	return txn_commit_try_async(txn);
 }
 
 /** A simpler version of applier_apply_tx() for final join stage. */
@@ -1305,6 +1581,425 @@ finish:
 	return rc;
 }
 
+/**
+ * A run of transactions coming from the same instance that are
+ * applied concurrently, each in its own fiber.
+ *
+ * A transaction starts applying as soon as all preceding
+ * transactions of the run it conflicts with are committed while
+ * commits are submitted to WAL strictly in the order transactions
+ * were received. Transactions conflict if they modify the same
+ * primary key or if the keys modified by one of them can't be
+ * told in advance and they modify the same space.
+ *
+ * The run holds the order latch of the instance the transactions
+ * come from until all of them are committed so the same rows
+ * received by another applier are skipped as usual.
+ */
+struct applier_run {
+	/** Order latch held by the run or NULL if the run is empty. */
+	struct latch *latch;
+	/** LSN of the last row added to the run. */
+	int64_t last_lsn;
+	/** Sequence number of the next transaction added to the run. */
+	int64_t next_seq;
+	/** Sequence number of the next transaction to commit. */
+	int64_t commit_seq;
+	/** Number of transactions being applied. */
+	int in_flight;
+	/** Set if a transaction of the run failed to apply. */
+	bool is_failed;
+	/** The error a transaction of the run failed with. */
+	struct diag diag;
+	/** Signalled when a transaction is committed or fails. */
+	struct fiber_cond cond;
+	/**
+	 * Map of conflict keys to the sequence number of the last
+	 * transaction of the run having the key, created on demand.
+	 */
+	struct mh_i64ptr_t *keys;
+};
+
+static void
+applier_run_create(struct applier_run *run)
+{
+	run->latch = NULL;
+	run->last_lsn = 0;
+	run->next_seq = 0;
+	run->commit_seq = 0;
+	run->in_flight = 0;
+	run->is_failed = false;
+	diag_create(&run->diag);
+	fiber_cond_create(&run->cond);
+	run->keys = NULL;
+}
+
+/**
+ * Wait for all transactions of a run to complete and release the
+ * order latch. Returns -1 and sets diag if any of them failed.
+ */
+static int
+applier_run_finish(struct applier_run *run)
+{
+	while (run->in_flight > 0)
+		fiber_cond_wait(&run->cond);
+	if (run->latch != NULL) {
+		latch_unlock(run->latch);
+		run->latch = NULL;
+	}
+	run->next_seq = 0;
+	run->commit_seq = 0;
+	if (run->keys != NULL)
+		mh_i64ptr_clear(run->keys);
+	if (run->is_failed) {
+		run->is_failed = false;
+		diag_move(&run->diag, diag_get());
+		return -1;
+	}
+	return 0;
+}
+
+static void
+applier_run_destroy(struct applier_run *run)
+{
+	assert(run->in_flight == 0);
+	assert(run->latch == NULL);
+	diag_destroy(&run->diag);
+	fiber_cond_destroy(&run->cond);
+	if (run->keys != NULL)
+		mh_i64ptr_delete(run->keys);
+}
+
+/** Conflict key of a primary key of a space. */
+static inline uint64_t
+applier_run_key(uint32_t space_id, uint32_t key_hash)
+{
+	return (uint64_t)space_id << 32 | key_hash;
+}
+
+/** Conflict key of all transactions modifying a space. */
+static inline uint64_t
+applier_run_space_key(uint32_t space_id)
+{
+	return 1ULL << 63 | (uint64_t)space_id << 1;
+}
+
+/**
+ * Conflict key of transactions modifying a space keys of which
+ * can't be told in advance.
+ */
+static inline uint64_t
+applier_run_space_all_key(uint32_t space_id)
+{
+	return applier_run_space_key(space_id) | 1;
+}
+
+/**
+ * Return the sequence number of the last transaction of a run
+ * having the given conflict key or -1.
+ */
+static int64_t
+applier_run_get_key(struct applier_run *run, uint64_t key)
+{
+	if (run->keys == NULL)
+		return -1;
+	mh_int_t k = mh_i64ptr_find(run->keys, key, NULL);
+	if (k == mh_end(run->keys))
+		return -1;
+	return (intptr_t)mh_i64ptr_node(run->keys, k)->val;
+}
+
+static void
+applier_run_set_key(struct applier_run *run, uint64_t key, int64_t seq)
+{
+	if (run->keys == NULL)
+		run->keys = mh_i64ptr_new();
+	struct mh_i64ptr_node_t node = { key, (void *)(intptr_t)seq };
+	mh_i64ptr_put(run->keys, &node, NULL, NULL);
+}
+
+/**
+ * Calculate the hash of the primary key modified by a request.
+ * Returns false if the key can't be told without executing the
+ * request or if the request may modify other unique keys.
+ */
+static bool
+applier_request_key_hash(struct space *space, struct request *request,
+			 uint32_t *hash)
+{
+	struct index *pk = space_index(space, 0);
+	if (pk == NULL)
+		return false;
+	for (uint32_t i = 1; i < space->index_count; i++) {
+		if (space->index[i]->def->opts.is_unique)
+			return false;
+	}
+	struct key_def *key_def = pk->def->key_def;
+	const char *key;
+	switch (request->type) {
+	case IPROTO_INSERT:
+	case IPROTO_REPLACE:
+	case IPROTO_UPSERT:
+		key = tuple_extract_key_raw(request->tuple, request->tuple_end,
+					    key_def, MULTIKEY_NONE, NULL);
+		if (key == NULL) {
+			diag_clear(diag_get());
+			return false;
+		}
+		break;
+	case IPROTO_DELETE:
+	case IPROTO_UPDATE:
+		if (request->index_id != 0)
+			return false;
+		key = request->key;
+		break;
+	default:
+		return false;
+	}
+	uint32_t part_count = mp_decode_array(&key);
+	if (exact_key_validate(key_def, key, part_count) != 0) {
+		diag_clear(diag_get());
+		return false;
+	}
+	*hash = key_hash(key, key_def);
+	return true;
+}
+
+/**
+ * Check if a transaction can be applied concurrently with other
+ * transactions of a run.
+ *
+ * @param rows The transaction rows.
+ * @param[out] has_vinyl Set if the transaction modifies vinyl
+ *             spaces.
+ * @param[out] can_yield Set if the transaction may yield while
+ *             being applied.
+ *
+ * @retval 0 The transaction can be added to the run.
+ * @retval -1 The transaction must be applied after the run.
+ */
+static int
+applier_run_check_tx(struct stailq *rows, bool *has_vinyl, bool *can_yield)
+{
+	bool has_other = false;
+	*has_vinyl = false;
+	struct applier_tx_row *item;
+	stailq_foreach_entry(item, rows, next) {
+		if (item->row.type == IPROTO_NOP)
+			continue;
+		if (!iproto_type_is_dml(item->row.type))
+			return -1;
+		struct space *space = space_by_id(item->req.dml.space_id);
+		/*
+		 * Changes of system spaces and spaces with triggers
+		 * may depend on or affect any other data.
+		 */
+		if (space == NULL || space_id(space) < BOX_SYSTEM_ID_MAX ||
+		    !rlist_empty(&space->before_replace) ||
+		    !rlist_empty(&space->on_replace))
+			return -1;
+		if (space_is_vinyl(space))
+			*has_vinyl = true;
+		else
+			has_other = true;
+	}
+	/*
+	 * Only vinyl transactions yield when applied.
+	 * A memtx transaction is aborted if it yields
+	 * so it has to wait for its turn to commit before
+	 * it starts applying.
+	 */
+	*can_yield = *has_vinyl && !has_other;
+	return 0;
+}
+
+/**
+ * Register keys of vinyl spaces modified by a transaction in
+ * a run and find the last transaction of the run it conflicts
+ * with. Keys of other spaces aren't tracked, because only vinyl
+ * transactions may be applied before preceding transactions are
+ * committed.
+ *
+ * @param run The run.
+ * @param rows The transaction rows.
+ * @param seq Sequence number of the transaction.
+ *
+ * @return Sequence number of the last conflicting transaction
+ *         or -1.
+ */
+static int64_t
+applier_run_add_keys(struct applier_run *run, struct stailq *rows,
+		     int64_t seq)
+{
+	int64_t dep = -1;
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	struct applier_tx_row *item;
+	stailq_foreach_entry(item, rows, next) {
+		if (item->row.type == IPROTO_NOP)
+			continue;
+		struct request *request = &item->req.dml;
+		struct space *space = space_by_id(request->space_id);
+		assert(space != NULL);
+		if (!space_is_vinyl(space))
+			continue;
+		uint32_t id = space_id(space);
+		uint32_t hash;
+		uint64_t keys[2];
+		int64_t prev;
+		if (applier_request_key_hash(space, request, &hash)) {
+			keys[0] = applier_run_key(id, hash);
+			keys[1] = applier_run_space_key(id);
+			prev = applier_run_get_key(run, keys[0]);
+		} else {
+			keys[0] = applier_run_space_all_key(id);
+			keys[1] = applier_run_space_key(id);
+			prev = applier_run_get_key(run, keys[1]);
+		}
+		dep = MAX(dep, prev);
+		prev = applier_run_get_key(run, applier_run_space_all_key(id));
+		dep = MAX(dep, prev);
+		applier_run_set_key(run, keys[0], seq);
+		applier_run_set_key(run, keys[1], seq);
+	}
+	region_truncate(region, region_svp);
+	return dep;
+}
+
+/** Fiber applying a transaction added to a run. */
+static int
+applier_run_apply_f(va_list ap)
+{
+	struct applier_run *run = va_arg(ap, struct applier_run *);
+	struct session *session = va_arg(ap, struct session *);
+	struct stailq *rows = va_arg(ap, struct stailq *);
+	uint32_t replica_id = va_arg(ap, uint32_t);
+	int64_t seq = va_arg(ap, int64_t);
+	int64_t dep = va_arg(ap, int64_t);
+	bool can_yield = va_arg(ap, int);
+	/*
+	 * Borrow the applier session so that on_replace() triggers
+	 * see the applier session type. The applier fiber waits for
+	 * all transactions of the run so the session outlives us.
+	 */
+	fiber_set_session(fiber(), session);
+	fiber_set_user(fiber(), &session->credentials);
+
+	/*
+	 * A transaction that can't yield is applied only when
+	 * all preceding transactions are committed.
+	 */
+	int64_t wait_seq = can_yield ? dep + 1 : seq;
+	while (run->commit_seq < wait_seq && !run->is_failed)
+		fiber_cond_wait(&run->cond);
+	if (run->is_failed)
+		goto out;
+	struct txn *txn;
+	txn = apply_plain_tx_begin(replica_id, rows,
+				   replication_skip_conflict, true);
+	if (txn == NULL)
+		goto fail;
+	while (run->commit_seq < seq && !run->is_failed)
+		fiber_cond_wait(&run->cond);
+	if (run->is_failed) {
+		txn_abort(txn);
+		goto out;
+	}
+	if (txn_commit_try_async(txn) != 0)
+		goto fail;
+	struct xrow_header *last_row;
+	last_row = &stailq_last_entry(rows, struct applier_tx_row, next)->row;
+	vclock_follow(&replicaset.applier.vclock, last_row->replica_id,
+		      last_row->lsn);
+	run->commit_seq = seq + 1;
+	goto out;
+fail:
+	run->is_failed = true;
+	diag_move(diag_get(), &run->diag);
+out:
+	run->in_flight--;
+	fiber_cond_broadcast(&run->cond);
+	fiber_gc();
+	return 0;
+}
+
+/**
+ * Apply a transaction concurrently with other transactions of
+ * the run if possible, see applier_run. Transactions that can't
+ * be applied concurrently are applied with applier_apply_tx()
+ * after all transactions of the run are committed.
+ *
+ * Return 0 for success or -1 in case of an error.
+ */
+static int
+applier_run_apply_tx(struct applier_run *run, struct applier *applier,
+		     struct stailq *rows)
+{
+	if (replication_parallel_apply <= 1)
+		goto sequential;
+	struct xrow_header *first_row, *last_row;
+	first_row = &stailq_first_entry(rows, struct applier_tx_row,
+					next)->row;
+	last_row = &stailq_last_entry(rows, struct applier_tx_row, next)->row;
+	if (iproto_type_is_synchro_request(first_row->type))
+		goto sequential;
+	struct replica *replica;
+	replica = replica_by_id(first_row->replica_id);
+	struct latch *latch;
+	latch = (replica ? &replica->order_latch :
+		 &replicaset.applier.order_latch);
+	if (run->latch != latch) {
+		if (applier_run_finish(run) != 0)
+			return -1;
+		latch_lock(latch);
+		run->latch = latch;
+		run->last_lsn = vclock_get(&replicaset.applier.vclock,
+					   first_row->replica_id);
+	}
+	/*
+	 * Let applier_apply_tx() deal with transactions that have
+	 * already been applied, completely or partially.
+	 */
+	if (first_row->lsn <= run->last_lsn)
+		goto sequential;
+	while (run->in_flight >= replication_parallel_apply &&
+	       !run->is_failed)
+		fiber_cond_wait(&run->cond);
+	if (run->is_failed)
+		return applier_run_finish(run);
+	applier_synchro_filter_tx(rows);
+	bool has_vinyl, can_yield;
+	if (applier_run_check_tx(rows, &has_vinyl, &can_yield) != 0)
+		goto sequential;
+	int64_t seq, dep;
+	seq = run->next_seq;
+	/*
+	 * A transaction that doesn't modify vinyl spaces waits for
+	 * all preceding transactions before it starts applying and
+	 * can't conflict with following transactions that may yield
+	 * so there's no need to track its keys.
+	 */
+	dep = -1;
+	if (has_vinyl)
+		dep = applier_run_add_keys(run, rows, seq);
+	struct fiber *f;
+	f = fiber_new("applier_apply", applier_run_apply_f);
+	if (f == NULL) {
+		diag_log();
+		goto sequential;
+	}
+	run->next_seq++;
+	run->in_flight++;
+	run->last_lsn = last_row->lsn;
+	fiber_start(f, run, current_session(), rows, applier->instance_id,
+		    seq, dep, (int)can_yield);
+	return 0;
+sequential:
+	if (applier_run_finish(run) != 0)
+		return -1;
+	return applier_apply_tx(applier, rows);
+}
+
 /**
  * Notify the applier's write fiber that there are more ACKs to
  * send to master.
@@ -1427,6 +2122,26 @@ applier_handle_raft(struct applier *applier, struct applier_tx_row *txr)
 	return 0;
 }
 
+/**
+ * Yield if the applier has been applying transactions since
+ * @a start for longer than replication_apply_budget so that
+ * requests served by tx don't wait until the whole batch is
+ * applied. Account the time spent applying and reset @a start.
+ */
+static void
+applier_check_apply_budget(struct applier *applier, double *start)
+{
+	if (replication_apply_budget == 0)
+		return;
+	double now = ev_monotonic_time();
+	if (now - *start < replication_apply_budget)
+		return;
+	applier->apply_time += now - *start;
+	applier->apply_yield_count++;
+	fiber_sleep(0);
+	*start = ev_monotonic_time();
+}
+
 /**
  * The tx part of applier-in-thread machinery. Apply all the parsed
  * transactions.
@@ -1437,16 +2152,39 @@ applier_process_batch(struct cmsg *base)
 	struct applier_data_msg *msg = (struct applier_data_msg *)base;
 	struct applier *applier = msg->base.applier;
 	struct applier_tx *tx;
+	/*
+	 * Rows are freed when the message is returned so all the
+	 * transactions must be committed by then.
+	 */
+	struct applier_run run;
+	applier_run_create(&run);
+	auto run_guard = make_scoped_guard([&] {
+		applier_run_finish(&run);
+		applier_run_destroy(&run);
+	});
+	double start = ev_monotonic_time();
+	int64_t tx_count = 0;
+	stailq_foreach_entry(tx, &msg->txs, next) {
+		if (tx->lag != TIMEOUT_INFINITY)
+			latency_collect(&applier->lag_latency, tx->lag);
+		tx_count++;
+	}
+	histogram_collect(applier->queue_depth, tx_count);
 	stailq_foreach_entry(tx, &msg->txs, next) {
 		struct applier_tx_row *txr =
 			stailq_first_entry(&tx->rows, struct applier_tx_row,
 					    next);
 		raft_process_heartbeat(box_raft(), applier->instance_id);
+		if (txr->row.replica_id == applier->instance_id &&
+		    txr->row.tm != 0)
+			applier->echo_tm = txr->row.tm;
 		if (txr->row.lsn == 0) {
-			if (applier_handle_raft(applier, txr) != 0)
+			if (applier_run_finish(&run) != 0 ||
+			    applier_handle_raft(applier, txr) != 0)
 				diag_raise();
 			applier_signal_ack(applier);
-		} else if (applier_apply_tx(applier, &tx->rows) != 0) {
+		} else if (applier_run_apply_tx(&run, applier,
+						&tx->rows) != 0) {
 			diag_raise();
 		}
 		if (applier->state == APPLIER_FINAL_JOIN &&
@@ -1456,7 +2194,11 @@ applier_process_batch(struct cmsg *base)
 			applier_set_state(applier, APPLIER_READY);
 			applier_set_state(applier, APPLIER_FOLLOW);
 		}
+		applier_check_apply_budget(applier, &start);
 	}
+	if (applier_run_finish(&run) != 0)
+		diag_raise();
+	applier->apply_time += ev_monotonic_time() - start;
 
 	/* Return the message to applier thread. */
 	cmsg_init(&msg->base.base, return_route);
@@ -1615,6 +2357,7 @@ applier_thread_reader_f(va_list ap)
 		}
 		try {
 			applier_read_tx(applier, &tx->rows, &ctx, timeout);
+			tx->lag = applier->lag;
 		} catch (FiberIsCancelled *) {
 			return 0;
 		} catch (Exception *e) {
@@ -1924,7 +2667,9 @@ applier_subscribe(struct applier *applier)
 	 */
 	uint32_t id_filter = box_is_orphan() ? 0 : 1 << instance_id;
 	xrow_encode_subscribe_xc(&row, &REPLICASET_UUID, &INSTANCE_UUID,
-				 &vclock, replication_anon, id_filter);
+				 &vclock, replication_anon, id_filter,
+				 replication_space_filter,
+				 replication_space_filter_size);
 	coio_write_xrow(io, &row);
 
 	/* Read SUBSCRIBE response */
@@ -2009,6 +2754,7 @@ applier_subscribe(struct applier *applier)
 	}
 
 	applier->lag = TIMEOUT_INFINITY;
+	applier->echo_tm = 0;
 
 	/*
 	 * Register triggers to handle WAL writes and rollbacks.
@@ -2263,6 +3009,17 @@ applier_new(struct uri *uri)
 		free(applier);
 		diag_raise();
 	}
+	static const int64_t queue_depth_buckets[] = {
+		1, 2, 4, 8, 16, 32, 64, 128,
+	};
+	applier->queue_depth = histogram_new(queue_depth_buckets,
+					     lengthof(queue_depth_buckets));
+	applier->rmean = rmean_new(replication_stat_strings,
+				   REPLICATION_STAT_LAST);
+	if (applier->queue_depth == NULL || applier->rmean == NULL ||
+	    latency_create(&applier->lag_latency) != 0 ||
+	    latency_create(&applier->apply_latency) != 0)
+		panic("failed to allocate applier statistics");
 	iostream_clear(&applier->io);
 	ibuf_create(&applier->ibuf, &cord()->slabc, 1024);
 
@@ -2286,6 +3043,10 @@ applier_delete(struct applier *applier)
 	uri_destroy(&applier->uri);
 	trigger_destroy(&applier->on_state);
 	diag_destroy(&applier->diag);
+	latency_destroy(&applier->lag_latency);
+	latency_destroy(&applier->apply_latency);
+	histogram_delete(applier->queue_depth);
+	rmean_delete(applier->rmean);
 	free(applier);
 }
 
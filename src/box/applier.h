@@ -47,11 +47,15 @@
 #include "cbus.h"
 
 #include "xrow.h"
+#include "latency.h"
 
 #if defined(__cplusplus)
 extern "C" {
 #endif /* defined(__cplusplus) */
 
+struct histogram;
+struct rmean;
+
 enum { APPLIER_SOURCE_MAXLEN = 1024 }; /* enough to fit URI with passwords */
 
 #define applier_STATE(_)                                             \
@@ -133,8 +137,35 @@ struct applier {
 	enum applier_state state;
 	/** Local time of this replica when the last row has been received */
 	ev_tstamp last_row_time;
+	/**
+	 * Timestamp of the latest heartbeat or row originated by the
+	 * master. It is echoed back in acks, so that the master knows
+	 * when the replica heard from it last time.
+	 */
+	double echo_tm;
 	/** Number of seconds this replica is behind the remote master */
 	ev_tstamp lag;
+	/** Histogram of applier::lag values of received transactions. */
+	struct latency lag_latency;
+	/**
+	 * Histogram of time passed since a transaction was written to
+	 * the master's WAL till it was written to the local WAL.
+	 */
+	struct latency apply_latency;
+	/**
+	 * Histogram of the number of transactions delivered to tx at
+	 * once, i.e. received but not applied yet.
+	 */
+	struct histogram *queue_depth;
+	/** Received rows and bytes, see enum replication_stat. */
+	struct rmean *rmean;
+	/** Time spent applying received transactions, in seconds. */
+	double apply_time;
+	/**
+	 * Number of times the applier yielded having exhausted
+	 * replication_apply_budget.
+	 */
+	int64_t apply_yield_count;
 	/** The last box_error_code() logged to avoid log flooding */
 	uint32_t last_logged_errcode;
 	/** Remote instance ID. */
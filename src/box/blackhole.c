@@ -156,7 +156,7 @@ blackhole_engine_create_space(struct engine *engine, struct space_def *def,
 	format = tuple_format_new(&tuple_format_runtime->vtab, NULL, NULL, 0,
 				  def->fields, def->field_count,
 				  def->exact_field_count, def->dict, false,
-				  false);
+				  false, false);
 	if (format == NULL) {
 		free(space);
 		return NULL;
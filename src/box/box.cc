@@ -272,6 +272,19 @@ box_check_memtx_min_tuple_size(ssize_t memtx_min_tuple_size)
 		  "specified value is out of bounds");
 }
 
+static double
+box_check_memtx_defrag_ratio(void)
+{
+	double ratio = cfg_getd("memtx_defrag_ratio");
+	if (ratio < 0 || ratio >= 1) {
+		diag_set(ClientError, ER_CFG, "memtx_defrag_ratio",
+			 "the value must be greater than or equal to 0 "
+			 "and less than 1");
+		return -1;
+	}
+	return ratio;
+}
+
 int
 box_process_rw(struct request *request, struct space *space,
 	       struct tuple **result)
@@ -754,6 +767,25 @@ error:
 	return ELECTION_MODE_INVALID;
 }
 
+/**
+ * A replica with replication_space_filter doesn't store rows of
+ * filtered spaces, but its vclock doesn't show it, so it mustn't
+ * be allowed to become a leader.
+ */
+static int
+box_check_election_mode_space_filter(enum election_mode mode)
+{
+	if ((mode == ELECTION_MODE_CANDIDATE ||
+	     mode == ELECTION_MODE_MANUAL) &&
+	    !cfg_isnil("replication_space_filter")) {
+		diag_set(ClientError, ER_CFG, "election_mode",
+			 "the value must be 'off' or 'voter' when "
+			 "replication_space_filter is set");
+		return -1;
+	}
+	return 0;
+}
+
 static double
 box_check_election_timeout(void)
 {
@@ -811,6 +843,79 @@ box_check_replication_threads(void)
 	return 0;
 }
 
+static int
+box_check_replication_parallel_apply(void)
+{
+	int count = cfg_geti("replication_parallel_apply");
+	if (count <= 0 || count > REPLICATION_PARALLEL_APPLY_MAX) {
+		diag_set(ClientError, ER_CFG, "replication_parallel_apply",
+			 tt_sprintf("must be greater than 0, less than or "
+				    "equal to %d",
+				    REPLICATION_PARALLEL_APPLY_MAX));
+		return -1;
+	}
+	return count;
+}
+
+static double
+box_check_replication_apply_budget(void)
+{
+	double budget = cfg_getd("replication_apply_budget");
+	if (budget < 0) {
+		diag_set(ClientError, ER_CFG, "replication_apply_budget",
+			 "the value must be greater than or equal to 0");
+		return -1;
+	}
+	return budget;
+}
+
+static int
+box_check_replication_join_streams(void)
+{
+	int count = cfg_geti("replication_join_streams");
+	if (count <= 0 || count > REPLICATION_JOIN_STREAMS_MAX) {
+		diag_set(ClientError, ER_CFG, "replication_join_streams",
+			 tt_sprintf("must be greater than 0, less than or "
+				    "equal to %d",
+				    REPLICATION_JOIN_STREAMS_MAX));
+		return -1;
+	}
+	return count;
+}
+
+/**
+ * Check box.cfg.replication_space_filter and store the space ids
+ * in @a ids unless it is NULL. Return the number of ids or -1.
+ * nil means that there's no filter, an empty list isn't allowed.
+ */
+static int
+box_check_replication_space_filter(uint32_t *ids)
+{
+	const char *name = "replication_space_filter";
+	int count = cfg_getarr_size(name);
+	if (count == 0 && !cfg_isnil(name)) {
+		diag_set(ClientError, ER_CFG, name,
+			 "the list of space ids must not be empty");
+		return -1;
+	}
+	for (int i = 0; i < count; i++) {
+		const char *str = cfg_getarr_elem(name, i);
+		char *end;
+		errno = 0;
+		unsigned long long id = str != NULL ?
+					strtoull(str, &end, 10) : 0;
+		if (str == NULL || *str == '\0' || *end != '\0' ||
+		    errno != 0 || id > BOX_SPACE_MAX) {
+			diag_set(ClientError, ER_CFG, name,
+				 "must be a space id or a list of space ids");
+			return -1;
+		}
+		if (ids != NULL)
+			ids[i] = id;
+	}
+	return count;
+}
+
 static int
 box_check_listen(void)
 {
@@ -1075,6 +1180,18 @@ box_check_wal_queue_max_size(void)
 	return size;
 }
 
+static int64_t
+box_check_wal_ring_size(void)
+{
+	int64_t size = cfg_geti64("wal_ring_size");
+	if (size < 0) {
+		diag_set(ClientError, ER_CFG, "wal_ring_size",
+			 "the value must be >= 0");
+		return -1;
+	}
+	return size;
+}
+
 static double
 box_check_wal_cleanup_delay(void)
 {
@@ -1220,6 +1337,16 @@ box_check_small_alloc_options(void)
 			  " to 1024 * 16 and exponent of two");
 }
 
+static void
+box_check_memtx_numa_node(void)
+{
+	int64_t node = cfg_geti64("memtx_numa_node");
+	if (node < -1 || node >= MEMTX_NUMA_NODE_MAX)
+		tnt_raise(ClientError, ER_CFG, "memtx_numa_node",
+			  tt_sprintf("must be -1 or a NUMA node number "
+				     "less than %d", MEMTX_NUMA_NODE_MAX));
+}
+
 static int
 box_check_iproto_options(void)
 {
@@ -1255,7 +1382,10 @@ box_check_config(void)
 		diag_raise();
 	box_check_instance_uuid(&uuid);
 	box_check_replicaset_uuid(&uuid);
-	if (box_check_election_mode() == ELECTION_MODE_INVALID)
+	enum election_mode election_mode = box_check_election_mode();
+	if (election_mode == ELECTION_MODE_INVALID)
+		diag_raise();
+	if (box_check_election_mode_space_filter(election_mode) != 0)
 		diag_raise();
 	if (box_check_election_timeout() < 0)
 		diag_raise();
@@ -1271,6 +1401,14 @@ box_check_config(void)
 		diag_raise();
 	if (box_check_replication_threads() < 0)
 		diag_raise();
+	if (box_check_replication_parallel_apply() < 0)
+		diag_raise();
+	if (box_check_replication_apply_budget() < 0)
+		diag_raise();
+	if (box_check_replication_join_streams() < 0)
+		diag_raise();
+	if (box_check_replication_space_filter(NULL) < 0)
+		diag_raise();
 	box_check_replication_sync_timeout();
 	box_check_readahead(cfg_geti("readahead"));
 	box_check_checkpoint_count(cfg_geti("checkpoint_count"));
@@ -1278,6 +1416,8 @@ box_check_config(void)
 	box_check_wal_mode(cfg_gets("wal_mode"));
 	if (box_check_wal_queue_max_size() < 0)
 		diag_raise();
+	if (box_check_wal_ring_size() < 0)
+		diag_raise();
 	if (box_check_wal_cleanup_delay() < 0)
 		diag_raise();
 	if (box_check_memory_quota("memtx_memory") < 0)
@@ -1286,6 +1426,9 @@ box_check_config(void)
 	if (box_check_allocator() != 0)
 		diag_raise();
 	box_check_small_alloc_options();
+	box_check_memtx_numa_node();
+	if (box_check_memtx_defrag_ratio() < 0)
+		diag_raise();
 	box_check_vinyl_options();
 	if (box_check_iproto_options() != 0)
 		diag_raise();
@@ -1301,6 +1444,8 @@ box_set_election_mode(void)
 	enum election_mode mode = box_check_election_mode();
 	if (mode == ELECTION_MODE_INVALID)
 		return -1;
+	if (box_check_election_mode_space_filter(mode) != 0)
+		return -1;
 	box_election_mode = mode;
 	raft_cfg_is_candidate(box_raft(), mode == ELECTION_MODE_CANDIDATE);
 	raft_cfg_is_enabled(box_raft(), mode != ELECTION_MODE_OFF);
@@ -1317,6 +1462,13 @@ box_set_election_timeout(void)
 	return 0;
 }
 
+void
+box_set_election_leader_lease(void)
+{
+	bool is_enabled = cfg_geti("election_leader_lease");
+	raft_cfg_is_lease_enabled(box_raft(), is_enabled);
+}
+
 /*
  * Sync box.cfg.replication with the cluster registry, but
  * don't start appliers.
@@ -1484,6 +1636,63 @@ box_set_replication_skip_conflict(void)
 	replication_skip_conflict = cfg_geti("replication_skip_conflict");
 }
 
+int
+box_set_replication_parallel_apply(void)
+{
+	int count = box_check_replication_parallel_apply();
+	if (count < 0)
+		return -1;
+	replication_parallel_apply = count;
+	return 0;
+}
+
+int
+box_set_replication_apply_budget(void)
+{
+	double budget = box_check_replication_apply_budget();
+	if (budget < 0)
+		return -1;
+	replication_apply_budget = budget;
+	return 0;
+}
+
+/** Set box.cfg.replication_join_from_checkpoint. Called only once. */
+static void
+box_set_replication_join_from_checkpoint(void)
+{
+	replication_join_from_checkpoint =
+		cfg_geti("replication_join_from_checkpoint") != 0;
+}
+
+/** Set box.cfg.replication_join_streams. Called only once. */
+static int
+box_set_replication_join_streams(void)
+{
+	int count = box_check_replication_join_streams();
+	if (count < 0)
+		return -1;
+	replication_join_streams = count;
+	return 0;
+}
+
+/** Set box.cfg.replication_space_filter. Called only once. */
+static int
+box_set_replication_space_filter(void)
+{
+	assert(replication_space_filter == NULL);
+	int count = box_check_replication_space_filter(NULL);
+	if (count <= 0)
+		return count;
+	uint32_t *ids = (uint32_t *)xcalloc(count, sizeof(*ids));
+	if (box_check_replication_space_filter(ids) < 0) {
+		free(ids);
+		return -1;
+	}
+	replication_space_filter = ids;
+	replication_space_filter_size = count;
+	return 0;
+}
+
 void
 box_set_replication_anon(void)
 {
@@ -1855,6 +2064,15 @@ box_promote(void)
 
 	if (!is_box_configured)
 		return 0;
+	/*
+	 * An instance that doesn't replicate some of the spaces may
+	 * lack data that the previous leader confirmed.
+	 */
+	if (replication_space_filter != NULL) {
+		diag_set(ClientError, ER_UNSUPPORTED,
+			 "replication_space_filter", "promotion");
+		return -1;
+	}
 	/*
 	 * Currently active leader (the instance that is seen as leader by both
 	 * raft and txn_limbo) can't issue another PROMOTE.
@@ -2002,6 +2220,18 @@ box_set_memtx_max_tuple_size(void)
 			cfg_geti("memtx_max_tuple_size"));
 }
 
+void
+box_set_memtx_defrag_ratio(void)
+{
+	double ratio = box_check_memtx_defrag_ratio();
+	if (ratio < 0)
+		diag_raise();
+	struct memtx_engine *memtx;
+	memtx = (struct memtx_engine *)engine_by_name("memtx");
+	assert(memtx != NULL);
+	memtx_engine_set_defrag_ratio(memtx, ratio);
+}
+
 void
 box_set_too_long_threshold(void)
 {
@@ -2097,6 +2327,14 @@ box_set_vinyl_cache(void)
 	vinyl_engine_set_cache(vinyl, cfg_geti64("vinyl_cache"));
 }
 
+void
+box_set_vinyl_page_cache(void)
+{
+	struct engine *vinyl = engine_by_name("vinyl");
+	assert(vinyl != NULL);
+	vinyl_engine_set_page_cache(vinyl, cfg_geti64("vinyl_page_cache"));
+}
+
 void
 box_set_vinyl_timeout(void)
 {
@@ -2315,6 +2553,39 @@ box_process1(struct request *request, box_tuple_t **result)
 	return box_process_rw(request, space, result);
 }
 
+/**
+ * Check if the instance is the leader holding the leader lease and
+ * owning the synchronous transaction queue.
+ */
+static int
+box_check_leader_lease(void)
+{
+	struct raft *raft = box_raft();
+	if (!raft_has_lease(raft) || txn_limbo.owner_id != instance_id ||
+	    txn_limbo_replica_term(&txn_limbo, instance_id) != raft->term) {
+		diag_set(ClientError, ER_NO_LEADER_LEASE);
+		return -1;
+	}
+	return 0;
+}
+
+API_EXPORT int
+box_wait_linearizable_read(void)
+{
+	if (box_check_leader_lease() != 0)
+		return -1;
+	/*
+	 * Readers see synchronous transactions before they are
+	 * confirmed, and they still may be rolled back. Wait for
+	 * their outcome so as not to return data which then may
+	 * disappear.
+	 */
+	if (txn_limbo_wait_confirm(&txn_limbo) != 0)
+		return -1;
+	/* The lease could expire while waiting. */
+	return box_check_leader_lease();
+}
+
 API_EXPORT int
 box_select(uint32_t space_id, uint32_t index_id,
 	   int iterator, uint32_t offset, uint32_t limit,
@@ -2709,7 +2980,7 @@ box_process_fetch_snapshot(struct iostream *io,
 
 	/* Send the snapshot data to the instance. */
 	struct vclock start_vclock;
-	relay_initial_join(io, header->sync, &start_vclock, 0);
+	relay_initial_join(io, header->sync, &start_vclock, 0, &uuid_nil, 1);
 	say_info("read-view sent.");
 
 	/* Remember master's vclock after the last request */
@@ -2808,6 +3079,31 @@ box_process_register(struct iostream *io, const struct xrow_header *header)
 	gc_guard.is_active = false;
 }
 
+static int
+box_find_vinyl_space_cb(struct space *space, void *data)
+{
+	if (!space_is_vinyl(space))
+		return 0;
+	*(bool *)data = true;
+	return 1;
+}
+
+/**
+ * Return the last checkpoint if a replica can be joined by sending
+ * its files as is, NULL otherwise. Only memtx checkpoints can be
+ * sent this way: vinyl data is spread over a lot of files and
+ * needs the metadata log to be loaded.
+ */
+static struct gc_checkpoint *
+box_find_join_checkpoint(void)
+{
+	bool has_vinyl = false;
+	space_foreach(box_find_vinyl_space_cb, &has_vinyl);
+	if (has_vinyl)
+		return NULL;
+	return gc_last_checkpoint();
+}
+
 void
 box_process_join(struct iostream *io, const struct xrow_header *header)
 {
@@ -2845,6 +3141,37 @@ box_process_join(struct iostream *io, const struct xrow_header *header)
 	 * <= OK { VCLOCK: current_vclock } - end of final JOIN stage.
 	 *      - `current_vclock` - master's vclock after final stage.
 	 *
+	 * If the replica sets CHECKPOINT_JOIN in the request and the
+	 * master has only memtx data, the initial data is sent as the
+	 * raw snapshot file of the last checkpoint instead:
+	 *
+	 * <= OK { VCLOCK: checkpoint_vclock }
+	 * <= JOIN_META
+	 * <= JOIN_SNAPSHOT { FILE_SIZE: size }
+	 * <= `size` bytes of the snapshot file
+	 * <= OK { VCLOCK: stop_vclock }
+	 *
+	 * and the final data is the WAL tail following the checkpoint.
+	 *
+	 * If the replica sets JOIN_STREAMS in the request, the master
+	 * may send memtx initial data over several connections. After
+	 * system spaces, right before the first row of a user space,
+	 * it tells the replica the number of connections and the id
+	 * of the join:
+	 *
+	 * <= JOIN_SNAPSHOT { JOIN_STREAMS: count, JOIN_ID: join_id }
+	 *
+	 * and the replica opens count - 1 additional connections:
+	 *
+	 * => JOIN { INSTANCE_UUID: replica_uuid, JOIN_ID: join_id }
+	 * <= INSERT
+	 *    ...
+	 * <= INSERT
+	 * <= OK
+	 *
+	 * Rows are split between all connections. The main connection
+	 * ends the initial data only when the additional ones are done.
+	 *
 	 * All packets must have the same SYNC value as initial JOIN request.
 	 * Master can send ERROR at any time. Replica doesn't confirm rows
 	 * by OKs. Either initial or final stream includes:
@@ -2858,7 +3185,11 @@ box_process_join(struct iostream *io, const struct xrow_header *header)
 	/* Decode JOIN request */
 	struct tt_uuid instance_uuid;
 	uint32_t replica_version_id;
-	xrow_decode_join_xc(header, &instance_uuid, &replica_version_id);
+	bool checkpoint_join;
+	uint32_t join_streams;
+	uint32_t join_id;
+	xrow_decode_join_xc(header, &instance_uuid, &replica_version_id,
+			    &checkpoint_join, &join_streams, &join_id);
 
 	/* Check that bootstrap has been finished */
 	if (!is_box_configured)
@@ -2871,6 +3202,19 @@ box_process_join(struct iostream *io, const struct xrow_header *header)
 	/* Check permissions */
 	access_check_universe_xc(PRIV_R);
 
+	if (join_id != 0) {
+		/* An additional stream of an initial join in progress. */
+		say_info("sending initial data to replica %s at %s",
+			 tt_uuid_str(&instance_uuid), sio_socketname(io->fd));
+		relay_initial_join_stream(io, header->sync, &instance_uuid,
+					  join_id);
+		struct xrow_header row;
+		xrow_encode_type(&row, IPROTO_OK);
+		row.sync = header->sync;
+		coio_write_xrow(io, &row);
+		return;
+	}
+
 	/*
 	 * Unless already registered, the new replica will be
 	 * added to _cluster space once the initial join stage
@@ -2890,11 +3234,30 @@ box_process_join(struct iostream *io, const struct xrow_header *header)
 			  "wal_mode = 'none'");
 	}
 
+	/*
+	 * Pin the checkpoint to be sent to the replica so that
+	 * it isn't removed while being sent.
+	 */
+	struct gc_checkpoint *checkpoint = NULL;
+	struct gc_checkpoint_ref checkpoint_ref;
+	if (checkpoint_join)
+		checkpoint = box_find_join_checkpoint();
+	if (checkpoint != NULL) {
+		gc_ref_checkpoint(checkpoint, &checkpoint_ref, "replica %s",
+				  tt_uuid_str(&instance_uuid));
+	}
+	auto checkpoint_guard = make_scoped_guard([&] {
+		if (checkpoint != NULL)
+			gc_unref_checkpoint(&checkpoint_ref);
+	});
+
 	/*
 	 * Register the replica as a WAL consumer so that
 	 * it can resume FINAL JOIN where INITIAL JOIN ends.
 	 */
-	struct gc_consumer *gc = gc_consumer_register(&replicaset.vclock,
+	struct gc_consumer *gc = gc_consumer_register(
+				checkpoint != NULL ? &checkpoint->vclock :
+						     &replicaset.vclock,
 				"replica %s", tt_uuid_str(&instance_uuid));
 	if (gc == NULL)
 		diag_raise();
@@ -2904,11 +3267,24 @@ box_process_join(struct iostream *io, const struct xrow_header *header)
 		 tt_uuid_str(&instance_uuid), sio_socketname(io->fd));
 
 	/*
-	 * Initial stream: feed replica with dirty data from engines.
+	 * Initial stream: feed replica with dirty data from engines
+	 * or with the last checkpoint.
 	 */
 	struct vclock start_vclock;
-	relay_initial_join(io, header->sync, &start_vclock,
-			   replica_version_id);
+	if (checkpoint != NULL) {
+		struct memtx_engine *memtx =
+			(struct memtx_engine *)engine_by_name("memtx");
+		vclock_copy(&start_vclock, &checkpoint->vclock);
+		const char *filename = xdir_format_filename(
+			&memtx->snap_dir, vclock_sum(&start_vclock), NONE);
+		say_info("sending checkpoint `%s'", filename);
+		relay_initial_join_checkpoint(io, header->sync, filename,
+					      &start_vclock);
+	} else {
+		relay_initial_join(io, header->sync, &start_vclock,
+				   replica_version_id, &instance_uuid,
+				   join_streams);
+	}
 	say_info("initial data sent.");
 
 	/**
@@ -2969,9 +3345,11 @@ box_process_subscribe(struct iostream *io, const struct xrow_header *header)
 	uint32_t replica_version_id;
 	bool anon;
 	uint32_t id_filter;
+	uint32_t *space_filter;
+	uint32_t space_filter_size;
 	xrow_decode_subscribe_xc(header, &peer_replicaset_uuid, &replica_uuid,
 				 &replica_clock, &replica_version_id, &anon,
-				 &id_filter);
+				 &id_filter, &space_filter, &space_filter_size);
 
 	/* Forbid connection to itself */
 	if (tt_uuid_is_equal(&replica_uuid, &INSTANCE_UUID))
@@ -3113,7 +3491,8 @@ box_process_subscribe(struct iostream *io, const struct xrow_header *header)
 	 * indefinitely).
 	 */
 	relay_subscribe(replica, io, header->sync, &replica_clock,
-			replica_version_id, id_filter);
+			replica_version_id, id_filter, space_filter,
+			space_filter_size);
 }
 
 void
@@ -3192,7 +3571,9 @@ engine_init()
 				    cfg_geti("strip_core"),
 				    cfg_geti("slab_alloc_granularity"),
 				    cfg_gets("memtx_allocator"),
-				    cfg_getd("slab_alloc_factor"));
+				    cfg_getd("slab_alloc_factor"),
+				    cfg_getb("memtx_use_huge_pages"),
+				    cfg_geti("memtx_numa_node"));
 	engine_register((struct engine *)memtx);
 	box_set_memtx_max_tuple_size();
 
@@ -3210,10 +3591,12 @@ engine_init()
 				    cfg_geti64("vinyl_memory"),
 				    cfg_geti("vinyl_read_threads"),
 				    cfg_geti("vinyl_write_threads"),
+				    cfg_getb("vinyl_direct_io"),
 				    cfg_geti("force_recovery"));
 	engine_register((struct engine *)vinyl);
 	box_set_vinyl_max_tuple_size();
 	box_set_vinyl_cache();
+	box_set_vinyl_page_cache();
 	box_set_vinyl_timeout();
 }
 
@@ -3636,8 +4019,11 @@ box_cfg_xc(void)
 
 	int64_t wal_max_size = box_check_wal_max_size(cfg_geti64("wal_max_size"));
 	enum wal_mode wal_mode = box_check_wal_mode(cfg_gets("wal_mode"));
+	int64_t wal_ring_size = box_check_wal_ring_size();
+	if (wal_ring_size < 0)
+		diag_raise();
 	if (wal_init(wal_mode, cfg_gets("wal_dir"), wal_max_size,
-		     &INSTANCE_UUID, on_wal_garbage_collection,
+		     wal_ring_size, &INSTANCE_UUID, on_wal_garbage_collection,
 		     on_wal_checkpoint_threshold) != 0) {
 		diag_raise();
 	}
@@ -3663,6 +4049,15 @@ box_cfg_xc(void)
 		diag_raise();
 	box_set_replication_sync_timeout();
 	box_set_replication_skip_conflict();
+	if (box_set_replication_parallel_apply() != 0)
+		diag_raise();
+	if (box_set_replication_apply_budget() != 0)
+		diag_raise();
+	box_set_replication_join_from_checkpoint();
+	if (box_set_replication_join_streams() != 0)
+		diag_raise();
+	if (box_set_replication_space_filter() != 0)
+		diag_raise();
 	box_set_replication_anon();
 
 	struct gc_checkpoint *checkpoint = gc_last_checkpoint();
@@ -3760,6 +4155,7 @@ box_cfg_xc(void)
 
 	if (box_set_election_timeout() != 0)
 		diag_raise();
+	box_set_election_leader_lease();
 	/*
 	 * Election is enabled last. So as all the parameters are installed by
 	 * that time.
@@ -260,12 +260,15 @@ int box_set_wal_queue_max_size(void);
 int box_set_wal_cleanup_delay(void);
 void box_set_memtx_memory(void);
 void box_set_memtx_max_tuple_size(void);
+void box_set_memtx_defrag_ratio(void);
 void box_set_vinyl_memory(void);
 void box_set_vinyl_max_tuple_size(void);
 void box_set_vinyl_cache(void);
+void box_set_vinyl_page_cache(void);
 void box_set_vinyl_timeout(void);
 int box_set_election_mode(void);
 int box_set_election_timeout(void);
+void box_set_election_leader_lease(void);
 void box_set_replication_timeout(void);
 void box_set_replication_connect_timeout(void);
 void box_set_replication_connect_quorum(void);
@@ -275,6 +278,8 @@ int box_set_replication_synchro_quorum(void);
 int box_set_replication_synchro_timeout(void);
 void box_set_replication_sync_timeout(void);
 void box_set_replication_skip_conflict(void);
+int box_set_replication_parallel_apply(void);
+int box_set_replication_apply_budget(void);
 void box_set_replication_anon(void);
 void box_set_net_msg_max(void);
 int box_set_crash(void);
@@ -307,6 +312,15 @@ box_select(uint32_t space_id, uint32_t index_id,
 	   const char *key, const char *key_end,
 	   struct port *port);
 
+/**
+ * Wait until the instance may serve a linearizable read, i.e. it
+ * is the leader holding the leader lease and it has no pending
+ * synchronous transactions readers could see before they are
+ * confirmed. It is private and used only by FFI.
+ */
+API_EXPORT int
+box_wait_linearizable_read(void);
+
 /** \cond public */
 
 /*
@@ -227,6 +227,20 @@ engine_join(struct engine_join_ctx *ctx, struct xstream *stream)
 	return 0;
 }
 
+int
+engine_join_parallel(struct engine_join_ctx *ctx, struct xstream *stream)
+{
+	int i = 0;
+	struct engine *engine;
+	engine_foreach(engine) {
+		if ((engine->flags & ENGINE_JOIN_PARALLEL) != 0 &&
+		    engine->vtab->join(engine, ctx->array[i], stream) != 0)
+			return -1;
+		i++;
+	}
+	return 0;
+}
+
 void
 engine_complete_join(struct engine_join_ctx *ctx)
 {
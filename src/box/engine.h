@@ -81,7 +81,10 @@ struct engine_vtab {
 	int (*prepare_join)(struct engine *engine, void **ctx);
 	/**
 	 * Feed the read view frozen on the previous step to
-	 * the given stream.
+	 * the given stream. If the engine has ENGINE_JOIN_PARALLEL
+	 * flag set, it may be called for the same context with
+	 * several streams at the same time, in which case the read
+	 * view is split between the streams.
 	 */
 	int (*join)(struct engine *engine, void *ctx, struct xstream *stream);
 	/**
@@ -221,6 +224,11 @@ enum {
 	 * transactions w/o throwing ER_CROSS_ENGINE_TRANSACTION.
 	 */
 	ENGINE_BYPASS_TX = 1 << 0,
+	/**
+	 * If set, the engine can feed a read view frozen for a new
+	 * replica to several streams in parallel.
+	 */
+	ENGINE_JOIN_PARALLEL = 1 << 1,
 };
 
 struct engine {
@@ -360,6 +368,14 @@ engine_prepare_join(struct engine_join_ctx *ctx);
 int
 engine_join(struct engine_join_ctx *ctx, struct xstream *stream);
 
+/**
+ * Feed a read view frozen by engine_prepare_join() to an additional
+ * stream. Only engines that support ENGINE_JOIN_PARALLEL take part,
+ * the rest of the read view is fed by engine_join().
+ */
+int
+engine_join_parallel(struct engine_join_ctx *ctx, struct xstream *stream);
+
 void
 engine_complete_join(struct engine_join_ctx *ctx);
 
@@ -517,6 +533,13 @@ engine_join_xc(struct engine_join_ctx *ctx, struct xstream *stream)
 		diag_raise();
 }
 
+static inline void
+engine_join_parallel_xc(struct engine_join_ctx *ctx, struct xstream *stream)
+{
+	if (engine_join_parallel(ctx, stream) != 0)
+		diag_raise();
+}
+
 #endif /* defined(__cplusplus) */
 
 #endif /* TARANTOOL_BOX_ENGINE_H_INCLUDED */
@@ -120,6 +120,11 @@ const char *on_conflict_action_strs[] = {
 	/* [ON_CONFLICT_ACTION_DEFAULT]  = */ "default"
 };
 
+const char *compression_type_strs[] = {
+	/* [COMPRESSION_TYPE_NONE] = */ "none",
+	/* [COMPRESSION_TYPE_ZSTD] = */ "zstd",
+};
+
 static int64_t
 field_type_by_name_wrapper(const char *str, uint32_t len)
 {
@@ -165,6 +170,8 @@ const struct opt_def field_def_reg[] = {
 		     nullable_action, NULL),
 	OPT_DEF("collation", OPT_UINT32, struct field_def, coll_id),
 	OPT_DEF("default", OPT_STRPTR, struct field_def, default_value),
+	OPT_DEF_ENUM("compression", compression_type, struct field_def,
+		     compression, NULL),
 	OPT_END,
 };
 
@@ -175,7 +182,8 @@ const struct field_def field_def_default = {
 	.nullable_action = ON_CONFLICT_ACTION_DEFAULT,
 	.coll_id = COLL_NONE,
 	.default_value = NULL,
-	.default_value_expr = NULL
+	.default_value_expr = NULL,
+	.compression = COMPRESSION_TYPE_NONE,
 };
 
 enum field_type
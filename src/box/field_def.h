@@ -80,6 +80,15 @@ enum on_conflict_action {
 
 /** \endcond public */
 
+/** Compression of a field value stored in a tuple. */
+enum compression_type {
+	COMPRESSION_TYPE_NONE = 0,
+	COMPRESSION_TYPE_ZSTD,
+	compression_type_MAX
+};
+
+extern const char *compression_type_strs[];
+
 enum {
 	/**
 	 * This mask allows to store in VdbeOp.p5 operand of
@@ -145,6 +154,8 @@ struct field_def {
 	char *default_value;
 	/** AST for parsed default value. */
 	struct Expr *default_value_expr;
+	/** Compression of the field value in memtx tuples. */
+	enum compression_type compression;
 };
 
 /**
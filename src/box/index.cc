@@ -39,6 +39,7 @@
 #include "rmean.h"
 #include "info/info.h"
 #include "memtx_tx.h"
+#include "mp_decimal.h"
 
 /* {{{ Utilities. **********************************************/
 
@@ -437,6 +438,197 @@ box_index_compact(uint32_t space_id, uint32_t index_id)
 	return 0;
 }
 
+/** Set a decimal overflow error for an aggregated field. */
+static void
+index_aggregate_overflow(uint32_t fieldno)
+{
+	diag_set(ClientError, ER_UPDATE_DECIMAL_OVERFLOW, '+',
+		 int2str(fieldno + TUPLE_INDEX_BASE));
+}
+
+/**
+ * Switch an aggregate to decimal arithmetics, converting the values
+ * accounted so far.
+ */
+static int
+index_aggregate_make_decimal(struct index_aggregate *agg, uint32_t fieldno)
+{
+	assert(!agg->is_decimal);
+	agg->is_decimal = true;
+	if (agg->count == 0) {
+		decimal_zero(&agg->dec_sum);
+		return 0;
+	}
+	if (agg->is_int) {
+		decimal_from_int64(&agg->dec_sum, agg->int_sum);
+		decimal_from_int64(&agg->dec_min, agg->int_min);
+		decimal_from_int64(&agg->dec_max, agg->int_max);
+		return 0;
+	}
+	if (decimal_from_double(&agg->dec_sum, agg->sum) == NULL ||
+	    decimal_from_double(&agg->dec_min, agg->min) == NULL ||
+	    decimal_from_double(&agg->dec_max, agg->max) == NULL) {
+		index_aggregate_overflow(fieldno);
+		return -1;
+	}
+	return 0;
+}
+
+/** Account a decimal value in an aggregate. */
+static int
+index_aggregate_add_decimal(struct index_aggregate *agg, const decimal_t *dec,
+			    uint32_t fieldno)
+{
+	if (!agg->is_decimal && index_aggregate_make_decimal(agg, fieldno) != 0)
+		return -1;
+	if (decimal_add(&agg->dec_sum, &agg->dec_sum, dec) == NULL) {
+		index_aggregate_overflow(fieldno);
+		return -1;
+	}
+	if (agg->count == 0 || decimal_compare(dec, &agg->dec_min) < 0)
+		agg->dec_min = *dec;
+	if (agg->count == 0 || decimal_compare(dec, &agg->dec_max) > 0)
+		agg->dec_max = *dec;
+	agg->count++;
+	return 0;
+}
+
+/** Account a field value in an aggregate. */
+static int
+index_aggregate_add(struct index_aggregate *agg, const char *field,
+		    uint32_t fieldno)
+{
+	int64_t ival;
+	double dval;
+	decimal_t dec;
+	switch (mp_typeof(*field)) {
+	case MP_NIL:
+		return 0;
+	case MP_UINT: {
+		uint64_t uval = mp_decode_uint(&field);
+		if (agg->is_decimal) {
+			decimal_from_uint64(&dec, uval);
+			goto add_decimal;
+		}
+		if (uval > INT64_MAX) {
+			dval = uval;
+			goto add_double;
+		}
+		ival = uval;
+		break;
+	}
+	case MP_INT:
+		ival = mp_decode_int(&field);
+		break;
+	case MP_FLOAT:
+		dval = mp_decode_float(&field);
+		goto add_double;
+	case MP_DOUBLE:
+		dval = mp_decode_double(&field);
+		goto add_double;
+	case MP_EXT: {
+		const char *data = field;
+		if (mp_decode_decimal(&data, &dec) != NULL)
+			goto add_decimal;
+		FALLTHROUGH;
+	}
+	default:
+		diag_set(ClientError, ER_FIELD_TYPE,
+			 int2str(fieldno + TUPLE_INDEX_BASE),
+			 field_type_strs[FIELD_TYPE_NUMBER],
+			 mp_type_strs[mp_typeof(*field)]);
+		return -1;
+	}
+	if (agg->is_decimal) {
+		decimal_from_int64(&dec, ival);
+		goto add_decimal;
+	}
+	if (agg->is_int &&
+	    !(ival > 0 && agg->int_sum > INT64_MAX - ival) &&
+	    !(ival < 0 && agg->int_sum < INT64_MIN - ival)) {
+		agg->int_sum += ival;
+		agg->int_min = agg->count == 0 ? ival : MIN(agg->int_min, ival);
+		agg->int_max = agg->count == 0 ? ival : MAX(agg->int_max, ival);
+		agg->count++;
+		return 0;
+	}
+	dval = ival;
+add_double:
+	if (agg->is_decimal) {
+		if (decimal_from_double(&dec, dval) == NULL) {
+			index_aggregate_overflow(fieldno);
+			return -1;
+		}
+		goto add_decimal;
+	}
+	if (agg->is_int) {
+		/* Integer overflow or a non-integer value. */
+		agg->is_int = false;
+		agg->sum = agg->int_sum;
+		agg->min = agg->int_min;
+		agg->max = agg->int_max;
+	}
+	agg->sum += dval;
+	agg->min = agg->count == 0 ? dval : MIN(agg->min, dval);
+	agg->max = agg->count == 0 ? dval : MAX(agg->max, dval);
+	agg->count++;
+	return 0;
+add_decimal:
+	return index_aggregate_add_decimal(agg, &dec, fieldno);
+}
+
+int
+box_index_aggregate(uint32_t space_id, uint32_t index_id, int type,
+		    const char *key, const char *key_end, uint32_t fieldno,
+		    struct index_aggregate *result)
+{
+	assert(key != NULL && key_end != NULL);
+	mp_tuple_assert(key, key_end);
+	memset(result, 0, sizeof(*result));
+	result->is_int = true;
+	if (type < 0 || type >= iterator_type_MAX) {
+		diag_set(ClientError, ER_ILLEGAL_PARAMS,
+			 "Invalid iterator type");
+		return -1;
+	}
+	enum iterator_type itype = (enum iterator_type) type;
+	struct space *space;
+	struct index *index;
+	if (check_index(space_id, index_id, &space, &index) != 0)
+		return -1;
+	uint32_t part_count = mp_decode_array(&key);
+	if (key_validate(index->def, itype, key, part_count))
+		return -1;
+	/* Start transaction in the engine. */
+	struct txn *txn;
+	struct txn_ro_savepoint svp;
+	if (txn_begin_ro_stmt(space, &txn, &svp) != 0)
+		return -1;
+	struct iterator *it = index_create_iterator(index, itype,
+						    key, part_count);
+	if (it == NULL) {
+		txn_rollback_stmt(txn);
+		return -1;
+	}
+	int rc;
+	struct tuple *tuple;
+	while ((rc = iterator_next(it, &tuple)) == 0 && tuple != NULL) {
+		const char *field = tuple_field(tuple, fieldno);
+		if (field == NULL)
+			continue;
+		rc = index_aggregate_add(result, field, fieldno);
+		if (rc != 0)
+			break;
+	}
+	iterator_delete(it);
+	if (rc != 0) {
+		txn_rollback_stmt(txn);
+		return -1;
+	}
+	txn_commit_ro_stmt(txn, &svp);
+	return 0;
+}
+
 /* }}} */
 
 /* {{{ Internal API */
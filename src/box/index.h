@@ -34,6 +34,7 @@
 #include "trivia/util.h"
 #include "iterator_type.h"
 #include "index_def.h"
+#include "decimal.h"
 
 #if defined(__cplusplus)
 extern "C" {
@@ -236,6 +237,56 @@ box_index_stat(uint32_t space_id, uint32_t index_id,
 int
 box_index_compact(uint32_t space_id, uint32_t index_id);
 
+/** Result of an aggregate scan of an index, see box_index_aggregate(). */
+struct index_aggregate {
+	/** Number of tuples that have a number in the scanned field. */
+	uint64_t count;
+	/**
+	 * Set if all scanned values are integers and their sum fits
+	 * in int64_t. If set, int_sum, int_min and int_max hold the
+	 * result, otherwise sum, min and max do.
+	 */
+	bool is_int;
+	int64_t int_sum;
+	int64_t int_min;
+	int64_t int_max;
+	double sum;
+	double min;
+	double max;
+	/**
+	 * Set if some of the scanned values are decimals. If set,
+	 * dec_sum, dec_min and dec_max hold the result and the other
+	 * values are converted to decimals on accounting.
+	 */
+	bool is_decimal;
+	decimal_t dec_sum;
+	decimal_t dec_min;
+	decimal_t dec_max;
+};
+
+/**
+ * Compute count, sum, min and max of a numeric field over tuples
+ * matched by the provided key (index:aggregate()). The field is
+ * read directly from tuple data, without creating Lua objects.
+ * Tuples that don't have the field or have nil in it are skipped.
+ * If some of the values are decimals, all values are accounted as
+ * decimals.
+ *
+ * \param space_id space identifier
+ * \param index_id index identifier
+ * \param type iterator type - enum \link iterator_type \endlink
+ * \param key encoded key in MsgPack Array format ([part1, part2, ...]).
+ * \param key_end the end of encoded \a key.
+ * \param fieldno zero-based number of the field to aggregate.
+ * \param[out] result aggregate values.
+ * \retval -1 on error (check box_error_last())
+ * \retval 0 on success
+ */
+int
+box_index_aggregate(uint32_t space_id, uint32_t index_id, int type,
+		    const char *key, const char *key_end, uint32_t fieldno,
+		    struct index_aggregate *result);
+
 struct iterator {
 	/**
 	 * Iterate to the next tuple.
@@ -48,10 +48,14 @@ const struct index_opts index_opts_default = {
 	/* .run_count_per_level = */ 2,
 	/* .run_size_ratio      = */ 3.5,
 	/* .bloom_fpr           = */ 0.05,
+	/* .ttl                 = */ 0,
+	/* .ttl_field           = */ UINT32_MAX,
+	/* .blob_threshold      = */ 0,
 	/* .lsn                 = */ 0,
 	/* .stat                = */ NULL,
 	/* .func                = */ 0,
 	/* .hint                = */ true,
+	/* .wide_hint           = */ false,
 };
 
 const struct opt_def index_opts_reg[] = {
@@ -64,10 +68,15 @@ const struct opt_def index_opts_reg[] = {
 	OPT_DEF("run_count_per_level", OPT_INT64, struct index_opts, run_count_per_level),
 	OPT_DEF("run_size_ratio", OPT_FLOAT, struct index_opts, run_size_ratio),
 	OPT_DEF("bloom_fpr", OPT_FLOAT, struct index_opts, bloom_fpr),
+	OPT_DEF("ttl", OPT_FLOAT, struct index_opts, ttl),
+	OPT_DEF("ttl_field", OPT_UINT32, struct index_opts, ttl_field),
+	OPT_DEF("blob_threshold", OPT_UINT32, struct index_opts,
+		blob_threshold),
 	OPT_DEF("lsn", OPT_INT64, struct index_opts, lsn),
 	OPT_DEF("func", OPT_UINT32, struct index_opts, func_id),
 	OPT_DEF_LEGACY("sql"),
 	OPT_DEF("hint", OPT_BOOL, struct index_opts, hint),
+	OPT_DEF("wide_hint", OPT_BOOL, struct index_opts, wide_hint),
 	OPT_END,
 };
 
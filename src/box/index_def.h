@@ -153,6 +153,32 @@ struct index_opts {
 	double run_size_ratio;
 	/* Bloom filter false positive rate. */
 	double bloom_fpr;
+	/**
+	 * Vinyl statement time-to-live, in seconds. A tuple is
+	 * considered expired once the time stored in field ttl_field
+	 * plus ttl is less than or equal to the current time. Expired
+	 * tuples are hidden from readers and dropped by compaction.
+	 * An UPSERT is applied to an expired tuple as if there were
+	 * no tuple. 0 means that tuples never expire.
+	 *
+	 * Compaction doesn't generate DELETEs for secondary indexes
+	 * when it drops expired tuples so ttl may only be set for
+	 * the primary index of a space without secondary indexes.
+	 */
+	double ttl;
+	/**
+	 * Number of the field storing tuple time, see ttl. Must be
+	 * set if ttl is, UINT32_MAX if unset.
+	 */
+	uint32_t ttl_field;
+	/**
+	 * Vinyl key-value separation threshold, in bytes. String
+	 * and varbinary fields that are not indexed and are at
+	 * least this big are stored in separate blob files rather
+	 * than in run pages so that compaction doesn't rewrite
+	 * them. 0 disables key-value separation.
+	 */
+	uint32_t blob_threshold;
 	/**
 	 * LSN from the time of index creation.
 	 */
@@ -169,6 +195,14 @@ struct index_opts {
 	 * Use hint optimization for tree index.
 	 */
 	bool hint;
+	/**
+	 * Store an extended comparison hint along with the regular
+	 * one in each tree index entry, see tuple_hint_ext(). Takes
+	 * 8 more bytes per entry, but lets the index compare strings
+	 * with a long common prefix and composite keys with an equal
+	 * first part without looking into tuples.
+	 */
+	bool wide_hint;
 };
 
 extern const struct index_opts index_opts_default;
@@ -213,10 +247,18 @@ index_opts_cmp(const struct index_opts *o1, const struct index_opts *o2)
 		return o1->run_size_ratio < o2->run_size_ratio ? -1 : 1;
 	if (o1->bloom_fpr != o2->bloom_fpr)
 		return o1->bloom_fpr < o2->bloom_fpr ? -1 : 1;
+	if (o1->ttl != o2->ttl)
+		return o1->ttl < o2->ttl ? -1 : 1;
+	if (o1->ttl_field != o2->ttl_field)
+		return o1->ttl_field < o2->ttl_field ? -1 : 1;
+	if (o1->blob_threshold != o2->blob_threshold)
+		return o1->blob_threshold < o2->blob_threshold ? -1 : 1;
 	if (o1->func_id != o2->func_id)
 		return o1->func_id - o2->func_id;
 	if (o1->hint != o2->hint)
 		return o1->hint - o2->hint;
+	if (o1->wide_hint != o2->wide_hint)
+		return o1->wide_hint - o2->wide_hint;
 	return 0;
 }
 
@@ -152,6 +152,12 @@ const unsigned char iproto_key_type[IPROTO_KEY_MAX] =
 	/* 0x56 */	MP_DOUBLE, /* IPROTO_TIMEOUT */
 	/* 0x57 */	MP_STR, /* IPROTO_EVENT_KEY */
 	/* 0x58 */	MP_NIL, /* IPROTO_EVENT_DATA (can be any) */
+	/* 0x59 */	MP_ARRAY, /* IPROTO_SPACE_FILTER */
+	/* 0x5a */	MP_UINT, /* IPROTO_FILE_SIZE */
+	/* 0x5b */	MP_BOOL, /* IPROTO_CHECKPOINT_JOIN */
+	/* 0x5c */	MP_UINT, /* IPROTO_JOIN_STREAMS */
+	/* 0x5d */	MP_UINT, /* IPROTO_JOIN_ID */
+	/* 0x5e */	MP_DOUBLE, /* IPROTO_ECHO_TM */
 	/* }}} */
 };
 
@@ -288,6 +294,11 @@ const char *iproto_key_strs[IPROTO_KEY_MAX] = {
 	"timeout",          /* 0x56 */
 	"event key",        /* 0x57 */
 	"event data",       /* 0x58 */
+	"space filter",     /* 0x59 */
+	"file size",        /* 0x5a */
+	"checkpoint join",  /* 0x5b */
+	"join streams",     /* 0x5c */
+	"join id",          /* 0x5d */
 };
 
 const char *vy_page_info_key_strs[VY_PAGE_INFO_KEY_MAX] = {
@@ -310,6 +321,7 @@ const char *vy_run_info_key_strs[VY_RUN_INFO_KEY_MAX] = {
 	"bloom filter legacy",
 	"bloom filter",
 	"stmt stat",
+	"blobs",
 };
 
 const char *vy_row_index_key_strs[VY_ROW_INDEX_KEY_MAX] = {
@@ -148,6 +148,21 @@ enum iproto_key {
 	/** Key name and data sent to a remote watcher. */
 	IPROTO_EVENT_KEY = 0x57,
 	IPROTO_EVENT_DATA = 0x58,
+	/** Ids of spaces a replica subscribes to. */
+	IPROTO_SPACE_FILTER = 0x59,
+	/** Size of a raw file following the packet. */
+	IPROTO_FILE_SIZE = 0x5a,
+	/** Whether a replica can join from a checkpoint file. */
+	IPROTO_CHECKPOINT_JOIN = 0x5b,
+	/** Number of streams a replica joins over. */
+	IPROTO_JOIN_STREAMS = 0x5c,
+	/** Identifier of an initial join in progress. */
+	IPROTO_JOIN_ID = 0x5d,
+	/**
+	 * Timestamp of the latest heartbeat or row originated by the
+	 * master that a replica received, echoed back in acks.
+	 */
+	IPROTO_ECHO_TM = 0x5e,
 	/*
 	 * Be careful to not extend iproto_key values over 0x7f.
 	 * iproto_keys are encoded in msgpack as positive fixnum, which ends at
@@ -462,6 +477,8 @@ enum vy_run_info_key {
 	VY_RUN_INFO_BLOOM = 7,
 	/** Number of statements of each type (map). */
 	VY_RUN_INFO_STMT_STAT = 8,
+	/** Size of values stored in each blob file (map). */
+	VY_RUN_INFO_BLOBS = 9,
 	/** The last key in this enum + 1 */
 	VY_RUN_INFO_KEY_MAX
 };
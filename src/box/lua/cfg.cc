@@ -210,6 +210,17 @@ lbox_cfg_set_memtx_max_tuple_size(struct lua_State *L)
 	return 0;
 }
 
+static int
+lbox_cfg_set_memtx_defrag_ratio(struct lua_State *L)
+{
+	try {
+		box_set_memtx_defrag_ratio();
+	} catch (Exception *) {
+		luaT_error(L);
+	}
+	return 0;
+}
+
 static int
 lbox_cfg_set_vinyl_memory(struct lua_State *L)
 {
@@ -243,6 +254,17 @@ lbox_cfg_set_vinyl_cache(struct lua_State *L)
 	return 0;
 }
 
+static int
+lbox_cfg_set_vinyl_page_cache(struct lua_State *L)
+{
+	try {
+		box_set_vinyl_page_cache();
+	} catch (Exception *) {
+		luaT_error(L);
+	}
+	return 0;
+}
+
 static int
 lbox_cfg_set_vinyl_timeout(struct lua_State *L)
 {
@@ -298,6 +320,14 @@ lbox_cfg_set_election_timeout(struct lua_State *L)
 	return 0;
 }
 
+static int
+lbox_cfg_set_election_leader_lease(struct lua_State *L)
+{
+	(void)L;
+	box_set_election_leader_lease();
+	return 0;
+}
+
 static int
 lbox_cfg_set_replication_timeout(struct lua_State *L)
 {
@@ -388,6 +418,22 @@ lbox_cfg_set_replication_skip_conflict(struct lua_State *L)
 	return 0;
 }
 
+static int
+lbox_cfg_set_replication_parallel_apply(struct lua_State *L)
+{
+	if (box_set_replication_parallel_apply() != 0)
+		luaT_error(L);
+	return 0;
+}
+
+static int
+lbox_cfg_set_replication_apply_budget(struct lua_State *L)
+{
+	if (box_set_replication_apply_budget() != 0)
+		luaT_error(L);
+	return 0;
+}
+
 static int
 lbox_cfg_set_crash(struct lua_State *L)
 {
@@ -425,12 +471,16 @@ box_lua_cfg_init(struct lua_State *L)
 		{"cfg_set_read_only", lbox_cfg_set_read_only},
 		{"cfg_set_memtx_memory", lbox_cfg_set_memtx_memory},
 		{"cfg_set_memtx_max_tuple_size", lbox_cfg_set_memtx_max_tuple_size},
+		{"cfg_set_memtx_defrag_ratio", lbox_cfg_set_memtx_defrag_ratio},
 		{"cfg_set_vinyl_memory", lbox_cfg_set_vinyl_memory},
 		{"cfg_set_vinyl_max_tuple_size", lbox_cfg_set_vinyl_max_tuple_size},
 		{"cfg_set_vinyl_cache", lbox_cfg_set_vinyl_cache},
+		{"cfg_set_vinyl_page_cache", lbox_cfg_set_vinyl_page_cache},
 		{"cfg_set_vinyl_timeout", lbox_cfg_set_vinyl_timeout},
 		{"cfg_set_election_mode", lbox_cfg_set_election_mode},
 		{"cfg_set_election_timeout", lbox_cfg_set_election_timeout},
+		{"cfg_set_election_leader_lease",
+			lbox_cfg_set_election_leader_lease},
 		{"cfg_set_replication_timeout", lbox_cfg_set_replication_timeout},
 		{"cfg_set_replication_connect_quorum", lbox_cfg_set_replication_connect_quorum},
 		{"cfg_set_replication_connect_timeout", lbox_cfg_set_replication_connect_timeout},
@@ -439,6 +489,8 @@ box_lua_cfg_init(struct lua_State *L)
 		{"cfg_set_replication_synchro_timeout", lbox_cfg_set_replication_synchro_timeout},
 		{"cfg_set_replication_sync_timeout", lbox_cfg_set_replication_sync_timeout},
 		{"cfg_set_replication_skip_conflict", lbox_cfg_set_replication_skip_conflict},
+		{"cfg_set_replication_parallel_apply", lbox_cfg_set_replication_parallel_apply},
+		{"cfg_set_replication_apply_budget", lbox_cfg_set_replication_apply_budget},
 		{"cfg_set_replication_anon", lbox_cfg_set_replication_anon},
 		{"cfg_set_net_msg_max", lbox_cfg_set_net_msg_max},
 		{"cfg_set_sql_cache_size", lbox_set_prepared_stmt_cache_size},
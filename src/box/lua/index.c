@@ -31,6 +31,7 @@
 #include "box/lua/index.h"
 #include "lua/utils.h"
 #include "lua/info.h"
+#include "lua/decimal.h"
 #include "info/info.h"
 #include "box/box.h"
 #include "box/index.h"
@@ -226,6 +227,56 @@ lbox_index_count(lua_State *L)
 	return 1;
 }
 
+static int
+lbox_index_aggregate(lua_State *L)
+{
+	if (lua_gettop(L) != 5 || !lua_isnumber(L, 1) || !lua_isnumber(L, 2) ||
+	    !lua_isnumber(L, 3) || !lua_isnumber(L, 5)) {
+		return luaL_error(L, "usage index.aggregate(space_id, "
+				  "index_id, iterator, key, fieldno)");
+	}
+
+	uint32_t space_id = lua_tonumber(L, 1);
+	uint32_t index_id = lua_tonumber(L, 2);
+	uint32_t iterator = lua_tonumber(L, 3);
+	size_t key_len;
+	const char *key = lbox_encode_tuple_on_gc(L, 4, &key_len);
+	uint32_t fieldno = lua_tonumber(L, 5);
+
+	struct index_aggregate agg;
+	if (box_index_aggregate(space_id, index_id, iterator, key,
+				key + key_len, fieldno, &agg) != 0)
+		return luaT_error(L);
+	lua_newtable(L);
+	luaL_pushuint64(L, agg.count);
+	lua_setfield(L, -2, "count");
+	if (agg.count == 0)
+		return 1;
+	if (agg.is_decimal) {
+		*lua_pushdecimal(L) = agg.dec_sum;
+		lua_setfield(L, -2, "sum");
+		*lua_pushdecimal(L) = agg.dec_min;
+		lua_setfield(L, -2, "min");
+		*lua_pushdecimal(L) = agg.dec_max;
+		lua_setfield(L, -2, "max");
+	} else if (agg.is_int) {
+		luaL_pushint64(L, agg.int_sum);
+		lua_setfield(L, -2, "sum");
+		luaL_pushint64(L, agg.int_min);
+		lua_setfield(L, -2, "min");
+		luaL_pushint64(L, agg.int_max);
+		lua_setfield(L, -2, "max");
+	} else {
+		lua_pushnumber(L, agg.sum);
+		lua_setfield(L, -2, "sum");
+		lua_pushnumber(L, agg.min);
+		lua_setfield(L, -2, "min");
+		lua_pushnumber(L, agg.max);
+		lua_setfield(L, -2, "max");
+	}
+	return 1;
+}
+
 static void
 box_index_init_iterator_types(struct lua_State *L, int idx)
 {
@@ -360,6 +411,7 @@ box_lua_index_init(struct lua_State *L)
 		{"min", lbox_index_min},
 		{"max", lbox_index_max},
 		{"count", lbox_index_count},
+		{"aggregate", lbox_index_aggregate},
 		{"iterator", lbox_index_iterator},
 		{"iterator_next", lbox_iterator_next},
 		{"truncate", lbox_truncate},
@@ -55,6 +55,10 @@
 #include "lua/serializer.h" /* luaL_setmaphint */
 #include "fiber.h"
 #include "sio.h"
+#include "tt_static.h"
+#include "histogram.h"
+#include "latency.h"
+#include "rmean.h"
 
 static void
 lbox_pushvclock(struct lua_State *L, const struct vclock *vclock)
@@ -70,6 +74,44 @@ lbox_pushvclock(struct lua_State *L, const struct vclock *vclock)
 	luaL_setmaphint(L, -1); /* compact flow */
 }
 
+/** Percentiles reported for histograms. */
+static const int lbox_info_pcts[] = {50, 75, 90, 95, 99};
+
+static void
+lbox_info_latency(struct lua_State *L, struct latency *latency)
+{
+	lua_createtable(L, 0, lengthof(lbox_info_pcts));
+	for (size_t i = 0; i < lengthof(lbox_info_pcts); i++) {
+		int pct = lbox_info_pcts[i];
+		lua_pushnumber(L, latency_get(latency, pct));
+		lua_setfield(L, -2, tt_sprintf("p%d", pct));
+	}
+}
+
+static void
+lbox_info_histogram(struct lua_State *L, struct histogram *hist)
+{
+	lua_createtable(L, 0, lengthof(lbox_info_pcts));
+	for (size_t i = 0; i < lengthof(lbox_info_pcts); i++) {
+		int pct = lbox_info_pcts[i];
+		luaL_pushint64(L, histogram_percentile(hist, pct));
+		lua_setfield(L, -2, tt_sprintf("p%d", pct));
+	}
+}
+
+static int
+lbox_info_rmean_item(const char *name, int rps, int64_t total, void *cb_ctx)
+{
+	struct lua_State *L = (struct lua_State *)cb_ctx;
+	lua_createtable(L, 0, 2);
+	lua_pushnumber(L, rps);
+	lua_setfield(L, -2, "rps");
+	lua_pushnumber(L, total);
+	lua_setfield(L, -2, "total");
+	lua_setfield(L, -2, name);
+	return 0;
+}
+
 static inline void
 lbox_push_replication_error_message(struct lua_State *L, struct error *e,
 				    int idx)
@@ -121,6 +163,20 @@ lbox_pushapplier(lua_State *L, struct applier *applier)
 		lua_pushlstring(L, name, total);
 		lua_settable(L, -3);
 
+		lua_createtable(L, 0, 7);
+		lbox_info_latency(L, &applier->lag_latency);
+		lua_setfield(L, -2, "lag");
+		lbox_info_latency(L, &applier->apply_latency);
+		lua_setfield(L, -2, "apply_lag");
+		lbox_info_histogram(L, applier->queue_depth);
+		lua_setfield(L, -2, "queue");
+		rmean_foreach(applier->rmean, lbox_info_rmean_item, L);
+		lua_pushnumber(L, applier->apply_time);
+		lua_setfield(L, -2, "apply_time");
+		lua_pushnumber(L, applier->apply_yield_count);
+		lua_setfield(L, -2, "apply_yields");
+		lua_setfield(L, -2, "stat");
+
 		struct error *e = diag_last_error(&applier->reader->diag);
 		if (e != NULL)
 			lbox_push_replication_error_message(L, e, -1);
@@ -147,6 +203,11 @@ lbox_pushrelay(lua_State *L, struct relay *relay)
 		lua_pushstring(L, "lag");
 		lua_pushnumber(L, relay_txn_lag(relay));
 		lua_settable(L, -3);
+		lua_createtable(L, 0, 3);
+		lbox_info_latency(L, relay_lag_latency(relay));
+		lua_setfield(L, -2, "lag");
+		rmean_foreach(relay_rmean(relay), lbox_info_rmean_item, L);
+		lua_setfield(L, -2, "stat");
 		break;
 	case RELAY_STOPPED:
 	{
@@ -614,7 +675,7 @@ static int
 lbox_info_election(struct lua_State *L)
 {
 	struct raft *raft = box_raft();
-	lua_createtable(L, 0, 4);
+	lua_createtable(L, 0, 5);
 	lua_pushstring(L, raft_state_str(raft->state));
 	lua_setfield(L, -2, "state");
 	luaL_pushuint64(L, raft->volatile_term);
@@ -623,6 +684,8 @@ lbox_info_election(struct lua_State *L)
 	lua_setfield(L, -2, "vote");
 	lua_pushinteger(L, raft->leader);
 	lua_setfield(L, -2, "leader");
+	lua_pushboolean(L, raft_has_lease(raft));
+	lua_setfield(L, -2, "lease");
 	return 1;
 }
 
@@ -642,6 +705,14 @@ lbox_info_synchro(struct lua_State *L)
 	lua_setfield(L, -2, "len");
 	lua_pushnumber(L, queue->owner_id);
 	lua_setfield(L, -2, "owner");
+	lbox_info_latency(L, &queue->commit_latency);
+	lua_setfield(L, -2, "latency");
+	lua_createtable(L, 0, 2);
+	lua_pushnumber(L, queue->confirm_count);
+	lua_setfield(L, -2, "count");
+	lbox_info_latency(L, &queue->confirm_latency);
+	lua_setfield(L, -2, "latency");
+	lua_setfield(L, -2, "confirm");
 	lua_setfield(L, -2, "queue");
 
 	return 1;
@@ -44,6 +44,8 @@
 #include "box/txn.h"
 #include "box/func.h"
 #include "box/mp_error.h"
+#include "box/tuple_compression.h"
+#include "fiber.h"
 
 #include "box/lua/error.h"
 #include "box/lua/tuple.h"
@@ -422,7 +424,8 @@ luamp_encode_extension_box(struct lua_State *L, int idx,
 }
 
 /**
- * A MsgPack extensions handler that supports errors decode.
+ * A MsgPack extensions handler that supports errors and compressed
+ * tuple fields decode.
  */
 static void
 luamp_decode_extension_box(struct lua_State *L, const char **data)
@@ -431,6 +434,24 @@ luamp_decode_extension_box(struct lua_State *L, const char **data)
 	int8_t ext_type;
 	uint32_t len = mp_decode_extl(data, &ext_type);
 
+	if (ext_type == MP_COMPRESSION) {
+		/*
+		 * The value may be stored in a field of type 'any'
+		 * by the user, so don't trust it: compression_unpack()
+		 * limits its size and checks the decompressed MsgPack.
+		 */
+		struct region *region = &fiber()->gc;
+		size_t region_svp = region_used(region);
+		const char *value = compression_unpack(data, len, region);
+		if (value == NULL) {
+			region_truncate(region, region_svp);
+			luaT_error(L);
+			return;
+		}
+		luamp_decode(L, luaL_msgpack_default, &value);
+		region_truncate(region, region_svp);
+		return;
+	}
 	if (ext_type != MP_ERROR) {
 		luaL_error(L, "Unsupported MsgPack extension type: %d",
 			   ext_type);
@@ -46,6 +46,9 @@ local default_cfg = {
     slab_alloc_factor   = 1.05,
     iproto_threads      = 1,
     memtx_allocator     = "small",
+    memtx_use_huge_pages = false,
+    memtx_numa_node     = -1,
+    memtx_defrag_ratio  = 0,
     work_dir            = nil,
     memtx_dir           = ".",
     wal_dir             = ".",
@@ -53,6 +56,8 @@ local default_cfg = {
     vinyl_dir           = '.',
     vinyl_memory        = 128 * 1024 * 1024,
     vinyl_cache         = 128 * 1024 * 1024,
+    vinyl_page_cache    = 0,
+    vinyl_direct_io     = false,
     vinyl_max_tuple_size = 1024 * 1024,
     vinyl_read_threads  = 1,
     vinyl_write_threads = 4,
@@ -78,6 +83,7 @@ local default_cfg = {
     wal_max_size        = 256 * 1024 * 1024,
     wal_dir_rescan_delay= 2,
     wal_queue_max_size  = 16 * 1024 * 1024,
+    wal_ring_size       = 16 * 1024 * 1024,
     wal_cleanup_delay   = 4 * 3600,
     force_recovery      = false,
     replication         = nil,
@@ -96,6 +102,7 @@ local default_cfg = {
     checkpoint_count    = 2,
     worker_pool_threads = 4,
     election_mode       = 'off',
+    election_leader_lease = false,
     election_timeout    = 5,
     replication_timeout = 1,
     replication_sync_lag = 10,
@@ -107,6 +114,11 @@ local default_cfg = {
     replication_skip_conflict = false,
     replication_anon      = false,
     replication_threads   = 1,
+    replication_parallel_apply = 1,
+    replication_apply_budget = 0,
+    replication_join_from_checkpoint = false,
+    replication_join_streams = 1,
+    replication_space_filter = nil, -- all spaces
     feedback_enabled      = true,
     feedback_crashinfo    = true,
     feedback_host         = "https://feedback.tarantool.io",
@@ -157,12 +169,17 @@ local template_cfg = {
     slab_alloc_factor   = 'number',
     iproto_threads      = 'number',
     memtx_allocator     = 'string',
+    memtx_use_huge_pages = 'boolean',
+    memtx_numa_node     = 'number',
+    memtx_defrag_ratio  = 'number',
     work_dir            = 'string',
     memtx_dir            = 'string',
     wal_dir             = 'string',
     vinyl_dir           = 'string',
     vinyl_memory        = 'number',
     vinyl_cache               = 'number',
+    vinyl_page_cache          = 'number',
+    vinyl_direct_io           = 'boolean',
     vinyl_max_tuple_size      = 'number',
     vinyl_read_threads        = 'number',
     vinyl_write_threads       = 'number',
@@ -201,12 +218,14 @@ local template_cfg = {
     checkpoint_interval = 'number',
     checkpoint_wal_threshold = 'number',
     wal_queue_max_size  = 'number',
+    wal_ring_size       = 'number',
     checkpoint_count    = 'number',
     read_only           = 'boolean',
     hot_standby         = 'boolean',
     memtx_use_mvcc_engine = 'boolean',
     worker_pool_threads = 'number',
     election_mode       = 'string',
+    election_leader_lease = 'boolean',
     election_timeout    = 'number',
     replication_timeout = 'number',
     replication_sync_lag = 'number',
@@ -218,6 +237,11 @@ local template_cfg = {
     replication_skip_conflict = 'boolean',
     replication_anon      = 'boolean',
     replication_threads   = 'number',
+    replication_parallel_apply = 'number',
+    replication_apply_budget = 'number',
+    replication_join_from_checkpoint = 'boolean',
+    replication_join_streams = 'number',
+    replication_space_filter = 'number, table',
     feedback_enabled      = ifdef_feedback('boolean'),
     feedback_crashinfo    = ifdef_feedback('boolean'),
     feedback_host         = ifdef_feedback('string'),
@@ -297,9 +321,11 @@ local dynamic_cfg = {
     read_only               = private.cfg_set_read_only,
     memtx_memory            = private.cfg_set_memtx_memory,
     memtx_max_tuple_size    = private.cfg_set_memtx_max_tuple_size,
+    memtx_defrag_ratio      = private.cfg_set_memtx_defrag_ratio,
     vinyl_memory            = private.cfg_set_vinyl_memory,
     vinyl_max_tuple_size    = private.cfg_set_vinyl_max_tuple_size,
     vinyl_cache             = private.cfg_set_vinyl_cache,
+    vinyl_page_cache        = private.cfg_set_vinyl_page_cache,
     vinyl_timeout           = private.cfg_set_vinyl_timeout,
     checkpoint_count        = private.cfg_set_checkpoint_count,
     checkpoint_interval     = private.cfg_set_checkpoint_interval,
@@ -319,6 +345,7 @@ local dynamic_cfg = {
     force_recovery          = function() end,
     election_mode           = private.cfg_set_election_mode,
     election_timeout        = private.cfg_set_election_timeout,
+    election_leader_lease   = private.cfg_set_election_leader_lease,
     replication_timeout     = private.cfg_set_replication_timeout,
     replication_connect_timeout = private.cfg_set_replication_connect_timeout,
     replication_connect_quorum = private.cfg_set_replication_connect_quorum,
@@ -327,6 +354,8 @@ local dynamic_cfg = {
     replication_synchro_quorum = private.cfg_set_replication_synchro_quorum,
     replication_synchro_timeout = private.cfg_set_replication_synchro_timeout,
     replication_skip_conflict = private.cfg_set_replication_skip_conflict,
+    replication_parallel_apply = private.cfg_set_replication_parallel_apply,
+    replication_apply_budget = private.cfg_set_replication_apply_budget,
     replication_anon        = private.cfg_set_replication_anon,
     instance_uuid           = check_instance_uuid,
     replicaset_uuid         = check_replicaset_uuid,
@@ -409,10 +438,12 @@ local dynamic_cfg_skip_at_load = {
     vinyl_memory            = true,
     vinyl_max_tuple_size    = true,
     vinyl_cache             = true,
+    vinyl_page_cache        = true,
     vinyl_timeout           = true,
     too_long_threshold      = true,
     election_mode           = true,
     election_timeout        = true,
+    election_leader_lease   = true,
     replication             = true,
     replication_timeout     = true,
     replication_connect_timeout = true,
@@ -422,6 +453,8 @@ local dynamic_cfg_skip_at_load = {
     replication_synchro_quorum = true,
     replication_synchro_timeout = true,
     replication_skip_conflict = true,
+    replication_parallel_apply = true,
+    replication_apply_budget = true,
     replication_anon        = true,
     wal_dir_rescan_delay    = true,
     custom_proc_title       = true,
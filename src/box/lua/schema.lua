@@ -109,6 +109,9 @@ ffi.cdef[[
                const char *key, const char *key_end,
                struct port *port);
 
+    int
+    box_wait_linearizable_read(void);
+
     void password_prepare(const char *password, int len,
                           char *out, int out_len);
 
@@ -443,6 +446,7 @@ box.schema.space.create = function(name, options)
         is_local = 'boolean',
         temporary = 'boolean',
         is_sync = 'boolean',
+        compact_field_map = 'boolean',
     }
     local options_defaults = {
         engine = 'memtx',
@@ -487,7 +491,8 @@ box.schema.space.create = function(name, options)
     local space_options = setmap({
         group_id = options.is_local and 1 or nil,
         temporary = options.temporary and true or nil,
-        is_sync = options.is_sync
+        is_sync = options.is_sync,
+        compact_field_map = options.compact_field_map and true or nil,
     })
     _space:insert{id, uid, name, options.engine, options.field_count,
         space_options, format}
@@ -580,6 +585,7 @@ local alter_space_template = {
     format = 'table',
     temporary = 'boolean',
     is_sync = 'boolean',
+    compact_field_map = 'boolean',
     name = 'string',
 }
 
@@ -616,6 +622,10 @@ box.schema.space.alter = function(space_id, options)
         flags.is_sync = options.is_sync
     end
 
+    if options.compact_field_map ~= nil then
+        flags.compact_field_map = options.compact_field_map
+    end
+
     local format
     if options.format ~= nil then
         format = update_format(options.format)
@@ -1085,8 +1095,12 @@ local index_options = {
     range_size = 'number',
     page_size = 'number',
     bloom_fpr = 'number',
+    ttl = 'number',
+    ttl_field = 'number, string',
+    blob_threshold = 'number',
     func = 'number, string',
     hint = 'boolean',
+    wide_hint = 'boolean',
 }
 
 local function jsonpaths_from_idx_parts(parts)
@@ -1133,6 +1147,18 @@ end
 local create_index_template = table.deepcopy(alter_index_template)
 create_index_template.if_not_exists = "boolean"
 
+-- Convert the ttl_field index option, which can be given as
+-- a field number or name, to a zero-based field number.
+local function ttl_field_resolve(format, ttl_field)
+    local idx, path = format_field_resolve(format, ttl_field,
+                                           "options.ttl_field")
+    if path ~= nil then
+        box.error(box.error.ILLEGAL_PARAMS,
+                  "options.ttl_field: JSON path is not supported")
+    end
+    return idx
+end
+
 -- Find a function id by given function name
 local function func_id_by_name(func_name)
     local func = box.space._func.index.name:get(func_name)
@@ -1194,6 +1220,19 @@ box.schema.index.create = function(space_id, name, options)
         box.error(box.error.MODIFY_INDEX, name, space.name,
                 "functional index can't use hints")
     end
+    if options.wide_hint and
+            (options.type ~= 'tree' or box.space[space_id].engine ~= 'memtx') then
+        box.error(box.error.MODIFY_INDEX, name, space.name,
+                "wide_hint is only reasonable with memtx tree index")
+    end
+    if options.wide_hint and options.func then
+        box.error(box.error.MODIFY_INDEX, name, space.name,
+                "functional index can't use hints")
+    end
+    if options.wide_hint and options.hint == false then
+        box.error(box.error.MODIFY_INDEX, name, space.name,
+                "wide_hint requires hint")
+    end
 
     local _index = box.space[box.schema.INDEX_ID]
     local _vindex = box.space[box.schema.VINDEX_ID]
@@ -1232,9 +1271,16 @@ box.schema.index.create = function(space_id, name, options)
             run_count_per_level = options.run_count_per_level,
             run_size_ratio = options.run_size_ratio,
             bloom_fpr = options.bloom_fpr,
+            ttl = options.ttl,
+            ttl_field = options.ttl_field,
+            blob_threshold = options.blob_threshold,
             func = options.func,
             hint = options.hint,
+            wide_hint = options.wide_hint,
     }
+    if index_opts.ttl_field ~= nil then
+        index_opts.ttl_field = ttl_field_resolve(format, index_opts.ttl_field)
+    end
     local field_type_aliases = {
         num = 'unsigned'; -- Deprecated since 1.7.2
         uint = 'unsigned';
@@ -1254,7 +1300,7 @@ box.schema.index.create = function(space_id, name, options)
     if parts_can_be_simplified then
         parts = simplify_index_parts(parts)
     end
-    if options.hint and is_multikey_index(parts) then
+    if (options.hint or options.wide_hint) and is_multikey_index(parts) then
         box.error(box.error.MODIFY_INDEX, name, space.name,
                 "multikey index can't use hints")
     end
@@ -1380,6 +1426,9 @@ box.schema.index.alter = function(space_id, index_id, options)
             index_opts[k] = options[k]
         end
     end
+    if options.ttl_field ~= nil then
+        index_opts.ttl_field = ttl_field_resolve(format, options.ttl_field)
+    end
     if options.hint and
        (options.type ~= 'tree' or box.space[space_id].engine ~= 'memtx') then
         box.error(box.error.MODIFY_INDEX, space.index[index_id].name,
@@ -1391,6 +1440,17 @@ box.schema.index.alter = function(space_id, index_id, options)
                                           space.name,
                 "functional index can't use hints")
     end
+    if options.wide_hint and
+       (options.type ~= 'tree' or box.space[space_id].engine ~= 'memtx') then
+        box.error(box.error.MODIFY_INDEX, space.index[index_id].name,
+                                          space.name,
+            "wide_hint is only reasonable with memtx tree index")
+    end
+    if index_opts.wide_hint and index_opts.hint == false then
+        box.error(box.error.MODIFY_INDEX, space.index[index_id].name,
+                                          space.name,
+                "wide_hint requires hint")
+    end
     if options.parts then
         local parts_can_be_simplified
         parts, parts_can_be_simplified =
@@ -1400,7 +1460,7 @@ box.schema.index.alter = function(space_id, index_id, options)
             parts = simplify_index_parts(parts)
         end
     end
-    if options.hint and is_multikey_index(parts) then
+    if (options.hint or options.wide_hint) and is_multikey_index(parts) then
         box.error(box.error.MODIFY_INDEX, space.index[index_id].name,
                                           space.name,
                 "multikey index can't use hints")
@@ -1930,6 +1990,33 @@ base_index_mt.count_luac = function(index, key, opts)
     return internal.count(index.space_id, index.id, itype, key);
 end
 
+-- count, sum, min and max of a numeric field in an index subtree
+base_index_mt.aggregate = function(index, field, key, opts)
+    check_index_arg(index, 'aggregate')
+    local fieldno = field
+    if type(field) == 'string' then
+        local space = box.space[index.space_id]
+        fieldno = nil
+        for i, f in ipairs(space:format()) do
+            if f.name == field then
+                fieldno = i
+                break
+            end
+        end
+        if fieldno == nil then
+            box.error(box.error.NO_SUCH_FIELD_NAME_IN_SPACE, field,
+                      space.name)
+        end
+    elseif type(field) ~= 'number' or field < 1 then
+        box.error(box.error.ILLEGAL_PARAMS,
+                  "Usage: index:aggregate(field, key, opts)")
+    end
+    key = keify(key)
+    local itype = check_iterator_type(opts, #key == 0);
+    return internal.aggregate(index.space_id, index.id, itype, key,
+                              fieldno - 1)
+end
+
 base_index_mt.get_ffi = function(index, key)
     check_index_arg(index, 'get')
     local ibuf = cord_ibuf_take()
@@ -1966,8 +2053,18 @@ local function check_select_opts(opts, key_is_nil)
     return iterator, offset, limit
 end
 
+-- Wait until a linearizable read is possible if it was requested.
+-- Must be called before taking the cord buffer, because it yields.
+local function check_select_linearizable(opts)
+    if opts ~= nil and opts.linearizable and
+       builtin.box_wait_linearizable_read() ~= 0 then
+        return box.error()
+    end
+end
+
 base_index_mt.select_ffi = function(index, key, opts)
     check_index_arg(index, 'select')
+    check_select_linearizable(opts)
     local ibuf = cord_ibuf_take()
     local key, key_end = tuple_encode(ibuf, key)
     local iterator, offset, limit = check_select_opts(opts, key + 1 >= key_end)
@@ -1992,6 +2089,7 @@ end
 
 base_index_mt.select_luac = function(index, key, opts)
     check_index_arg(index, 'select')
+    check_select_linearizable(opts)
     local key = keify(key)
     local iterator, offset, limit = check_select_opts(opts, #key == 0)
     return internal.select(index.space_id, index.id, iterator,
@@ -2059,6 +2157,14 @@ space_mt.count = function(space, key, opts)
     end
     return pk:count(key, opts)
 end
+space_mt.aggregate = function(space, field, key, opts)
+    check_space_arg(space, 'aggregate')
+    local pk = space.index[0]
+    if pk == nil then
+        return {count = 0} -- empty space without indexes
+    end
+    return pk:aggregate(field, key, opts)
+end
 space_mt.bsize = function(space)
     check_space_arg(space, 'bsize')
     local s = builtin.space_by_id(space.id)
@@ -231,6 +231,22 @@ lbox_slab_info(struct lua_State *L)
 	return 1;
 }
 
+/**
+ * How much of the arena is backed by huge pages. Not a part of
+ * box.slab.info(), because it's costly to calculate and yields.
+ */
+static int
+lbox_slab_huge_pages_size(struct lua_State *L)
+{
+	struct memtx_engine *memtx;
+	memtx = (struct memtx_engine *)engine_by_name("memtx");
+	ssize_t size = memtx_engine_huge_pages_size(memtx);
+	if (size < 0)
+		return 0;
+	luaL_pushuint64(L, size);
+	return 1;
+}
+
 static int
 lbox_runtime_info(struct lua_State *L)
 {
@@ -281,6 +297,10 @@ box_lua_slab_init(struct lua_State *L)
 	lua_pushcfunction(L, lbox_slab_check);
 	lua_settable(L, -3);
 
+	lua_pushstring(L, "huge_pages_size");
+	lua_pushcfunction(L, lbox_slab_huge_pages_size);
+	lua_settable(L, -3);
+
 	lua_settable(L, -3); /* box.slab */
 
 	lua_pushstring(L, "runtime");
@@ -349,6 +349,11 @@ lbox_fillspace(struct lua_State *L, struct space *space, int i)
 			lua_pushnil(L);
 			lua_setfield(L, -2, "hint");
 		}
+		if (index_opts->wide_hint)
+			lua_pushboolean(L, true);
+		else
+			lua_pushnil(L);
+		lua_setfield(L, -2, "wide_hint");
 
 		if (index_opts->func_id > 0) {
 			lua_pushstring(L, "func");
@@ -437,6 +442,18 @@ lbox_fillspace(struct lua_State *L, struct space *space, int i)
 			lua_pushnumber(L, index_opts->bloom_fpr);
 			lua_setfield(L, -2, "bloom_fpr");
 
+			if (index_opts->ttl > 0) {
+				lua_pushnumber(L, index_opts->ttl);
+				lua_setfield(L, -2, "ttl");
+				lua_pushnumber(L, index_opts->ttl_field +
+					       TUPLE_INDEX_BASE);
+				lua_setfield(L, -2, "ttl_field");
+			}
+			if (index_opts->blob_threshold > 0) {
+				lua_pushnumber(L, index_opts->blob_threshold);
+				lua_setfield(L, -2, "blob_threshold");
+			}
+
 			lua_settable(L, -3);
 		}
 		lua_setfield(L, -2, index_def->name);
@@ -42,6 +42,7 @@
 
 #include "box/tuple.h"
 #include "box/tuple_convert.h"
+#include "box/tuple_compression.h"
 #include "box/errcode.h"
 #include "json/json.h"
 #include "mpstream/mpstream.h"
@@ -465,9 +466,34 @@ luamp_encode_tuple(struct lua_State *L, struct luaL_serializer *cfg,
 void
 tuple_to_mpstream(struct tuple *tuple, struct mpstream *stream)
 {
-	size_t bsize = box_tuple_bsize(tuple);
+	if (likely(!tuple_format(tuple)->has_compressed_fields)) {
+		size_t bsize = box_tuple_bsize(tuple);
+		char *ptr = mpstream_reserve(stream, bsize);
+		box_tuple_to_buf(tuple, ptr, bsize);
+		mpstream_advance(stream, bsize);
+		return;
+	}
+	/*
+	 * The stream may be allocated on the fiber region so we
+	 * decompress the tuple on a separate one. Reserve memory
+	 * before creating it, because the stream raises a Lua
+	 * error on allocation failure.
+	 */
+	uint32_t bsize = tuple_bsize_decompressed(tuple);
 	char *ptr = mpstream_reserve(stream, bsize);
-	box_tuple_to_buf(tuple, ptr, bsize);
+	struct region region;
+	region_create(&region, &cord()->slabc);
+	uint32_t size;
+	const char *data = tuple_data_decompressed(tuple, &size, &region);
+	if (data != NULL) {
+		assert(size == bsize);
+		memcpy(ptr, data, size);
+	}
+	region_destroy(&region);
+	if (data == NULL) {
+		stream->error(stream->error_ctx);
+		return;
+	}
 	mpstream_advance(stream, bsize);
 }
 
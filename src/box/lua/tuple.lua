@@ -269,7 +269,11 @@ end
 -- Set encode hooks for msgpackffi
 local function tuple_to_msgpack(buf, tuple)
     assert(ffi.istype(tuple_t, tuple))
-    local bsize = builtin.box_tuple_bsize(tuple)
+    -- Compressed fields are decompressed so the size may exceed bsize.
+    local bsize = tonumber(builtin.box_tuple_to_buf(tuple, nil, 0))
+    if bsize < 0 then
+        return box.error()
+    end
     buf:reserve(bsize)
     builtin.box_tuple_to_buf(tuple, buf.wpos, bsize)
     buf.wpos = buf.wpos + bsize
@@ -31,6 +31,15 @@
 #include "memtx_engine.h"
 #include "memtx_space.h"
 
+#include <inttypes.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+#endif
+
 #include <small/quota.h>
 #include <small/small.h>
 #include <small/mempool.h>
@@ -38,7 +47,9 @@
 #include "fiber.h"
 #include "errinj.h"
 #include "coio_file.h"
+#include "coio_task.h"
 #include "tuple.h"
+#include "tuple_compression.h"
 #include "txn.h"
 #include "memtx_tx.h"
 #include "memtx_tree.h"
@@ -64,6 +75,17 @@ checkpoint_cancel(struct checkpoint *ckpt);
 static void
 replica_join_cancel(struct cord *replica_join_cord);
 
+struct memtx_join_ctx;
+
+/** A stream a read view is sent to from its own cord. */
+struct memtx_join_stream {
+	struct cord cord;
+	/** Link in memtx_engine::join_streams. */
+	struct rlist in_engine;
+	struct memtx_join_ctx *ctx;
+	struct xstream *stream;
+};
+
 enum {
 	OBJSIZE_MIN = 16,
 	SLAB_SIZE = 16 * 1024 * 1024,
@@ -130,8 +152,9 @@ memtx_engine_shutdown(struct engine *engine)
 	struct memtx_engine *memtx = (struct memtx_engine *)engine;
 	if (memtx->checkpoint != NULL)
 		checkpoint_cancel(memtx->checkpoint);
-	if (memtx->replica_join_cord != NULL)
-		replica_join_cancel(memtx->replica_join_cord);
+	struct memtx_join_stream *stream;
+	rlist_foreach_entry(stream, &memtx->join_streams, in_engine)
+		replica_join_cancel(&stream->cord);
 	mempool_destroy(&memtx->iterator_pool);
 	if (mempool_is_initialized(&memtx->rtree_iterator_pool))
 		mempool_destroy(&memtx->rtree_iterator_pool);
@@ -151,7 +174,8 @@ memtx_engine_shutdown(struct engine *engine)
 
 static int
 memtx_engine_recover_snapshot_row(struct memtx_engine *memtx,
-				  struct xrow_header *row, int *is_space_system);
+				  struct xrow_header *row, bool skip_local,
+				  int *is_space_system);
 
 int
 memtx_engine_recover_snapshot(struct memtx_engine *memtx,
@@ -162,7 +186,15 @@ memtx_engine_recover_snapshot(struct memtx_engine *memtx,
 	int64_t signature = vclock_sum(vclock);
 	const char *filename = xdir_format_filename(&memtx->snap_dir,
 						    signature, NONE);
+	return memtx_engine_recover_snapshot_file(memtx, filename, signature,
+						  false);
+}
 
+int
+memtx_engine_recover_snapshot_file(struct memtx_engine *memtx,
+				   const char *filename, int64_t signature,
+				   bool skip_local)
+{
 	say_info("recovering from `%s'", filename);
 	struct xlog_cursor cursor;
 	if (xlog_cursor_open(&cursor, filename) < 0)
@@ -178,7 +210,7 @@ memtx_engine_recover_snapshot(struct memtx_engine *memtx,
 	 */
 	while ((rc = xlog_cursor_next(&cursor, &row, force_recovery)) == 0) {
 		row.lsn = signature;
-		rc = memtx_engine_recover_snapshot_row(memtx, &row,
+		rc = memtx_engine_recover_snapshot_row(memtx, &row, skip_local,
 						       &is_space_system);
 		force_recovery = is_space_system == 0 ?
 				 memtx->force_recovery : false;
@@ -244,7 +276,8 @@ memtx_engine_recover_synchro(const struct xrow_header *row)
 
 static int
 memtx_engine_recover_snapshot_row(struct memtx_engine *memtx,
-				  struct xrow_header *row, int *is_space_system)
+				  struct xrow_header *row, bool skip_local,
+				  int *is_space_system)
 {
 	assert(row->bodycnt == 1); /* always 1 for read */
 	if (row->type != IPROTO_INSERT) {
@@ -269,6 +302,12 @@ memtx_engine_recover_snapshot_row(struct memtx_engine *memtx,
 		diag_set(ClientError, ER_CROSS_ENGINE_TRANSACTION);
 		return -1;
 	}
+	/*
+	 * Data of local spaces isn't replicated, so skip it if
+	 * the snapshot was received from a master.
+	 */
+	if (skip_local && space_group_id(space) == GROUP_LOCAL)
+		return 0;
 	struct txn *txn = txn_begin();
 	if (txn == NULL)
 		return -1;
@@ -507,7 +546,8 @@ memtx_engine_bootstrap(struct engine *engine)
 	int rc, is_space_system;
 	struct xrow_header row;
 	while ((rc = xlog_cursor_next(&cursor, &row, true)) == 0) {
-		rc = memtx_engine_recover_snapshot_row(memtx, &row, &is_space_system);
+		rc = memtx_engine_recover_snapshot_row(memtx, &row, false,
+						       &is_space_system);
 		if (rc < 0)
 			break;
 	}
@@ -905,7 +945,29 @@ struct memtx_join_entry {
 
 struct memtx_join_ctx {
 	struct rlist entries;
-	struct xstream *stream;
+	/**
+	 * Protects the entry iterators, which are shared by all
+	 * streams the read view is sent to.
+	 */
+	pthread_mutex_t mutex;
+	/** Entry to fetch tuples from, NULL when all are sent. */
+	struct memtx_join_entry *current;
+};
+
+enum {
+	/**
+	 * Max number of tuples a join stream fetches from the read
+	 * view at once. Streams fetch tuples in batches so that
+	 * a big space is split between all of them.
+	 */
+	MEMTX_JOIN_BATCH_SIZE = 512,
+};
+
+/** A tuple fetched from the read view by a join stream. */
+struct memtx_join_tuple {
+	uint32_t space_id;
+	uint32_t size;
+	const char *data;
 };
 
 static int
@@ -938,10 +1000,12 @@ memtx_join_add_space(struct space *space, void *arg)
 	return 0;
 }
 
+static void
+memtx_engine_complete_join(struct engine *engine, void *arg);
+
 static int
 memtx_engine_prepare_join(struct engine *engine, void **arg)
 {
-	(void)engine;
 	struct memtx_join_ctx *ctx =
 		(struct memtx_join_ctx *)malloc(sizeof(*ctx));
 	if (ctx == NULL) {
@@ -950,10 +1014,14 @@ memtx_engine_prepare_join(struct engine *engine, void **arg)
 		return -1;
 	}
 	rlist_create(&ctx->entries);
+	tt_pthread_mutex_init(&ctx->mutex, NULL);
 	if (space_foreach(memtx_join_add_space, ctx) != 0) {
-		free(ctx);
+		memtx_engine_complete_join(engine, ctx);
 		return -1;
 	}
+	ctx->current = rlist_empty(&ctx->entries) ? NULL :
+		rlist_first_entry(&ctx->entries, struct memtx_join_entry,
+				  in_ctx);
 	*arg = ctx;
 	return 0;
 }
@@ -978,45 +1046,79 @@ memtx_join_send_tuple(struct xstream *stream, uint32_t space_id,
 	return xstream_write(stream, &row);
 }
 
+/**
+ * Fetch the next batch of tuples from the read view.
+ * Returns the number of fetched tuples, 0 if all tuples
+ * have been sent, -1 on error.
+ */
 static int
-memtx_join_f(va_list ap)
+memtx_join_fetch(struct memtx_join_ctx *ctx, struct memtx_join_tuple *batch)
 {
-	struct memtx_join_ctx *ctx = va_arg(ap, struct memtx_join_ctx *);
-	struct memtx_join_entry *entry;
-	rlist_foreach_entry(entry, &ctx->entries, in_ctx) {
+	int count = 0;
+	tt_pthread_mutex_lock(&ctx->mutex);
+	while (ctx->current != NULL && count < MEMTX_JOIN_BATCH_SIZE) {
+		struct memtx_join_entry *entry = ctx->current;
 		struct snapshot_iterator *it = entry->iterator;
-		int rc;
-		uint32_t size;
-		const char *data;
-		while ((rc = it->next(it, &data, &size)) == 0 && data != NULL) {
-			if (memtx_join_send_tuple(ctx->stream, entry->space_id,
-						  data, size) != 0)
+		struct memtx_join_tuple *tuple = &batch[count];
+		if (it->next(it, &tuple->data, &tuple->size) != 0) {
+			/* Make the other streams stop, too. */
+			ctx->current = NULL;
+			count = -1;
+			break;
+		}
+		if (tuple->data != NULL) {
+			tuple->space_id = entry->space_id;
+			count++;
+		} else if (rlist_next(&entry->in_ctx) == &ctx->entries) {
+			ctx->current = NULL;
+		} else {
+			ctx->current = rlist_next_entry(entry, in_ctx);
+		}
+	}
+	tt_pthread_mutex_unlock(&ctx->mutex);
+	return count;
+}
+
+static int
+memtx_join_f(va_list ap)
+{
+	struct memtx_join_stream *stream =
+		va_arg(ap, struct memtx_join_stream *);
+	struct memtx_join_tuple batch[MEMTX_JOIN_BATCH_SIZE];
+	int count;
+	while ((count = memtx_join_fetch(stream->ctx, batch)) > 0) {
+		for (int i = 0; i < count; i++) {
+			if (memtx_join_send_tuple(stream->stream,
+						  batch[i].space_id,
+						  batch[i].data,
+						  batch[i].size) != 0)
 				return -1;
 		}
-		if (rc != 0)
-			return -1;
 	}
-	return 0;
+	return count;
 }
 
 static int
 memtx_engine_join(struct engine *engine, void *arg, struct xstream *stream)
 {
-	(void)engine;
+	struct memtx_engine *memtx = (struct memtx_engine *)engine;
 	struct memtx_join_ctx *ctx = (struct memtx_join_ctx *)arg;
-	ctx->stream = stream;
 	/*
 	 * Memtx snapshot iterators are safe to use from another
 	 * thread and so we do so as not to consume too much of
 	 * precious tx cpu time while a new replica is joining.
+	 * The read view may be sent to several streams at the
+	 * same time, each from its own thread.
 	 */
-	struct cord cord;
-	if (cord_costart(&cord, "initial_join", memtx_join_f, ctx) != 0)
+	struct memtx_join_stream join_stream;
+	join_stream.ctx = ctx;
+	join_stream.stream = stream;
+	if (cord_costart(&join_stream.cord, "initial_join", memtx_join_f,
+			 &join_stream) != 0)
 		return -1;
-	struct memtx_engine *memtx = (struct memtx_engine *)engine;
-	memtx->replica_join_cord = &cord;
-	int res = cord_cojoin(&cord);
-	memtx->replica_join_cord = NULL;
+	rlist_add_entry(&memtx->join_streams, &join_stream, in_engine);
+	int res = cord_cojoin(&join_stream.cord);
+	rlist_del_entry(&join_stream, in_engine);
 	xstream_reset(stream);
 	return res;
 }
@@ -1031,6 +1133,7 @@ memtx_engine_complete_join(struct engine *engine, void *arg)
 		entry->iterator->free(entry->iterator);
 		free(entry);
 	}
+	tt_pthread_mutex_destroy(&ctx->mutex);
 	free(ctx);
 }
 
@@ -1119,6 +1222,130 @@ memtx_engine_gc_f(va_list va)
 	return 0;
 }
 
+/** How often to check if defragmentation is needed, in seconds. */
+static const double MEMTX_DEFRAG_CHECK_INTERVAL = 60;
+/** Max number of tuples relocated without yielding. */
+static const uint32_t MEMTX_DEFRAG_BATCH_SIZE = 100;
+
+/**
+ * Check if the tuple memory is fragmented enough to be worth
+ * relocating tuples and if tuples can be relocated at all now.
+ */
+static bool
+memtx_engine_needs_defrag(struct memtx_engine *memtx)
+{
+	if (memtx->defrag_ratio == 0 || memtx->state != MEMTX_OK)
+		return false;
+	/*
+	 * Tuples may be accessed by a read view (checkpoint or
+	 * replica join) without being referenced.
+	 */
+	if (memtx->delayed_free_mode > 0)
+		return false;
+	struct allocator_stats stats;
+	memset(&stats, 0, sizeof(stats));
+	allocators_stats(&stats);
+	if (stats.small.total == 0)
+		return false;
+	return (double)stats.small.used / stats.small.total <
+	       memtx->defrag_ratio;
+}
+
+static int
+memtx_engine_collect_defrag_space(struct space *space, void *arg)
+{
+	struct region *region = (struct region *)arg;
+	if (!memtx_space_can_defrag(space))
+		return 0;
+	uint32_t *id = (uint32_t *)region_alloc(region, sizeof(*id));
+	if (id == NULL) {
+		diag_set(OutOfMemory, sizeof(*id), "region_alloc", "id");
+		return -1;
+	}
+	*id = space_id(space);
+	return 0;
+}
+
+/**
+ * Relocate tuples of all memtx spaces. The small allocator always
+ * takes memory from the lowest addressed slab that has free space
+ * so moving tuples makes data migrate towards the beginning of
+ * the arena, leaving slabs at higher addresses empty. Empty slabs
+ * are returned to the slab cache and the quota.
+ */
+static void
+memtx_engine_defrag(struct memtx_engine *memtx)
+{
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	/* Space ids are collected first, because the cache may change. */
+	if (space_foreach(memtx_engine_collect_defrag_space, region) != 0) {
+		diag_log();
+		region_truncate(region, region_svp);
+		return;
+	}
+	size_t size = region_used(region) - region_svp;
+	uint32_t *space_ids = (uint32_t *)region_join(region, size);
+	if (space_ids == NULL) {
+		diag_log();
+		region_truncate(region, region_svp);
+		return;
+	}
+	uint32_t space_count = size / sizeof(*space_ids);
+	say_info("memtx defragmentation started");
+	for (uint32_t i = 0; i < space_count; i++) {
+		struct space *space = space_by_id(space_ids[i]);
+		if (space == NULL)
+			continue;
+		struct index *pk = space_index(space, 0);
+		uint32_t version = schema_version;
+		char *key = NULL;
+		do {
+			if (fiber_is_cancelled() ||
+			    !memtx_engine_needs_defrag(memtx))
+				break;
+			/*
+			 * The key to resume from is meaningless if the
+			 * space was dropped or altered while we yielded.
+			 */
+			if (version != schema_version &&
+			    (space_by_id(space_ids[i]) != space ||
+			     space_index(space, 0) != pk))
+				break;
+			version = schema_version;
+			if (!memtx_space_can_defrag(space))
+				break;
+			if (memtx_space_defrag(space, &key,
+					       MEMTX_DEFRAG_BATCH_SIZE) != 0) {
+				diag_log();
+				break;
+			}
+			/*
+			 * Yield after each batch so as not to block
+			 * tx thread for too long.
+			 */
+			fiber_sleep(0);
+		} while (key != NULL);
+		free(key);
+	}
+	region_truncate(region, region_svp);
+	say_info("memtx defragmentation finished");
+}
+
+static int
+memtx_engine_defrag_f(va_list va)
+{
+	struct memtx_engine *memtx = va_arg(va, struct memtx_engine *);
+	while (!fiber_is_cancelled()) {
+		if (memtx_engine_needs_defrag(memtx))
+			memtx_engine_defrag(memtx);
+		fiber_yield_timeout(memtx->defrag_ratio > 0 ?
+				    MEMTX_DEFRAG_CHECK_INTERVAL :
+				    TIMEOUT_INFINITY);
+	}
+	return 0;
+}
+
 void
 memtx_set_tuple_format_vtab(const char *allocator_name)
 {
@@ -1133,11 +1360,99 @@ memtx_set_tuple_format_vtab(const char *allocator_name)
 	}
 }
 
+/**
+ * Advise the kernel to back the tuple arena with transparent huge
+ * pages and to allocate its memory on the given NUMA node (if it
+ * is not negative). The whole arena is mapped on creation while its
+ * pages are populated lazily, so the advice applies to all memory
+ * the arena is going to use. The memory policy is "preferred" rather
+ * than "bind" so that an allocation falls back to other nodes instead
+ * of failing when the node runs out of memory. Errors are logged and
+ * otherwise ignored.
+ */
+static void
+memtx_engine_set_arena_policy(struct memtx_engine *memtx,
+			      bool use_huge_pages, int numa_node)
+{
+	void *addr = memtx->arena.arena;
+	size_t size = memtx->arena.prealloc;
+	memtx->use_huge_pages = false;
+	if (use_huge_pages) {
+#if defined(MADV_HUGEPAGE)
+		if (madvise(addr, size, MADV_HUGEPAGE) == 0)
+			memtx->use_huge_pages = true;
+		else
+			say_syserror("madvise(MADV_HUGEPAGE)");
+#else
+		say_warn("huge pages are not supported on this platform");
+#endif
+	}
+	if (numa_node >= 0) {
+#if defined(__linux__) && defined(SYS_mbind)
+		unsigned long nodemask[MEMTX_NUMA_NODE_MAX / (CHAR_BIT *
+							sizeof(unsigned long))];
+		memset(nodemask, 0, sizeof(nodemask));
+		nodemask[numa_node / (CHAR_BIT * sizeof(unsigned long))] |=
+			1UL << (numa_node % (CHAR_BIT * sizeof(unsigned long)));
+		if (syscall(SYS_mbind, addr, size, MPOL_PREFERRED, nodemask,
+			    MEMTX_NUMA_NODE_MAX + 1, 0) != 0)
+			say_syserror("mbind");
+#else
+		say_warn("NUMA memory policy is not supported "
+			 "on this platform");
+#endif
+	}
+}
+
+/**
+ * Scan /proc/self/smaps for the arena mappings. Executed in a coio
+ * thread, because the file may be huge in a big process.
+ */
+static ssize_t
+memtx_engine_huge_pages_size_f(va_list ap)
+{
+	struct memtx_engine *memtx = va_arg(ap, struct memtx_engine *);
+#if defined(__linux__)
+	FILE *f = fopen("/proc/self/smaps", "r");
+	if (f == NULL)
+		return -1;
+	uintptr_t begin = (uintptr_t)memtx->arena.arena;
+	uintptr_t end = begin + memtx->arena.prealloc;
+	bool is_arena = false;
+	size_t size = 0;
+	char line[256];
+	while (fgets(line, sizeof(line), f) != NULL) {
+		uintptr_t map_begin, map_end;
+		unsigned long kb;
+		if (sscanf(line, "%" SCNxPTR "-%" SCNxPTR " ",
+			   &map_begin, &map_end) == 2)
+			is_arena = map_begin < end && map_end > begin;
+		else if (is_arena &&
+			 sscanf(line, "AnonHugePages: %lu kB", &kb) == 1)
+			size += kb * 1024;
+	}
+	fclose(f);
+	return size;
+#else
+	(void)memtx;
+	return 0;
+#endif
+}
+
+ssize_t
+memtx_engine_huge_pages_size(struct memtx_engine *memtx)
+{
+	if (!memtx->use_huge_pages)
+		return -1;
+	return coio_call(memtx_engine_huge_pages_size_f, memtx);
+}
+
 struct memtx_engine *
 memtx_engine_new(const char *snap_dirname, bool force_recovery,
 		 uint64_t tuple_arena_max_size, uint32_t objsize_min,
 		 bool dontdump, unsigned granularity,
-		 const char *allocator, float alloc_factor)
+		 const char *allocator, float alloc_factor,
+		 bool use_huge_pages, int numa_node)
 {
 	int64_t snap_signature;
 	struct memtx_engine *memtx =
@@ -1186,6 +1501,10 @@ memtx_engine_new(const char *snap_dirname, bool force_recovery,
 	memtx->gc_fiber = fiber_new("memtx.gc", memtx_engine_gc_f);
 	if (memtx->gc_fiber == NULL)
 		goto fail;
+	memtx->defrag_fiber = fiber_new("memtx.defrag",
+					memtx_engine_defrag_f);
+	if (memtx->defrag_fiber == NULL)
+		goto fail;
 
 	/* Apply lowest allowed objsize bound. */
 	if (objsize_min < OBJSIZE_MIN)
@@ -1205,6 +1524,7 @@ memtx_engine_new(const char *snap_dirname, bool force_recovery,
 	quota_init(&memtx->quota, tuple_arena_max_size);
 	tuple_arena_create(&memtx->arena, &memtx->quota, tuple_arena_max_size,
 			   SLAB_SIZE, dontdump, "memtx");
+	memtx_engine_set_arena_policy(memtx, use_huge_pages, numa_node);
 	slab_cache_create(&memtx->slab_cache, &memtx->arena);
 	memtx->free_mode = MEMTX_ENGINE_FREE;
 	float actual_alloc_factor;
@@ -1231,12 +1551,14 @@ memtx_engine_new(const char *snap_dirname, bool force_recovery,
 	memtx->max_tuple_size = MAX_TUPLE_SIZE;
 	memtx->force_recovery = force_recovery;
 
-	memtx->replica_join_cord = NULL;
+	rlist_create(&memtx->join_streams);
 
 	memtx->base.vtab = &memtx_engine_vtab;
 	memtx->base.name = "memtx";
+	memtx->base.flags = ENGINE_JOIN_PARALLEL;
 
 	fiber_start(memtx->gc_fiber, memtx);
+	fiber_start(memtx->defrag_fiber, memtx);
 	return memtx;
 fail:
 	xdir_destroy(&memtx->snap_dir);
@@ -1276,6 +1598,13 @@ memtx_engine_set_max_tuple_size(struct memtx_engine *memtx, size_t max_size)
 	memtx->max_tuple_size = max_size;
 }
 
+void
+memtx_engine_set_defrag_ratio(struct memtx_engine *memtx, double ratio)
+{
+	memtx->defrag_ratio = ratio;
+	fiber_wakeup(memtx->defrag_fiber);
+}
+
 void
 memtx_enter_delayed_free_mode(struct memtx_engine *memtx)
 {
@@ -1310,6 +1639,9 @@ memtx_tuple_new(struct tuple_format *format, const char *data, const char *end)
 	uint32_t data_offset, field_map_size;
 	char *raw;
 	bool make_compact;
+	if (format->has_compressed_fields &&
+	    tuple_compress_fields(format, &data, &end, region) != 0)
+		goto end;
 	if (tuple_field_map_create(format, data, true, &builder) != 0)
 		goto end;
 	field_map_size = field_map_build_size(&builder);
@@ -1523,6 +1855,8 @@ memtx_index_def_change_requires_rebuild(struct index *index,
 		return true;
 	if (old_def->opts.hint != new_def->opts.hint)
 		return true;
+	if (old_def->opts.wide_hint != new_def->opts.wide_hint)
+		return true;
 
 	const struct key_def *old_cmp_def, *new_cmp_def;
 	if (index_depends_on_pk(index)) {
@@ -133,10 +133,11 @@ struct memtx_engine {
 	/** Skip invalid snapshot records if this flag is set. */
 	bool force_recovery;
 	/**
-	 * Cord being currently used to join replica. It is only
-	 * needed to be able to cancel it on shutdown.
+	 * Streams being currently used to join replicas, linked by
+	 * memtx_join_stream::in_engine. They are only needed to be
+	 * able to cancel their cords on shutdown.
 	 */
-	struct cord *replica_join_cord;
+	struct rlist join_streams;
 	/** Common quota for tuples and indexes. */
 	struct quota quota;
 	/**
@@ -146,6 +147,11 @@ struct memtx_engine {
 	 * is reflected in box.slab.info(), @sa lua/slab.c.
 	 */
 	struct slab_arena arena;
+	/**
+	 * Set if the arena is advised to be backed by transparent
+	 * huge pages, see memtx_engine_huge_pages_size().
+	 */
+	bool use_huge_pages;
 	/** Slab cache for allocating tuples. */
 	struct slab_cache slab_cache;
 	/** Slab cache for allocating index extents. */
@@ -193,6 +199,15 @@ struct memtx_engine {
 	 * Free mode, determines a strategy for freeing up memory
 	 */
 	enum memtx_engine_free_mode free_mode;
+	/**
+	 * Tuples are relocated in background when the ratio of
+	 * memory used by tuples to memory allocated for slabs
+	 * drops below this value, box.cfg.memtx_defrag_ratio.
+	 * Zero disables defragmentation.
+	 */
+	double defrag_ratio;
+	/** Fiber that relocates tuples to release sparse slabs. */
+	struct fiber *defrag_fiber;
 };
 
 struct memtx_gc_task;
@@ -228,12 +243,33 @@ struct memtx_engine *
 memtx_engine_new(const char *snap_dirname, bool force_recovery,
 		 uint64_t tuple_arena_max_size, uint32_t objsize_min,
 		 bool dontdump, unsigned granularity,
-		 const char *allocator, float alloc_factor);
+		 const char *allocator, float alloc_factor,
+		 bool use_huge_pages, int numa_node);
+
+/**
+ * Return the size of the memtx arena memory that is currently
+ * backed by huge pages, in bytes, or -1 if huge pages aren't used
+ * or the size can't be determined. The size is calculated in a
+ * coio thread, so the function yields.
+ */
+ssize_t
+memtx_engine_huge_pages_size(struct memtx_engine *memtx);
 
 int
 memtx_engine_recover_snapshot(struct memtx_engine *memtx,
 			      const struct vclock *vclock);
 
+/**
+ * Load a snapshot file that doesn't necessarily belong to the
+ * snapshot directory, e.g. one received from a master on join.
+ * All rows are assigned the given signature as LSN. If skip_local
+ * is set, rows of local spaces are ignored.
+ */
+int
+memtx_engine_recover_snapshot_file(struct memtx_engine *memtx,
+				   const char *filename, int64_t signature,
+				   bool skip_local);
+
 void
 memtx_engine_set_snap_io_rate_limit(struct memtx_engine *memtx, double limit);
 
@@ -243,6 +279,9 @@ memtx_engine_set_memory(struct memtx_engine *memtx, size_t size);
 void
 memtx_engine_set_max_tuple_size(struct memtx_engine *memtx, size_t max_size);
 
+void
+memtx_engine_set_defrag_ratio(struct memtx_engine *memtx, double ratio);
+
 /**
  * Enter tuple delayed free mode: tuple allocated before the call
  * won't be freed until memtx_leave_delayed_free_mode() is called.
@@ -265,7 +304,9 @@ extern struct tuple_format_vtab memtx_tuple_format_vtab;
 
 enum {
 	MEMTX_EXTENT_SIZE = 16 * 1024,
-	MEMTX_SLAB_SIZE = 4 * 1024 * 1024
+	MEMTX_SLAB_SIZE = 4 * 1024 * 1024,
+	/** The arena can be bound to NUMA nodes [0, MEMTX_NUMA_NODE_MAX). */
+	MEMTX_NUMA_NODE_MAX = 1024,
 };
 
 /**
@@ -309,13 +350,15 @@ static inline struct memtx_engine *
 memtx_engine_new_xc(const char *snap_dirname, bool force_recovery,
 		    uint64_t tuple_arena_max_size, uint32_t objsize_min,
 		    bool dontdump, unsigned granularity,
-		    const char *allocator, float alloc_factor)
+		    const char *allocator, float alloc_factor,
+		    bool use_huge_pages, int numa_node)
 {
 	struct memtx_engine *memtx;
 	memtx = memtx_engine_new(snap_dirname, force_recovery,
 				 tuple_arena_max_size,
 				 objsize_min, dontdump,
-				 granularity, allocator, alloc_factor);
+				 granularity, allocator, alloc_factor,
+				 use_huge_pages, numa_node);
 	if (memtx == NULL)
 		diag_raise();
 	return memtx;
@@ -323,6 +323,157 @@ rollback:
 	return -1;
 }
 
+/**
+ * Move a tuple stored in a memtx space to a newly allocated memory
+ * chunk and replace it with the copy in all indexes of the space.
+ * The copy is dropped if it happens to be allocated at a higher
+ * address than the original, because in this case it wouldn't
+ * help to release any slab.
+ */
+static int
+memtx_space_relocate_tuple(struct space *space, struct tuple *old_tuple)
+{
+	struct memtx_engine *memtx = (struct memtx_engine *)space->engine;
+	if (memtx_index_extent_reserve(memtx,
+				       RESERVE_EXTENTS_BEFORE_REPLACE) != 0)
+		return -1;
+	struct tuple *new_tuple = tuple_new(tuple_format(old_tuple),
+					    tuple_data(old_tuple),
+					    tuple_data(old_tuple) +
+					    tuple_bsize(old_tuple));
+	if (new_tuple == NULL)
+		return -1;
+	tuple_ref(new_tuple);
+	if ((uintptr_t)new_tuple > (uintptr_t)old_tuple) {
+		tuple_unref(new_tuple);
+		return 0;
+	}
+	uint32_t i;
+	for (i = 0; i < space->index_count; i++) {
+		struct tuple *unused;
+		struct index *index = space->index[i];
+		if (index_replace(index, old_tuple, new_tuple,
+				  i == 0 ? DUP_REPLACE : DUP_INSERT,
+				  &unused, &unused) != 0)
+			goto rollback;
+	}
+	tuple_unref(old_tuple);
+	return 0;
+rollback:
+	for (; i > 0; i--) {
+		struct tuple *unused;
+		struct index *index = space->index[i - 1];
+		/* Rollback must not fail. */
+		if (index_replace(index, new_tuple, old_tuple,
+				  DUP_INSERT, &unused, &unused) != 0) {
+			diag_log();
+			unreachable();
+			panic("failed to rollback change");
+		}
+	}
+	tuple_unref(new_tuple);
+	return -1;
+}
+
+bool
+memtx_space_can_defrag(struct space *space)
+{
+	struct memtx_space *memtx_space = (struct memtx_space *)space;
+	if (!space_is_memtx(space) || space_is_system(space) ||
+	    space->index_count == 0 ||
+	    memtx_space->replace != memtx_space_replace_all_keys)
+		return false;
+	/*
+	 * DDL operations that yield (index build, format check)
+	 * use on_replace triggers to keep track of concurrent
+	 * changes and keep raw pointers to tuples, which would be
+	 * left dangling after relocation.
+	 */
+	if (!rlist_empty(&space->on_replace))
+		return false;
+	/*
+	 * Replacing a tuple in a functional index calls the index
+	 * function, which may yield.
+	 */
+	for (uint32_t i = 0; i < space->index_count; i++) {
+		if (space->index[i]->def->opts.func_id > 0)
+			return false;
+	}
+	return true;
+}
+
+int
+memtx_space_defrag(struct space *space, char **key, uint32_t limit)
+{
+	assert(memtx_space_can_defrag(space));
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	struct index *pk = space->index[0];
+	size_t size;
+	struct tuple **tuples = region_alloc_array(region, typeof(tuples[0]),
+						   limit, &size);
+	if (tuples == NULL) {
+		diag_set(OutOfMemory, size, "region_alloc_array", "tuples");
+		return -1;
+	}
+	const char *pos = *key;
+	uint32_t part_count = pos != NULL ? mp_decode_array(&pos) : 0;
+	if (pos != NULL &&
+	    exact_key_validate(pk->def->key_def, pos, part_count) != 0) {
+		region_truncate(region, region_svp);
+		return -1;
+	}
+	struct iterator *it = index_create_iterator(pk, ITER_GT, pos,
+						    part_count);
+	if (it == NULL) {
+		region_truncate(region, region_svp);
+		return -1;
+	}
+	/*
+	 * Collect tuples first, because an iterator may hold
+	 * a reference to the current tuple.
+	 */
+	uint32_t count = 0;
+	struct tuple *tuple;
+	while (count < limit && iterator_next(it, &tuple) == 0 &&
+	       tuple != NULL)
+		tuples[count++] = tuple;
+	iterator_delete(it);
+	free(*key);
+	*key = NULL;
+	if (count == limit) {
+		/* Remember where to resume. */
+		uint32_t key_size;
+		const char *last = tuple_extract_key(tuples[count - 1],
+						     pk->def->key_def,
+						     MULTIKEY_NONE, &key_size);
+		if (last == NULL) {
+			region_truncate(region, region_svp);
+			return -1;
+		}
+		*key = xmalloc(key_size);
+		memcpy(*key, last, key_size);
+	}
+	int rc = 0;
+	for (uint32_t i = 0; i < count; i++) {
+		tuple = tuples[i];
+		/*
+		 * A tuple referenced by anyone but the space may be
+		 * used by a transaction, a read view or a fiber, and
+		 * a dirty tuple is tracked by the transaction manager,
+		 * so leave them alone.
+		 */
+		if (tuple->is_dirty || !tuple_has_single_ref(tuple))
+			continue;
+		if (memtx_space_relocate_tuple(space, tuple) != 0) {
+			rc = -1;
+			break;
+		}
+	}
+	region_truncate(region, region_svp);
+	return rc;
+}
+
 static inline enum dup_replace_mode
 dup_replace_mode(uint16_t op)
 {
@@ -650,6 +801,12 @@ memtx_space_check_index_def(struct space *space, struct index_def *index_def)
 			return -1;
 		}
 	}
+	if (index_def->opts.ttl > 0) {
+		diag_set(ClientError, ER_MODIFY_INDEX,
+			 index_def->name, space_name(space),
+			 "ttl is not supported by memtx engine");
+		return -1;
+	}
 	switch (index_def->type) {
 	case HASH:
 		if (! index_def->opts.is_unique) {
@@ -1337,7 +1494,8 @@ memtx_space_new(struct memtx_engine *memtx,
 		tuple_format_new(&memtx_tuple_format_vtab, memtx, keys, key_count,
 				 def->fields, def->field_count,
 				 def->exact_field_count, def->dict,
-				 def->opts.is_temporary, def->opts.is_ephemeral);
+				 def->opts.is_temporary, def->opts.is_ephemeral,
+				 def->opts.compact_field_map);
 	if (format == NULL) {
 		free(memtx_space);
 		return NULL;
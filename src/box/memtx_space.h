@@ -84,6 +84,27 @@ int
 memtx_space_replace_all_keys(struct space *, struct tuple *, struct tuple *,
 			     enum dup_replace_mode, struct tuple **);
 
+/**
+ * Check if tuples of a memtx space can be relocated by the
+ * defragmentation fiber, see memtx_space_defrag().
+ */
+bool
+memtx_space_can_defrag(struct space *space);
+
+/**
+ * Move up to @a limit tuples of a memtx space to new memory so
+ * that sparse slabs may be released. Tuples are visited in the
+ * primary key order starting after @a key (MsgPack array, NULL
+ * means the beginning of the space). The function doesn't yield.
+ * On return @a key is replaced with the primary key of the last
+ * visited tuple allocated with malloc() or NULL if the end of
+ * the space has been reached. The caller must make sure that
+ * @a key was produced for the same primary key, the function
+ * only checks that it is valid.
+ */
+int
+memtx_space_defrag(struct space *space, char **key, uint32_t limit);
+
 struct space *
 memtx_space_new(struct memtx_engine *memtx,
 		struct space_def *def, struct rlist *key_list);
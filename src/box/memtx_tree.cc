@@ -42,6 +42,25 @@
 #include <qsort_arg.h>
 #include <small/mempool.h>
 
+/**
+ * Value of the USE_HINT template argument of tree index functions
+ * that selects wide hints: in addition to the regular comparison
+ * hint, each tree element stores an extended one, see
+ * tuple_hint_ext(). Other values are false (no hints), true
+ * (regular hints only) and MEMTX_TREE_MK_HINT.
+ */
+static constexpr int MEMTX_TREE_WIDE_HINT = 2;
+
+/**
+ * Value of the USE_HINT template argument of tree index functions
+ * used by multikey and functional indexes. Tree elements store a
+ * regular hint, but it is a multikey index or a functional key
+ * rather than a comparison hint, so the tree compares elements with
+ * the comparator only. Using a separate tree type lets the regular
+ * hint trees check hints inline without looking at the key_def.
+ */
+static constexpr int MEMTX_TREE_MK_HINT = 3;
+
 /**
  * Struct that is used as a key in BPS tree definition.
  */
@@ -52,22 +71,41 @@ struct memtx_tree_key_data_common {
 	uint32_t part_count;
 };
 
-template <bool USE_HINT>
+template <int USE_HINT>
 struct memtx_tree_key_data;
 
 template <>
 struct memtx_tree_key_data<false> : memtx_tree_key_data_common {
 	static constexpr hint_t hint = HINT_NONE;
+	static constexpr hint_t hint_ext = HINT_NONE;
 	void set_hint(hint_t) { assert(false); }
+	void set_hint_ext(hint_t) { assert(false); }
 };
 
 template <>
 struct memtx_tree_key_data<true> : memtx_tree_key_data_common {
 	/** Comparison hint, see tuple_hint(). */
 	hint_t hint;
+	static constexpr hint_t hint_ext = HINT_NONE;
 	void set_hint(hint_t h) { hint = h; }
+	void set_hint_ext(hint_t) { assert(false); }
 };
 
+template <>
+struct memtx_tree_key_data<MEMTX_TREE_WIDE_HINT> :
+	memtx_tree_key_data_common {
+	/** Comparison hint, see key_hint(). */
+	hint_t hint;
+	/** Extended comparison hint, see key_hint_ext(). */
+	hint_t hint_ext;
+	void set_hint(hint_t h) { hint = h; }
+	void set_hint_ext(hint_t h) { hint_ext = h; }
+};
+
+template <>
+struct memtx_tree_key_data<MEMTX_TREE_MK_HINT> :
+	memtx_tree_key_data<true> {};
+
 /**
  * Struct that is used as a elem in BPS tree definition.
  */
@@ -76,13 +114,15 @@ struct memtx_tree_data_common {
 	struct tuple *tuple;
 };
 
-template <bool USE_HINT>
+template <int USE_HINT>
 struct memtx_tree_data;
 
 template <>
 struct memtx_tree_data<false> : memtx_tree_data_common {
 	static constexpr hint_t hint = HINT_NONE;
+	static constexpr hint_t hint_ext = HINT_NONE;
 	void set_hint(hint_t) { assert(false); }
+	void set_hint_ext(hint_t) { assert(false); }
 };
 
 template <>
@@ -92,6 +132,84 @@ struct memtx_tree_data<true> :  memtx_tree_data<false> {
 	void set_hint(hint_t h) { hint = h; }
 };
 
+template <>
+struct memtx_tree_data<MEMTX_TREE_WIDE_HINT> : memtx_tree_data<true> {
+	/** Extended comparison hint, see tuple_hint_ext(). */
+	hint_t hint_ext;
+	void set_hint_ext(hint_t h) { hint_ext = h; }
+};
+
+template <>
+struct memtx_tree_data<MEMTX_TREE_MK_HINT> : memtx_tree_data<true> {};
+
+/**
+ * Compare comparison hints of two tree elements or of a tree
+ * element and a key. Returns 0 if a full comparison is needed.
+ *
+ * Hints are checked inline rather than by the comparator so that
+ * the most of comparisons done by block search in a big tree don't
+ * pay for an indirect call. Must not be used for multikey and
+ * functional indexes, see MEMTX_TREE_MK_HINT.
+ */
+static inline int
+memtx_tree_hint_cmp(hint_t hint_a, hint_t hint_b)
+{
+	if (hint_a != hint_b && hint_a != HINT_NONE && hint_b != HINT_NONE)
+		return hint_a < hint_b ? -1 : 1;
+	return 0;
+}
+
+/**
+ * Compare extended hints of two tree elements or of a tree element
+ * and a key whose regular hints are equal to @a hint. Returns 0 if
+ * a full comparison is needed.
+ */
+static inline int
+memtx_tree_hint_ext_cmp(hint_t hint, hint_t hint_ext_a, hint_t hint_ext_b)
+{
+	if (hint != HINT_NONE && hint_ext_a != HINT_NONE &&
+	    hint_ext_b != HINT_NONE && hint_ext_a != hint_ext_b)
+		return hint_ext_a < hint_ext_b ? -1 : 1;
+	return 0;
+}
+
+/** Compare two tree elements. */
+template <int USE_HINT>
+static inline int
+memtx_tree_data_compare(const struct memtx_tree_data<USE_HINT> *a,
+			const struct memtx_tree_data<USE_HINT> *b,
+			struct key_def *key_def)
+{
+	if (USE_HINT == MEMTX_TREE_MK_HINT)
+		return tuple_compare(a->tuple, a->hint, b->tuple, b->hint,
+				     key_def);
+	int rc = memtx_tree_hint_cmp(a->hint, b->hint);
+	if (rc == 0 && a->hint == b->hint)
+		rc = memtx_tree_hint_ext_cmp(a->hint, a->hint_ext, b->hint_ext);
+	if (rc != 0)
+		return rc;
+	return tuple_compare(a->tuple, a->hint, b->tuple, b->hint, key_def);
+}
+
+/** Compare a tree element with a key. */
+template <int USE_HINT>
+static inline int
+memtx_tree_data_compare_key(const struct memtx_tree_data<USE_HINT> *a,
+			    const struct memtx_tree_key_data<USE_HINT> *b,
+			    struct key_def *key_def)
+{
+	if (USE_HINT == MEMTX_TREE_MK_HINT)
+		return tuple_compare_with_key(a->tuple, a->hint, b->key,
+					      b->part_count, b->hint, key_def);
+	int rc = memtx_tree_hint_cmp(a->hint, b->hint);
+	if (rc == 0 && a->hint == b->hint)
+		rc = memtx_tree_hint_ext_cmp(a->hint, a->hint_ext, b->hint_ext);
+	if (rc != 0)
+		return rc;
+	return tuple_compare_with_key(a->tuple, a->hint, b->key,
+				      b->part_count, b->hint, key_def);
+}
+
 /**
  * Test whether BPS tree elements are identical i.e. represent
  * the same tuple at the same position in the tree.
@@ -110,11 +228,9 @@ memtx_tree_data_is_equal(const struct memtx_tree_data_common *a,
 #define BPS_TREE_NAME memtx_tree
 #define BPS_TREE_BLOCK_SIZE (512)
 #define BPS_TREE_EXTENT_SIZE MEMTX_EXTENT_SIZE
-#define BPS_TREE_COMPARE(a, b, arg)\
-	tuple_compare((&a)->tuple, (&a)->hint, (&b)->tuple, (&b)->hint, arg)
+#define BPS_TREE_COMPARE(a, b, arg) memtx_tree_data_compare(&a, &b, arg)
 #define BPS_TREE_COMPARE_KEY(a, b, arg)\
-	tuple_compare_with_key((&a)->tuple, (&a)->hint, (b)->key,\
-			       (b)->part_count, (b)->hint, arg)
+	memtx_tree_data_compare_key(&a, b, arg)
 #define BPS_TREE_IS_IDENTICAL(a, b) memtx_tree_data_is_equal(&a, &b)
 #define BPS_TREE_NO_DEBUG 1
 #define bps_tree_arg_t struct key_def *
@@ -139,6 +255,26 @@ memtx_tree_data_is_equal(const struct memtx_tree_data_common *a,
 #undef bps_tree_elem_t
 #undef bps_tree_key_t
 
+#define BPS_TREE_NAMESPACE NS_WIDE_HINT
+#define bps_tree_elem_t struct memtx_tree_data<MEMTX_TREE_WIDE_HINT>
+#define bps_tree_key_t struct memtx_tree_key_data<MEMTX_TREE_WIDE_HINT> *
+
+#include "salad/bps_tree.h"
+
+#undef BPS_TREE_NAMESPACE
+#undef bps_tree_elem_t
+#undef bps_tree_key_t
+
+#define BPS_TREE_NAMESPACE NS_MK_HINT
+#define bps_tree_elem_t struct memtx_tree_data<MEMTX_TREE_MK_HINT>
+#define bps_tree_key_t struct memtx_tree_key_data<MEMTX_TREE_MK_HINT> *
+
+#include "salad/bps_tree.h"
+
+#undef BPS_TREE_NAMESPACE
+#undef bps_tree_elem_t
+#undef bps_tree_key_t
+
 #undef BPS_TREE_NAME
 #undef BPS_TREE_BLOCK_SIZE
 #undef BPS_TREE_EXTENT_SIZE
@@ -150,8 +286,10 @@ memtx_tree_data_is_equal(const struct memtx_tree_data_common *a,
 
 using namespace NS_NO_HINT;
 using namespace NS_USE_HINT;
+using namespace NS_WIDE_HINT;
+using namespace NS_MK_HINT;
 
-template <bool USE_HINT>
+template <int USE_HINT>
 struct memtx_tree_selector;
 
 template <>
@@ -160,10 +298,18 @@ struct memtx_tree_selector<false> : NS_NO_HINT::memtx_tree {};
 template <>
 struct memtx_tree_selector<true> : NS_USE_HINT::memtx_tree {};
 
-template <bool USE_HINT>
+template <>
+struct memtx_tree_selector<MEMTX_TREE_WIDE_HINT> :
+	NS_WIDE_HINT::memtx_tree {};
+
+template <>
+struct memtx_tree_selector<MEMTX_TREE_MK_HINT> :
+	NS_MK_HINT::memtx_tree {};
+
+template <int USE_HINT>
 using memtx_tree_t = struct memtx_tree_selector<USE_HINT>;
 
-template <bool USE_HINT>
+template <int USE_HINT>
 struct memtx_tree_iterator_selector;
 
 template <>
@@ -176,7 +322,17 @@ struct memtx_tree_iterator_selector<true> {
 	using type = NS_USE_HINT::memtx_tree_iterator;
 };
 
-template <bool USE_HINT>
+template <>
+struct memtx_tree_iterator_selector<MEMTX_TREE_WIDE_HINT> {
+	using type = NS_WIDE_HINT::memtx_tree_iterator;
+};
+
+template <>
+struct memtx_tree_iterator_selector<MEMTX_TREE_MK_HINT> {
+	using type = NS_MK_HINT::memtx_tree_iterator;
+};
+
+template <int USE_HINT>
 using memtx_tree_iterator_t = typename memtx_tree_iterator_selector<USE_HINT>::type;
 
 static void
@@ -191,7 +347,19 @@ invalidate_tree_iterator(NS_USE_HINT::memtx_tree_iterator *itr)
 	*itr = NS_USE_HINT::memtx_tree_invalid_iterator();
 }
 
-template <bool USE_HINT>
+static void
+invalidate_tree_iterator(NS_WIDE_HINT::memtx_tree_iterator *itr)
+{
+	*itr = NS_WIDE_HINT::memtx_tree_invalid_iterator();
+}
+
+static void
+invalidate_tree_iterator(NS_MK_HINT::memtx_tree_iterator *itr)
+{
+	*itr = NS_MK_HINT::memtx_tree_invalid_iterator();
+}
+
+template <int USE_HINT>
 struct memtx_tree_index {
 	struct index base;
 	memtx_tree_t<USE_HINT> tree;
@@ -210,7 +378,7 @@ memtx_tree_cmp_def(TREE *tree)
 	return tree->arg;
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static int
 memtx_tree_qcompare(const void* a, const void *b, void *c)
 {
@@ -219,12 +387,11 @@ memtx_tree_qcompare(const void* a, const void *b, void *c)
 	const struct memtx_tree_data<USE_HINT> *data_b =
 		(struct memtx_tree_data<USE_HINT> *)b;
 	struct key_def *key_def = (struct key_def *)c;
-	return tuple_compare(data_a->tuple, data_a->hint, data_b->tuple,
-			     data_b->hint, key_def);
+	return memtx_tree_data_compare(data_a, data_b, key_def);
 }
 
 /* {{{ MemtxTree Iterators ****************************************/
-template <bool USE_HINT>
+template <int USE_HINT>
 struct tree_iterator {
 	struct iterator base;
 	memtx_tree_iterator_t<USE_HINT> tree_iterator;
@@ -241,12 +408,20 @@ static_assert(sizeof(struct tree_iterator<false>) <= MEMTX_ITERATOR_SIZE,
 static_assert(sizeof(struct tree_iterator<true>) <= MEMTX_ITERATOR_SIZE,
 	      "sizeof(struct tree_iterator<true>) must be less than or equal "
 	      "to MEMTX_ITERATOR_SIZE");
-
-template <bool USE_HINT>
+static_assert(sizeof(struct tree_iterator<MEMTX_TREE_WIDE_HINT>) <=
+	      MEMTX_ITERATOR_SIZE,
+	      "sizeof(struct tree_iterator<MEMTX_TREE_WIDE_HINT>) must be "
+	      "less than or equal to MEMTX_ITERATOR_SIZE");
+static_assert(sizeof(struct tree_iterator<MEMTX_TREE_MK_HINT>) <=
+	      MEMTX_ITERATOR_SIZE,
+	      "sizeof(struct tree_iterator<MEMTX_TREE_MK_HINT>) must be "
+	      "less than or equal to MEMTX_ITERATOR_SIZE");
+
+template <int USE_HINT>
 static void
 tree_iterator_free(struct iterator *iterator);
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static inline struct tree_iterator<USE_HINT> *
 get_tree_iterator(struct iterator *it)
 {
@@ -254,7 +429,7 @@ get_tree_iterator(struct iterator *it)
 	return (struct tree_iterator<USE_HINT> *) it;
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static void
 tree_iterator_free(struct iterator *iterator)
 {
@@ -273,7 +448,7 @@ tree_iterator_dummie(struct iterator *iterator, struct tuple **ret)
 	return 0;
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static int
 tree_iterator_next_base(struct iterator *iterator, struct tuple **ret)
 {
@@ -311,7 +486,7 @@ tree_iterator_next_base(struct iterator *iterator, struct tuple **ret)
 	return 0;
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static int
 tree_iterator_prev_base(struct iterator *iterator, struct tuple **ret)
 {
@@ -349,7 +524,7 @@ tree_iterator_prev_base(struct iterator *iterator, struct tuple **ret)
 	return 0;
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static int
 tree_iterator_next_equal_base(struct iterator *iterator, struct tuple **ret)
 {
@@ -404,7 +579,7 @@ tree_iterator_next_equal_base(struct iterator *iterator, struct tuple **ret)
 	return 0;
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static int
 tree_iterator_prev_equal_base(struct iterator *iterator, struct tuple **ret)
 {
@@ -459,7 +634,7 @@ tree_iterator_prev_equal_base(struct iterator *iterator, struct tuple **ret)
 }
 
 #define WRAP_ITERATOR_METHOD(name)						\
-template <bool USE_HINT>							\
+template <int USE_HINT>							\
 static int									\
 name(struct iterator *iterator, struct tuple **ret)				\
 {										\
@@ -501,7 +676,7 @@ WRAP_ITERATOR_METHOD(tree_iterator_prev_equal);
 
 #undef WRAP_ITERATOR_METHOD
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static void
 tree_iterator_set_next_method(struct tree_iterator<USE_HINT> *it)
 {
@@ -530,7 +705,7 @@ tree_iterator_set_next_method(struct tree_iterator<USE_HINT> *it)
 	}
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static int
 tree_iterator_start(struct iterator *iterator, struct tuple **ret)
 {
@@ -641,7 +816,7 @@ tree_iterator_start(struct iterator *iterator, struct tuple **ret)
 
 /* {{{ MemtxTree  **********************************************************/
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static void
 memtx_tree_index_free(struct memtx_tree_index<USE_HINT> *index)
 {
@@ -650,7 +825,7 @@ memtx_tree_index_free(struct memtx_tree_index<USE_HINT> *index)
 	free(index);
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static void
 memtx_tree_index_gc_run(struct memtx_gc_task *task, bool *done)
 {
@@ -683,7 +858,7 @@ memtx_tree_index_gc_run(struct memtx_gc_task *task, bool *done)
 	*done = true;
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static void
 memtx_tree_index_gc_free(struct memtx_gc_task *task)
 {
@@ -692,7 +867,7 @@ memtx_tree_index_gc_free(struct memtx_gc_task *task)
 	memtx_tree_index_free(index);
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static struct memtx_gc_task_vtab * get_memtx_tree_index_gc_vtab()
 {
 	static memtx_gc_task_vtab tab =
@@ -703,7 +878,7 @@ static struct memtx_gc_task_vtab * get_memtx_tree_index_gc_vtab()
 	return &tab;
 };
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static void
 memtx_tree_index_destroy(struct index *base)
 {
@@ -728,7 +903,7 @@ memtx_tree_index_destroy(struct index *base)
 	}
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static void
 memtx_tree_index_update_def(struct index *base)
 {
@@ -753,7 +928,7 @@ memtx_tree_index_depends_on_pk(struct index *base)
 	return !def->opts.is_unique || def->key_def->is_nullable;
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static ssize_t
 memtx_tree_index_size(struct index *base)
 {
@@ -765,7 +940,7 @@ memtx_tree_index_size(struct index *base)
 	       memtx_tx_index_invisible_count(in_txn(), space, base);
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static ssize_t
 memtx_tree_index_bsize(struct index *base)
 {
@@ -774,7 +949,7 @@ memtx_tree_index_bsize(struct index *base)
 	return memtx_tree_mem_used(&index->tree);
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static int
 memtx_tree_index_random(struct index *base, uint32_t rnd, struct tuple **result)
 {
@@ -785,7 +960,7 @@ memtx_tree_index_random(struct index *base, uint32_t rnd, struct tuple **result)
 	return 0;
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static ssize_t
 memtx_tree_index_count(struct index *base, enum iterator_type type,
 		       const char *key, uint32_t part_count)
@@ -795,7 +970,7 @@ memtx_tree_index_count(struct index *base, enum iterator_type type,
 	return generic_index_count(base, type, key, part_count);
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static int
 memtx_tree_index_get(struct index *base, const char *key,
 		     uint32_t part_count, struct tuple **result)
@@ -812,6 +987,8 @@ memtx_tree_index_get(struct index *base, const char *key,
 	key_data.part_count = part_count;
 	if (USE_HINT)
 		key_data.set_hint(key_hint(key, part_count, cmp_def));
+	if (USE_HINT == MEMTX_TREE_WIDE_HINT)
+		key_data.set_hint_ext(key_hint_ext(key, part_count, cmp_def));
 	struct memtx_tree_data<USE_HINT> *res =
 		memtx_tree_find(&index->tree, &key_data);
 	if (res == NULL) {
@@ -828,7 +1005,7 @@ memtx_tree_index_get(struct index *base, const char *key,
 	return 0;
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static int
 memtx_tree_index_replace(struct index *base, struct tuple *old_tuple,
 			 struct tuple *new_tuple, enum dup_replace_mode mode,
@@ -842,6 +1019,9 @@ memtx_tree_index_replace(struct index *base, struct tuple *old_tuple,
 		new_data.tuple = new_tuple;
 		if (USE_HINT)
 			new_data.set_hint(tuple_hint(new_tuple, cmp_def));
+		if (USE_HINT == MEMTX_TREE_WIDE_HINT)
+			new_data.set_hint_ext(tuple_hint_ext(new_tuple,
+							     cmp_def));
 		struct memtx_tree_data<USE_HINT> dup_data, suc_data;
 		dup_data.tuple = suc_data.tuple = NULL;
 
@@ -887,6 +1067,9 @@ memtx_tree_index_replace(struct index *base, struct tuple *old_tuple,
 		old_data.tuple = old_tuple;
 		if (USE_HINT)
 			old_data.set_hint(tuple_hint(old_tuple, cmp_def));
+		if (USE_HINT == MEMTX_TREE_WIDE_HINT)
+			old_data.set_hint_ext(tuple_hint_ext(old_tuple,
+							     cmp_def));
 		memtx_tree_delete(&index->tree, old_data);
 	}
 	*result = old_tuple;
@@ -899,13 +1082,14 @@ memtx_tree_index_replace(struct index *base, struct tuple *old_tuple,
  * by all it's multikey indexes.
  */
 static int
-memtx_tree_index_replace_multikey_one(struct memtx_tree_index<true> *index,
-			struct tuple *old_tuple, struct tuple *new_tuple,
-			enum dup_replace_mode mode, hint_t hint,
-			struct memtx_tree_data<true> *replaced_data,
-			bool *is_multikey_conflict)
+memtx_tree_index_replace_multikey_one(
+		struct memtx_tree_index<MEMTX_TREE_MK_HINT> *index,
+		struct tuple *old_tuple, struct tuple *new_tuple,
+		enum dup_replace_mode mode, hint_t hint,
+		struct memtx_tree_data<MEMTX_TREE_MK_HINT> *replaced_data,
+		bool *is_multikey_conflict)
 {
-	struct memtx_tree_data<true> new_data, dup_data;
+	struct memtx_tree_data<MEMTX_TREE_MK_HINT> new_data, dup_data;
 	new_data.tuple = new_tuple;
 	new_data.hint = hint;
 	dup_data.tuple = NULL;
@@ -961,11 +1145,12 @@ memtx_tree_index_replace_multikey_one(struct memtx_tree_index<true> *index,
  * delete operation is fault-tolerant.
  */
 static void
-memtx_tree_index_replace_multikey_rollback(struct memtx_tree_index<true> *index,
-			struct tuple *new_tuple, struct tuple *replaced_tuple,
-			int err_multikey_idx)
+memtx_tree_index_replace_multikey_rollback(
+		struct memtx_tree_index<MEMTX_TREE_MK_HINT> *index,
+		struct tuple *new_tuple, struct tuple *replaced_tuple,
+		int err_multikey_idx)
 {
-	struct memtx_tree_data<true> data;
+	struct memtx_tree_data<MEMTX_TREE_MK_HINT> data;
 	if (replaced_tuple != NULL) {
 		/* Restore replaced tuple index occurrences. */
 		struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
@@ -1039,8 +1224,8 @@ memtx_tree_index_replace_multikey(struct index *base, struct tuple *old_tuple,
 			struct tuple *new_tuple, enum dup_replace_mode mode,
 			struct tuple **result, struct tuple **successor)
 {
-	struct memtx_tree_index<true> *index =
-		(struct memtx_tree_index<true> *)base;
+	struct memtx_tree_index<MEMTX_TREE_MK_HINT> *index =
+		(struct memtx_tree_index<MEMTX_TREE_MK_HINT> *)base;
 
 	/* MUTLIKEY doesn't support successor for now. */
 	*successor = NULL;
@@ -1054,7 +1239,8 @@ memtx_tree_index_replace_multikey(struct index *base, struct tuple *old_tuple,
 		for (; (uint32_t) multikey_idx < multikey_count;
 		     multikey_idx++) {
 			bool is_multikey_conflict;
-			struct memtx_tree_data<true> replaced_data;
+			struct memtx_tree_data<MEMTX_TREE_MK_HINT>
+				replaced_data;
 			err = memtx_tree_index_replace_multikey_one(index,
 						old_tuple, new_tuple, mode,
 						multikey_idx, &replaced_data,
@@ -1079,7 +1265,7 @@ memtx_tree_index_replace_multikey(struct index *base, struct tuple *old_tuple,
 		}
 	}
 	if (old_tuple != NULL) {
-		struct memtx_tree_data<true> data;
+		struct memtx_tree_data<MEMTX_TREE_MK_HINT> data;
 		data.tuple = old_tuple;
 		uint32_t multikey_count =
 			tuple_multikey_count(old_tuple, cmp_def);
@@ -1111,7 +1297,7 @@ struct func_key_undo {
 	/** A link to organize entries in list. */
 	struct rlist link;
 	/** An inserted record copy. */
-	struct memtx_tree_data<true> key;
+	struct memtx_tree_data<MEMTX_TREE_MK_HINT> key;
 };
 
 /** Allocate a new func_key_undo on given region. */
@@ -1134,9 +1320,9 @@ func_key_undo_new(struct region *region)
  * return a given index object in it's original state.
  */
 static void
-memtx_tree_func_index_replace_rollback(struct memtx_tree_index<true> *index,
-				       struct rlist *old_keys,
-				       struct rlist *new_keys)
+memtx_tree_func_index_replace_rollback(
+		struct memtx_tree_index<MEMTX_TREE_MK_HINT> *index,
+		struct rlist *old_keys, struct rlist *new_keys)
 {
 	struct func_key_undo *entry;
 	rlist_foreach_entry(entry, new_keys, link) {
@@ -1168,8 +1354,8 @@ memtx_tree_func_index_replace(struct index *base, struct tuple *old_tuple,
 	/* FUNC doesn't support successor for now. */
 	*successor = NULL;
 
-	struct memtx_tree_index<true> *index =
-		(struct memtx_tree_index<true> *)base;
+	struct memtx_tree_index<MEMTX_TREE_MK_HINT> *index =
+		(struct memtx_tree_index<MEMTX_TREE_MK_HINT> *)base;
 	struct index_def *index_def = index->base.def;
 	assert(index_def->key_def->for_func_index);
 
@@ -1202,7 +1388,7 @@ memtx_tree_func_index_replace(struct index *base, struct tuple *old_tuple,
 			undo->key.hint = (hint_t)key;
 			rlist_add(&new_keys, &undo->link);
 			bool is_multikey_conflict;
-			struct memtx_tree_data<true> old_data;
+			struct memtx_tree_data<MEMTX_TREE_MK_HINT> old_data;
 			old_data.tuple = NULL;
 			err = memtx_tree_index_replace_multikey_one(index,
 						old_tuple, new_tuple,
@@ -1265,7 +1451,8 @@ memtx_tree_func_index_replace(struct index *base, struct tuple *old_tuple,
 		if (key_list_iterator_create(&it, old_tuple, index_def, false,
 					     func_index_key_dummy_alloc) != 0)
 			goto end;
-		struct memtx_tree_data<true> data, deleted_data;
+		struct memtx_tree_data<MEMTX_TREE_MK_HINT> data;
+		struct memtx_tree_data<MEMTX_TREE_MK_HINT> deleted_data;
 		data.tuple = old_tuple;
 		const char *key;
 		while (key_list_iterator_next(&it, &key) == 0 && key != NULL) {
@@ -1290,7 +1477,7 @@ end:
 	return rc;
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static struct iterator *
 memtx_tree_index_create_iterator(struct index *base, enum iterator_type type,
 				 const char *key, uint32_t part_count)
@@ -1332,12 +1519,15 @@ memtx_tree_index_create_iterator(struct index *base, enum iterator_type type,
 	it->key_data.part_count = part_count;
 	if (USE_HINT)
 		it->key_data.set_hint(key_hint(key, part_count, cmp_def));
+	if (USE_HINT == MEMTX_TREE_WIDE_HINT)
+		it->key_data.set_hint_ext(key_hint_ext(key, part_count,
+						       cmp_def));
 	invalidate_tree_iterator(&it->tree_iterator);
 	it->current.tuple = NULL;
 	return (struct iterator *)it;
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static void
 memtx_tree_index_begin_build(struct index *base)
 {
@@ -1347,7 +1537,7 @@ memtx_tree_index_begin_build(struct index *base)
 	(void)index;
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static int
 memtx_tree_index_reserve(struct index *base, uint32_t size_hint)
 {
@@ -1368,7 +1558,7 @@ memtx_tree_index_reserve(struct index *base, uint32_t size_hint)
 	return 0;
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 /** Initialize the next element of the index build_array. */
 static int
 memtx_tree_index_build_array_append(struct memtx_tree_index<USE_HINT> *index,
@@ -1407,7 +1597,7 @@ memtx_tree_index_build_array_append(struct memtx_tree_index<USE_HINT> *index,
 	return 0;
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static int
 memtx_tree_index_build_next(struct index *base, struct tuple *tuple)
 {
@@ -1416,14 +1606,21 @@ memtx_tree_index_build_next(struct index *base, struct tuple *tuple)
 	struct memtx_tree_index<USE_HINT> *index =
 		(struct memtx_tree_index<USE_HINT> *)base;
 	struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
-	return memtx_tree_index_build_array_append(index, tuple,
-						   tuple_hint(tuple, cmp_def));
+	hint_t hint = tuple_hint(tuple, cmp_def);
+	if (memtx_tree_index_build_array_append(index, tuple, hint) != 0)
+		return -1;
+	if (USE_HINT == MEMTX_TREE_WIDE_HINT) {
+		index->build_array[index->build_array_size - 1].set_hint_ext(
+			tuple_hint_ext(tuple, cmp_def));
+	}
+	return 0;
 }
 
 static int
 memtx_tree_index_build_next_multikey(struct index *base, struct tuple *tuple)
 {
-	struct memtx_tree_index<true> *index = (struct memtx_tree_index<true> *)base;
+	struct memtx_tree_index<MEMTX_TREE_MK_HINT> *index =
+		(struct memtx_tree_index<MEMTX_TREE_MK_HINT> *)base;
 	struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
 	uint32_t multikey_count = tuple_multikey_count(tuple, cmp_def);
 	for (uint32_t multikey_idx = 0; multikey_idx < multikey_count;
@@ -1438,7 +1635,8 @@ memtx_tree_index_build_next_multikey(struct index *base, struct tuple *tuple)
 static int
 memtx_tree_func_index_build_next(struct index *base, struct tuple *tuple)
 {
-	struct memtx_tree_index<true> *index = (struct memtx_tree_index<true> *)base;
+	struct memtx_tree_index<MEMTX_TREE_MK_HINT> *index =
+		(struct memtx_tree_index<MEMTX_TREE_MK_HINT> *)base;
 	struct index_def *index_def = index->base.def;
 	assert(index_def->key_def->for_func_index);
 
@@ -1474,7 +1672,7 @@ error:
  * of equal tuples (in terms of index's cmp_def and have same
  * tuple pointer). The build_array is expected to be sorted.
  */
-template <bool USE_HINT>
+template <int USE_HINT>
 static void
 memtx_tree_index_build_array_deduplicate(struct memtx_tree_index<USE_HINT> *index,
 			void (*destroy)(struct tuple *tuple, const char *hint))
@@ -1510,7 +1708,7 @@ memtx_tree_index_build_array_deduplicate(struct memtx_tree_index<USE_HINT> *inde
 	index->build_array_size = w_idx + 1;
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static void
 memtx_tree_index_end_build(struct index *base)
 {
@@ -1542,7 +1740,7 @@ memtx_tree_index_end_build(struct index *base)
 	index->build_array_alloc_size = 0;
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 struct tree_snapshot_iterator {
 	struct snapshot_iterator base;
 	struct memtx_tree_index<USE_HINT> *index;
@@ -1550,7 +1748,7 @@ struct tree_snapshot_iterator {
 	struct memtx_tx_snapshot_cleaner cleaner;
 };
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static void
 tree_snapshot_iterator_free(struct snapshot_iterator *iterator)
 {
@@ -1565,7 +1763,7 @@ tree_snapshot_iterator_free(struct snapshot_iterator *iterator)
 	free(iterator);
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static int
 tree_snapshot_iterator_next(struct snapshot_iterator *iterator,
 			    const char **data, uint32_t *size)
@@ -1603,7 +1801,7 @@ tree_snapshot_iterator_next(struct snapshot_iterator *iterator,
  * index modifications will not affect the iteration results.
  * Must be destroyed by iterator->free after usage.
  */
-template <bool USE_HINT>
+template <int USE_HINT>
 static struct snapshot_iterator *
 memtx_tree_index_create_snapshot_iterator(struct index *base)
 {
@@ -1692,64 +1890,97 @@ static const struct index_vtab memtx_tree_use_hint_index_vtab = {
 	/* .end_build = */ memtx_tree_index_end_build<true>,
 };
 
+static const struct index_vtab memtx_tree_wide_hint_index_vtab = {
+	/* .destroy = */ memtx_tree_index_destroy<MEMTX_TREE_WIDE_HINT>,
+	/* .commit_create = */ generic_index_commit_create,
+	/* .abort_create = */ generic_index_abort_create,
+	/* .commit_modify = */ generic_index_commit_modify,
+	/* .commit_drop = */ generic_index_commit_drop,
+	/* .update_def = */ memtx_tree_index_update_def<MEMTX_TREE_WIDE_HINT>,
+	/* .depends_on_pk = */ memtx_tree_index_depends_on_pk,
+	/* .def_change_requires_rebuild = */
+		memtx_index_def_change_requires_rebuild,
+	/* .size = */ memtx_tree_index_size<MEMTX_TREE_WIDE_HINT>,
+	/* .bsize = */ memtx_tree_index_bsize<MEMTX_TREE_WIDE_HINT>,
+	/* .min = */ generic_index_min,
+	/* .max = */ generic_index_max,
+	/* .random = */ memtx_tree_index_random<MEMTX_TREE_WIDE_HINT>,
+	/* .count = */ memtx_tree_index_count<MEMTX_TREE_WIDE_HINT>,
+	/* .get = */ memtx_tree_index_get<MEMTX_TREE_WIDE_HINT>,
+	/* .replace = */ memtx_tree_index_replace<MEMTX_TREE_WIDE_HINT>,
+	/* .create_iterator = */
+		memtx_tree_index_create_iterator<MEMTX_TREE_WIDE_HINT>,
+	/* .create_snapshot_iterator = */
+		memtx_tree_index_create_snapshot_iterator<MEMTX_TREE_WIDE_HINT>,
+	/* .stat = */ generic_index_stat,
+	/* .compact = */ generic_index_compact,
+	/* .reset_stat = */ generic_index_reset_stat,
+	/* .begin_build = */ memtx_tree_index_begin_build<MEMTX_TREE_WIDE_HINT>,
+	/* .reserve = */ memtx_tree_index_reserve<MEMTX_TREE_WIDE_HINT>,
+	/* .build_next = */ memtx_tree_index_build_next<MEMTX_TREE_WIDE_HINT>,
+	/* .end_build = */ memtx_tree_index_end_build<MEMTX_TREE_WIDE_HINT>,
+};
+
 static const struct index_vtab memtx_tree_index_multikey_vtab = {
-	/* .destroy = */ memtx_tree_index_destroy<true>,
+	/* .destroy = */ memtx_tree_index_destroy<MEMTX_TREE_MK_HINT>,
 	/* .commit_create = */ generic_index_commit_create,
 	/* .abort_create = */ generic_index_abort_create,
 	/* .commit_modify = */ generic_index_commit_modify,
 	/* .commit_drop = */ generic_index_commit_drop,
-	/* .update_def = */ memtx_tree_index_update_def<true>,
+	/* .update_def = */ memtx_tree_index_update_def<MEMTX_TREE_MK_HINT>,
 	/* .depends_on_pk = */ memtx_tree_index_depends_on_pk,
 	/* .def_change_requires_rebuild = */
 		memtx_index_def_change_requires_rebuild,
-	/* .size = */ memtx_tree_index_size<true>,
-	/* .bsize = */ memtx_tree_index_bsize<true>,
+	/* .size = */ memtx_tree_index_size<MEMTX_TREE_MK_HINT>,
+	/* .bsize = */ memtx_tree_index_bsize<MEMTX_TREE_MK_HINT>,
 	/* .min = */ generic_index_min,
 	/* .max = */ generic_index_max,
-	/* .random = */ memtx_tree_index_random<true>,
-	/* .count = */ memtx_tree_index_count<true>,
-	/* .get = */ memtx_tree_index_get<true>,
+	/* .random = */ memtx_tree_index_random<MEMTX_TREE_MK_HINT>,
+	/* .count = */ memtx_tree_index_count<MEMTX_TREE_MK_HINT>,
+	/* .get = */ memtx_tree_index_get<MEMTX_TREE_MK_HINT>,
 	/* .replace = */ memtx_tree_index_replace_multikey,
-	/* .create_iterator = */ memtx_tree_index_create_iterator<true>,
+	/* .create_iterator = */
+		memtx_tree_index_create_iterator<MEMTX_TREE_MK_HINT>,
 	/* .create_snapshot_iterator = */
-		memtx_tree_index_create_snapshot_iterator<true>,
+		memtx_tree_index_create_snapshot_iterator<MEMTX_TREE_MK_HINT>,
 	/* .stat = */ generic_index_stat,
 	/* .compact = */ generic_index_compact,
 	/* .reset_stat = */ generic_index_reset_stat,
-	/* .begin_build = */ memtx_tree_index_begin_build<true>,
-	/* .reserve = */ memtx_tree_index_reserve<true>,
+	/* .begin_build = */ memtx_tree_index_begin_build<MEMTX_TREE_MK_HINT>,
+	/* .reserve = */ memtx_tree_index_reserve<MEMTX_TREE_MK_HINT>,
 	/* .build_next = */ memtx_tree_index_build_next_multikey,
-	/* .end_build = */ memtx_tree_index_end_build<true>,
+	/* .end_build = */ memtx_tree_index_end_build<MEMTX_TREE_MK_HINT>,
 };
 
 static const struct index_vtab memtx_tree_func_index_vtab = {
-	/* .destroy = */ memtx_tree_index_destroy<true>,
+	/* .destroy = */ memtx_tree_index_destroy<MEMTX_TREE_MK_HINT>,
 	/* .commit_create = */ generic_index_commit_create,
 	/* .abort_create = */ generic_index_abort_create,
 	/* .commit_modify = */ generic_index_commit_modify,
 	/* .commit_drop = */ generic_index_commit_drop,
-	/* .update_def = */ memtx_tree_index_update_def<true>,
+	/* .update_def = */ memtx_tree_index_update_def<MEMTX_TREE_MK_HINT>,
 	/* .depends_on_pk = */ memtx_tree_index_depends_on_pk,
 	/* .def_change_requires_rebuild = */
 		memtx_index_def_change_requires_rebuild,
-	/* .size = */ memtx_tree_index_size<true>,
-	/* .bsize = */ memtx_tree_index_bsize<true>,
+	/* .size = */ memtx_tree_index_size<MEMTX_TREE_MK_HINT>,
+	/* .bsize = */ memtx_tree_index_bsize<MEMTX_TREE_MK_HINT>,
 	/* .min = */ generic_index_min,
 	/* .max = */ generic_index_max,
-	/* .random = */ memtx_tree_index_random<true>,
-	/* .count = */ memtx_tree_index_count<true>,
-	/* .get = */ memtx_tree_index_get<true>,
+	/* .random = */ memtx_tree_index_random<MEMTX_TREE_MK_HINT>,
+	/* .count = */ memtx_tree_index_count<MEMTX_TREE_MK_HINT>,
+	/* .get = */ memtx_tree_index_get<MEMTX_TREE_MK_HINT>,
 	/* .replace = */ memtx_tree_func_index_replace,
-	/* .create_iterator = */ memtx_tree_index_create_iterator<true>,
+	/* .create_iterator = */
+		memtx_tree_index_create_iterator<MEMTX_TREE_MK_HINT>,
 	/* .create_snapshot_iterator = */
-		memtx_tree_index_create_snapshot_iterator<true>,
+		memtx_tree_index_create_snapshot_iterator<MEMTX_TREE_MK_HINT>,
 	/* .stat = */ generic_index_stat,
 	/* .compact = */ generic_index_compact,
 	/* .reset_stat = */ generic_index_reset_stat,
-	/* .begin_build = */ memtx_tree_index_begin_build<true>,
-	/* .reserve = */ memtx_tree_index_reserve<true>,
+	/* .begin_build = */ memtx_tree_index_begin_build<MEMTX_TREE_MK_HINT>,
+	/* .reserve = */ memtx_tree_index_reserve<MEMTX_TREE_MK_HINT>,
 	/* .build_next = */ memtx_tree_func_index_build_next,
-	/* .end_build = */ memtx_tree_index_end_build<true>,
+	/* .end_build = */ memtx_tree_index_end_build<MEMTX_TREE_MK_HINT>,
 };
 
 /**
@@ -1759,7 +1990,7 @@ static const struct index_vtab memtx_tree_func_index_vtab = {
  * key defintion is not completely initialized at that moment).
  */
 static const struct index_vtab memtx_tree_disabled_index_vtab = {
-	/* .destroy = */ memtx_tree_index_destroy<true>,
+	/* .destroy = */ memtx_tree_index_destroy<MEMTX_TREE_MK_HINT>,
 	/* .commit_create = */ generic_index_commit_create,
 	/* .abort_create = */ generic_index_abort_create,
 	/* .commit_modify = */ generic_index_commit_modify,
@@ -1788,7 +2019,7 @@ static const struct index_vtab memtx_tree_disabled_index_vtab = {
 	/* .end_build = */ generic_index_end_build,
 };
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static struct index *
 memtx_tree_index_new_tpl(struct memtx_engine *memtx, struct index_def *def,
 			 const struct index_vtab *vtab)
@@ -1826,8 +2057,16 @@ memtx_tree_index_new(struct memtx_engine *memtx, struct index_def *def)
 			vtab = &memtx_tree_disabled_index_vtab;
 		else
 			vtab = &memtx_tree_func_index_vtab;
+		return memtx_tree_index_new_tpl<MEMTX_TREE_MK_HINT>(memtx, def,
+								    vtab);
 	} else if (def->key_def->is_multikey) {
 		vtab = &memtx_tree_index_multikey_vtab;
+		return memtx_tree_index_new_tpl<MEMTX_TREE_MK_HINT>(memtx, def,
+								    vtab);
+	} else if (def->opts.hint && def->opts.wide_hint) {
+		vtab = &memtx_tree_wide_hint_index_vtab;
+		return memtx_tree_index_new_tpl<MEMTX_TREE_WIDE_HINT>(
+			memtx, def, vtab);
 	} else if (def->opts.hint) {
 		vtab = &memtx_tree_use_hint_index_vtab;
 	} else {
@@ -32,6 +32,8 @@
 
 #include "trivia/config.h"
 #include "trivia/util.h" /** static_assert */
+#include "bit/bit.h"
+#include "msgpuck.h"
 #include "tt_static.h"
 #include "scoped_guard.h"
 #include "cbus.h"
@@ -47,17 +49,34 @@
 #include "iproto_constants.h"
 #include "recovery.h"
 #include "replication.h"
+#include "schema_def.h"
 #include "trigger.h"
 #include "vclock/vclock.h"
 #include "version.h"
 #include "xrow.h"
 #include "xrow_io.h"
+#include "xrow_ring.h"
 #include "xstream.h"
 #include "wal.h"
 #include "txn_limbo.h"
 #include "raft.h"
+#include "latency.h"
+#include "rmean.h"
 
+#include <fcntl.h>
 #include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+
+enum {
+	/** Max size of rows read from the WAL ring at once. */
+	RELAY_RING_READ_SIZE = 64 * 1024,
+	/** Max number of rows forwarded from the WAL ring at once. */
+	RELAY_FORWARD_ROWS_MAX = 64,
+	/** Size of the fixed header of a forwarded row. */
+	RELAY_FORWARD_FIXHEADER_SIZE = 5,
+};
 
 /**
  * Cbus message to send status updates from relay to tx thread.
@@ -71,6 +90,11 @@ struct relay_status_msg {
 	struct vclock vclock;
 	/** Last replicated transaction timestamp. */
 	double txn_lag;
+	/**
+	 * Time when the replica is known to have heard from this
+	 * instance last time, see relay::echo_time.
+	 */
+	double ack_time;
 };
 
 /**
@@ -114,6 +138,24 @@ struct relay {
 	struct recovery *r;
 	/** Xstream argument to recovery */
 	struct xstream stream;
+	/**
+	 * Position of the next row to read from the WAL ring or -1
+	 * if rows are read from WAL files, see wal_ring().
+	 */
+	int64_t ring_pos;
+	/** Buffer for rows read from the WAL ring. */
+	struct ibuf ring_buf;
+	/**
+	 * Rows read from the WAL ring to be sent as they are, see
+	 * relay_forward_row(). Each row takes two vectors: the
+	 * fixed header and the row data stored in ring_buf.
+	 */
+	struct iovec forward_iov[2 * RELAY_FORWARD_ROWS_MAX];
+	/** Fixed headers of rows referenced by forward_iov. */
+	char forward_fixheader[RELAY_FORWARD_ROWS_MAX]
+			      [RELAY_FORWARD_FIXHEADER_SIZE];
+	/** Number of rows referenced by forward_iov. */
+	int forward_row_count;
 	/** Vclock to stop playing xlogs */
 	struct vclock stop_vclock;
 	/** Remote replica */
@@ -126,6 +168,12 @@ struct relay {
 	struct diag diag;
 	/** Vclock recieved from replica. */
 	struct vclock recv_vclock;
+	/**
+	 * Monotonic time when the replica is known to have heard
+	 * from this instance last time, according to the timestamp
+	 * echoed in its acks. 0 if the replica doesn't echo it.
+	 */
+	double echo_time;
 	/** Replicatoin slave version. */
 	uint32_t version_id;
 	/**
@@ -135,6 +183,23 @@ struct relay {
 	 * is passed by the replica on subscribe.
 	 */
 	uint32_t id_filter;
+	/**
+	 * Sorted ids of user spaces the replica subscribed to, or
+	 * NULL if it needs all spaces. DML rows of other user
+	 * spaces are relayed as NOPs. Passed by the replica on
+	 * subscribe.
+	 */
+	uint32_t *space_filter;
+	/** Number of ids in space_filter. */
+	uint32_t space_filter_size;
+	/**
+	 * Id of the join the replica may attach additional streams
+	 * to, or 0. Sent to the replica before the first row of a
+	 * user space and reset then, see relay_initial_join().
+	 */
+	uint32_t join_id;
+	/** Number of streams the replica may use for the join. */
+	uint32_t join_streams;
 	/**
 	 * How many rows has this relay sent to the replica. Used to yield once
 	 * in a while when reading a WAL to unblock the event loop.
@@ -161,6 +226,8 @@ struct relay {
 	struct stailq pending_gc;
 	/** Time when last row was sent to peer. */
 	double last_row_time;
+	/** Rows and bytes sent to peer, see enum replication_stat. */
+	struct rmean *rmean;
 	/**
 	 * A time difference between the moment when we
 	 * wrote a transaction to the local WAL and when
@@ -182,6 +249,8 @@ struct relay {
 		 * from TX thread only.
 		 */
 		double txn_lag;
+		/** Histogram of txn_lag values. */
+		struct latency lag_latency;
 		/**
 		 * True if the relay needs Raft updates. It can live fine
 		 * without sending Raft updates, if it is a relay to an
@@ -239,12 +308,28 @@ relay_txn_lag(const struct relay *relay)
 	return relay->tx.txn_lag;
 }
 
+struct latency *
+relay_lag_latency(struct relay *relay)
+{
+	return &relay->tx.lag_latency;
+}
+
+struct rmean *
+relay_rmean(struct relay *relay)
+{
+	return relay->rmean;
+}
+
 static void
 relay_send(struct relay *relay, struct xrow_header *packet);
 static void
 relay_send_initial_join_row(struct xstream *stream, struct xrow_header *row);
 static void
 relay_send_row(struct xstream *stream, struct xrow_header *row);
+static bool
+relay_row_is_needed(struct relay *relay, struct xrow_header *packet);
+static bool
+relay_row_is_filtered(struct relay *relay, struct xrow_header *packet);
 
 struct relay *
 relay_new(struct replica *replica)
@@ -273,6 +358,21 @@ relay_new(struct replica *replica)
 	assert(relay != NULL);
 
 	memset(relay, 0, sizeof(struct relay));
+	relay->rmean = rmean_new(replication_stat_strings,
+				 REPLICATION_STAT_LAST);
+	if (relay->rmean == NULL) {
+		diag_set(OutOfMemory, sizeof(struct rmean), "rmean_new",
+			 "struct rmean");
+		free(relay);
+		return NULL;
+	}
+	if (latency_create(&relay->tx.lag_latency) != 0) {
+		diag_set(OutOfMemory, 0, "latency_create",
+			 "struct latency");
+		rmean_delete(relay->rmean);
+		free(relay);
+		return NULL;
+	}
 	relay->replica = replica;
 	relay->last_row_time = ev_monotonic_now(loop());
 	fiber_cond_create(&relay->reader_cond);
@@ -303,9 +403,11 @@ relay_start(struct relay *relay, struct iostream *io, uint64_t sync,
 	diag_clear(&relay->diag);
 	relay->io = io;
 	relay->sync = sync;
+	relay->forward_row_count = 0;
 	relay->state = RELAY_FOLLOW;
 	relay->row_count = 0;
 	relay->last_row_time = ev_monotonic_now(loop());
+	relay->echo_time = 0;
 }
 
 void
@@ -348,6 +450,9 @@ relay_stop(struct relay *relay)
 		free(gc_msg);
 	}
 	stailq_create(&relay->pending_gc);
+	free(relay->space_filter);
+	relay->space_filter = NULL;
+	relay->space_filter_size = 0;
 	relay->io = NULL;
 	if (relay->r != NULL)
 		recovery_delete(relay->r);
@@ -374,6 +479,8 @@ relay_delete(struct relay *relay)
 		relay_stop(relay);
 	fiber_cond_destroy(&relay->reader_cond);
 	diag_destroy(&relay->diag);
+	latency_destroy(&relay->tx.lag_latency);
+	rmean_delete(relay->rmean);
 	TRASH(relay);
 	free(relay);
 }
@@ -393,9 +500,64 @@ relay_set_cord_name(int fd)
 	cord_set_name(name);
 }
 
+/**
+ * An initial join sending a read view over several streams. The
+ * main stream registers the join so that additional streams opened
+ * by the replica can find it and send their parts of the read view.
+ */
+struct relay_join {
+	/** Link in relay_joins. */
+	struct rlist in_joins;
+	/** Id of the join, unique among all joins. */
+	uint32_t id;
+	/** UUID of the joining replica. */
+	struct tt_uuid instance_uuid;
+	/** Read view sent to the replica. */
+	struct engine_join_ctx *ctx;
+	/** Number of additional streams sending the read view. */
+	int stream_count;
+	/** Signaled when an additional stream is done. */
+	struct fiber_cond stream_cond;
+};
+
+/** Joins additional streams can be attached to. */
+static RLIST_HEAD(relay_joins);
+
+/** Id of the last registered join. */
+static uint32_t relay_last_join_id;
+
+static struct relay_join *
+relay_join_by_id(uint32_t id)
+{
+	struct relay_join *join;
+	rlist_foreach_entry(join, &relay_joins, in_joins) {
+		if (join->id == id)
+			return join;
+	}
+	return NULL;
+}
+
+/**
+ * Wait until all additional streams of a join are done. Preserves
+ * the fiber diagnostics area as it may be called while an error
+ * is being raised.
+ */
+static void
+relay_join_wait_streams(struct relay_join *join)
+{
+	struct diag diag;
+	diag_create(&diag);
+	diag_move(diag_get(), &diag);
+	while (join->stream_count > 0)
+		fiber_cond_wait(&join->stream_cond);
+	diag_move(&diag, diag_get());
+	diag_destroy(&diag);
+}
+
 void
 relay_initial_join(struct iostream *io, uint64_t sync, struct vclock *vclock,
-		   uint32_t replica_version_id)
+		   uint32_t replica_version_id,
+		   const struct tt_uuid *instance_uuid, uint32_t join_streams)
 {
 	struct relay *relay = relay_new(NULL);
 	if (relay == NULL)
@@ -414,6 +576,38 @@ relay_initial_join(struct iostream *io, uint64_t sync, struct vclock *vclock,
 		engine_complete_join(&ctx);
 	});
 
+	/*
+	 * Let the replica open additional streams. Only replicas
+	 * aware of the metadata stage can be told to do that.
+	 */
+	if (replica_version_id == 0)
+		join_streams = 1;
+	join_streams = MIN(join_streams,
+			   (uint32_t)REPLICATION_JOIN_STREAMS_MAX);
+	struct relay_join join;
+	join.id = 0;
+	if (join_streams > 1) {
+		join.id = ++relay_last_join_id;
+		if (join.id == 0)
+			join.id = ++relay_last_join_id;
+		join.instance_uuid = *instance_uuid;
+		join.ctx = &ctx;
+		join.stream_count = 0;
+		fiber_cond_create(&join.stream_cond);
+		rlist_add_entry(&relay_joins, &join, in_joins);
+	}
+	/*
+	 * The read view must not be released while additional
+	 * streams are still sending it.
+	 */
+	auto streams_guard = make_scoped_guard([&] {
+		if (join.id == 0)
+			return;
+		rlist_del_entry(&join, in_joins);
+		relay_join_wait_streams(&join);
+		fiber_cond_destroy(&join.stream_cond);
+	});
+
 	/*
 	 * Sync WAL to make sure that all changes visible from
 	 * the frozen read view are successfully committed and
@@ -462,10 +656,119 @@ relay_initial_join(struct iostream *io, uint64_t sync, struct vclock *vclock,
 		xstream_write(&relay->stream, &row);
 	}
 
+	/*
+	 * System spaces must be applied on the replica before any
+	 * user data so the replica is told to open additional
+	 * streams only after they have been sent.
+	 */
+	relay->join_id = join.id;
+	relay->join_streams = join_streams;
+
 	/* Send read view to the replica. */
 	engine_join_xc(&ctx, &relay->stream);
 }
 
+void
+relay_initial_join_stream(struct iostream *io, uint64_t sync,
+			  const struct tt_uuid *instance_uuid,
+			  uint32_t join_id)
+{
+	struct relay_join *join = relay_join_by_id(join_id);
+	if (join == NULL) {
+		/*
+		 * The main stream has already sent the rest of
+		 * the read view or failed. Either way, there's
+		 * nothing to send.
+		 */
+		return;
+	}
+	if (!tt_uuid_is_equal(&join->instance_uuid, instance_uuid)) {
+		tnt_raise(ClientError, ER_PROTOCOL,
+			  "Join stream belongs to another replica");
+	}
+	struct relay *relay = relay_new(NULL);
+	if (relay == NULL)
+		diag_raise();
+
+	relay_start(relay, io, sync, relay_send_initial_join_row);
+	join->stream_count++;
+	auto relay_guard = make_scoped_guard([=] {
+		relay_stop(relay);
+		relay_delete(relay);
+		join->stream_count--;
+		fiber_cond_signal(&join->stream_cond);
+	});
+	engine_join_parallel_xc(join->ctx, &relay->stream);
+}
+
+/** Arguments of relay_send_file_f(). */
+struct relay_send_file_ctx {
+	/** Replica connection. */
+	struct iostream *io;
+	/** File to send. */
+	int fd;
+	/** Number of bytes to send. */
+	size_t size;
+};
+
+/**
+ * Send a file to the replica. Runs in a separate thread so as
+ * not to block the tx thread on disk reads.
+ */
+static int
+relay_send_file_f(va_list ap)
+{
+	struct relay_send_file_ctx *ctx =
+		va_arg(ap, struct relay_send_file_ctx *);
+	coio_enable();
+	relay_set_cord_name(ctx->io->fd);
+	if (coio_sendfile(ctx->io, ctx->fd, 0, ctx->size) < 0)
+		return -1;
+	return 0;
+}
+
+void
+relay_initial_join_checkpoint(struct iostream *io, uint64_t sync,
+			      const char *filename,
+			      const struct vclock *vclock)
+{
+	int fd = open(filename, O_RDONLY);
+	if (fd < 0)
+		tnt_raise(SystemError, "failed to open '%s'", filename);
+	auto fd_guard = make_scoped_guard([=] { close(fd); });
+	struct stat st;
+	if (fstat(fd, &st) < 0)
+		tnt_raise(SystemError, "failed to stat '%s'", filename);
+
+	/* Respond to the JOIN request with the checkpoint vclock. */
+	struct xrow_header row;
+	xrow_encode_vclock_xc(&row, vclock);
+	row.sync = sync;
+	coio_write_xrow(io, &row);
+	/*
+	 * Raft and limbo state is stored in the checkpoint so the
+	 * metadata stream is empty. The end of the stream tells
+	 * the replica the size of the file following it.
+	 */
+	xrow_encode_type(&row, IPROTO_JOIN_META);
+	row.sync = sync;
+	coio_write_xrow(io, &row);
+	xrow_encode_join_snapshot_xc(&row, st.st_size, 1, 0);
+	row.sync = sync;
+	coio_write_xrow(io, &row);
+
+	struct relay_send_file_ctx ctx;
+	ctx.io = io;
+	ctx.fd = fd;
+	ctx.size = st.st_size;
+	struct cord cord;
+	int rc = cord_costart(&cord, "join_file", relay_send_file_f, &ctx);
+	if (rc == 0)
+		rc = cord_cojoin(&cord);
+	if (rc != 0)
+		diag_raise();
+}
+
 int
 relay_final_join_f(va_list ap)
 {
@@ -539,6 +842,13 @@ static void
 tx_status_update(struct cmsg *msg)
 {
 	struct relay_status_msg *status = (struct relay_status_msg *)msg;
+	/*
+	 * The status is also sent when the replica acknowledges
+	 * nothing new, don't account the same lag twice then.
+	 */
+	if (vclock_sum(&status->vclock) > vclock_sum(&status->relay->tx.vclock))
+		latency_collect(&status->relay->tx.lag_latency,
+				status->txn_lag);
 	vclock_copy(&status->relay->tx.vclock, &status->vclock);
 	status->relay->tx.txn_lag = status->txn_lag;
 
@@ -552,11 +862,18 @@ tx_status_update(struct cmsg *msg)
 	 * collected only by the transactions originator (which is
 	 * the single master in 100% so far). Other instances wait
 	 * for master's CONFIRM message instead.
+	 *
+	 * A replica that subscribed to a subset of spaces may not
+	 * store the rows of a synchronous transaction, so it doesn't
+	 * participate in the quorum.
 	 */
-	if (txn_limbo.owner_id == instance_id && !anon) {
+	if (txn_limbo.owner_id == instance_id && !anon &&
+	    status->relay->space_filter == NULL) {
 		txn_limbo_ack(&txn_limbo, ack.source,
 			      vclock_get(ack.vclock, instance_id));
 	}
+	if (!anon)
+		raft_process_ack(box_raft(), ack.source, status->ack_time);
 	trigger_run(&replicaset.on_ack, &ack);
 
 	static const struct cmsg_hop route[] = {
@@ -577,17 +894,20 @@ tx_gc_advance(struct cmsg *msg)
 	free(m);
 }
 
-static int
-relay_on_close_log_f(struct trigger *trigger, void * /* event */)
+/**
+ * Queue a request to advance the replica gc state to the current
+ * recovery vclock.
+ */
+static void
+relay_push_gc_msg(struct relay *relay)
 {
 	static const struct cmsg_hop route[] = {
 		{tx_gc_advance, NULL}
 	};
-	struct relay *relay = (struct relay *)trigger->data;
 	struct relay_gc_msg *m = (struct relay_gc_msg *)malloc(sizeof(*m));
 	if (m == NULL) {
 		say_warn("failed to allocate relay gc message");
-		return 0;
+		return;
 	}
 	cmsg_init(&m->msg, route);
 	m->relay = relay;
@@ -598,6 +918,12 @@ relay_on_close_log_f(struct trigger *trigger, void * /* event */)
 	 * sent xlog.
 	 */
 	stailq_add_tail_entry(&relay->pending_gc, m, in_pending);
+}
+
+static int
+relay_on_close_log_f(struct trigger *trigger, void * /* event */)
+{
+	relay_push_gc_msg((struct relay *)trigger->data);
 	return 0;
 }
 
@@ -642,6 +968,183 @@ relay_set_error(struct relay *relay, struct error *e)
 		diag_set_error(&relay->diag, e);
 }
 
+/**
+ * Recreate the recovery so that it reads WAL files starting from
+ * the given vclock. The WAL file open by the old recovery, if any,
+ * is closed.
+ */
+static void
+relay_reset_recovery(struct relay *relay, const struct vclock *vclock)
+{
+	struct recovery *r = recovery_new(wal_dir(), false, vclock);
+	rlist_swap(&relay->r->on_close_log, &r->on_close_log);
+	recovery_delete(relay->r);
+	relay->r = r;
+}
+
+/**
+ * Check if rows read from the WAL ring can be sent as they are
+ * stored in the ring, without encoding them again.
+ */
+static bool
+relay_can_forward(struct relay *relay)
+{
+	/* Rows are stored in the ring without sync. */
+	if (relay->sync != 0)
+		return false;
+	/* Let error injections work with every row. */
+	struct errinj *inj = errinj(ERRINJ_RELAY_SEND_DELAY, ERRINJ_BOOL);
+	if (inj != NULL && inj->bparam)
+		return false;
+	inj = errinj(ERRINJ_RELAY_TIMEOUT, ERRINJ_DOUBLE);
+	if (inj != NULL && inj->dparam > 0)
+		return false;
+	inj = errinj(ERRINJ_RELAY_BREAK_LSN, ERRINJ_INT);
+	if (inj != NULL && inj->iparam >= 0)
+		return false;
+	return true;
+}
+
+/** Send the rows queued by relay_forward_row(). */
+static void
+relay_flush_forward(struct relay *relay)
+{
+	if (relay->forward_row_count == 0)
+		return;
+	int row_count = relay->forward_row_count;
+	relay->forward_row_count = 0;
+	relay->last_row_time = ev_monotonic_now(loop());
+	ssize_t size = coio_writev(relay->io, relay->forward_iov,
+				   2 * row_count, 0);
+	if (size < 0)
+		diag_raise();
+	rmean_collect(relay->rmean, REPLICATION_STAT_ROWS, row_count);
+	rmean_collect(relay->rmean, REPLICATION_STAT_BYTES, size);
+}
+
+/**
+ * Queue a row read from the WAL ring to be sent as it is stored in
+ * the ring. The row data must stay in relay::ring_buf until the
+ * queued rows are flushed with relay_flush_forward().
+ */
+static void
+relay_forward_row(struct relay *relay, const char *data, uint32_t len)
+{
+	if (relay->forward_row_count == RELAY_FORWARD_ROWS_MAX)
+		relay_flush_forward(relay);
+	int i = relay->forward_row_count++;
+	char *fixheader = relay->forward_fixheader[i];
+	fixheader[0] = 0xce; /* MP_UINT32 */
+	store_u32(fixheader + 1, mp_bswap_u32(len));
+	relay->forward_iov[2 * i].iov_base = fixheader;
+	relay->forward_iov[2 * i].iov_len = RELAY_FORWARD_FIXHEADER_SIZE;
+	relay->forward_iov[2 * i + 1].iov_base = (void *)data;
+	relay->forward_iov[2 * i + 1].iov_len = len;
+}
+
+/**
+ * Send rows stored in the WAL ring to the replica, starting from
+ * relay::ring_pos.
+ *
+ * Rows that the replica needs unchanged are sent as they are stored
+ * in the ring, in batches, without encoding them again. This makes
+ * an instance that relays rows received from another one, e.g. a hub
+ * feeding many replicas, forward them almost as cheaply as a proxy.
+ *
+ * @retval 0 All rows stored in the ring have been sent.
+ * @retval -1 Some of the rows the replica needs have already been
+ *            discarded from the ring.
+ */
+static int
+relay_send_ring(struct relay *relay, struct xrow_ring *ring)
+{
+	while (true) {
+		ibuf_reset(&relay->ring_buf);
+		int count = xrow_ring_read(ring, &relay->ring_pos,
+					   &relay->ring_buf,
+					   RELAY_RING_READ_SIZE);
+		if (count < 0) {
+			/* Out of memory: fall back on reading files. */
+			diag_clear(diag_get());
+			return -1;
+		}
+		if (count == 0)
+			return 0;
+		bool can_forward = relay_can_forward(relay);
+		const char *data = relay->ring_buf.rpos;
+		for (int i = 0; i < count; i++) {
+			struct xrow_header row;
+			uint32_t len;
+			const char *raw = xrow_ring_row_data(data, &len);
+			if (xrow_ring_decode(&row, &data) != 0)
+				diag_raise();
+			relay->stream.row_count++;
+			if (relay->stream.row_count % WAL_ROWS_PER_YIELD == 0) {
+				relay_flush_forward(relay);
+				xstream_yield(&relay->stream);
+			}
+			/* Skip rows already read from WAL files. */
+			struct vclock *vclock = &relay->r->vclock;
+			if (row.lsn <= vclock_get(vclock, row.replica_id))
+				continue;
+			vclock_follow_xrow(vclock, &row);
+			if (!relay_row_is_needed(relay, &row))
+				continue;
+			if (can_forward && row.group_id != GROUP_LOCAL &&
+			    !relay_row_is_filtered(relay, &row)) {
+				relay_forward_row(relay, raw, len);
+				continue;
+			}
+			relay_flush_forward(relay);
+			xstream_write_xc(&relay->stream, &row);
+		}
+		/* The rows are about to be overwritten. */
+		relay_flush_forward(relay);
+	}
+}
+
+/**
+ * Send rows written to the WAL since the last call. The rows are
+ * read from the WAL ring while the relay keeps up with the WAL
+ * writer and from WAL files otherwise.
+ */
+static void
+relay_recover_wals(struct relay *relay, bool scan_dir)
+{
+	struct xrow_ring *ring = wal_ring();
+	if (relay->ring_pos >= 0) {
+		assert(ring != NULL);
+		if (relay_send_ring(relay, ring) == 0)
+			return;
+		say_verbose("relay fell behind the WAL ring, "
+			    "reading WAL files");
+		relay->ring_pos = -1;
+		scan_dir = true;
+	}
+	recover_remaining_wals(relay->r, &relay->stream, NULL, scan_dir);
+	uint32_t replica_id = relay->replica != NULL ?
+			      relay->replica->id : REPLICA_ID_NIL;
+	if (ring == NULL ||
+	    xrow_ring_seek(ring, &relay->r->vclock, replica_id,
+			   &relay->ring_pos) != 0) {
+		relay->ring_pos = -1;
+		return;
+	}
+	say_verbose("relay caught up with the WAL ring");
+	/*
+	 * The ring stores all rows following the ones read from
+	 * WAL files so we don't need the current file anymore.
+	 * Close it so that it can be removed by garbage collection.
+	 * Rows skipped by the recovery are skipped when read from
+	 * the ring, because the recovery vclock is preserved.
+	 */
+	relay_reset_recovery(relay, &relay->r->vclock);
+	if (relay_send_ring(relay, ring) != 0) {
+		relay->ring_pos = -1;
+		recover_remaining_wals(relay->r, &relay->stream, NULL, true);
+	}
+}
+
 static void
 relay_process_wal_event(struct wal_watcher *watcher, unsigned events)
 {
@@ -659,8 +1162,15 @@ relay_process_wal_event(struct wal_watcher *watcher, unsigned events)
 		return;
 	}
 	try {
-		recover_remaining_wals(relay->r, &relay->stream, NULL,
-				       (events & WAL_EVENT_ROTATE) != 0);
+		relay_recover_wals(relay, (events & WAL_EVENT_ROTATE) != 0);
+		/*
+		 * WAL files aren't closed while rows are read from
+		 * the ring so let the garbage collector know about
+		 * the progress on rotation instead.
+		 */
+		if ((events & WAL_EVENT_ROTATE) != 0 && relay->ring_pos >= 0 &&
+		    !relay->replica->anon)
+			relay_push_gc_msg(relay);
 	} catch (Exception *e) {
 		relay_set_error(relay, e);
 		fiber_cancel(fiber());
@@ -684,7 +1194,21 @@ relay_reader_f(va_list ap)
 			struct xrow_header xrow;
 			coio_read_xrow_timeout_xc(relay->io, &ibuf, &xrow,
 					replication_disconnect_timeout());
-			xrow_decode_vclock_xc(&xrow, &relay->recv_vclock);
+			double echo_tm;
+			xrow_decode_ack_xc(&xrow, &relay->recv_vclock,
+					   &echo_tm);
+			/*
+			 * The replica echoes the realtime timestamp of
+			 * the latest heartbeat or row of ours it got.
+			 * It was set before the packet was sent, so the
+			 * replica heard from us at that moment or later.
+			 * Translate it to the monotonic clock.
+			 */
+			if (echo_tm != 0) {
+				double age = ev_now(loop()) - echo_tm;
+				relay->echo_time = ev_monotonic_now(loop()) -
+						   MAX(age, 0);
+			}
 			/*
 			 * Replica send us last replicated transaction
 			 * timestamp which is needed for relay lag
@@ -840,6 +1364,8 @@ relay_subscribe_f(va_list ap)
 	if (!relay->replica->anon)
 		trigger_add(&relay->r->on_close_log, &on_close_log);
 
+	ibuf_create(&relay->ring_buf, &cord()->slabc, RELAY_RING_READ_SIZE);
+
 	/* Setup WAL watcher for sending new rows to the replica. */
 	wal_set_watcher(&relay->wal_watcher, relay->endpoint.name,
 			relay_process_wal_event, cbus_process);
@@ -897,8 +1423,13 @@ relay_subscribe_f(va_list ap)
 		/* Collect xlog files received by the replica. */
 		relay_schedule_pending_gc(relay, send_vclock);
 
+		/*
+		 * Acks are reported even if the vclock is the same,
+		 * the leader needs them to prolong its lease.
+		 */
 		if (vclock_sum(&relay->status_msg.vclock) ==
-		    vclock_sum(send_vclock))
+		    vclock_sum(send_vclock) &&
+		    relay->status_msg.ack_time == relay->echo_time)
 			continue;
 		static const struct cmsg_hop route[] = {
 			{tx_status_update, NULL}
@@ -906,6 +1437,7 @@ relay_subscribe_f(va_list ap)
 		cmsg_init(&relay->status_msg.msg, route);
 		vclock_copy(&relay->status_msg.vclock, send_vclock);
 		relay->status_msg.txn_lag = relay->txn_lag;
+		relay->status_msg.ack_time = relay->echo_time;
 		relay->status_msg.relay = relay;
 		cpipe_push(&relay->tx_pipe, &relay->status_msg.msg);
 	}
@@ -920,6 +1452,7 @@ relay_subscribe_f(va_list ap)
 	 */
 	trigger_clear(&on_close_log);
 	wal_clear_watcher(&relay->wal_watcher, cbus_process);
+	ibuf_destroy(&relay->ring_buf);
 
 	/* Join ack reader fiber. */
 	fiber_cancel(reader);
@@ -948,7 +1481,8 @@ relay_subscribe_f(va_list ap)
 void
 relay_subscribe(struct replica *replica, struct iostream *io, uint64_t sync,
 		struct vclock *replica_clock, uint32_t replica_version_id,
-		uint32_t replica_id_filter)
+		uint32_t replica_id_filter, const uint32_t *space_filter,
+		uint32_t space_filter_size)
 {
 	assert(replica->anon || replica->id != REPLICA_ID_NIL);
 	struct relay *relay = replica->relay;
@@ -980,10 +1514,20 @@ relay_subscribe(struct replica *replica, struct iostream *io, uint64_t sync,
 	 */
 	vclock_copy(&relay->recv_vclock, replica_clock);
 	relay->r = recovery_new(wal_dir(), false, replica_clock);
+	relay->ring_pos = -1;
 	vclock_copy(&relay->tx.vclock, replica_clock);
 	relay->version_id = replica_version_id;
 
 	relay->id_filter = replica_id_filter;
+	if (space_filter_size > 0) {
+		relay->space_filter = (uint32_t *)xcalloc(
+			space_filter_size, sizeof(*space_filter));
+		std::copy(space_filter, space_filter + space_filter_size,
+			  relay->space_filter);
+		std::sort(relay->space_filter,
+			  relay->space_filter + space_filter_size);
+		relay->space_filter_size = space_filter_size;
+	}
 
 	int rc = cord_costart(&relay->cord, "subscribe",
 			      relay_subscribe_f, relay);
@@ -1000,7 +1544,9 @@ relay_send(struct relay *relay, struct xrow_header *packet)
 
 	packet->sync = relay->sync;
 	relay->last_row_time = ev_monotonic_now(loop());
-	coio_write_xrow(relay->io, packet);
+	size_t size = coio_write_xrow(relay->io, packet);
+	rmean_collect(relay->rmean, REPLICATION_STAT_ROWS, 1);
+	rmean_collect(relay->rmean, REPLICATION_STAT_BYTES, size);
 	fiber_gc();
 
 	struct errinj *inj = errinj(ERRINJ_RELAY_TIMEOUT, ERRINJ_DOUBLE);
@@ -1016,8 +1562,19 @@ relay_send_initial_join_row(struct xstream *stream, struct xrow_header *row)
 	 * Ignore replica local requests as we don't need to promote
 	 * vclock while sending a snapshot.
 	 */
-	if (row->group_id != GROUP_LOCAL)
-		relay_send(relay, row);
+	if (row->group_id == GROUP_LOCAL)
+		return;
+	uint32_t space_id;
+	if (relay->join_id != 0 && iproto_type_is_dml(row->type) &&
+	    xrow_decode_space_id(row, &space_id) == 0 &&
+	    space_id >= BOX_SYSTEM_ID_MAX) {
+		struct xrow_header marker;
+		xrow_encode_join_snapshot_xc(&marker, 0, relay->join_streams,
+					     relay->join_id);
+		relay->join_id = 0;
+		relay_send(relay, &marker);
+	}
+	relay_send(relay, row);
 }
 
 /**
@@ -1050,11 +1607,9 @@ relay_restart_recovery(struct relay *relay)
 	struct vclock restart_vclock;
 	vclock_copy(&restart_vclock, &relay->recv_vclock);
 	vclock_reset(&restart_vclock, 0, vclock_get(&relay->r->vclock, 0));
-	struct recovery *r = recovery_new(wal_dir(), false, &restart_vclock);
-	rlist_swap(&relay->r->on_close_log, &r->on_close_log);
-	recovery_delete(relay->r);
-	relay->r = r;
-	recover_remaining_wals(relay->r, &relay->stream, NULL, true);
+	relay_reset_recovery(relay, &restart_vclock);
+	relay->ring_pos = -1;
+	relay_recover_wals(relay, true);
 }
 
 /**
@@ -1115,32 +1670,43 @@ relay_push_raft(struct relay *relay, const struct raft_request *req)
 	relay_push_raft_msg(relay);
 }
 
-/** Send a single row to the client. */
-static void
-relay_send_row(struct xstream *stream, struct xrow_header *packet)
+/**
+ * Check if a row must be relayed as a NOP because it belongs to
+ * a user space the replica didn't subscribe to. System spaces
+ * are always relayed so that the replica has the same schema.
+ */
+static bool
+relay_row_is_filtered(struct relay *relay, struct xrow_header *packet)
 {
-	struct relay *relay = container_of(stream, struct relay, stream);
-	if (packet->group_id == GROUP_LOCAL) {
-		/*
-		 * We do not relay replica-local rows to other
-		 * instances, since we started signing them with
-		 * a zero instance id. However, if replica-local
-		 * rows, signed with a non-zero id are present in
-		 * our WAL, we still need to relay them as NOPs in
-		 * order to correctly promote the vclock on the
-		 * replica.
-		 */
-		if (packet->replica_id == REPLICA_ID_NIL)
-			return;
-		packet->type = IPROTO_NOP;
-		packet->group_id = GROUP_DEFAULT;
-		packet->bodycnt = 0;
+	if (relay->space_filter == NULL || !iproto_type_is_dml(packet->type))
+		return false;
+	uint32_t space_id;
+	if (xrow_decode_space_id(packet, &space_id) != 0) {
+		/* Let the replica report the malformed row. */
+		diag_clear(diag_get());
+		return false;
 	}
-	assert(iproto_type_is_dml(packet->type) ||
-	       iproto_type_is_synchro_request(packet->type));
+	if (space_id < BOX_SYSTEM_ID_MAX)
+		return false;
+	return !std::binary_search(relay->space_filter,
+				   relay->space_filter +
+				   relay->space_filter_size, space_id);
+}
+
+/** Check if a row read from the WAL must be sent to the client. */
+static bool
+relay_row_is_needed(struct relay *relay, struct xrow_header *packet)
+{
+	/*
+	 * We do not relay replica-local rows to other instances,
+	 * since we started signing them with a zero instance id.
+	 */
+	if (packet->group_id == GROUP_LOCAL &&
+	    packet->replica_id == REPLICA_ID_NIL)
+		return false;
 	/* Check if the rows from the instance are filtered. */
 	if ((1 << packet->replica_id & relay->id_filter) != 0)
-		return;
+		return false;
 	/*
 	 * We're feeding a WAL, thus responding to FINAL JOIN or SUBSCRIBE
 	 * request. If this is FINAL JOIN (i.e. relay->replica is NULL),
@@ -1153,18 +1719,45 @@ relay_send_row(struct xstream *stream, struct xrow_header *packet)
 	 * it). In the latter case packet's LSN is less than or equal to
 	 * local master's LSN at the moment it received 'SUBSCRIBE' request.
 	 */
-	if (relay->replica == NULL ||
-	    packet->replica_id != relay->replica->id ||
-	    packet->lsn <= vclock_get(&relay->local_vclock_at_subscribe,
-				      packet->replica_id)) {
-		struct errinj *inj = errinj(ERRINJ_RELAY_BREAK_LSN,
-					    ERRINJ_INT);
-		if (inj != NULL && packet->lsn == inj->iparam) {
-			packet->lsn = inj->iparam - 1;
-			packet->tsn = packet->lsn;
-			say_warn("injected broken lsn: %lld",
-				 (long long) packet->lsn);
-		}
-		relay_send(relay, packet);
+	return relay->replica == NULL ||
+	       packet->replica_id != relay->replica->id ||
+	       packet->lsn <= vclock_get(&relay->local_vclock_at_subscribe,
+					 packet->replica_id);
+}
+
+/** Send a single row to the client. */
+static void
+relay_send_row(struct xstream *stream, struct xrow_header *packet)
+{
+	struct relay *relay = container_of(stream, struct relay, stream);
+	if (!relay_row_is_needed(relay, packet))
+		return;
+	if (packet->group_id == GROUP_LOCAL) {
+		/*
+		 * If replica-local rows, signed with a non-zero id
+		 * are present in our WAL, we still need to relay
+		 * them as NOPs in order to correctly promote the
+		 * vclock on the replica.
+		 */
+		packet->type = IPROTO_NOP;
+		packet->group_id = GROUP_DEFAULT;
+		packet->bodycnt = 0;
+	} else if (relay_row_is_filtered(relay, packet)) {
+		/*
+		 * Rows of spaces the replica doesn't need are
+		 * relayed as NOPs to promote its vclock.
+		 */
+		packet->type = IPROTO_NOP;
+		packet->bodycnt = 0;
+	}
+	assert(iproto_type_is_dml(packet->type) ||
+	       iproto_type_is_synchro_request(packet->type));
+	struct errinj *inj = errinj(ERRINJ_RELAY_BREAK_LSN, ERRINJ_INT);
+	if (inj != NULL && packet->lsn == inj->iparam) {
+		packet->lsn = inj->iparam - 1;
+		packet->tsn = packet->lsn;
+		say_warn("injected broken lsn: %lld",
+			 (long long) packet->lsn);
 	}
+	relay_send(relay, packet);
 }
@@ -38,8 +38,10 @@ extern "C" {
 #endif /* defined(__cplusplus) */
 
 struct iostream;
+struct latency;
 struct relay;
 struct replica;
+struct rmean;
 struct tt_uuid;
 struct vclock;
 
@@ -100,6 +102,20 @@ relay_last_row_time(const struct relay *relay);
 double
 relay_txn_lag(const struct relay *relay);
 
+/**
+ * Returns the histogram of relay's transaction's lag values,
+ * collected every time the replica acknowledges new rows.
+ */
+struct latency *
+relay_lag_latency(struct relay *relay);
+
+/**
+ * Returns rows and bytes sent by the relay, see enum
+ * replication_stat.
+ */
+struct rmean *
+relay_rmean(struct relay *relay);
+
 /**
  * Send a Raft update request to the relay channel. It is not
  * guaranteed that it will be delivered. The connection may break.
@@ -118,10 +134,46 @@ relay_push_raft(struct relay *relay, const struct raft_request *req);
  * @param sync      sync from incoming JOIN request
  * @param vclock[out] vclock of the read view sent to the replica
  * @param replica_version_id peer's version
+ * @param instance_uuid UUID of the replica
+ * @param join_streams number of streams the replica can receive
+ *                  the rows over, see relay_initial_join_stream()
  */
 void
 relay_initial_join(struct iostream *io, uint64_t sync, struct vclock *vclock,
-		   uint32_t replica_version_id);
+		   uint32_t replica_version_id,
+		   const struct tt_uuid *instance_uuid, uint32_t join_streams);
+
+/**
+ * Send a part of initial JOIN rows to the replica over an
+ * additional stream. The rows are split between the stream and
+ * the main one, which is served by relay_initial_join(). Only
+ * engines supporting ENGINE_JOIN_PARALLEL send rows over
+ * additional streams.
+ *
+ * @param io        client connection
+ * @param sync      sync from incoming JOIN request
+ * @param instance_uuid UUID of the replica
+ * @param join_id   id of the join sent over the main stream
+ */
+void
+relay_initial_join_stream(struct iostream *io, uint64_t sync,
+			  const struct tt_uuid *instance_uuid,
+			  uint32_t join_id);
+
+/**
+ * Send a checkpoint file to the replica as is instead of initial
+ * JOIN rows. The replica loads the file as it would load its own
+ * checkpoint on recovery.
+ *
+ * @param io        client connection
+ * @param sync      sync from incoming JOIN request
+ * @param filename  memtx snapshot file of the checkpoint
+ * @param vclock    vclock of the checkpoint
+ */
+void
+relay_initial_join_checkpoint(struct iostream *io, uint64_t sync,
+			      const char *filename,
+			      const struct vclock *vclock);
 
 /**
  * Send final JOIN rows to the replica.
@@ -136,11 +188,16 @@ relay_final_join(struct iostream *io, uint64_t sync,
 /**
  * Subscribe a replica to updates.
  *
+ * If @a space_filter_size is not 0, only rows of the listed user
+ * spaces are sent, rows of other user spaces are replaced with
+ * NOPs.
+ *
  * @return none.
  */
 void
 relay_subscribe(struct replica *replica, struct iostream *io, uint64_t sync,
 		struct vclock *replica_vclock, uint32_t replica_version_id,
-		uint32_t replica_id_filter);
+		uint32_t replica_id_filter, const uint32_t *space_filter,
+		uint32_t space_filter_size);
 
 #endif /* TARANTOOL_REPLICATION_RELAY_H_INCLUDED */
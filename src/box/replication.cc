@@ -57,6 +57,17 @@ double replication_sync_timeout = 300.0; /* seconds */
 bool replication_skip_conflict = false;
 bool replication_anon = false;
 int replication_threads = 1;
+int replication_parallel_apply = 1;
+double replication_apply_budget = 0;
+bool replication_join_from_checkpoint = false;
+int replication_join_streams = 1;
+uint32_t *replication_space_filter = NULL;
+uint32_t replication_space_filter_size = 0;
+
+const char *replication_stat_strings[REPLICATION_STAT_LAST] = {
+	"rows",
+	"bytes",
+};
 
 struct replicaset replicaset;
 
@@ -123,6 +134,10 @@ replication_free(void)
 	trigger_destroy(&replicaset.on_ack);
 
 	applier_free();
+
+	free(replication_space_filter);
+	replication_space_filter = NULL;
+	replication_space_filter_size = 0;
 }
 
 int
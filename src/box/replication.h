@@ -100,6 +100,21 @@ static const int REPLICATION_CONNECT_QUORUM_ALL = INT_MAX;
 
 enum { REPLICATION_THREADS_MAX = 1000 };
 
+enum { REPLICATION_PARALLEL_APPLY_MAX = 1000 };
+
+enum { REPLICATION_JOIN_STREAMS_MAX = 32 };
+
+/** Counters collected for every upstream and downstream. */
+enum replication_stat {
+	/** Rows received or sent. */
+	REPLICATION_STAT_ROWS,
+	/** Bytes received or sent. */
+	REPLICATION_STAT_BYTES,
+	REPLICATION_STAT_LAST,
+};
+
+extern const char *replication_stat_strings[REPLICATION_STAT_LAST];
+
 /**
  * Network timeout. Determines how often master and slave exchange
  * heartbeat messages. Set by box.cfg.replication_timeout.
@@ -160,6 +175,42 @@ extern bool replication_anon;
 /** How many threads to use for decoding incoming replication stream. */
 extern int replication_threads;
 
+/**
+ * Max number of transactions received by an applier that may be
+ * applied concurrently, box.cfg.replication_parallel_apply.
+ */
+extern int replication_parallel_apply;
+
+/**
+ * Max time an applier may spend applying received transactions
+ * before it yields to let other fibers run, in seconds, or 0 if
+ * unlimited, box.cfg.replication_apply_budget.
+ */
+extern double replication_apply_budget;
+
+/**
+ * Whether to ask a master to send its last checkpoint file as is
+ * on join instead of initial data rows,
+ * box.cfg.replication_join_from_checkpoint.
+ */
+extern bool replication_join_from_checkpoint;
+
+/**
+ * Number of connections to receive the initial data over on join,
+ * box.cfg.replication_join_streams.
+ */
+extern int replication_join_streams;
+
+/**
+ * Ids of user spaces whose rows this instance fetches from
+ * masters, box.cfg.replication_space_filter. NULL if all spaces
+ * are fetched.
+ */
+extern uint32_t *replication_space_filter;
+
+/** Number of ids in replication_space_filter. */
+extern uint32_t replication_space_filter_size;
+
 /**
  * Wait for the given period of time before trying to reconnect
  * to a master.
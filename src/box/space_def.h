@@ -73,6 +73,13 @@ struct space_opts {
 	 * until replicated to a quorum of replicas.
 	 */
 	bool is_sync;
+	/**
+	 * Don't store offsets of indexed fields in tuples of this
+	 * space, see tuple_format::compact_field_map. Saves memory
+	 * per tuple at the cost of decoding the tuple on each
+	 * access to a secondary key.
+	 */
+	bool compact_field_map;
 	/** SQL statement that produced this space. */
 	char *sql;
 };
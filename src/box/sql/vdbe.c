@@ -44,6 +44,7 @@
 #include "box/fk_constraint.h"
 #include "box/txn.h"
 #include "box/tuple.h"
+#include "box/tuple_compression.h"
 #include "box/port.h"
 #include "sqlInt.h"
 #include "mem.h"
@@ -404,8 +405,19 @@ vdbe_field_ref_fetch(struct vdbe_field_ref *field_ref, uint32_t fieldno,
 	}
 	assert(sqlVdbeCheckMemInvariants(dest_mem) != 0);
 	const char *data = vdbe_field_ref_fetch_data(field_ref, fieldno);
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	if (field_ref->tuple != NULL) {
+		data = tuple_field_decompressed(tuple_format(field_ref->tuple),
+						fieldno, data, region);
+		if (data == NULL)
+			return -1;
+	}
 	uint32_t dummy;
-	if (mem_from_mp(dest_mem, data, &dummy) != 0)
+	/* Strings and blobs are copied so the region can be freed. */
+	int rc = mem_from_mp(dest_mem, data, &dummy);
+	region_truncate(region, region_svp);
+	if (rc != 0)
 		return -1;
 	UPDATE_MAX_BLOBSIZE(dest_mem);
 	return 0;
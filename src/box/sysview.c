@@ -546,7 +546,7 @@ sysview_engine_create_space(struct engine *engine, struct space_def *def,
 		tuple_format_new(NULL, NULL, keys, key_count, def->fields,
 				 def->field_count, def->exact_field_count,
 				 def->dict, def->opts.is_temporary,
-				 def->opts.is_ephemeral);
+				 def->opts.is_ephemeral, false);
 	if (format == NULL) {
 		free(space);
 		return NULL;
@@ -36,6 +36,7 @@
 #include "small/quota.h"
 #include "small/small.h"
 #include "xrow_update.h"
+#include "tuple_compression.h"
 #include "coll_id_cache.h"
 
 static struct mempool tuple_iterator_pool;
@@ -296,7 +297,7 @@ tuple_init(field_name_hash_f hash)
 	 */
 	tuple_format_runtime = tuple_format_new(&tuple_format_runtime_vtab, NULL,
 						NULL, 0, NULL, 0, 0, NULL, false,
-						false);
+						false, false);
 	if (tuple_format_runtime == NULL)
 		return -1;
 
@@ -568,7 +569,7 @@ box_tuple_format_new(struct key_def **keys, uint16_t key_count)
 	box_tuple_format_t *format =
 		tuple_format_new(&tuple_format_runtime_vtab, NULL,
 				 keys, key_count, NULL, 0, 0, NULL, false,
-				 false);
+				 false, false);
 	if (format != NULL)
 		tuple_format_ref(format);
 	return format;
@@ -606,11 +607,16 @@ box_tuple_bsize(box_tuple_t *tuple)
 ssize_t
 tuple_to_buf(struct tuple *tuple, char *buf, size_t size)
 {
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
 	uint32_t bsize;
-	const char *data = tuple_data_range(tuple, &bsize);
+	const char *data = tuple_data_decompressed(tuple, &bsize, region);
+	if (data == NULL)
+		return -1;
 	if (likely(bsize <= size)) {
 		memcpy(buf, data, bsize);
 	}
+	region_truncate(region, region_svp);
 	return bsize;
 }
 
@@ -632,7 +638,9 @@ const char *
 box_tuple_field(box_tuple_t *tuple, uint32_t fieldno)
 {
 	assert(tuple != NULL);
-	return tuple_field(tuple, fieldno);
+	return tuple_field_decompressed(tuple_format(tuple), fieldno,
+					tuple_field(tuple, fieldno),
+					&fiber()->gc);
 }
 
 typedef struct tuple_iterator box_tuple_iterator_t;
@@ -675,13 +683,16 @@ box_tuple_rewind(box_tuple_iterator_t *it)
 const char *
 box_tuple_seek(box_tuple_iterator_t *it, uint32_t fieldno)
 {
-	return tuple_seek(it, fieldno);
+	return tuple_field_decompressed(tuple_format(it->tuple), fieldno,
+					tuple_seek(it, fieldno), &fiber()->gc);
 }
 
 const char *
 box_tuple_next(box_tuple_iterator_t *it)
 {
-	return tuple_next(it);
+	uint32_t fieldno = it->fieldno;
+	return tuple_field_decompressed(tuple_format(it->tuple), fieldno,
+					tuple_next(it), &fiber()->gc);
 }
 
 box_tuple_t *
@@ -145,6 +145,8 @@ box_tuple_bsize(box_tuple_t *tuple);
  * Upon successful return, the function returns the number of bytes written.
  * If buffer size is not enough then the return value is the number of bytes
  * which would have been written if enough space had been available.
+ * Compressed field values are decompressed so the result may be longer
+ * than box_tuple_bsize().
  */
 ssize_t
 box_tuple_to_buf(box_tuple_t *tuple, char *buf, size_t size);
@@ -161,10 +163,12 @@ box_tuple_format(box_tuple_t *tuple);
  * Return the raw tuple field in MsgPack format.
  *
  * The buffer is valid until next call to box_tuple_* functions.
+ * A compressed field value is decompressed on the box region.
  *
  * \param tuple a tuple
  * \param fieldno zero-based index in MsgPack array.
- * \retval NULL if i >= box_tuple_field_count(tuple)
+ * \retval NULL if i >= box_tuple_field_count(tuple) or on
+ *         decompression error (diag is set)
  * \retval msgpack otherwise
  */
 const char *
@@ -474,6 +478,16 @@ tuple_is_unreferenced(struct tuple *tuple)
 	return tuple->local_refs == 0;
 }
 
+/**
+ * Check that the tuple has exactly one reference, i.e. it isn't
+ * shared by anyone but its owner (usually the space it's stored in).
+ */
+static inline bool
+tuple_has_single_ref(struct tuple *tuple)
+{
+	return tuple->local_refs == 1 && !tuple->has_uploaded_refs;
+}
+
 /** Check that the tuple is in compact mode. */
 static inline bool
 tuple_is_compact(struct tuple *tuple)
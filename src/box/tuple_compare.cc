@@ -504,10 +504,15 @@ tuple_compare_field(const char *field_a, const char *field_b,
 	}
 }
 
-static int
-tuple_compare_field_with_type(const char *field_a, enum mp_type a_type,
-			      const char *field_b, enum mp_type b_type,
-			      int8_t type, struct coll *coll)
+/**
+ * Inlined version of tuple_compare_field_with_type(). Used by
+ * comparators specialized by the field type, in which case the
+ * switch is folded by the compiler.
+ */
+static inline __attribute__((always_inline)) int
+tuple_compare_field_with_type_inline(const char *field_a, enum mp_type a_type,
+				     const char *field_b, enum mp_type b_type,
+				     int8_t type, struct coll *coll)
 {
 	switch (type) {
 	case FIELD_TYPE_UNSIGNED:
@@ -546,6 +551,16 @@ tuple_compare_field_with_type(const char *field_a, enum mp_type a_type,
 	}
 }
 
+static int
+tuple_compare_field_with_type(const char *field_a, enum mp_type a_type,
+			      const char *field_b, enum mp_type b_type,
+			      int8_t type, struct coll *coll)
+{
+	return tuple_compare_field_with_type_inline(field_a, a_type,
+						    field_b, b_type,
+						    type, coll);
+}
+
 template<bool is_nullable, bool has_optional_parts, bool has_json_paths,
 	 bool is_multikey>
 static inline int
@@ -1459,6 +1474,171 @@ func_index_compare_with_key(struct tuple *tuple, hint_t tuple_hint,
 
 /* }}} tuple_compare_with_key */
 
+/* {{{ tuple_compare_single_part */
+
+/**
+ * Compare two fields of a single-part key or a field and a key
+ * part. The field type is a template parameter so the type switch
+ * is resolved at compile time. Either field may be NULL if the key
+ * has optional parts, in which case it is treated as nil.
+ */
+template<enum field_type type, bool is_nullable, bool has_optional_parts>
+static inline int
+single_part_compare(const char *field_a, const char *field_b,
+		    struct coll *coll)
+{
+	assert(has_optional_parts || (field_a != NULL && field_b != NULL));
+	enum mp_type a_type = (has_optional_parts && field_a == NULL) ?
+			      MP_NIL : mp_typeof(*field_a);
+	enum mp_type b_type = (has_optional_parts && field_b == NULL) ?
+			      MP_NIL : mp_typeof(*field_b);
+	if (is_nullable) {
+		if (a_type == MP_NIL)
+			return b_type == MP_NIL ? 0 : -1;
+		else if (b_type == MP_NIL)
+			return 1;
+	}
+	return tuple_compare_field_with_type_inline(field_a, a_type,
+						    field_b, b_type,
+						    type, coll);
+}
+
+/**
+ * Comparator of tuples by a single-part key that doesn't use JSON
+ * paths. Unlike tuple_compare_slowpath(), it's specialized by the
+ * type of the key part, which makes it suitable for any key part
+ * type, nullability and collation.
+ */
+template<enum field_type type, bool is_nullable, bool has_optional_parts>
+static int
+tuple_compare_single_part(struct tuple *tuple_a, hint_t tuple_a_hint,
+			  struct tuple *tuple_b, hint_t tuple_b_hint,
+			  struct key_def *key_def)
+{
+	assert(key_def->part_count == 1);
+	assert(!key_def->has_json_paths);
+	assert(is_nullable == key_def->is_nullable);
+	assert(has_optional_parts == key_def->has_optional_parts);
+	assert(key_def->parts->type == type);
+	int rc = hint_cmp(tuple_a_hint, tuple_b_hint);
+	if (rc != 0)
+		return rc;
+	struct key_part *part = key_def->parts;
+	const char *field_a = tuple_field_raw(tuple_format(tuple_a),
+					      tuple_data(tuple_a),
+					      tuple_field_map(tuple_a),
+					      part->fieldno);
+	const char *field_b = tuple_field_raw(tuple_format(tuple_b),
+					      tuple_data(tuple_b),
+					      tuple_field_map(tuple_b),
+					      part->fieldno);
+	return single_part_compare<type, is_nullable, has_optional_parts>(
+			field_a, field_b, part->coll);
+}
+
+/**
+ * Same as tuple_compare_single_part(), but compares a tuple
+ * with a key.
+ */
+template<enum field_type type, bool is_nullable, bool has_optional_parts>
+static int
+tuple_compare_with_key_single_part(struct tuple *tuple, hint_t tuple_hint,
+				   const char *key, uint32_t part_count,
+				   hint_t key_hint, struct key_def *key_def)
+{
+	assert(key_def->part_count == 1);
+	assert(!key_def->has_json_paths);
+	assert(is_nullable == key_def->is_nullable);
+	assert(has_optional_parts == key_def->has_optional_parts);
+	assert(key_def->parts->type == type);
+	assert(key != NULL || part_count == 0);
+	assert(part_count <= 1);
+	int rc = hint_cmp(tuple_hint, key_hint);
+	if (rc != 0 || part_count == 0)
+		return rc;
+	struct key_part *part = key_def->parts;
+	const char *field = tuple_field_raw(tuple_format(tuple),
+					    tuple_data(tuple),
+					    tuple_field_map(tuple),
+					    part->fieldno);
+	return single_part_compare<type, is_nullable, has_optional_parts>(
+			field, key, part->coll);
+}
+
+template<enum field_type type>
+static void
+key_def_set_compare_func_single_part(struct key_def *def)
+{
+	if (def->is_nullable && def->has_optional_parts) {
+		def->tuple_compare =
+			tuple_compare_single_part<type, true, true>;
+		def->tuple_compare_with_key =
+			tuple_compare_with_key_single_part<type, true, true>;
+	} else if (def->is_nullable) {
+		def->tuple_compare =
+			tuple_compare_single_part<type, true, false>;
+		def->tuple_compare_with_key =
+			tuple_compare_with_key_single_part<type, true, false>;
+	} else {
+		assert(!def->has_optional_parts);
+		def->tuple_compare =
+			tuple_compare_single_part<type, false, false>;
+		def->tuple_compare_with_key =
+			tuple_compare_with_key_single_part<type, false, false>;
+	}
+}
+
+/**
+ * Set comparators specialized by the key part type for a key
+ * definition that consists of a single part without JSON path.
+ * Returns false if there's no specialization for the part type.
+ */
+static bool
+key_def_set_compare_func_single_part(struct key_def *def)
+{
+	assert(def->part_count == 1);
+	assert(!def->has_json_paths);
+	switch (def->parts->type) {
+	case FIELD_TYPE_BOOLEAN:
+		key_def_set_compare_func_single_part<FIELD_TYPE_BOOLEAN>(def);
+		return true;
+	case FIELD_TYPE_UNSIGNED:
+		key_def_set_compare_func_single_part<FIELD_TYPE_UNSIGNED>(def);
+		return true;
+	case FIELD_TYPE_INTEGER:
+		key_def_set_compare_func_single_part<FIELD_TYPE_INTEGER>(def);
+		return true;
+	case FIELD_TYPE_NUMBER:
+		key_def_set_compare_func_single_part<FIELD_TYPE_NUMBER>(def);
+		return true;
+	case FIELD_TYPE_DOUBLE:
+		key_def_set_compare_func_single_part<FIELD_TYPE_DOUBLE>(def);
+		return true;
+	case FIELD_TYPE_STRING:
+		key_def_set_compare_func_single_part<FIELD_TYPE_STRING>(def);
+		return true;
+	case FIELD_TYPE_VARBINARY:
+		key_def_set_compare_func_single_part<FIELD_TYPE_VARBINARY>(def);
+		return true;
+	case FIELD_TYPE_SCALAR:
+		key_def_set_compare_func_single_part<FIELD_TYPE_SCALAR>(def);
+		return true;
+	case FIELD_TYPE_DECIMAL:
+		key_def_set_compare_func_single_part<FIELD_TYPE_DECIMAL>(def);
+		return true;
+	case FIELD_TYPE_UUID:
+		key_def_set_compare_func_single_part<FIELD_TYPE_UUID>(def);
+		return true;
+	case FIELD_TYPE_DATETIME:
+		key_def_set_compare_func_single_part<FIELD_TYPE_DATETIME>(def);
+		return true;
+	default:
+		return false;
+	}
+}
+
+/* }}} tuple_compare_single_part */
+
 /* {{{ tuple_hint */
 
 /**
@@ -2041,6 +2221,142 @@ key_def_set_hint_func(struct key_def *def)
 	}
 }
 
+/**
+ * An extended comparison hint complements the regular one for
+ * the cases when the latter can't tell two tuples apart:
+ *
+ *  - If the first key part is a string or a binary field, the
+ *    extended hint stores the bytes that follow those stored in
+ *    the regular hint (or the corresponding part of the sort key
+ *    if there's a collation), so that strings with a long common
+ *    prefix can still be compared without decoding the tuples.
+ *
+ *  - If the first key part is an integer, a boolean, or NULL and
+ *    the regular hint stores it exactly (i.e. equal hints imply
+ *    equal fields), the extended hint is the regular hint of the
+ *    second key part.
+ *
+ *  - Otherwise, the extended hint is HINT_NONE.
+ *
+ * So if the regular hints of two tuples are equal and both
+ * extended hints are defined, the extended hints can be compared
+ * following the same rules as regular hints, see hint_t.
+ */
+static inline hint_t
+hint_str_ext(const char *s, uint32_t len, enum mp_class c)
+{
+	uint32_t skip = MIN(len, HINT_VALUE_BYTES);
+	return hint_create(c, hint_str_raw(s + skip, len - skip));
+}
+
+static inline hint_t
+hint_str_coll_ext(const char *s, uint32_t len, struct coll *coll)
+{
+	char buf[HINT_VALUE_BYTES * 2];
+	uint32_t buf_len = coll->hint(s, len, buf, sizeof(buf), coll);
+	return hint_str_ext(buf, buf_len, MP_CLASS_STR);
+}
+
+/**
+ * Compute the regular hint of a field of the given key part
+ * with a type switch. Used for the second key part, which is
+ * outside of templated hint functions.
+ */
+static hint_t
+field_hint_slow(const char *field, struct key_part *part)
+{
+	if (field == NULL || mp_typeof(*field) == MP_NIL)
+		return hint_nil();
+	switch (part->type) {
+	case FIELD_TYPE_BOOLEAN:
+		return field_hint_boolean(field);
+	case FIELD_TYPE_UNSIGNED:
+		return field_hint_unsigned(field);
+	case FIELD_TYPE_INTEGER:
+		return field_hint_integer(field);
+	case FIELD_TYPE_NUMBER:
+		return field_hint_number(field);
+	case FIELD_TYPE_DOUBLE:
+		return field_hint_double(field);
+	case FIELD_TYPE_STRING:
+		return field_hint_string(field, part->coll);
+	case FIELD_TYPE_VARBINARY:
+		return field_hint_varbinary(field);
+	case FIELD_TYPE_SCALAR:
+		return field_hint_scalar(field, part->coll);
+	case FIELD_TYPE_DECIMAL:
+		return field_hint_decimal(field);
+	case FIELD_TYPE_UUID:
+		return field_hint_uuid(field);
+	case FIELD_TYPE_DATETIME:
+		return field_hint_datetime(field);
+	default:
+		return HINT_NONE;
+	}
+}
+
+/**
+ * Compute the extended hint for the first key part.
+ * Returns true if the regular hint of the first part is exact
+ * and so the extended hint must be taken from the second part.
+ */
+static bool
+field_hint_ext(const char *field, struct key_part *part, hint_t *ext)
+{
+	*ext = HINT_NONE;
+	if (field == NULL)
+		return true;
+	uint32_t len;
+	switch (mp_typeof(*field)) {
+	case MP_NIL:
+	case MP_BOOL:
+		return true;
+	case MP_UINT:
+		return mp_decode_uint(&field) < (uint64_t)HINT_VALUE_INT_MAX;
+	case MP_INT:
+		return mp_decode_int(&field) > HINT_VALUE_INT_MIN;
+	case MP_STR:
+		len = mp_decode_strl(&field);
+		*ext = part->coll == NULL ?
+		       hint_str_ext(field, len, MP_CLASS_STR) :
+		       hint_str_coll_ext(field, len, part->coll);
+		return false;
+	case MP_BIN:
+		len = mp_decode_binl(&field);
+		*ext = hint_str_ext(field, len, MP_CLASS_BIN);
+		return false;
+	default:
+		return false;
+	}
+}
+
+hint_t
+tuple_hint_ext(struct tuple *tuple, struct key_def *key_def)
+{
+	assert(!key_def->is_multikey && !key_def->for_func_index);
+	hint_t ext;
+	const char *field = tuple_field_by_part(tuple, &key_def->parts[0],
+						MULTIKEY_NONE);
+	if (!field_hint_ext(field, &key_def->parts[0], &ext) ||
+	    key_def->part_count < 2)
+		return ext;
+	field = tuple_field_by_part(tuple, &key_def->parts[1], MULTIKEY_NONE);
+	return field_hint_slow(field, &key_def->parts[1]);
+}
+
+hint_t
+key_hint_ext(const char *key, uint32_t part_count, struct key_def *key_def)
+{
+	assert(!key_def->is_multikey && !key_def->for_func_index);
+	if (part_count == 0)
+		return HINT_NONE;
+	hint_t ext;
+	if (!field_hint_ext(key, &key_def->parts[0], &ext) || part_count < 2)
+		return ext;
+	mp_next(&key);
+	return field_hint_slow(key, &key_def->parts[1]);
+}
+
 /* }}} tuple_hint */
 
 static void
@@ -2082,6 +2398,17 @@ key_def_set_compare_func_fast(struct key_def *def)
 			break;
 		}
 	}
+	/*
+	 * Single-part keys not covered by pre-compiled comparators
+	 * use comparators specialized by the key part type.
+	 */
+	if ((cmp == NULL || cmp_wk == NULL) && def->part_count == 1 &&
+	    key_def_set_compare_func_single_part(def)) {
+		if (cmp == NULL)
+			cmp = def->tuple_compare;
+		if (cmp_wk == NULL)
+			cmp_wk = def->tuple_compare_with_key;
+	}
 	if (cmp == NULL) {
 		cmp = is_sequential ?
 			tuple_compare_sequential<false, false> :
@@ -2103,6 +2430,8 @@ static void
 key_def_set_compare_func_plain(struct key_def *def)
 {
 	assert(!def->has_json_paths);
+	if (def->part_count == 1 && key_def_set_compare_func_single_part(def))
+		return;
 	if (key_def_is_sequential(def)) {
 		def->tuple_compare = tuple_compare_sequential
 					<is_nullable, has_optional_parts>;
@@ -37,6 +37,7 @@ extern "C" {
 #endif /* defined(__cplusplus) */
 
 struct key_def;
+struct tuple;
 
 /**
  * Hints are now used for two purposes - passing the index of the
@@ -69,6 +70,24 @@ typedef uint64_t hint_t;
  */
 #define HINT_NONE ((hint_t)UINT64_MAX)
 
+/**
+ * Compute an extended comparison hint of a tuple. It is used
+ * by wide hint tree indexes to order tuples whose regular hints
+ * are equal: if both extended hints are not HINT_NONE, they
+ * obey the same rules as regular hints.
+ *
+ * Must not be used with multikey and functional key definitions.
+ */
+hint_t
+tuple_hint_ext(struct tuple *tuple, struct key_def *key_def);
+
+/**
+ * Compute an extended comparison hint of a key,
+ * see tuple_hint_ext().
+ */
+hint_t
+key_hint_ext(const char *key, uint32_t part_count, struct key_def *key_def);
+
 /**
  * Initialize comparator functions for the key_def.
  * @param key_def key definition
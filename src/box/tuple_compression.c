@@ -0,0 +1,369 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2022, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "tuple_compression.h"
+
+#include <assert.h>
+#include <string.h>
+#include <zstd.h>
+#include <msgpuck.h>
+#include <small/region.h>
+
+#include "diag.h"
+#include "trivia/util.h"
+#include "errcode.h"
+#include "mp_extension_types.h"
+#include "tuple.h"
+#include "tuple_format.h"
+
+/**
+ * Return true if MsgPack [@a data, @a end) contains a compressed
+ * value. The data must be valid MsgPack.
+ */
+static bool
+mp_has_compressed_value(const char *data, const char *end)
+{
+	while (data < end) {
+		switch (mp_typeof(*data)) {
+		case MP_ARRAY:
+			mp_decode_array(&data);
+			break;
+		case MP_MAP:
+			mp_decode_map(&data);
+			break;
+		case MP_EXT: {
+			int8_t type;
+			uint32_t len = mp_decode_extl(&data, &type);
+			if (type == MP_COMPRESSION)
+				return true;
+			data += len;
+			break;
+		}
+		default:
+			mp_next(&data);
+			break;
+		}
+	}
+	return false;
+}
+
+/**
+ * Check a compressed value supplied by the user or read from disk
+ * against the definition of the field it is stored in.
+ */
+static int
+tuple_check_compressed_field(struct tuple_field *field, const char *data,
+			     struct region *region)
+{
+	size_t region_svp = region_used(region);
+	int8_t type;
+	uint32_t len = mp_decode_extl(&data, &type);
+	assert(type == MP_COMPRESSION);
+	const char *value = compression_unpack(&data, len, region);
+	if (value == NULL)
+		return -1;
+	if (!field_mp_type_is_compatible(field->type, value,
+					 tuple_field_is_nullable(field))) {
+		diag_set(ClientError, ER_DECOMPRESSION,
+			 "compressed value type doesn't match field type");
+		region_truncate(region, region_svp);
+		return -1;
+	}
+	region_truncate(region, region_svp);
+	return 0;
+}
+
+/**
+ * Compress a field value of @a size bytes with ZSTD and append it
+ * to @a buf as MP_COMPRESSION. Return the new end of @a buf or @a buf
+ * if the compressed value isn't shorter than the original one.
+ */
+static char *
+tuple_compress_field_zstd(char *buf, const char *field, size_t size,
+			  struct region *region)
+{
+	size_t bound = ZSTD_compressBound(size);
+	char *zbuf = region_alloc(region, bound);
+	if (zbuf == NULL) {
+		diag_set(OutOfMemory, bound, "region_alloc", "zbuf");
+		return NULL;
+	}
+	size_t zsize = ZSTD_compress(zbuf, bound, field, size,
+				     TUPLE_COMPRESSION_ZSTD_LEVEL);
+	if (ZSTD_isError(zsize)) {
+		diag_set(ClientError, ER_COMPRESSION,
+			 ZSTD_getErrorName(zsize));
+		return NULL;
+	}
+	uint32_t len = mp_sizeof_uint(COMPRESSION_TYPE_ZSTD) +
+		       mp_sizeof_uint(size) + zsize;
+	if (mp_sizeof_ext(len) >= size)
+		return buf;
+	buf = mp_encode_extl(buf, MP_COMPRESSION, len);
+	buf = mp_encode_uint(buf, COMPRESSION_TYPE_ZSTD);
+	buf = mp_encode_uint(buf, size);
+	memcpy(buf, zbuf, zsize);
+	return buf + zsize;
+}
+
+int
+tuple_compress_fields(struct tuple_format *format, const char **data,
+		      const char **data_end, struct region *region)
+{
+	assert(format->has_compressed_fields);
+	const char *pos = *data;
+	uint32_t field_count = mp_decode_array(&pos);
+	field_count = MIN(field_count, tuple_format_field_count(format));
+	/*
+	 * The new tuple is allocated only when the first value is
+	 * compressed. Compressed values are shorter than original
+	 * ones so the new tuple can't be longer than the old one.
+	 */
+	char *buf = NULL;
+	char *buf_pos = NULL;
+	const char *copied = *data;
+	for (uint32_t i = 0; i < field_count; i++) {
+		const char *field = pos;
+		mp_next(&pos);
+		size_t size = pos - field;
+		struct tuple_field *format_field =
+			tuple_format_field(format, i);
+		enum compression_type type = format_field->compression;
+		if (type == COMPRESSION_TYPE_NONE)
+			continue;
+		if (tuple_field_is_compressed_value(format_field, field)) {
+			if (tuple_check_compressed_field(format_field, field,
+							 region) != 0)
+				return -1;
+			continue;
+		}
+		/*
+		 * The rest of the tuple is validated after compression
+		 * so check the value while it's still plain MsgPack.
+		 */
+		if (!field_mp_type_is_compatible(
+				format_field->type, field,
+				tuple_field_is_nullable(format_field))) {
+			diag_set(ClientError, ER_FIELD_TYPE,
+				 tuple_field_path(format_field, format),
+				 field_type_strs[format_field->type],
+				 mp_type_strs[mp_typeof(*field)]);
+			return -1;
+		}
+		if (size < TUPLE_COMPRESSION_MIN_SIZE ||
+		    size > TUPLE_COMPRESSION_MAX_SIZE ||
+		    mp_typeof(*field) == MP_EXT ||
+		    mp_has_compressed_value(field, pos))
+			continue;
+		if (buf == NULL) {
+			size_t total = *data_end - *data;
+			buf = region_alloc(region, total);
+			if (buf == NULL) {
+				diag_set(OutOfMemory, total, "region_alloc",
+					 "tuple");
+				return -1;
+			}
+			buf_pos = buf;
+		}
+		memcpy(buf_pos, copied, field - copied);
+		char *field_buf = buf_pos + (field - copied);
+		assert(type == COMPRESSION_TYPE_ZSTD);
+		char *field_end = tuple_compress_field_zstd(field_buf, field,
+							    size, region);
+		if (field_end == NULL)
+			return -1;
+		if (field_end == field_buf) {
+			/* Doesn't compress well, keep as is. */
+			continue;
+		}
+		buf_pos = field_end;
+		copied = pos;
+	}
+	if (buf == NULL)
+		return 0;
+	memcpy(buf_pos, copied, *data_end - copied);
+	buf_pos += *data_end - copied;
+	*data = buf;
+	*data_end = buf_pos;
+	return 0;
+}
+
+/**
+ * Return the size of tuple data [@a data, @a data_end) with
+ * compressed values decompressed. It is computed from the sizes
+ * stored along with compressed values, which are checked when
+ * the tuple is created, see compression_unpack(). @a is_compressed
+ * is set if the tuple has compressed values.
+ */
+static size_t
+tuple_decompressed_size(struct tuple_format *format, const char *data,
+			const char *data_end, bool *is_compressed)
+{
+	*is_compressed = false;
+	size_t total = data_end - data;
+	uint32_t field_count = mp_decode_array(&data);
+	field_count = MIN(field_count, tuple_format_field_count(format));
+	for (uint32_t i = 0; i < field_count; i++) {
+		const char *field = data;
+		mp_next(&data);
+		if (!tuple_field_is_compressed_value(
+				tuple_format_field(format, i), field))
+			continue;
+		total -= data - field;
+		int8_t type;
+		mp_decode_extl(&field, &type);
+		mp_decode_uint(&field);
+		total += mp_decode_uint(&field);
+		*is_compressed = true;
+	}
+	return total;
+}
+
+int
+tuple_decompress_fields(struct tuple_format *format, const char **data,
+			const char **data_end, struct region *region)
+{
+	assert(format->has_compressed_fields);
+	const char *pos = *data;
+	uint32_t field_count = mp_decode_array(&pos);
+	field_count = MIN(field_count, tuple_format_field_count(format));
+	const char *fields = pos;
+	bool is_compressed;
+	size_t total = tuple_decompressed_size(format, *data, *data_end,
+					       &is_compressed);
+	if (!is_compressed)
+		return 0;
+	char *buf = region_alloc(region, total);
+	if (buf == NULL) {
+		diag_set(OutOfMemory, total, "region_alloc", "tuple");
+		return -1;
+	}
+	char *buf_pos = buf;
+	const char *copied = *data;
+	pos = fields;
+	for (uint32_t i = 0; i < field_count; i++) {
+		const char *field = pos;
+		mp_next(&pos);
+		if (!tuple_field_is_compressed_value(
+				tuple_format_field(format, i), field))
+			continue;
+		memcpy(buf_pos, copied, field - copied);
+		buf_pos += field - copied;
+		copied = pos;
+		size_t region_svp = region_used(region);
+		int8_t type;
+		uint32_t len = mp_decode_extl(&field, &type);
+		const char *value = compression_unpack(&field, len, region);
+		if (value == NULL)
+			return -1;
+		/*
+		 * The value was checked to have the stored size when
+		 * the tuple was created, see compression_unpack().
+		 */
+		const char *value_end = value;
+		mp_next(&value_end);
+		assert(value_end - value <= buf + total - buf_pos);
+		memcpy(buf_pos, value, value_end - value);
+		buf_pos += value_end - value;
+		region_truncate(region, region_svp);
+	}
+	memcpy(buf_pos, copied, *data_end - copied);
+	buf_pos += *data_end - copied;
+	assert(buf_pos <= buf + total);
+	*data = buf;
+	*data_end = buf_pos;
+	return 0;
+}
+
+const char *
+tuple_data_decompressed(struct tuple *tuple, uint32_t *size,
+			struct region *region)
+{
+	const char *data = tuple_data_range(tuple, size);
+	struct tuple_format *format = tuple_format(tuple);
+	if (likely(!format->has_compressed_fields))
+		return data;
+	const char *data_end = data + *size;
+	if (tuple_decompress_fields(format, &data, &data_end, region) != 0)
+		return NULL;
+	*size = data_end - data;
+	return data;
+}
+
+uint32_t
+tuple_bsize_decompressed(struct tuple *tuple)
+{
+	uint32_t bsize;
+	const char *data = tuple_data_range(tuple, &bsize);
+	struct tuple_format *format = tuple_format(tuple);
+	if (likely(!format->has_compressed_fields))
+		return bsize;
+	bool is_compressed;
+	return tuple_decompressed_size(format, data, data + bsize,
+				       &is_compressed);
+}
+
+const char *
+tuple_field_decompressed(struct tuple_format *format, uint32_t fieldno,
+			 const char *field, struct region *region)
+{
+	if (likely(!format->has_compressed_fields) || field == NULL ||
+	    fieldno >= tuple_format_field_count(format))
+		return field;
+	struct tuple_field *format_field = tuple_format_field(format, fieldno);
+	if (!tuple_field_is_compressed_value(format_field, field))
+		return field;
+	int8_t type;
+	uint32_t len = mp_decode_extl(&field, &type);
+	return compression_unpack(&field, len, region);
+}
+
+const char *
+compression_unpack(const char **data, uint32_t len, struct region *region)
+{
+	const char *end = *data + len;
+	const char *pos = *data;
+	if (mp_typeof(*pos) != MP_UINT || mp_check_uint(pos, end) > 0 ||
+	    mp_decode_uint(&pos) != COMPRESSION_TYPE_ZSTD ||
+	    pos >= end || mp_typeof(*pos) != MP_UINT ||
+	    mp_check_uint(pos, end) > 0)
+		goto invalid;
+	uint64_t size = mp_decode_uint(&pos);
+	/*
+	 * The value may come from the user so check the size before
+	 * allocating memory for it.
+	 */
+	if (size == 0 || size > TUPLE_COMPRESSION_MAX_SIZE ||
+	    ZSTD_getFrameContentSize(pos, end - pos) != size)
+		goto invalid;
+	size_t region_svp = region_used(region);
+	char *buf = region_alloc(region, size);
+	if (buf == NULL) {
+		diag_set(OutOfMemory, size, "region_alloc", "buf");
+		return NULL;
+	}
+	size_t rc = ZSTD_decompress(buf, size, pos, end - pos);
+	if (ZSTD_isError(rc)) {
+		region_truncate(region, region_svp);
+		diag_set(ClientError, ER_DECOMPRESSION, ZSTD_getErrorName(rc));
+		return NULL;
+	}
+	/*
+	 * The decompressed value must be exactly one valid MsgPack
+	 * value. Compressed values are never nested so that a small
+	 * value can't be blown up recursively.
+	 */
+	const char *check = buf;
+	if (rc != size || mp_check(&check, buf + size) != 0 ||
+	    check != buf + size || mp_has_compressed_value(buf, buf + size)) {
+		region_truncate(region, region_svp);
+		goto invalid;
+	}
+	*data = end;
+	return buf;
+invalid:
+	diag_set(ClientError, ER_DECOMPRESSION, "invalid compressed value");
+	return NULL;
+}
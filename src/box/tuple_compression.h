@@ -0,0 +1,119 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2022, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+struct region;
+struct tuple;
+struct tuple_format;
+
+enum {
+	/** Field values shorter than this are never compressed. */
+	TUPLE_COMPRESSION_MIN_SIZE = 64,
+	/**
+	 * Field values longer than this are never compressed so
+	 * that decompression of a malformed value can't make us
+	 * allocate an arbitrary amount of memory.
+	 */
+	TUPLE_COMPRESSION_MAX_SIZE = 16 * 1024 * 1024,
+	/** ZSTD compression level used for field values. */
+	TUPLE_COMPRESSION_ZSTD_LEVEL = 3,
+};
+
+/**
+ * Compress values of fields that have compression set in @a format.
+ *
+ * A compressed value is stored as MP_EXT of type MP_COMPRESSION:
+ * MP_UINT compression type, MP_UINT size of the original value,
+ * compressed MsgPack of the original value. Short and huge values,
+ * values that contain compressed values and values that don't
+ * shrink are left as is. Values that are already compressed (sent
+ * by the user or read from a snapshot) are decompressed and checked
+ * against the field definition.
+ *
+ * Values of fields that have compression set are type checked, the
+ * rest of the tuple must be validated against @a format afterwards.
+ * If any value is compressed, [@a data, @a data_end) is updated
+ * to point to a new tuple allocated on @a region.
+ *
+ * @retval 0 Success.
+ * @retval -1 Memory, compression or validation error, diag is set.
+ */
+int
+tuple_compress_fields(struct tuple_format *format, const char **data,
+		      const char **data_end, struct region *region);
+
+/**
+ * Decompress values of compressed fields of a tuple that has
+ * @a format. If any value is compressed, [@a data, @a data_end)
+ * is updated to point to a copy of the tuple allocated on
+ * @a region, otherwise it is left as is.
+ *
+ * @retval 0 Success.
+ * @retval -1 Memory or decompression error, diag is set.
+ */
+int
+tuple_decompress_fields(struct tuple_format *format, const char **data,
+			const char **data_end, struct region *region);
+
+/**
+ * Return the data of @a tuple as the user sent it, i.e. with
+ * compressed field values decompressed, and store its size in
+ * @a size. The tuple data is returned as is unless it has
+ * compressed values, in which case the result is allocated on
+ * @a region.
+ *
+ * @retval not NULL Tuple data.
+ * @retval NULL Memory or decompression error, diag is set.
+ */
+const char *
+tuple_data_decompressed(struct tuple *tuple, uint32_t *size,
+			struct region *region);
+
+/**
+ * Return the size of the data returned by tuple_data_decompressed()
+ * for @a tuple without decompressing it.
+ */
+uint32_t
+tuple_bsize_decompressed(struct tuple *tuple);
+
+/**
+ * Return field @a fieldno of a tuple that has @a format given the
+ * field value @a field, which may be NULL. If the value is
+ * compressed, it is decompressed on @a region.
+ *
+ * @retval not NULL or NULL if @a field is NULL Field value.
+ * @retval NULL Memory or decompression error, diag is set.
+ */
+const char *
+tuple_field_decompressed(struct tuple_format *format, uint32_t fieldno,
+			 const char *field, struct region *region);
+
+/**
+ * Decompress the payload of an MP_COMPRESSION extension of
+ * length @a len. On success, @a data is advanced past the
+ * payload and the original MsgPack value allocated on @a region
+ * is returned. The payload may come from the user so it is
+ * validated: the original value must be valid MsgPack not longer
+ * than TUPLE_COMPRESSION_MAX_SIZE that has no compressed values
+ * in it.
+ *
+ * @retval not NULL Decompressed value.
+ * @retval NULL Memory, decompression or validation error, diag is
+ *              set.
+ */
+const char *
+compression_unpack(const char **data, uint32_t len, struct region *region);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
@@ -29,6 +29,7 @@
  * SUCH DAMAGE.
  */
 #include "tuple.h"
+#include "tuple_compression.h"
 #include <msgpuck/msgpuck.h>
 #include <yaml.h>
 #include <base64.h>
@@ -40,12 +41,18 @@
 int
 tuple_to_obuf(struct tuple *tuple, struct obuf *buf)
 {
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
 	uint32_t bsize;
-	const char *data = tuple_data_range(tuple, &bsize);
+	const char *data = tuple_data_decompressed(tuple, &bsize, region);
+	if (data == NULL)
+		return -1;
 	if (obuf_dup(buf, data, bsize) != bsize) {
+		region_truncate(region, region_svp);
 		diag_set(OutOfMemory, bsize, "tuple_to_obuf", "dup");
 		return -1;
 	}
+	region_truncate(region, region_svp);
 	return 0;
 }
 
@@ -79,6 +79,8 @@ tuple_format_cmp(const struct tuple_format *format1,
 	struct tuple_format *b = (struct tuple_format *)format2;
 	if (a->exact_field_count != b->exact_field_count)
 		return a->exact_field_count - b->exact_field_count;
+	if (a->compact_field_map != b->compact_field_map)
+		return (int)a->compact_field_map - (int)b->compact_field_map;
 	if (a->total_field_count != b->total_field_count)
 		return a->total_field_count - b->total_field_count;
 
@@ -97,6 +99,9 @@ tuple_format_cmp(const struct tuple_format *format1,
 		if (field_a->is_key_part != field_b->is_key_part)
 			return (int)field_a->is_key_part -
 				(int)field_b->is_key_part;
+		if (field_a->compression != field_b->compression)
+			return (int)field_a->compression -
+				(int)field_b->compression;
 	}
 
 	return tuple_dictionary_cmp(format1->dict, format2->dict);
@@ -120,8 +125,12 @@ tuple_format_hash(struct tuple_format *format)
 		TUPLE_FIELD_MEMBER_HASH(f, coll_id, h, carry, size)
 		TUPLE_FIELD_MEMBER_HASH(f, nullable_action, h, carry, size)
 		TUPLE_FIELD_MEMBER_HASH(f, is_key_part, h, carry, size)
+		TUPLE_FIELD_MEMBER_HASH(f, compression, h, carry, size)
 	}
 #undef TUPLE_FIELD_MEMBER_HASH
+	PMurHash32_Process(&h, &carry, &format->compact_field_map,
+			   sizeof(format->compact_field_map));
+	size += sizeof(format->compact_field_map);
 	size += tuple_dictionary_hash_process(format->dict, &h, &carry);
 	return PMurHash32_Result(h, carry, size);
 }
@@ -153,6 +162,7 @@ tuple_field_new(void)
 	field->type = FIELD_TYPE_ANY;
 	field->offset_slot = TUPLE_OFFSET_SLOT_NIL;
 	field->coll_id = COLL_NONE;
+	field->compression = COMPRESSION_TYPE_NONE;
 	field->nullable_action = ON_CONFLICT_ACTION_NONE;
 	field->multikey_required_fields = NULL;
 	return field;
@@ -165,8 +175,7 @@ tuple_field_delete(struct tuple_field *field)
 	free(field);
 }
 
-/** Return path to a tuple field. Used for error reporting. */
-static const char *
+const char *
 tuple_field_path(const struct tuple_field *field,
 		 const struct tuple_format *format)
 {
@@ -428,6 +437,29 @@ tuple_format_use_key_part(struct tuple_format *format, uint32_t field_count,
 	return 0;
 }
 
+/**
+ * A compressed value can't be compared or looked into without
+ * decompression so neither a compressed field nor any path in it
+ * can be indexed. Check that a key part doesn't refer to a field
+ * whose top-level field is compressed.
+ */
+static int
+tuple_format_check_compressed_key_part(struct tuple_format *format,
+				       uint32_t field_count,
+				       const struct key_part *part)
+{
+	if (part->fieldno >= field_count)
+		return 0;
+	struct tuple_field *field = tuple_format_field(format, part->fieldno);
+	if (field->compression == COMPRESSION_TYPE_NONE)
+		return 0;
+	diag_set(ClientError, ER_UNSUPPORTED,
+		 tt_sprintf("Compressed field %s",
+			    tuple_field_path(field, format)),
+		 "indexing");
+	return -1;
+}
+
 /**
  * Extract all available type info from keys and field
  * definitions.
@@ -462,6 +494,9 @@ tuple_format_create(struct tuple_format *format, struct key_def * const *keys,
 		}
 		field->coll = coll;
 		field->coll_id = cid;
+		field->compression = fields[i].compression;
+		if (field->compression != COMPRESSION_TYPE_NONE)
+			format->has_compressed_fields = true;
 	}
 
 	int current_slot = 0;
@@ -476,12 +511,22 @@ tuple_format_create(struct tuple_format *format, struct key_def * const *keys,
 		const struct key_def *key_def = keys[key_no];
 		if (key_def->for_func_index)
 			continue;
-		bool is_sequential = key_def_is_sequential(key_def);
+		/*
+		 * Sequential keys don't need offset slots. Neither do
+		 * any keys in a compact format, except multikey ones,
+		 * because a multikey array member can't be found
+		 * without its offset.
+		 */
+		bool is_sequential = key_def_is_sequential(key_def) ||
+				     (format->compact_field_map &&
+				      !key_def->is_multikey);
 		const struct key_part *part = key_def->parts;
 		const struct key_part *parts_end = part + key_def->part_count;
 
 		for (; part < parts_end; part++) {
-			if (tuple_format_use_key_part(format, field_count, part,
+			if (tuple_format_check_compressed_key_part(
+					format, field_count, part) != 0 ||
+			    tuple_format_use_key_part(format, field_count, part,
 						      is_sequential,
 						      &current_slot,
 						      &path_pool) != 0)
@@ -548,6 +593,14 @@ tuple_format_create(struct tuple_format *format, struct key_def * const *keys,
 		    !tuple_field_is_nullable(field))
 			bit_set(required_fields, field->id);
 	}
+	for (uint32_t i = 0; i < tuple_format_field_count(format); i++) {
+		field = tuple_format_field(format, i);
+		if (field->offset_slot != TUPLE_OFFSET_SLOT_NIL)
+			format->offset_field_count = i + 1;
+		if (json_token_is_leaf(&field->token) &&
+		    !tuple_field_is_nullable(field))
+			format->required_field_count = i + 1;
+	}
 out:
 	format->hash = tuple_format_hash(format);
 	return 0;
@@ -682,6 +735,8 @@ tuple_format_alloc(struct key_def * const *keys, uint16_t key_count,
 	format->index_field_count = index_field_count;
 	format->exact_field_count = 0;
 	format->min_field_count = 0;
+	format->offset_field_count = 0;
+	format->required_field_count = 0;
 	format->epoch = 0;
 	return format;
 error:
@@ -760,7 +815,7 @@ tuple_format_new(struct tuple_format_vtab *vtab, void *engine,
 		 const struct field_def *space_fields,
 		 uint32_t space_field_count, uint32_t exact_field_count,
 		 struct tuple_dictionary *dict, bool is_temporary,
-		 bool is_reusable)
+		 bool is_reusable, bool compact_field_map)
 {
 	struct tuple_format *format =
 		tuple_format_alloc(keys, key_count, space_field_count, dict);
@@ -773,6 +828,8 @@ tuple_format_new(struct tuple_format_vtab *vtab, void *engine,
 	format->engine = engine;
 	format->is_temporary = is_temporary;
 	format->is_reusable = is_reusable;
+	format->compact_field_map = compact_field_map;
+	format->has_compressed_fields = false;
 	format->exact_field_count = exact_field_count;
 	format->epoch = ++formats_epoch;
 	if (tuple_format_create(format, keys, key_count, space_fields,
@@ -844,7 +901,6 @@ static int
 tuple_field_map_create_plain(struct tuple_format *format, const char *tuple,
 			     bool validate, struct field_map_builder *builder)
 {
-	struct region *region = &fiber()->gc;
 	const char *pos = tuple;
 	uint32_t defined_field_count = mp_decode_array(&pos);
 	if (validate && format->exact_field_count > 0 &&
@@ -854,38 +910,30 @@ tuple_field_map_create_plain(struct tuple_format *format, const char *tuple,
 			 (unsigned) format->exact_field_count);
 		return -1;
 	}
-	defined_field_count = MIN(defined_field_count,
-				  tuple_format_field_count(format));
-
-	void *required_fields = NULL;
-	uint32_t required_fields_sz = BITMAP_SIZE(format->total_field_count);
-
-	if (unlikely(defined_field_count == 0)) {
-		required_fields = format->required_fields;
-		goto end;
-	}
-
-	if (validate) {
-		required_fields = region_alloc(region, required_fields_sz);
-		memcpy(required_fields, format->required_fields,
-		       required_fields_sz);
-	}
+	/*
+	 * Unless the tuple is validated, stop at the last field
+	 * that has an offset slot: there's nothing to do with the
+	 * rest.
+	 */
+	uint32_t field_count = validate ? tuple_format_field_count(format) :
+					  format->offset_field_count;
+	field_count = MIN(defined_field_count, field_count);
 
 	struct tuple_field *field;
 	struct json_token **token = format->fields.root.children;
-	for (uint32_t i = 0; i < defined_field_count; i++, token++, mp_next(&pos)) {
+	for (uint32_t i = 0; i < field_count; i++, token++, mp_next(&pos)) {
 		field = json_tree_entry(*token, struct tuple_field, token);
 		if (validate) {
 			bool nullable = tuple_field_is_nullable(field);
-			if(!field_mp_type_is_compatible(field->type, pos,
-							nullable)) {
+			if (!field_mp_type_is_compatible(field->type, pos,
+							 nullable) &&
+			    !tuple_field_is_compressed_value(field, pos)) {
 				diag_set(ClientError, ER_FIELD_TYPE,
 					 tuple_field_path(field, format),
 					 field_type_strs[field->type],
 					 mp_type_strs[mp_typeof(*pos)]);
 				return -1;
 			}
-			bit_clear(required_fields, field->id);
 		}
 		if (field->offset_slot != TUPLE_OFFSET_SLOT_NIL &&
 		    field_map_builder_set_slot(builder, field->offset_slot,
@@ -894,13 +942,31 @@ tuple_field_map_create_plain(struct tuple_format *format, const char *tuple,
 			return -1;
 		}
 	}
-
-end:
-	if (!validate)
-		return 0;
-
-	return tuple_format_required_fields_validate(format, required_fields,
+	/*
+	 * All top-level fields are leaves so checking the field
+	 * count is enough to make sure no required field is missing.
+	 */
+	if (validate && defined_field_count < format->required_field_count) {
+		/* Find the first missing field to report it. */
+		struct region *region = &fiber()->gc;
+		uint32_t required_fields_sz =
+			BITMAP_SIZE(format->total_field_count);
+		void *required_fields = region_alloc(region,
 						     required_fields_sz);
+		if (required_fields == NULL) {
+			diag_set(OutOfMemory, required_fields_sz,
+				 "region_alloc", "required field bitmap");
+			return -1;
+		}
+		memcpy(required_fields, format->required_fields,
+		       required_fields_sz);
+		for (uint32_t i = 0; i < defined_field_count; i++)
+			bit_clear(required_fields,
+				  tuple_format_field(format, i)->id);
+		return tuple_format_required_fields_validate(
+			format, required_fields, required_fields_sz);
+	}
+	return 0;
 }
 
 /** @sa declaration for details. */
@@ -1223,7 +1289,9 @@ tuple_format_iterator_next(struct tuple_format_iterator *it,
 	 * defined in format.
 	 */
 	bool is_nullable = tuple_field_is_nullable(field);
-	if (!field_mp_type_is_compatible(field->type, entry->data, is_nullable) != 0) {
+	if (!field_mp_type_is_compatible(field->type, entry->data,
+					 is_nullable) &&
+	    !tuple_field_is_compressed_value(field, entry->data)) {
 		diag_set(ClientError, ER_FIELD_TYPE,
 			 tuple_field_path(field, it->format),
 			 field_type_strs[field->type],
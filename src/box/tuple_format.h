@@ -37,6 +37,7 @@
 #include "json/json.h"
 #include "tuple_dictionary.h"
 #include "field_map.h"
+#include "mp_extension_types.h"
 
 #if defined(__cplusplus)
 extern "C" {
@@ -134,6 +135,8 @@ struct tuple_field {
 	struct coll *coll;
 	/** Collation identifier. */
 	uint32_t coll_id;
+	/** Compression of the field value in memtx tuples. */
+	enum compression_type compression;
 	/**
 	 * Bitmap of fields that must be present in a tuple
 	 * conforming to the multikey subtree. Not NULL only
@@ -157,6 +160,28 @@ tuple_field_is_nullable(struct tuple_field *tuple_field)
 	return tuple_field->nullable_action == ON_CONFLICT_ACTION_NONE;
 }
 
+/** Return path to a tuple field. Used for error reporting. */
+const char *
+tuple_field_path(const struct tuple_field *field,
+		 const struct tuple_format *format);
+
+/**
+ * Return true if @a data is a compressed value that may be stored
+ * in @a tuple_field. Values are type checked before compression,
+ * see tuple_compress_fields().
+ */
+static inline bool
+tuple_field_is_compressed_value(struct tuple_field *tuple_field,
+				const char *data)
+{
+	if (tuple_field->compression == COMPRESSION_TYPE_NONE ||
+	    mp_typeof(*data) != MP_EXT)
+		return false;
+	int8_t ext_type;
+	mp_decode_extl(&data, &ext_type);
+	return ext_type == MP_COMPRESSION;
+}
+
 /**
  * @brief Tuple format
  * Tuple format describes how tuple is stored and information about its fields
@@ -196,6 +221,16 @@ struct tuple_format {
 	 * those are never altered. We can also reuse formats exported to Lua.
 	 */
 	bool is_reusable;
+	/**
+	 * If set, offset slots are allocated only for fields that
+	 * can't be accessed without them, i.e. for arrays indexed
+	 * by multikey indexes and their members. Other indexed fields
+	 * are found by decoding the tuple, which makes tuples smaller
+	 * but access to fields other than the first one slower.
+	 */
+	bool compact_field_map;
+	/** True if values of some fields are stored compressed. */
+	bool has_compressed_fields;
 	/**
 	 * Size of minimal field map of tuple where each indexed
 	 * field has own offset slot (in bytes). The real tuple
@@ -218,6 +253,18 @@ struct tuple_format {
 	 * index_field_count <= min_field_count <= field_count.
 	 */
 	uint32_t min_field_count;
+	/**
+	 * The longest top-level field prefix in which the last
+	 * field has an offset slot. Fields following it needn't
+	 * be decoded to build a field map.
+	 */
+	uint32_t offset_field_count;
+	/**
+	 * The longest top-level field prefix in which the last
+	 * field is required. A tuple having at least this many
+	 * fields has all top-level required fields.
+	 */
+	uint32_t required_field_count;
 	/**
 	 * Total number of formatted fields, including JSON
 	 * path fields. See also tuple_format::fields.
@@ -335,6 +382,8 @@ tuple_format_unref(struct tuple_format *format)
  * @param exact_field_count Exact field count for format.
  * @param is_temporary Set if format belongs to temporary space.
  * @param is_reusable Set if format may be reused.
+ * @param compact_field_map Set if offsets of indexed fields
+ *        shouldn't be stored in tuples.
  *
  * @retval not NULL Tuple format.
  * @retval     NULL Memory error.
@@ -345,7 +394,7 @@ tuple_format_new(struct tuple_format_vtab *vtab, void *engine,
 		 const struct field_def *space_fields,
 		 uint32_t space_field_count, uint32_t exact_field_count,
 		 struct tuple_dictionary *dict, bool is_temporary,
-		 bool is_reusable);
+		 bool is_reusable, bool compact_field_map);
 
 /**
  * Check, if @a format1 can store any tuples of @a format2. For
@@ -48,6 +48,11 @@ txn_limbo_create(struct txn_limbo *limbo)
 	vclock_create(&limbo->promote_term_map);
 	limbo->promote_greatest_term = 0;
 	limbo->confirmed_lsn = 0;
+	limbo->is_writing_confirm = false;
+	limbo->confirm_count = 0;
+	if (latency_create(&limbo->commit_latency) != 0 ||
+	    latency_create(&limbo->confirm_latency) != 0)
+		panic("failed to allocate limbo latency histograms");
 	limbo->rollback_count = 0;
 	limbo->is_in_rollback = false;
 }
@@ -119,6 +124,7 @@ txn_limbo_append(struct txn_limbo *limbo, uint32_t id, struct txn *txn)
 	e->txn = txn;
 	e->lsn = -1;
 	e->ack_count = 0;
+	e->insertion_time = fiber_clock();
 	e->is_commit = false;
 	e->is_rollback = false;
 	rlist_add_tail_entry(&limbo->queue, e, in_queue);
@@ -369,10 +375,12 @@ fail:
 static void
 txn_limbo_write_confirm(struct txn_limbo *limbo, int64_t lsn)
 {
-	assert(lsn > limbo->confirmed_lsn);
+	assert(lsn <= limbo->confirmed_lsn);
 	assert(!limbo->is_in_rollback);
-	limbo->confirmed_lsn = lsn;
+	double start_time = fiber_clock();
 	txn_limbo_write_synchro(limbo, IPROTO_RAFT_CONFIRM, lsn, 0);
+	latency_collect(&limbo->confirm_latency, fiber_clock() - start_time);
+	limbo->confirm_count++;
 }
 
 /** Confirm all the entries <= @a lsn. */
@@ -427,6 +435,10 @@ txn_limbo_read_confirm(struct txn_limbo *limbo, int64_t lsn)
 			e->txn = NULL;
 			continue;
 		}
+		if (txn_has_flag(e->txn, TXN_WAIT_ACK)) {
+			latency_collect(&limbo->commit_latency,
+					fiber_clock() - e->insertion_time);
+		}
 		e->is_commit = true;
 		txn_limbo_remove(limbo, e);
 		txn_clear_flags(e->txn, TXN_WAIT_SYNC | TXN_WAIT_ACK);
@@ -439,6 +451,46 @@ txn_limbo_read_confirm(struct txn_limbo *limbo, int64_t lsn)
 	}
 }
 
+/**
+ * Check if the first synchronous transaction in the queue gathered
+ * quorum but hasn't been confirmed yet.
+ */
+static bool
+txn_limbo_has_confirm_pending(struct txn_limbo *limbo)
+{
+	if (limbo->is_in_rollback)
+		return false;
+	struct txn_limbo_entry *e;
+	rlist_foreach_entry(e, &limbo->queue, in_queue) {
+		if (txn_has_flag(e->txn, TXN_WAIT_ACK))
+			return e->lsn > 0 && e->lsn <= limbo->confirmed_lsn;
+	}
+	return false;
+}
+
+/**
+ * Confirm all the entries <= @a lsn, which has just gathered
+ * quorum. If another fiber is writing a CONFIRM right now, it
+ * will confirm the entries once it's done, see
+ * txn_limbo::is_writing_confirm.
+ */
+static void
+txn_limbo_confirm(struct txn_limbo *limbo, int64_t lsn)
+{
+	assert(lsn > limbo->confirmed_lsn);
+	assert(!limbo->is_in_rollback);
+	limbo->confirmed_lsn = lsn;
+	if (limbo->is_writing_confirm)
+		return;
+	limbo->is_writing_confirm = true;
+	do {
+		lsn = limbo->confirmed_lsn;
+		txn_limbo_write_confirm(limbo, lsn);
+		txn_limbo_read_confirm(limbo, lsn);
+	} while (txn_limbo_has_confirm_pending(limbo));
+	limbo->is_writing_confirm = false;
+}
+
 /**
  * Write a rollback message to WAL. After it's written all the
  * transactions following the current one and waiting for
@@ -594,8 +646,7 @@ txn_limbo_ack(struct txn_limbo *limbo, uint32_t replica_id, int64_t lsn)
 	}
 	if (confirm_lsn == -1 || confirm_lsn <= limbo->confirmed_lsn)
 		return;
-	txn_limbo_write_confirm(limbo, confirm_lsn);
-	txn_limbo_read_confirm(limbo, confirm_lsn);
+	txn_limbo_confirm(limbo, confirm_lsn);
 }
 
 /**
@@ -805,10 +856,8 @@ txn_limbo_on_parameters_change(struct txn_limbo *limbo)
 			assert(confirm_lsn > 0);
 		}
 	}
-	if (confirm_lsn > limbo->confirmed_lsn && !limbo->is_in_rollback) {
-		txn_limbo_write_confirm(limbo, confirm_lsn);
-		txn_limbo_read_confirm(limbo, confirm_lsn);
-	}
+	if (confirm_lsn > limbo->confirmed_lsn && !limbo->is_in_rollback)
+		txn_limbo_confirm(limbo, confirm_lsn);
 	/*
 	 * Wakeup all the others - timed out will rollback. Also
 	 * there can be non-transactional waiters, such as CONFIRM
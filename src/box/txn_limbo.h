@@ -31,6 +31,7 @@
  */
 #include "small/rlist.h"
 #include "vclock/vclock.h"
+#include "latency.h"
 
 #include <stdint.h>
 
@@ -60,6 +61,8 @@ struct txn_limbo_entry {
 	 * confirmed receipt of the transaction.
 	 */
 	int ack_count;
+	/** Time when the entry was added to the limbo. */
+	double insertion_time;
 	/**
 	 * Result flags. Only one of them can be true. But both
 	 * can be false if the transaction is still waiting for
@@ -155,6 +158,25 @@ struct txn_limbo {
 	 * illegal.
 	 */
 	int64_t confirmed_lsn;
+	/**
+	 * Whether a CONFIRM is being written to WAL. Quorum advances
+	 * made while it's in progress don't write CONFIRMs on their
+	 * own. Instead, they only bump confirmed_lsn, and the fiber
+	 * writing the CONFIRM writes one more for all of them once
+	 * it's done. This way, no matter how many transactions gather
+	 * quorum during a WAL write, they are confirmed with a single
+	 * CONFIRM entry.
+	 */
+	bool is_writing_confirm;
+	/** Number of CONFIRM entries written by the instance. */
+	int64_t confirm_count;
+	/**
+	 * Latency of synchronous transactions, from the moment they
+	 * are added to the limbo until they are confirmed.
+	 */
+	struct latency commit_latency;
+	/** Latency of CONFIRM WAL writes. */
+	struct latency confirm_latency;
 	/**
 	 * Total number of performed rollbacks. It used as a guard
 	 * to do some actions assuming all limbo transactions will
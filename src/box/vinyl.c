@@ -583,6 +583,18 @@ vinyl_engine_check_space_def(struct space_def *def)
 			 def->name, "engine does not support temporary flag");
 		return -1;
 	}
+	for (uint32_t i = 0; i < def->field_count; i++) {
+		if (def->fields[i].compression != COMPRESSION_TYPE_NONE) {
+			diag_set(ClientError, ER_ALTER_SPACE, def->name,
+				 "engine does not support field compression");
+			return -1;
+		}
+	}
+	if (def->opts.compact_field_map) {
+		diag_set(ClientError, ER_ALTER_SPACE, def->name,
+			 "engine does not support compact_field_map flag");
+		return -1;
+	}
 	return 0;
 }
 
@@ -677,6 +689,52 @@ vinyl_space_check_index_def(struct space *space, struct index_def *index_def)
 			 "functional index");
 		return -1;
 	}
+	if (index_def->opts.ttl > 0 && index_def->iid != 0) {
+		diag_set(ClientError, ER_MODIFY_INDEX,
+			 index_def->name, space_name(space),
+			 "ttl is only supported by primary index");
+		return -1;
+	}
+	/*
+	 * Expired tuples are dropped by compaction of the primary
+	 * index, which doesn't generate DELETEs for secondary
+	 * indexes, so we can't let a space with ttl have them.
+	 */
+	struct index *pk = space_index(space, 0);
+	if ((index_def->opts.ttl > 0 && space->index_count > 1) ||
+	    (index_def->iid != 0 && pk != NULL && pk->def->opts.ttl > 0)) {
+		diag_set(ClientError, ER_MODIFY_INDEX,
+			 index_def->name, space_name(space),
+			 "ttl is not supported by spaces with secondary "
+			 "indexes");
+		return -1;
+	}
+	uint32_t ttl_field = index_def->opts.ttl_field;
+	if (index_def->opts.ttl > 0 && ttl_field == UINT32_MAX) {
+		diag_set(ClientError, ER_MODIFY_INDEX,
+			 index_def->name, space_name(space),
+			 "ttl_field must be set along with ttl");
+		return -1;
+	}
+	/*
+	 * The time field doesn't have to be in the space format,
+	 * but if it is, it must be numeric.
+	 */
+	if (index_def->opts.ttl > 0 &&
+	    ttl_field < space->def->field_count &&
+	    !field_type1_contains_type2(FIELD_TYPE_NUMBER,
+					space->def->fields[ttl_field].type)) {
+		diag_set(ClientError, ER_MODIFY_INDEX,
+			 index_def->name, space_name(space),
+			 "ttl_field must have a numeric type");
+		return -1;
+	}
+	if (index_def->opts.blob_threshold > 0 && index_def->iid != 0) {
+		diag_set(ClientError, ER_MODIFY_INDEX,
+			 index_def->name, space_name(space),
+			 "blob_threshold is only supported by primary index");
+		return -1;
+	}
 	return 0;
 }
 
@@ -934,6 +992,14 @@ vinyl_index_def_change_requires_rebuild(struct index *index,
 		return true;
 	if (old_def->opts.func_id != new_def->opts.func_id)
 		return true;
+	/*
+	 * Runs written with key-value separation enabled store
+	 * references to blob files instead of field values so
+	 * we can't switch it on or off without rewriting them.
+	 */
+	if ((old_def->opts.blob_threshold > 0) !=
+	    (new_def->opts.blob_threshold > 0))
+		return true;
 
 	assert(index_depends_on_pk(index));
 	const struct key_def *old_cmp_def = old_def->cmp_def;
@@ -1406,6 +1472,11 @@ vy_get(struct vy_lsm *lsm, struct vy_tx *tx,
 			return -1;
 		if (vy_point_lookup(lsm, tx, rv, key, &partial) != 0)
 			return -1;
+		if (partial.stmt != NULL &&
+		    vy_lsm_tuple_is_expired(lsm, partial.stmt)) {
+			tuple_unref(partial.stmt);
+			partial = vy_entry_none();
+		}
 		if (lsm->index_id > 0 && partial.stmt != NULL) {
 			rc = vy_get_by_secondary_tuple(lsm, tx, rv,
 						       partial, &entry);
@@ -2113,7 +2184,14 @@ vy_upsert(struct vy_env *env, struct vy_tx *tx, struct txn_stmt *stmt,
 	if (tuple_validate_raw(pk->mem_format, tuple))
 		return -1;
 
-	if (space->index_count == 1 && rlist_empty(&space->on_replace))
+	/*
+	 * UPSERT statements can't be applied to statements that
+	 * have fields moved to blob files on compaction so if
+	 * key-value separation is enabled, we always turn UPSERT
+	 * into REPLACE.
+	 */
+	if (space->index_count == 1 && rlist_empty(&space->on_replace) &&
+	    pk->opts.blob_threshold == 0)
 		return vy_lsm_upsert(tx, pk, tuple, tuple_end, ops, ops_end);
 
 	const char *old_tuple, *old_tuple_end;
@@ -2572,7 +2650,8 @@ vy_squash_schedule(struct vy_lsm *lsm, struct vy_entry entry,
 
 static struct vy_env *
 vy_env_new(const char *path, size_t memory,
-	   int read_threads, int write_threads, bool force_recovery)
+	   int read_threads, int write_threads, bool direct_io,
+	   bool force_recovery)
 {
 	struct vy_env *e = malloc(sizeof(*e));
 	if (unlikely(e == NULL)) {
@@ -2619,6 +2698,7 @@ vy_env_new(const char *path, size_t memory,
 	               sizeof(struct vinyl_iterator));
 	vy_cache_env_create(&e->cache_env, slab_cache);
 	vy_run_env_create(&e->run_env, read_threads);
+	e->run_env.direct_io = direct_io;
 	vy_log_init(e->path);
 	return e;
 
@@ -2671,10 +2751,12 @@ vy_env_complete_recovery(struct vy_env *env)
 
 struct engine *
 vinyl_engine_new(const char *dir, size_t memory,
-		 int read_threads, int write_threads, bool force_recovery)
+		 int read_threads, int write_threads, bool direct_io,
+		 bool force_recovery)
 {
 	struct vy_env *env = vy_env_new(dir, memory, read_threads,
-					write_threads, force_recovery);
+					write_threads, direct_io,
+					force_recovery);
 	if (env == NULL)
 		return NULL;
 
@@ -2697,6 +2779,13 @@ vinyl_engine_set_cache(struct engine *engine, size_t quota)
 	vy_cache_env_set_quota(&env->cache_env, quota);
 }
 
+void
+vinyl_engine_set_page_cache(struct engine *engine, size_t quota)
+{
+	struct vy_env *env = vy_env(engine);
+	vy_run_env_set_page_cache(&env->run_env, quota);
+}
+
 int
 vinyl_engine_set_memory(struct engine *engine, size_t size)
 {
@@ -3055,6 +3144,22 @@ vinyl_engine_complete_join(struct engine *engine, void *arg)
 
 /* {{{ Garbage collection */
 
+/**
+ * Return true if a blob file with the given id was written to
+ * the log as a part of an LSM tree.
+ */
+static bool
+vy_lsm_recovery_info_has_blob(struct vy_lsm_recovery_info *lsm_info,
+			      int64_t blob_id)
+{
+	struct vy_blob_recovery_info *blob_info;
+	rlist_foreach_entry(blob_info, &lsm_info->blobs, in_lsm) {
+		if (blob_info->id == blob_id)
+			return true;
+	}
+	return false;
+}
+
 /**
  * Given a record encoding information about a vinyl run, try to
  * delete the corresponding files. On success, write a "forget" record
@@ -3070,6 +3175,19 @@ vy_gc_run(struct vy_env *env,
 	if (vy_run_remove_files(env->path, lsm_info->space_id,
 				lsm_info->index_id, run_info->id) != 0)
 		return;
+	/*
+	 * A blob file written along with a run is logged only if
+	 * the run is committed. If it isn't, because the run was
+	 * never completed or the task writing it failed or was
+	 * aborted after the files had been written, delete the
+	 * blob file together with the run files. A logged blob
+	 * file may outlive the run so it's deleted separately,
+	 * see vy_gc_blob().
+	 */
+	if (!vy_lsm_recovery_info_has_blob(lsm_info, run_info->id) &&
+	    vy_blob_remove_files(env->path, lsm_info->space_id,
+				 lsm_info->index_id, run_info->id) != 0)
+		return;
 
 	/* Forget the run on success. */
 	vy_log_tx_begin();
@@ -3083,6 +3201,26 @@ vy_gc_run(struct vy_env *env,
 	vy_log_tx_try_commit();
 }
 
+/**
+ * Given a record encoding information about a blob file, try to
+ * delete the file. On success, write a "forget" record to the log.
+ */
+static void
+vy_gc_blob(struct vy_env *env,
+	   struct vy_lsm_recovery_info *lsm_info,
+	   struct vy_blob_recovery_info *blob_info)
+{
+	/* Try to delete the file. */
+	if (vy_blob_remove_files(env->path, lsm_info->space_id,
+				 lsm_info->index_id, blob_info->id) != 0)
+		return;
+
+	/* Forget the blob file on success. */
+	vy_log_tx_begin();
+	vy_log_forget_blob(blob_info->id);
+	vy_log_tx_try_commit();
+}
+
 /**
  * Given a dropped or not fully built LSM tree, delete all its
  * ranges and slices and mark all its runs as dropped. Forget
@@ -3116,8 +3254,17 @@ vy_gc_lsm(struct vy_lsm_recovery_info *lsm_info)
 			vy_log_drop_run(run_info->id, run_info->gc_lsn);
 		}
 	}
+	struct vy_blob_recovery_info *blob_info;
+	rlist_foreach_entry(blob_info, &lsm_info->blobs, in_lsm) {
+		if (!blob_info->is_dropped) {
+			blob_info->is_dropped = true;
+			blob_info->gc_lsn = lsm_info->drop_lsn;
+			vy_log_drop_blob(blob_info->id, blob_info->gc_lsn);
+		}
+	}
 	if (rlist_empty(&lsm_info->ranges) &&
-	    rlist_empty(&lsm_info->runs))
+	    rlist_empty(&lsm_info->runs) &&
+	    rlist_empty(&lsm_info->blobs))
 		vy_log_forget_lsm(lsm_info->id);
 	vy_log_tx_try_commit();
 }
@@ -3154,6 +3301,16 @@ vy_gc(struct vy_env *env, struct vy_recovery *recovery,
 			if (loops % VY_YIELD_LOOPS == 0)
 				fiber_sleep(0);
 		}
+
+		struct vy_blob_recovery_info *blob_info;
+		rlist_foreach_entry(blob_info, &lsm_info->blobs, in_lsm) {
+			if (blob_info->is_dropped &&
+			    blob_info->gc_lsn < gc_lsn &&
+			    (gc_mask & VY_GC_DROPPED) != 0)
+				vy_gc_blob(env, lsm_info, blob_info);
+			if (loops % VY_YIELD_LOOPS == 0)
+				fiber_sleep(0);
+		}
 	}
 }
 
@@ -3229,6 +3386,19 @@ vinyl_engine_backup(struct engine *engine, const struct vclock *vclock,
 			if (loops % VY_YIELD_LOOPS == 0)
 				fiber_sleep(0);
 		}
+		struct vy_blob_recovery_info *blob_info;
+		rlist_foreach_entry(blob_info, &lsm_info->blobs, in_lsm) {
+			if (blob_info->is_dropped)
+				continue;
+			char path[PATH_MAX];
+			vy_blob_snprint_path(path, sizeof(path), env->path,
+					     lsm_info->space_id,
+					     lsm_info->index_id,
+					     blob_info->id, false);
+			rc = cb(path, cb_arg);
+			if (rc != 0)
+				goto out;
+		}
 	}
 out:
 	vy_recovery_delete(recovery);
@@ -4193,6 +4363,26 @@ vinyl_space_build_index(struct space *src_space, struct index *new_index,
 	if (!need_wal_sync && vy_lsm_is_empty(pk))
 		return 0; /* space is empty, nothing to do */
 
+	/*
+	 * Dump and compaction of the primary index move big fields
+	 * that aren't indexed to blob files, see blob_threshold.
+	 * Keys extracted from such fields would be blob references
+	 * rather than values, so we can only index fields that are
+	 * already indexed or precede an indexed field.
+	 */
+	if (pk->opts.blob_threshold > 0) {
+		struct key_def *key_def = new_index->def->key_def;
+		for (uint32_t i = 0; i < key_def->part_count; i++) {
+			if (key_def->parts[i].fieldno <
+			    src_space->format->index_field_count)
+				continue;
+			diag_set(ClientError, ER_UNSUPPORTED, "Vinyl",
+				 "indexing fields that may be stored in "
+				 "blob files");
+			return -1;
+		}
+	}
+
 	if (txn_check_singlestatement(txn, "index build") != 0)
 		return -1;
 
@@ -43,7 +43,8 @@ struct engine;
 
 struct engine *
 vinyl_engine_new(const char *dir, size_t memory,
-		 int read_threads, int write_threads, bool force_recovery);
+		 int read_threads, int write_threads, bool direct_io,
+		 bool force_recovery);
 
 /**
  * Vinyl engine statistics (box.stat.vinyl()).
@@ -57,6 +58,12 @@ vinyl_engine_stat(struct engine *engine, struct info_handler *handler);
 void
 vinyl_engine_set_cache(struct engine *engine, size_t quota);
 
+/**
+ * Update vinyl page cache size.
+ */
+void
+vinyl_engine_set_page_cache(struct engine *engine, size_t quota);
+
 /**
  * Update vinyl memory size.
  */
@@ -95,11 +102,12 @@ vinyl_engine_set_snap_io_rate_limit(struct engine *engine, double limit);
 
 static inline struct engine *
 vinyl_engine_new_xc(const char *dir, size_t memory,
-		    int read_threads, int write_threads, bool force_recovery)
+		    int read_threads, int write_threads, bool direct_io,
+		    bool force_recovery)
 {
 	struct engine *vinyl;
 	vinyl = vinyl_engine_new(dir, memory, read_threads,
-				 write_threads, force_recovery);
+				 write_threads, direct_io, force_recovery);
 	if (vinyl == NULL)
 		diag_raise();
 	return vinyl;
@@ -31,6 +31,7 @@
 #include "vy_history.h"
 
 #include <assert.h>
+#include <math.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <small/mempool.h>
@@ -74,6 +75,7 @@ vy_history_cleanup(struct vy_history *history)
 
 int
 vy_history_apply(struct vy_history *history, struct key_def *cmp_def,
+		 uint32_t expire_fieldno, double expire_deadline,
 		 bool keep_delete, int *upserts_applied, struct vy_entry *ret)
 {
 	*ret = vy_entry_none();
@@ -103,6 +105,12 @@ vy_history_apply(struct vy_history *history, struct key_def *cmp_def,
 		node = rlist_prev_entry_safe(node, &history->stmts, link);
 	}
 	while (node != NULL) {
+		if (curr.stmt != NULL && expire_deadline > -INFINITY &&
+		    vy_stmt_is_expired(curr.stmt, expire_fieldno,
+				       expire_deadline)) {
+			tuple_unref(curr.stmt);
+			curr = vy_entry_none();
+		}
 		struct vy_entry entry = vy_entry_apply_upsert(node->entry, curr,
 							      cmp_def, true);
 		++*upserts_applied;
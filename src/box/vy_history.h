@@ -149,9 +149,13 @@ vy_history_cleanup(struct vy_history *history);
  * Get a resultant statement from collected history.
  * If the resultant statement is a DELETE, the function
  * will return NULL unless @keep_delete flag is set.
+ * An UPSERT is applied to a tuple that has expired by
+ * @expire_deadline (see vy_stmt_is_expired()) as if there
+ * were no tuple. Pass -INFINITY if tuples never expire.
  */
 int
 vy_history_apply(struct vy_history *history, struct key_def *cmp_def,
+		 uint32_t expire_fieldno, double expire_deadline,
 		 bool keep_delete, int *upserts_applied, struct vy_entry *ret);
 
 #if defined(__cplusplus)
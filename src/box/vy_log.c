@@ -86,6 +86,8 @@ enum vy_log_key {
 	VY_LOG_KEY_DROP_LSN		= 14,
 	VY_LOG_KEY_GROUP_ID		= 15,
 	VY_LOG_KEY_DUMP_COUNT		= 16,
+	VY_LOG_KEY_BLOB_ID		= 17,
+	VY_LOG_KEY_GARBAGE_SIZE		= 18,
 };
 
 /** vy_log_key -> human readable name. */
@@ -107,6 +109,8 @@ static const char *vy_log_key_name[] = {
 	[VY_LOG_KEY_DROP_LSN]		= "drop_lsn",
 	[VY_LOG_KEY_GROUP_ID]		= "group_id",
 	[VY_LOG_KEY_DUMP_COUNT]		= "dump_count",
+	[VY_LOG_KEY_BLOB_ID]		= "blob_id",
+	[VY_LOG_KEY_GARBAGE_SIZE]	= "garbage_size",
 };
 
 /** vy_log_type -> human readable name. */
@@ -129,6 +133,10 @@ static const char *vy_log_type_name[] = {
 	[VY_LOG_PREPARE_LSM]		= "prepare_lsm",
 	[VY_LOG_REBOOTSTRAP]		= "rebootstrap",
 	[VY_LOG_ABORT_REBOOTSTRAP]	= "abort_rebootstrap",
+	[VY_LOG_CREATE_BLOB]		= "create_blob",
+	[VY_LOG_DROP_BLOB]		= "drop_blob",
+	[VY_LOG_FORGET_BLOB]		= "forget_blob",
+	[VY_LOG_MODIFY_BLOB]		= "modify_blob",
 };
 
 /** Batch of vylog records that must be written in one go. */
@@ -314,6 +322,14 @@ vy_log_record_snprint(char *buf, int size, const struct vy_log_record *record)
 		SNPRINT(total, snprintf, buf, size, "%s=%"PRIu32", ",
 			vy_log_key_name[VY_LOG_KEY_DUMP_COUNT],
 			record->dump_count);
+	if (record->blob_id > 0)
+		SNPRINT(total, snprintf, buf, size, "%s=%"PRIi64", ",
+			vy_log_key_name[VY_LOG_KEY_BLOB_ID],
+			record->blob_id);
+	if (record->garbage_size > 0)
+		SNPRINT(total, snprintf, buf, size, "%s=%"PRIu64", ",
+			vy_log_key_name[VY_LOG_KEY_GARBAGE_SIZE],
+			record->garbage_size);
 	SNPRINT(total, snprintf, buf, size, "}");
 	return total;
 }
@@ -445,6 +461,16 @@ vy_log_record_encode(const struct vy_log_record *record,
 		size += mp_sizeof_uint(record->dump_count);
 		n_keys++;
 	}
+	if (record->blob_id > 0) {
+		size += mp_sizeof_uint(VY_LOG_KEY_BLOB_ID);
+		size += mp_sizeof_uint(record->blob_id);
+		n_keys++;
+	}
+	if (record->garbage_size > 0) {
+		size += mp_sizeof_uint(VY_LOG_KEY_GARBAGE_SIZE);
+		size += mp_sizeof_uint(record->garbage_size);
+		n_keys++;
+	}
 	size += mp_sizeof_map(n_keys);
 
 	/*
@@ -531,6 +557,14 @@ vy_log_record_encode(const struct vy_log_record *record,
 		pos = mp_encode_uint(pos, VY_LOG_KEY_DUMP_COUNT);
 		pos = mp_encode_uint(pos, record->dump_count);
 	}
+	if (record->blob_id > 0) {
+		pos = mp_encode_uint(pos, VY_LOG_KEY_BLOB_ID);
+		pos = mp_encode_uint(pos, record->blob_id);
+	}
+	if (record->garbage_size > 0) {
+		pos = mp_encode_uint(pos, VY_LOG_KEY_GARBAGE_SIZE);
+		pos = mp_encode_uint(pos, record->garbage_size);
+	}
 	assert(pos == tuple + size);
 
 	/*
@@ -663,6 +697,12 @@ vy_log_record_decode(struct vy_log_record *record,
 		case VY_LOG_KEY_DUMP_COUNT:
 			record->dump_count = mp_decode_uint(&pos);
 			break;
+		case VY_LOG_KEY_BLOB_ID:
+			record->blob_id = mp_decode_uint(&pos);
+			break;
+		case VY_LOG_KEY_GARBAGE_SIZE:
+			record->garbage_size = mp_decode_uint(&pos);
+			break;
 		default:
 			mp_next(&pos); /* unknown key, ignore */
 			break;
@@ -1449,6 +1489,17 @@ vy_recovery_lookup_range(struct vy_recovery *recovery, int64_t range_id)
 	return mh_i64ptr_node(h, k)->val;
 }
 
+/** Lookup a blob file in vy_recovery::blob_hash map. */
+static struct vy_blob_recovery_info *
+vy_recovery_lookup_blob(struct vy_recovery *recovery, int64_t blob_id)
+{
+	struct mh_i64ptr_t *h = recovery->blob_hash;
+	mh_int_t k = mh_i64ptr_find(h, blob_id, NULL);
+	if (k == mh_end(h))
+		return NULL;
+	return mh_i64ptr_node(h, k)->val;
+}
+
 /** Lookup a vinyl run in vy_recovery::run_hash map. */
 static struct vy_run_recovery_info *
 vy_recovery_lookup_run(struct vy_recovery *recovery, int64_t run_id)
@@ -1558,6 +1609,7 @@ vy_recovery_do_create_lsm(struct vy_recovery *recovery, int64_t id,
 	lsm->prepared = NULL;
 	rlist_create(&lsm->ranges);
 	rlist_create(&lsm->runs);
+	rlist_create(&lsm->blobs);
 	/*
 	 * Keep newer LSM trees closer to the tail of the list
 	 * so that on log rotation we create/drop past incarnations
@@ -1730,10 +1782,11 @@ vy_recovery_forget_lsm(struct vy_recovery *recovery, int64_t id)
 		return -1;
 	}
 	struct vy_lsm_recovery_info *lsm = mh_i64ptr_node(h, k)->val;
-	if (!rlist_empty(&lsm->ranges) || !rlist_empty(&lsm->runs)) {
+	if (!rlist_empty(&lsm->ranges) || !rlist_empty(&lsm->runs) ||
+	    !rlist_empty(&lsm->blobs)) {
 		diag_set(ClientError, ER_INVALID_VYLOG_FILE,
-			 tt_sprintf("Forgotten LSM tree %lld has ranges/runs",
-				    (long long)id));
+			 tt_sprintf("Forgotten LSM tree %lld has "
+				    "ranges/runs/blobs", (long long)id));
 		return -1;
 	}
 	mh_i64ptr_del(h, k, NULL);
@@ -1925,6 +1978,134 @@ vy_recovery_forget_run(struct vy_recovery *recovery, int64_t run_id)
 	return 0;
 }
 
+/**
+ * Handle a VY_LOG_CREATE_BLOB log record.
+ * This function allocates a new blob file with ID @blob_id,
+ * inserts it to the hash, and adds it to the list of blob files
+ * of the LSM tree with ID @lsm_id.
+ * Return 0 on success, -1 if blob file already exists, LSM tree
+ * not found, or OOM.
+ */
+static int
+vy_recovery_create_blob(struct vy_recovery *recovery, int64_t lsm_id,
+			int64_t blob_id)
+{
+	struct vy_lsm_recovery_info *lsm;
+	lsm = vy_recovery_lookup_lsm(recovery, lsm_id);
+	if (lsm == NULL) {
+		diag_set(ClientError, ER_INVALID_VYLOG_FILE,
+			 tt_sprintf("Blob %lld created for unregistered "
+				    "LSM tree %lld", (long long)blob_id,
+				    (long long)lsm_id));
+		return -1;
+	}
+	if (vy_recovery_lookup_blob(recovery, blob_id) != NULL) {
+		diag_set(ClientError, ER_INVALID_VYLOG_FILE,
+			 tt_sprintf("Duplicate blob id %lld",
+				    (long long)blob_id));
+		return -1;
+	}
+	struct vy_blob_recovery_info *blob = malloc(sizeof(*blob));
+	if (blob == NULL) {
+		diag_set(OutOfMemory, sizeof(*blob),
+			 "malloc", "struct vy_blob_recovery_info");
+		return -1;
+	}
+	struct mh_i64ptr_t *h = recovery->blob_hash;
+	struct mh_i64ptr_node_t node = { blob_id, blob };
+	struct mh_i64ptr_node_t *old_node = NULL;
+	mh_i64ptr_put(h, &node, &old_node, NULL);
+	assert(old_node == NULL);
+	blob->id = blob_id;
+	blob->gc_lsn = -1;
+	blob->is_dropped = false;
+	blob->garbage_size = 0;
+	blob->data = NULL;
+	rlist_add_tail_entry(&lsm->blobs, blob, in_lsm);
+	if (recovery->max_id < blob_id)
+		recovery->max_id = blob_id;
+	return 0;
+}
+
+/**
+ * Handle a VY_LOG_DROP_BLOB log record.
+ * This function marks the blob file with ID @blob_id as deleted.
+ * Return 0 on success, -1 if blob file not found or already deleted.
+ */
+static int
+vy_recovery_drop_blob(struct vy_recovery *recovery, int64_t blob_id,
+		      int64_t gc_lsn)
+{
+	struct vy_blob_recovery_info *blob;
+	blob = vy_recovery_lookup_blob(recovery, blob_id);
+	if (blob == NULL) {
+		diag_set(ClientError, ER_INVALID_VYLOG_FILE,
+			 tt_sprintf("Blob %lld deleted but not registered",
+				    (long long)blob_id));
+		return -1;
+	}
+	if (blob->is_dropped) {
+		diag_set(ClientError, ER_INVALID_VYLOG_FILE,
+			 tt_sprintf("Blob %lld deleted twice",
+				    (long long)blob_id));
+		return -1;
+	}
+	blob->is_dropped = true;
+	blob->gc_lsn = gc_lsn;
+	return 0;
+}
+
+/**
+ * Handle a VY_LOG_FORGET_BLOB log record.
+ * This function frees the blob file with ID @blob_id.
+ * Return 0 on success, -1 if blob file not found.
+ */
+static int
+vy_recovery_forget_blob(struct vy_recovery *recovery, int64_t blob_id)
+{
+	struct mh_i64ptr_t *h = recovery->blob_hash;
+	mh_int_t k = mh_i64ptr_find(h, blob_id, NULL);
+	if (k == mh_end(h)) {
+		diag_set(ClientError, ER_INVALID_VYLOG_FILE,
+			 tt_sprintf("Blob %lld forgotten but not registered",
+				    (long long)blob_id));
+		return -1;
+	}
+	struct vy_blob_recovery_info *blob = mh_i64ptr_node(h, k)->val;
+	mh_i64ptr_del(h, k, NULL);
+	rlist_del_entry(blob, in_lsm);
+	free(blob);
+	return 0;
+}
+
+/**
+ * Handle a VY_LOG_MODIFY_BLOB log record.
+ * This function updates the size of garbage stored in the blob
+ * file with ID @blob_id.
+ * Return 0 on success, -1 if blob file not found or deleted.
+ */
+static int
+vy_recovery_modify_blob(struct vy_recovery *recovery, int64_t blob_id,
+			uint64_t garbage_size)
+{
+	struct vy_blob_recovery_info *blob;
+	blob = vy_recovery_lookup_blob(recovery, blob_id);
+	if (blob == NULL) {
+		diag_set(ClientError, ER_INVALID_VYLOG_FILE,
+			 tt_sprintf("Blob %lld modified but not registered",
+				    (long long)blob_id));
+		return -1;
+	}
+	if (blob->is_dropped) {
+		diag_set(ClientError, ER_INVALID_VYLOG_FILE,
+			 tt_sprintf("Blob %lld modified after deletion",
+				    (long long)blob_id));
+		return -1;
+	}
+	blob->garbage_size = garbage_size;
+	return 0;
+}
+
 /**
  * Handle a VY_LOG_INSERT_RANGE log record.
  * This function allocates a new vinyl range with ID @range_id,
@@ -2252,6 +2433,21 @@ vy_recovery_process_record(struct vy_recovery *recovery,
 	case VY_LOG_ABORT_REBOOTSTRAP:
 		vy_recovery_abort_rebootstrap(recovery);
 		break;
+	case VY_LOG_CREATE_BLOB:
+		rc = vy_recovery_create_blob(recovery, record->lsm_id,
+					     record->blob_id);
+		break;
+	case VY_LOG_DROP_BLOB:
+		rc = vy_recovery_drop_blob(recovery, record->blob_id,
+					   record->gc_lsn);
+		break;
+	case VY_LOG_FORGET_BLOB:
+		rc = vy_recovery_forget_blob(recovery, record->blob_id);
+		break;
+	case VY_LOG_MODIFY_BLOB:
+		rc = vy_recovery_modify_blob(recovery, record->blob_id,
+					     record->garbage_size);
+		break;
 	default:
 		unreachable();
 	}
@@ -2368,6 +2564,7 @@ vy_recovery_new_f(va_list ap)
 	recovery->range_hash = NULL;
 	recovery->run_hash = NULL;
 	recovery->slice_hash = NULL;
+	recovery->blob_hash = NULL;
 	recovery->max_id = -1;
 	recovery->in_rebootstrap = false;
 
@@ -2376,6 +2573,7 @@ vy_recovery_new_f(va_list ap)
 	recovery->range_hash = mh_i64ptr_new();
 	recovery->run_hash = mh_i64ptr_new();
 	recovery->slice_hash = mh_i64ptr_new();
+	recovery->blob_hash = mh_i64ptr_new();
 
 	/*
 	 * We don't create a log file if there are no objects to
@@ -2487,6 +2685,7 @@ vy_recovery_delete(struct vy_recovery *recovery)
 	struct vy_range_recovery_info *range, *next_range;
 	struct vy_slice_recovery_info *slice, *next_slice;
 	struct vy_run_recovery_info *run, *next_run;
+	struct vy_blob_recovery_info *blob, *next_blob;
 
 	rlist_foreach_entry_safe(lsm, &recovery->lsms, in_recovery, next_lsm) {
 		rlist_foreach_entry_safe(range, &lsm->ranges,
@@ -2498,6 +2697,8 @@ vy_recovery_delete(struct vy_recovery *recovery)
 		}
 		rlist_foreach_entry_safe(run, &lsm->runs, in_lsm, next_run)
 			free(run);
+		rlist_foreach_entry_safe(blob, &lsm->blobs, in_lsm, next_blob)
+			free(blob);
 		free(lsm->key_parts);
 		free(lsm);
 	}
@@ -2511,6 +2712,8 @@ vy_recovery_delete(struct vy_recovery *recovery)
 		mh_i64ptr_delete(recovery->run_hash);
 	if (recovery->slice_hash != NULL)
 		mh_i64ptr_delete(recovery->slice_hash);
+	if (recovery->blob_hash != NULL)
+		mh_i64ptr_delete(recovery->blob_hash);
 	TRASH(recovery);
 	free(recovery);
 }
@@ -2536,6 +2739,7 @@ vy_log_append_lsm(struct xlog *xlog, struct vy_lsm_recovery_info *lsm)
 	struct vy_range_recovery_info *range;
 	struct vy_slice_recovery_info *slice;
 	struct vy_run_recovery_info *run;
+	struct vy_blob_recovery_info *blob;
 	struct vy_log_record record;
 
 	vy_log_record_init(&record);
@@ -2578,6 +2782,34 @@ vy_log_append_lsm(struct xlog *xlog, struct vy_lsm_recovery_info *lsm)
 			return -1;
 	}
 
+	rlist_foreach_entry(blob, &lsm->blobs, in_lsm) {
+		vy_log_record_init(&record);
+		record.type = VY_LOG_CREATE_BLOB;
+		record.lsm_id = lsm->id;
+		record.blob_id = blob->id;
+		if (vy_log_append_record(xlog, &record) != 0)
+			return -1;
+
+		if (!blob->is_dropped) {
+			if (blob->garbage_size == 0)
+				continue;
+			vy_log_record_init(&record);
+			record.type = VY_LOG_MODIFY_BLOB;
+			record.blob_id = blob->id;
+			record.garbage_size = blob->garbage_size;
+			if (vy_log_append_record(xlog, &record) != 0)
+				return -1;
+			continue;
+		}
+
+		vy_log_record_init(&record);
+		record.type = VY_LOG_DROP_BLOB;
+		record.blob_id = blob->id;
+		record.gc_lsn = blob->gc_lsn;
+		if (vy_log_append_record(xlog, &record) != 0)
+			return -1;
+	}
+
 	rlist_foreach_entry(range, &lsm->ranges, in_lsm) {
 		vy_log_record_init(&record);
 		record.type = VY_LOG_INSERT_RANGE;
@@ -217,6 +217,44 @@ enum vy_log_record_type {
 	 * See also VY_LOG_REBOOTSTRAP.
 	 */
 	VY_LOG_ABORT_REBOOTSTRAP	= 17,
+	/**
+	 * Commit a blob file creation.
+	 * Requires vy_log_record::lsm_id, blob_id.
+	 *
+	 * Written along with VY_LOG_CREATE_RUN for the run the blob
+	 * file was written with. A blob file may outlive the run,
+	 * because values stored in it may be referenced by runs
+	 * created by compaction. The blob file is dropped when no
+	 * run references it any more. If the run the blob file was
+	 * written with is never created, the blob file is removed
+	 * along with the run files.
+	 */
+	VY_LOG_CREATE_BLOB		= 18,
+	/**
+	 * Drop a blob file.
+	 * Requires vy_log_record::blob_id, gc_lsn.
+	 *
+	 * Similarly to VY_LOG_DROP_RUN, this only marks the blob
+	 * file as deleted on recovery. It is freed by
+	 * VY_LOG_FORGET_BLOB.
+	 */
+	VY_LOG_DROP_BLOB		= 19,
+	/**
+	 * Forget a blob file.
+	 * Requires vy_log_record::blob_id.
+	 *
+	 * Written after an unused blob file has been removed.
+	 */
+	VY_LOG_FORGET_BLOB		= 20,
+	/**
+	 * Update the size of garbage in a blob file.
+	 * Requires vy_log_record::blob_id, garbage_size.
+	 *
+	 * Written by compaction for each blob file storing values
+	 * that were referenced by compacted runs, but aren't
+	 * referenced by the compaction output.
+	 */
+	VY_LOG_MODIFY_BLOB		= 21,
 
 	vy_log_record_type_MAX
 };
@@ -283,6 +321,13 @@ struct vy_log_record {
 	int64_t gc_lsn;
 	/** For runs: number of dumps it took to create the run. */
 	uint32_t dump_count;
+	/** Unique ID of the blob file. */
+	int64_t blob_id;
+	/**
+	 * For blob files: size of values stored in the file
+	 * that aren't referenced by any run.
+	 */
+	uint64_t garbage_size;
 	/** Link in vy_log_tx::records. */
 	struct stailq_entry in_tx;
 };
@@ -304,6 +349,8 @@ struct vy_recovery {
 	struct mh_i64ptr_t *run_hash;
 	/** ID -> vy_slice_recovery_info. */
 	struct mh_i64ptr_t *slice_hash;
+	/** ID -> vy_blob_recovery_info. */
+	struct mh_i64ptr_t *blob_hash;
 	/**
 	 * Maximal vinyl object ID, according to the metadata log,
 	 * or -1 in case no vinyl objects were recovered.
@@ -360,6 +407,11 @@ struct vy_lsm_recovery_info {
 	 * vy_run_recovery_info::in_lsm.
 	 */
 	struct rlist runs;
+	/**
+	 * List of all blob files created for the LSM tree,
+	 * linked by vy_blob_recovery_info::in_lsm.
+	 */
+	struct rlist blobs;
 	/**
 	 * Pointer to an LSM tree that is going to replace
 	 * this one after successful ALTER.
@@ -421,6 +473,35 @@ struct vy_run_recovery_info {
 	void *data;
 };
 
+/** Blob file info stored in a recovery context. */
+struct vy_blob_recovery_info {
+	/** Link in vy_lsm_recovery_info::blobs. */
+	struct rlist in_lsm;
+	/** ID of the blob file. */
+	int64_t id;
+	/**
+	 * For deleted blob files: LSN of the last checkpoint
+	 * that uses this blob file.
+	 */
+	int64_t gc_lsn;
+	/** True if the blob file was dropped (VY_LOG_DROP_BLOB). */
+	bool is_dropped;
+	/**
+	 * Size of values stored in the blob file that aren't
+	 * referenced by any run (VY_LOG_MODIFY_BLOB).
+	 */
+	uint64_t garbage_size;
+	/*
+	 * The following field is initialized to NULL and
+	 * ignored by vy_log subsystem. It may be used by
+	 * the caller to store some extra information.
+	 *
+	 * During recovery, we store a pointer to vy_blob
+	 * corresponding to this object.
+	 */
+	void *data;
+};
+
 /** Slice info stored in a recovery context. */
 struct vy_slice_recovery_info {
 	/** Link in vy_range_recovery_info::slices. */
@@ -762,6 +843,53 @@ vy_log_forget_run(int64_t run_id)
 	vy_log_write(&record);
 }
 
+/** Helper to log a blob file creation. */
+static inline void
+vy_log_create_blob(int64_t lsm_id, int64_t blob_id)
+{
+	struct vy_log_record record;
+	vy_log_record_init(&record);
+	record.type = VY_LOG_CREATE_BLOB;
+	record.lsm_id = lsm_id;
+	record.blob_id = blob_id;
+	vy_log_write(&record);
+}
+
+/** Helper to log a blob file deletion. */
+static inline void
+vy_log_drop_blob(int64_t blob_id, int64_t gc_lsn)
+{
+	struct vy_log_record record;
+	vy_log_record_init(&record);
+	record.type = VY_LOG_DROP_BLOB;
+	record.blob_id = blob_id;
+	record.gc_lsn = gc_lsn;
+	vy_log_write(&record);
+}
+
+/** Helper to log a change of the size of garbage in a blob file. */
+static inline void
+vy_log_modify_blob(int64_t blob_id, uint64_t garbage_size)
+{
+	struct vy_log_record record;
+	vy_log_record_init(&record);
+	record.type = VY_LOG_MODIFY_BLOB;
+	record.blob_id = blob_id;
+	record.garbage_size = garbage_size;
+	vy_log_write(&record);
+}
+
+/** Helper to log a blob file cleanup. */
+static inline void
+vy_log_forget_blob(int64_t blob_id)
+{
+	struct vy_log_record record;
+	vy_log_record_init(&record);
+	record.type = VY_LOG_FORGET_BLOB;
+	record.blob_id = blob_id;
+	vy_log_write(&record);
+}
+
 /** Helper to log creation of a run slice. */
 static inline void
 vy_log_insert_slice(int64_t range_id, int64_t run_id, int64_t slice_id,
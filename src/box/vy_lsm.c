@@ -196,6 +196,7 @@ vy_lsm_new(struct vy_lsm_env *lsm_env, struct vy_cache_env *cache_env,
 	vy_range_tree_new(&lsm->range_tree);
 	vy_range_heap_create(&lsm->range_heap);
 	rlist_create(&lsm->runs);
+	rlist_create(&lsm->blobs);
 	lsm->pk = pk;
 	if (pk != NULL)
 		vy_lsm_ref(pk);
@@ -271,6 +272,10 @@ vy_lsm_delete(struct vy_lsm *lsm)
 	rlist_foreach_entry_safe(run, &lsm->runs, in_lsm, next_run)
 		vy_lsm_remove_run(lsm, run);
 
+	struct vy_blob *blob, *next_blob;
+	rlist_foreach_entry_safe(blob, &lsm->blobs, in_lsm, next_blob)
+		vy_lsm_remove_blob(lsm, blob);
+
 	vy_range_tree_iter(&lsm->range_tree, NULL, vy_range_tree_free_cb, NULL);
 	vy_range_heap_destroy(&lsm->range_heap);
 	tuple_format_unref(lsm->disk_format);
@@ -377,6 +382,10 @@ vy_lsm_recover_run(struct vy_lsm *lsm, struct vy_run_recovery_info *run_info,
 		vy_run_unref(run);
 		return NULL;
 	}
+	if (vy_run_bind_blobs(run, &lsm->blobs, NULL) != 0) {
+		vy_run_unref(run);
+		return NULL;
+	}
 	vy_lsm_add_run(lsm, run);
 
 	/*
@@ -607,6 +616,27 @@ vy_lsm_recover(struct vy_lsm *lsm, struct vy_recovery *recovery,
 	 */
 	lsm->dump_lsn = lsm_info->dump_lsn;
 
+	/*
+	 * Open blob files before loading runs, because runs
+	 * reference them.
+	 */
+	struct vy_blob_recovery_info *blob_info;
+	rlist_foreach_entry(blob_info, &lsm_info->blobs, in_lsm) {
+		if (blob_info->is_dropped)
+			continue;
+		struct vy_blob *blob = vy_blob_new(blob_info->id);
+		if (blob == NULL)
+			return -1;
+		if (vy_blob_recover(blob, lsm->env->path, lsm->space_id,
+				    lsm->index_id) != 0) {
+			vy_blob_unref(blob);
+			return -1;
+		}
+		blob->garbage_size = blob_info->garbage_size;
+		vy_lsm_add_blob(lsm, blob);
+		vy_blob_unref(blob);
+	}
+
 	int rc = 0;
 	struct vy_range_recovery_info *range_info;
 	rlist_foreach_entry(range_info, &lsm_info->ranges, in_lsm) {
@@ -748,6 +778,8 @@ vy_lsm_add_run(struct vy_lsm *lsm, struct vy_run *run)
 	assert(rlist_empty(&run->in_lsm));
 	rlist_add_entry(&lsm->runs, run, in_lsm);
 	lsm->run_count++;
+	for (uint32_t i = 0; i < run->info.blob_count; i++)
+		run->blobs[i]->run_count++;
 	vy_disk_stmt_counter_add(&lsm->stat.disk.count, &run->count);
 	vy_stmt_stat_add(&lsm->stat.disk.stmt, &run->info.stmt_stat);
 
@@ -777,6 +809,10 @@ vy_lsm_remove_run(struct vy_lsm *lsm, struct vy_run *run)
 	assert(!rlist_empty(&run->in_lsm));
 	rlist_del_entry(run, in_lsm);
 	lsm->run_count--;
+	for (uint32_t i = 0; i < run->info.blob_count; i++) {
+		assert(run->blobs[i]->run_count > 0);
+		run->blobs[i]->run_count--;
+	}
 	vy_disk_stmt_counter_sub(&lsm->stat.disk.count, &run->count);
 	vy_stmt_stat_sub(&lsm->stat.disk.stmt, &run->info.stmt_stat);
 
@@ -795,6 +831,23 @@ vy_lsm_remove_run(struct vy_lsm *lsm, struct vy_run *run)
 		env->disk_index_size -= run->count.bytes;
 }
 
+void
+vy_lsm_add_blob(struct vy_lsm *lsm, struct vy_blob *blob)
+{
+	assert(rlist_empty(&blob->in_lsm));
+	rlist_add_tail_entry(&lsm->blobs, blob, in_lsm);
+	vy_blob_ref(blob);
+}
+
+void
+vy_lsm_remove_blob(struct vy_lsm *lsm, struct vy_blob *blob)
+{
+	(void)lsm;
+	assert(!rlist_empty(&blob->in_lsm));
+	rlist_del_entry(blob, in_lsm);
+	vy_blob_unref(blob);
+}
+
 void
 vy_lsm_add_range(struct vy_lsm *lsm, struct vy_range *range)
 {
@@ -1023,6 +1076,9 @@ vy_lsm_commit_upsert(struct vy_lsm *lsm, struct vy_mem *mem,
 		older = vy_mem_older_lsn(mem, entry);
 		assert(older.stmt == NULL ||
 		       vy_stmt_type(older.stmt) != IPROTO_UPSERT);
+		if (older.stmt != NULL &&
+		    vy_lsm_tuple_is_expired(lsm, older.stmt))
+			older = vy_entry_none();
 		struct vy_entry upserted;
 		upserted = vy_entry_apply_upsert(entry, older,
 						lsm->cmp_def, false);
@@ -1126,32 +1182,38 @@ vy_lsm_find_range_intersection(struct vy_lsm *lsm,
 	return 0;
 }
 
-bool
-vy_lsm_split_range(struct vy_lsm *lsm, struct vy_range *range)
+/**
+ * Split a range by the given keys. The keys must be sorted in
+ * ascending order and lie strictly inside the range.
+ */
+static bool
+vy_lsm_do_split_range(struct vy_lsm *lsm, struct vy_range *range,
+		      const char **split_keys_raw, int n_split_keys)
 {
 	struct tuple_format *key_format = lsm->env->key_format;
-
-	const char *split_key_raw;
-	if (!vy_range_needs_split(range, vy_lsm_range_size(lsm),
-				  &split_key_raw))
-		return false;
-
-	/* Split a range in two parts. */
-	const int n_parts = 2;
-	struct vy_range *parts[2] = { NULL, NULL };
+	int n_parts = n_split_keys + 1;
+	struct vy_range **parts = NULL;
+	struct vy_entry *keys = NULL;
+
+	parts = calloc(n_parts, sizeof(*parts));
+	keys = calloc(n_parts + 1, sizeof(*keys));
+	if (parts == NULL || keys == NULL) {
+		diag_set(OutOfMemory, n_parts * sizeof(*parts) +
+			 (n_parts + 1) * sizeof(*keys), "malloc", "ranges");
+		goto fail;
+	}
 	/*
 	 * Determine new ranges' boundaries.
 	 */
-	struct vy_entry split_key;
-	split_key = vy_entry_key_from_msgpack(key_format, lsm->cmp_def,
-					      split_key_raw);
-	if (split_key.stmt == NULL)
-		goto fail;
-
-	struct vy_entry keys[3];
 	keys[0] = range->begin;
-	keys[1] = split_key;
-	keys[2] = range->end;
+	keys[n_parts] = range->end;
+	for (int i = 0; i < n_split_keys; i++) {
+		keys[i + 1] = vy_entry_key_from_msgpack(key_format,
+							lsm->cmp_def,
+							split_keys_raw[i]);
+		if (keys[i + 1].stmt == NULL)
+			goto fail;
+	}
 
 	/*
 	 * Allocate new ranges and create slices of
@@ -1216,21 +1278,37 @@ vy_lsm_split_range(struct vy_lsm *lsm, struct vy_range *range)
 	}
 	lsm->range_tree_version++;
 
-	say_info("%s: split range %s by key %s", vy_lsm_name(lsm),
-		 vy_range_str(range), tuple_str(split_key.stmt));
+	if (n_split_keys == 1) {
+		say_info("%s: split range %s by key %s", vy_lsm_name(lsm),
+			 vy_range_str(range), tuple_str(keys[1].stmt));
+	} else {
+		say_info("%s: split range %s in %d parts", vy_lsm_name(lsm),
+			 vy_range_str(range), n_parts);
+	}
 
 	rlist_foreach_entry(slice, &range->slices, in_range)
 		vy_slice_wait_pinned(slice);
 	vy_range_delete(range);
-	tuple_unref(split_key.stmt);
+	for (int i = 1; i < n_parts; i++)
+		tuple_unref(keys[i].stmt);
+	free(keys);
+	free(parts);
 	return true;
 fail:
-	for (int i = 0; i < n_parts; i++) {
-		if (parts[i] != NULL)
-			vy_range_delete(parts[i]);
+	if (parts != NULL) {
+		for (int i = 0; i < n_parts; i++) {
+			if (parts[i] != NULL)
+				vy_range_delete(parts[i]);
+		}
 	}
-	if (split_key.stmt != NULL)
-		tuple_unref(split_key.stmt);
+	if (keys != NULL) {
+		for (int i = 1; i < n_parts; i++) {
+			if (keys[i].stmt != NULL)
+				tuple_unref(keys[i].stmt);
+		}
+	}
+	free(keys);
+	free(parts);
 
 	diag_log();
 	say_error("%s: failed to split range %s",
@@ -1238,6 +1316,37 @@ fail:
 	return false;
 }
 
+bool
+vy_lsm_split_range(struct vy_lsm *lsm, struct vy_range *range)
+{
+	const char *split_key_raw;
+	if (!vy_range_needs_split(range, vy_lsm_range_size(lsm),
+				  &split_key_raw))
+		return false;
+	return vy_lsm_do_split_range(lsm, range, &split_key_raw, 1);
+}
+
+bool
+vy_lsm_split_range_parallel(struct vy_lsm *lsm, struct vy_range *range,
+			    int max_parts)
+{
+	if (max_parts < 2)
+		return false;
+	const char **split_keys_raw = calloc(max_parts - 1,
+					     sizeof(*split_keys_raw));
+	if (split_keys_raw == NULL)
+		return false;
+	bool rc = false;
+	int n_split_keys = vy_range_needs_parallel_split(range,
+					vy_lsm_range_size(lsm), max_parts,
+					split_keys_raw);
+	if (n_split_keys > 0)
+		rc = vy_lsm_do_split_range(lsm, range, split_keys_raw,
+					   n_split_keys);
+	free(split_keys_raw);
+	return rc;
+}
+
 bool
 vy_lsm_coalesce_range(struct vy_lsm *lsm, struct vy_range *range)
 {
@@ -32,6 +32,7 @@
  */
 
 #include <assert.h>
+#include <math.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <small/mempool.h>
@@ -39,6 +40,7 @@
 
 #include "index.h"
 #include "index_def.h"
+#include "clock.h"
 #define HEAP_FORWARD_DECLARATION
 #include "salad/heap.h"
 #include "vy_entry.h"
@@ -54,6 +56,7 @@ extern "C" {
 struct histogram;
 struct tuple;
 struct tuple_format;
+struct vy_blob;
 struct vy_lsm;
 struct vy_mem;
 struct vy_mem_env;
@@ -257,6 +260,12 @@ struct vy_lsm {
 	struct rlist runs;
 	/** Number of entries in all ranges. */
 	int run_count;
+	/**
+	 * List of blob files storing values of this LSM tree,
+	 * linked by vy_blob->in_lsm. Each of them is referenced
+	 * by the LSM tree. See also index_opts::blob_threshold.
+	 */
+	struct rlist blobs;
 	/**
 	 * Histogram accounting how many ranges of the LSM tree
 	 * have a particular number of runs.
@@ -381,6 +390,32 @@ vy_lsm_dumps_per_compaction(struct vy_lsm *lsm)
 	return lsm->sum_dumps_per_compaction / lsm->range_count;
 }
 
+/**
+ * Return the time up to which statements of an LSM tree are
+ * considered expired (see index_opts::ttl) or -INFINITY if the
+ * LSM tree statements never expire.
+ */
+static inline double
+vy_lsm_expire_deadline(struct vy_lsm *lsm)
+{
+	if (lsm->opts.ttl <= 0)
+		return -INFINITY;
+	return clock_realtime() - lsm->opts.ttl;
+}
+
+/**
+ * Return true if a tuple read from an LSM tree has expired
+ * and so must be hidden from the user.
+ */
+static inline bool
+vy_lsm_tuple_is_expired(struct vy_lsm *lsm, struct tuple *tuple)
+{
+	if (lsm->opts.ttl <= 0)
+		return false;
+	return vy_stmt_is_expired(tuple, lsm->opts.ttl_field,
+				  vy_lsm_expire_deadline(lsm));
+}
+
 /**
  * Increment the reference counter of an LSM tree.
  * An LSM tree cannot be deleted if its reference
@@ -478,6 +513,14 @@ vy_lsm_add_run(struct vy_lsm *lsm, struct vy_run *run);
 void
 vy_lsm_remove_run(struct vy_lsm *lsm, struct vy_run *run);
 
+/** Add a blob file to the list of blob files of an LSM tree. */
+void
+vy_lsm_add_blob(struct vy_lsm *lsm, struct vy_blob *blob);
+
+/** Remove a blob file from the list of blob files of an LSM tree. */
+void
+vy_lsm_remove_blob(struct vy_lsm *lsm, struct vy_blob *blob);
+
 /**
  * Add a range to both the range tree and the range heap
  * of an LSM tree.
@@ -571,6 +614,17 @@ vy_lsm_find_range_intersection(struct vy_lsm *lsm,
 bool
 vy_lsm_split_range(struct vy_lsm *lsm, struct vy_range *range);
 
+/**
+ * Split a range that is going to be compacted in up to @max_parts
+ * parts if it is big enough, return true if the range was split.
+ * The parts can then be compacted in parallel by different worker
+ * threads. Like vy_lsm_split_range(), this doesn't involve any
+ * heavy operations.
+ */
+bool
+vy_lsm_split_range_parallel(struct vy_lsm *lsm, struct vy_range *range,
+			    int max_parts);
+
 /**
  * Coalesce a range with one or more its neighbors if it is too small,
  * return true if the range was coalesced. We coalesce ranges by
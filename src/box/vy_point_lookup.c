@@ -285,6 +285,8 @@ done:
 	if (rc == 0) {
 		int upserts_applied;
 		rc = vy_history_apply(&history, lsm->cmp_def,
+				      lsm->opts.ttl_field,
+				      vy_lsm_expire_deadline(lsm),
 				      false, &upserts_applied, ret);
 		lsm->stat.upsert.applied += upserts_applied;
 	}
@@ -320,6 +322,8 @@ done:
 	if (rc == 0) {
 		int upserts_applied;
 		rc = vy_history_apply(&history, lsm->cmp_def,
+				      lsm->opts.ttl_field,
+				      vy_lsm_expire_deadline(lsm),
 				      true, &upserts_applied, ret);
 		lsm->stat.upsert.applied += upserts_applied;
 	}
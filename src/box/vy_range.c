@@ -515,6 +515,86 @@ vy_range_needs_split(struct vy_range *range, int64_t range_size,
 	return true;
 }
 
+/**
+ * Unlike vy_range_needs_split(), which splits a range in two only
+ * after it has been compacted, this function is meant to be called
+ * before the first compaction of a range, e.g. one created for an
+ * index that was just loaded with a lot of data:
+ *
+ * - We only split ranges that haven't been compacted yet. Compacted
+ *   ranges are split by vy_range_needs_split().
+ * - We use the total size of all slices of the range as an estimate
+ *   of the compaction output size. Since it doesn't take into account
+ *   overwritten statements, we aim at parts of about twice the target
+ *   range size so that the parts are unlikely to be coalesced back.
+ *   Anyway, they will be split in two after compaction if they turn
+ *   out to be big.
+ * - We split in no more parts than the given limit, which is supposed
+ *   to be equal to the number of compaction threads.
+ * - We split by keys evenly spread over the page index of the
+ *   biggest run.
+ */
+int
+vy_range_needs_parallel_split(struct vy_range *range, int64_t range_size,
+			      int max_parts, const char **split_keys)
+{
+	if (max_parts < 2 || range_size <= 0 || range->n_compactions > 0)
+		return 0;
+
+	/* Estimate the range size and find the biggest slice. */
+	int64_t size = 0;
+	struct vy_slice *slice, *biggest = NULL;
+	rlist_foreach_entry(slice, &range->slices, in_range) {
+		size += slice->count.bytes;
+		if (biggest == NULL ||
+		    slice->count.bytes > biggest->count.bytes)
+			biggest = slice;
+	}
+	if (biggest == NULL)
+		return 0;
+
+	int64_t n_parts = MIN(size / (2 * range_size), max_parts);
+	uint32_t page_count = biggest->last_page_no -
+			      biggest->first_page_no + 1;
+	n_parts = MIN(n_parts, page_count);
+	if (n_parts < 2)
+		return 0;
+
+	int n_keys = 0;
+	const char *prev_key = NULL;
+	hint_t prev_key_hint = HINT_NONE;
+	for (int64_t i = 1; i < n_parts; i++) {
+		struct vy_page_info *page;
+		page = vy_run_page_info(biggest->run, biggest->first_page_no +
+					page_count * i / n_parts);
+		/*
+		 * Split keys must be ascending and lie strictly inside
+		 * the range, see also vy_range_needs_split().
+		 */
+		if (prev_key != NULL &&
+		    key_compare(prev_key, prev_key_hint,
+				page->min_key, page->min_key_hint,
+				range->cmp_def) >= 0)
+			continue;
+		if (prev_key == NULL && biggest->begin.stmt != NULL &&
+		    vy_entry_compare_with_raw_key(biggest->begin,
+						  page->min_key,
+						  page->min_key_hint,
+						  range->cmp_def) >= 0)
+			continue;
+		if (prev_key == NULL && range->begin.stmt != NULL &&
+		    vy_entry_compare_with_raw_key(range->begin,
+						  page->min_key,
+						  page->min_key_hint,
+						  range->cmp_def) >= 0)
+			continue;
+		split_keys[n_keys++] = page->min_key;
+		prev_key = page->min_key;
+		prev_key_hint = page->min_key_hint;
+	}
+	return n_keys;
+}
+
 /**
  * Check if a range should be coalesced with one or more its neighbors.
  * If it should, return true and set @p_first and @p_last to the first
@@ -266,6 +266,23 @@ bool
 vy_range_needs_split(struct vy_range *range, int64_t range_size,
 		     const char **p_split_key);
 
+/**
+ * Check if a range is so big that it should be split in several
+ * parts so that the parts could be compacted in parallel.
+ *
+ * @param range             The range.
+ * @param range_size        Target range size.
+ * @param max_parts         Max number of parts to split the range in.
+ * @param[out] split_keys   Keys to split the range by, must have room
+ *                          for at least max_parts - 1 keys.
+ *
+ * @retval                  Number of keys to split the range by
+ *                          or 0 if the range doesn't need to be split.
+ */
+int
+vy_range_needs_parallel_split(struct vy_range *range, int64_t range_size,
+			      int max_parts, const char **split_keys);
+
 /**
  * Check if a range needs to be coalesced with adjacent
  * ranges in a range tree.
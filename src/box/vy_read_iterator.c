@@ -769,6 +769,8 @@ vy_read_iterator_apply_history(struct vy_read_iterator *itr,
 
 	int upserts_applied = 0;
 	int rc = vy_history_apply(&history, lsm->cmp_def,
+				  lsm->opts.ttl_field,
+				  vy_lsm_expire_deadline(lsm),
 				  true, &upserts_applied, ret);
 
 	lsm->stat.upsert.applied += upserts_applied;
@@ -803,6 +805,20 @@ vy_read_iterator_track_read(struct vy_read_iterator *itr, struct vy_entry entry)
 	return rc;
 }
 
+/**
+ * Make the next tuple added to the cache by the read iterator
+ * start a new chain, i.e. don't link it with the last cached
+ * tuple. Used when the iterator skips a tuple that may become
+ * visible later.
+ */
+static void
+vy_read_iterator_cache_break(struct vy_read_iterator *itr)
+{
+	if (itr->last_cached.stmt != NULL)
+		tuple_unref(itr->last_cached.stmt);
+	itr->last_cached = vy_entry_none();
+}
+
 NODISCARD int
 vy_read_iterator_next(struct vy_read_iterator *itr, struct vy_entry *result)
 {
@@ -836,6 +852,18 @@ next_key:
 		}
 		goto next_key;
 	}
+	if (entry.stmt != NULL && vy_lsm_tuple_is_expired(itr->lsm,
+							  entry.stmt)) {
+		/*
+		 * Expired tuples are treated as deleted. Although
+		 * the time only goes forward, the tuple may become
+		 * visible again if the ttl options are altered so
+		 * we must not consider previous + current tuple as
+		 * an unbroken chain.
+		 */
+		vy_read_iterator_cache_break(itr);
+		goto next_key;
+	}
 	assert(entry.stmt == NULL ||
 	       vy_stmt_type(entry.stmt) == IPROTO_INSERT ||
 	       vy_stmt_type(entry.stmt) == IPROTO_REPLACE);
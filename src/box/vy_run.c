@@ -30,6 +30,7 @@
  */
 #include "vy_run.h"
 
+#include <fcntl.h>
 #include <zstd.h>
 
 #include "fiber.h"
@@ -38,6 +39,7 @@
 #include "cbus.h"
 #include "memory.h"
 #include "coio_file.h"
+#include "crc32.h"
 
 #include "replication.h"
 #include "tuple_bloom.h"
@@ -74,6 +76,19 @@ const char *vy_file_suffix[] = {
 /* sync run and index files very 16 MB */
 #define VY_RUN_SYNC_INTERVAL (1 << 24)
 
+/** Signature every blob file starts with. */
+#define VY_BLOB_SIGNATURE "VYBLOB1\n"
+#define VY_BLOB_SIGNATURE_LEN (sizeof(VY_BLOB_SIGNATURE) - 1)
+
+/** Write values to blob files in chunks of this size. */
+#define VY_BLOB_WRITE_BUF_SIZE (1 << 20)
+
+/**
+ * Max size of values a run iterator reads from blob files in
+ * one go, see vy_run_iterator_prefetch_blobs().
+ */
+#define VY_BLOB_BATCH_SIZE (1 << 20)
+
 /**
  * We read runs in background threads so as not to stall tx.
  * This structure represents such a thread.
@@ -111,6 +126,53 @@ struct vy_page_read_task {
 	struct vy_page *page;
 };
 
+/**
+ * Max number of pages a run iterator may read ahead.
+ * See vy_run_iterator::readahead_window.
+ */
+enum { VY_RUN_READAHEAD_MAX = 8 };
+
+/**
+ * Alignment of file offsets, sizes, and memory buffers used for
+ * direct IO. Must be a multiple of the logical block size.
+ */
+enum { VY_DIRECT_IO_ALIGN = 4096 };
+
+/**
+ * Cbus message used for reading a page before a run iterator
+ * actually needs it. Unlike vy_page_read_task, the iterator
+ * doesn't wait for the message to complete, so the message
+ * may outlive the iterator, in which case it frees itself
+ * upon return to tx.
+ */
+struct vy_page_readahead {
+	/** parent */
+	struct cmsg base;
+	/** Message route: reader thread -> tx. */
+	struct cmsg_hop route[2];
+	/** vy_run with fd - ref. counted */
+	struct vy_run *run;
+	/** Number of the page to read. */
+	uint32_t page_no;
+	/** [out] resulting vinyl page */
+	struct vy_page *page;
+	/** [out] 0 on success, -1 on error */
+	int rc;
+	/** [out] error, set if rc is -1 */
+	struct diag diag;
+	/** Set when the message returns to tx. */
+	bool is_done;
+	/** Fiber waiting for the message to complete or NULL. */
+	struct fiber *waiter;
+	/**
+	 * Iterator that issued the message or NULL if the page
+	 * isn't needed anymore.
+	 */
+	struct vy_run_iterator *itr;
+	/** Link in vy_run_iterator::readahead. */
+	struct rlist in_itr;
+};
+
 /** Destructor for env->zdctx_key thread-local variable */
 static void
 vy_free_zdctx(void *arg)
@@ -183,7 +245,13 @@ vy_run_env_create(struct vy_run_env *env, int read_threads)
 	tt_pthread_key_create(&env->zdctx_key, vy_free_zdctx);
 	mempool_create(&env->read_task_pool, cord_slab_cache(),
 		       sizeof(struct vy_page_read_task));
+	mempool_create(&env->readahead_pool, cord_slab_cache(),
+		       sizeof(struct vy_page_readahead));
 	env->initial_join = false;
+	env->direct_io = false;
+	rlist_create(&env->page_cache.lru);
+	env->page_cache.quota = 0;
+	env->page_cache.used = 0;
 }
 
 /**
@@ -194,7 +262,9 @@ vy_run_env_destroy(struct vy_run_env *env)
 {
 	if (env->reader_pool != NULL)
 		vy_run_env_stop_readers(env);
+	vy_run_env_set_page_cache(env, 0);
 	mempool_destroy(&env->read_task_pool);
+	mempool_destroy(&env->readahead_pool);
 	tt_pthread_key_delete(env->zdctx_key);
 }
 
@@ -209,6 +279,19 @@ vy_run_env_enable_coio(struct vy_run_env *env)
 	vy_run_env_start_readers(env);
 }
 
+/**
+ * Pick a reader thread to process the next read request.
+ */
+static struct vy_run_reader *
+vy_run_env_next_reader(struct vy_run_env *env)
+{
+	assert(env->reader_pool != NULL);
+	struct vy_run_reader *reader;
+	reader = &env->reader_pool[env->next_reader++];
+	env->next_reader %= env->reader_pool_size;
+	return reader;
+}
+
 /**
  * Execute a task on behalf of a reader thread.
  */
@@ -220,10 +303,7 @@ vy_run_env_coio_call(struct vy_run_env *env, struct cbus_call_msg *msg,
 	if (env->reader_pool == NULL)
 		return func(msg);
 
-	/* Pick a reader thread. */
-	struct vy_run_reader *reader;
-	reader = &env->reader_pool[env->next_reader++];
-	env->next_reader %= env->reader_pool_size;
+	struct vy_run_reader *reader = vy_run_env_next_reader(env);
 
 	/* Post the task to the reader thread. */
 	bool cancellable = fiber_set_cancellable(false);
@@ -290,9 +370,13 @@ vy_run_new(struct vy_run_env *env, int64_t id)
 	return run;
 }
 
+static void
+vy_run_purge_cached_pages(struct vy_run *run);
+
 static void
 vy_run_clear(struct vy_run *run)
 {
+	vy_run_purge_cached_pages(run);
 	if (run->page_info != NULL) {
 		uint32_t page_no;
 		for (page_no = 0; page_no < run->info.page_count; ++page_no)
@@ -310,6 +394,15 @@ vy_run_clear(struct vy_run *run)
 	run->info.min_key = NULL;
 	free(run->info.max_key);
 	run->info.max_key = NULL;
+	if (run->blobs != NULL) {
+		for (uint32_t i = 0; i < run->info.blob_count; i++)
+			vy_blob_unref(run->blobs[i]);
+		free(run->blobs);
+	}
+	run->blobs = NULL;
+	free(run->info.blob_info);
+	run->info.blob_info = NULL;
+	run->info.blob_count = 0;
 }
 
 void
@@ -323,12 +416,266 @@ vy_run_delete(struct vy_run *run)
 	free(run);
 }
 
+/**
+ * Switch the run data file descriptor to direct IO if the run
+ * environment is configured so. Failure isn't critical, because
+ * vy_page_read() works with both kinds of file descriptors, so
+ * we just log it.
+ */
+static void
+vy_run_setup_direct_io(struct vy_run *run)
+{
+	if (!run->env->direct_io)
+		return;
+#if defined(O_DIRECT)
+	int flags = fcntl(run->fd, F_GETFL);
+	if (flags < 0 || fcntl(run->fd, F_SETFL, flags | O_DIRECT) < 0)
+		say_syserror("failed to enable direct IO for run %lld",
+			     (long long)run->id);
+#elif defined(F_NOCACHE)
+	if (fcntl(run->fd, F_NOCACHE, 1) < 0)
+		say_syserror("failed to enable direct IO for run %lld",
+			     (long long)run->id);
+#endif
+}
+
 size_t
 vy_run_bloom_size(struct vy_run *run)
 {
 	return run->info.bloom == NULL ? 0 : tuple_bloom_size(run->info.bloom);
 }
 
+/** {{{ vy_blob */
+
+struct vy_blob *
+vy_blob_new(int64_t id)
+{
+	struct vy_blob *blob = calloc(1, sizeof(*blob));
+	if (blob == NULL) {
+		diag_set(OutOfMemory, sizeof(*blob), "malloc",
+			 "struct vy_blob");
+		return NULL;
+	}
+	blob->id = id;
+	blob->fd = -1;
+	blob->refs = 1;
+	rlist_create(&blob->in_lsm);
+	return blob;
+}
+
+void
+vy_blob_delete(struct vy_blob *blob)
+{
+	assert(blob->refs == 0);
+	assert(blob->run_count == 0);
+	if (blob->fd >= 0 && close(blob->fd) < 0)
+		say_syserror("close failed");
+	TRASH(blob);
+	free(blob);
+}
+
+int
+vy_blob_recover(struct vy_blob *blob, const char *dir,
+		uint32_t space_id, uint32_t iid)
+{
+	assert(blob->fd < 0);
+	char path[PATH_MAX];
+	vy_blob_snprint_path(path, sizeof(path), dir, space_id, iid,
+			     blob->id, false);
+	int fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		diag_set(SystemError, "failed to open '%s' file", path);
+		goto fail;
+	}
+	char signature[VY_BLOB_SIGNATURE_LEN];
+	ssize_t size = fio_pread(fd, signature, sizeof(signature), 0);
+	if (size < 0) {
+		diag_set(SystemError, "failed to read '%s' file", path);
+		goto fail_close;
+	}
+	if (size != (ssize_t)sizeof(signature) ||
+	    memcmp(signature, VY_BLOB_SIGNATURE, sizeof(signature)) != 0) {
+		diag_set(ClientError, ER_INVALID_RUN_FILE,
+			 tt_sprintf("Invalid blob file signature: %s", path));
+		goto fail_close;
+	}
+	off_t end = lseek(fd, 0, SEEK_END);
+	if (end < 0) {
+		diag_set(SystemError, "failed to seek '%s' file", path);
+		goto fail_close;
+	}
+	blob->fd = fd;
+	blob->size = end;
+	return 0;
+fail_close:
+	close(fd);
+fail:
+	diag_log();
+	say_error("failed to load `%s'", path);
+	return -1;
+}
+
+int
+vy_blob_read(struct vy_blob *blob, const struct vy_blob_ref *ref, char *buf)
+{
+	assert(blob->id == ref->blob_id);
+	ssize_t size = fio_pread(blob->fd, buf, ref->size, ref->offset);
+	if (size < 0) {
+		diag_set(SystemError, "failed to read from file");
+		return -1;
+	}
+	if (size != (ssize_t)ref->size ||
+	    crc32_calc(0, buf, ref->size) != ref->crc32) {
+		diag_set(ClientError, ER_INVALID_RUN_FILE,
+			 tt_sprintf("Corrupted value in blob file %lld "
+				    "at offset %llu", (long long)blob->id,
+				    (unsigned long long)ref->offset));
+		return -1;
+	}
+	return 0;
+}
+
+int
+vy_run_bind_blobs(struct vy_run *run, struct rlist *blobs,
+		  struct vy_blob *new_blob)
+{
+	assert(run->blobs == NULL);
+	uint32_t count = run->info.blob_count;
+	if (count == 0)
+		return 0;
+	struct vy_blob **run_blobs = calloc(count, sizeof(*run_blobs));
+	if (run_blobs == NULL) {
+		diag_set(OutOfMemory, count * sizeof(*run_blobs),
+			 "calloc", "struct vy_blob *");
+		return -1;
+	}
+	for (uint32_t i = 0; i < count; i++) {
+		int64_t blob_id = run->info.blob_info[i].id;
+		struct vy_blob *blob = NULL;
+		if (new_blob != NULL && new_blob->id == blob_id) {
+			blob = new_blob;
+		} else {
+			struct vy_blob *b;
+			rlist_foreach_entry(b, blobs, in_lsm) {
+				if (b->id == blob_id) {
+					blob = b;
+					break;
+				}
+			}
+		}
+		if (blob == NULL) {
+			diag_set(ClientError, ER_INVALID_VYLOG_FILE,
+				 tt_sprintf("Run %lld references unknown "
+					    "blob file %lld",
+					    (long long)run->id,
+					    (long long)blob_id));
+			goto fail;
+		}
+		vy_blob_ref(blob);
+		run_blobs[i] = blob;
+	}
+	run->blobs = run_blobs;
+	return 0;
+fail:
+	for (uint32_t i = 0; i < count && run_blobs[i] != NULL; i++)
+		vy_blob_unref(run_blobs[i]);
+	free(run_blobs);
+	return -1;
+}
+
+/** Look up a blob file referenced by a run by id. */
+static struct vy_blob *
+vy_run_lookup_blob(struct vy_run *run, int64_t blob_id)
+{
+	if (run->blobs == NULL)
+		return NULL;
+	for (uint32_t i = 0; i < run->info.blob_count; i++) {
+		if (run->blobs[i]->id == blob_id)
+			return run->blobs[i];
+	}
+	return NULL;
+}
+
+/**
+ * Account @size bytes of values stored in blob file @blob_id
+ * to a blob info array of @count entries. @capacity is the current
+ * capacity of the array, which is grown if necessary.
+ */
+static int
+vy_blob_info_account(struct vy_run_blob_info **blob_info, uint32_t *count,
+		     uint32_t *capacity, int64_t blob_id, uint64_t size)
+{
+	for (uint32_t i = 0; i < *count; i++) {
+		if ((*blob_info)[i].id == blob_id) {
+			(*blob_info)[i].size += size;
+			return 0;
+		}
+	}
+	if (*count >= *capacity) {
+		uint32_t new_capacity = *capacity > 0 ? *capacity * 2 : 4;
+		struct vy_run_blob_info *new_blob_info;
+		new_blob_info = realloc(*blob_info,
+					new_capacity * sizeof(*new_blob_info));
+		if (new_blob_info == NULL) {
+			diag_set(OutOfMemory,
+				 new_capacity * sizeof(*new_blob_info),
+				 "realloc", "struct vy_run_blob_info");
+			return -1;
+		}
+		*blob_info = new_blob_info;
+		*capacity = new_capacity;
+	}
+	struct vy_run_blob_info *info = &(*blob_info)[(*count)++];
+	info->id = blob_id;
+	info->size = size;
+	return 0;
+}
+
+/**
+ * Account all values referenced by a statement with blob
+ * references, see vy_blob_info_account().
+ */
+static int
+vy_blob_info_account_refs(struct vy_run_blob_info **blob_info,
+			  uint32_t *count, uint32_t *capacity,
+			  struct tuple *stmt)
+{
+	assert(vy_stmt_flags(stmt) & VY_STMT_BLOB_REFS);
+	const char *pos = tuple_data(stmt);
+	uint32_t field_count = mp_decode_array(&pos);
+	for (uint32_t i = 0; i < field_count; i++) {
+		struct vy_blob_ref ref;
+		if (vy_blob_ref_decode(pos, &ref) &&
+		    vy_blob_info_account(blob_info, count, capacity,
+					 ref.blob_id, ref.size) != 0)
+			return -1;
+		mp_next(&pos);
+	}
+	return 0;
+}
+
+/** Account values stored in blob file @blob_id to run info. */
+static int
+vy_run_info_account_blob(struct vy_run_info *run_info, uint32_t *capacity,
+			 int64_t blob_id, uint64_t size)
+{
+	return vy_blob_info_account(&run_info->blob_info,
+				    &run_info->blob_count, capacity,
+				    blob_id, size);
+}
+
+/** Account values referenced by a statement to run info. */
+static int
+vy_run_info_account_blob_refs(struct vy_run_info *run_info,
+			      uint32_t *capacity, struct tuple *stmt)
+{
+	return vy_blob_info_account_refs(&run_info->blob_info,
+					 &run_info->blob_count, capacity,
+					 stmt);
+}
+
+/** vy_blob }}} */
+
 /**
  * Find a page from which the iteration of a given key must be started.
  * LE and LT: the found page definitely contains the position
@@ -623,6 +970,31 @@ vy_stmt_stat_decode(struct vy_stmt_stat *stat, const char **data)
 	}
 }
 
+/**
+ * Decode information about blob files referenced by a run
+ * from @data and advance @data.
+ */
+static int
+vy_run_blob_info_decode(struct vy_run_info *run_info, const char **data)
+{
+	uint32_t count = mp_decode_map(data);
+	if (count == 0)
+		return 0;
+	struct vy_run_blob_info *blob_info = calloc(count, sizeof(*blob_info));
+	if (blob_info == NULL) {
+		diag_set(OutOfMemory, count * sizeof(*blob_info),
+			 "calloc", "struct vy_run_blob_info");
+		return -1;
+	}
+	for (uint32_t i = 0; i < count; i++) {
+		blob_info[i].id = mp_decode_uint(data);
+		blob_info[i].size = mp_decode_uint(data);
+	}
+	run_info->blob_info = blob_info;
+	run_info->blob_count = count;
+	return 0;
+}
+
 /**
  * Decode the run metadata from xrow.
  *
@@ -687,6 +1059,10 @@ vy_run_info_decode(struct vy_run_info *run_info,
 		case VY_RUN_INFO_STMT_STAT:
 			vy_stmt_stat_decode(&run_info->stmt_stat, &pos);
 			break;
+		case VY_RUN_INFO_BLOBS:
+			if (vy_run_blob_info_decode(run_info, &pos) != 0)
+				return -1;
+			break;
 		default:
 			mp_next(&pos); /* unknown key, ignore */
 			break;
@@ -730,6 +1106,9 @@ vy_page_new(const struct vy_page_info *page_info)
 		free(page);
 		return NULL;
 	}
+	page->refs = 1;
+	page->run = NULL;
+	rlist_create(&page->in_cache);
 	return page;
 }
 
@@ -748,6 +1127,128 @@ vy_page_delete(struct vy_page *page)
 	free(page);
 }
 
+static inline void
+vy_page_ref(struct vy_page *page)
+{
+	assert(page->refs > 0);
+	page->refs++;
+}
+
+static inline void
+vy_page_unref(struct vy_page *page)
+{
+	assert(page->refs > 0);
+	if (--page->refs == 0)
+		vy_page_delete(page);
+}
+
+/** Size of memory used by a page, in bytes. */
+static inline size_t
+vy_page_mem_used(struct vy_page *page)
+{
+	return sizeof(*page) + page->unpacked_size +
+	       page->row_count * sizeof(uint32_t);
+}
+
+/** Remove a page from the page cache. */
+static void
+vy_page_cache_remove(struct vy_page_cache *cache, struct vy_page *page)
+{
+	struct vy_run *run = page->run;
+	assert(run != NULL);
+	assert(run->cached_pages[page->page_no] == page);
+	run->cached_pages[page->page_no] = NULL;
+	page->run = NULL;
+	rlist_del_entry(page, in_cache);
+	assert(cache->used >= vy_page_mem_used(page));
+	cache->used -= vy_page_mem_used(page);
+	vy_page_unref(page);
+}
+
+/** Evict the least recently used pages until the cache fits in quota. */
+static void
+vy_page_cache_evict(struct vy_page_cache *cache)
+{
+	while (cache->used > cache->quota) {
+		assert(!rlist_empty(&cache->lru));
+		struct vy_page *page = rlist_last_entry(&cache->lru,
+							struct vy_page,
+							in_cache);
+		vy_page_cache_remove(cache, page);
+	}
+}
+
+/**
+ * Look up a page in the page cache. Returns the page referenced
+ * or NULL if the page isn't cached.
+ */
+static struct vy_page *
+vy_page_cache_lookup(struct vy_run *run, uint32_t page_no)
+{
+	struct vy_page_cache *cache = &run->env->page_cache;
+	if (run->cached_pages == NULL)
+		return NULL;
+	struct vy_page *page = run->cached_pages[page_no];
+	if (page == NULL)
+		return NULL;
+	rlist_move_entry(&cache->lru, page, in_cache);
+	vy_page_ref(page);
+	return page;
+}
+
+/**
+ * Add a page read from a run file to the page cache, evicting
+ * the least recently used pages if necessary. The cache is best
+ * effort so the function silently fails on memory allocation
+ * error.
+ */
+static void
+vy_page_cache_put(struct vy_run *run, struct vy_page *page)
+{
+	struct vy_page_cache *cache = &run->env->page_cache;
+	if (vy_page_mem_used(page) > cache->quota)
+		return;
+	if (run->cached_pages == NULL) {
+		run->cached_pages = calloc(run->info.page_count,
+					   sizeof(*run->cached_pages));
+		if (run->cached_pages == NULL)
+			return;
+	}
+	/* The page may have been read by another iterator. */
+	if (run->cached_pages[page->page_no] != NULL)
+		return;
+	assert(page->run == NULL);
+	run->cached_pages[page->page_no] = page;
+	page->run = run;
+	rlist_add_entry(&cache->lru, page, in_cache);
+	cache->used += vy_page_mem_used(page);
+	vy_page_ref(page);
+	vy_page_cache_evict(cache);
+}
+
+/** Remove all pages of a run from the page cache. */
+static void
+vy_run_purge_cached_pages(struct vy_run *run)
+{
+	if (run->cached_pages == NULL)
+		return;
+	struct vy_page_cache *cache = &run->env->page_cache;
+	for (uint32_t page_no = 0; page_no < run->info.page_count; page_no++) {
+		struct vy_page *page = run->cached_pages[page_no];
+		if (page != NULL)
+			vy_page_cache_remove(cache, page);
+	}
+	free(run->cached_pages);
+	run->cached_pages = NULL;
+}
+
+void
+vy_run_env_set_page_cache(struct vy_run_env *env, size_t quota)
+{
+	env->page_cache.quota = quota;
+	vy_page_cache_evict(&env->page_cache);
+}
+
 static int
 vy_page_xrow(struct vy_page *page, uint32_t stmt_no,
 	     struct xrow_header *xrow)
@@ -823,6 +1324,9 @@ vy_page_find_key(struct vy_page *page, struct vy_entry key,
 	return end;
 }
 
+static void
+vy_page_readahead_discard(struct vy_page_readahead *ra);
+
 /**
  * End iteration and free cached data.
  */
@@ -834,11 +1338,15 @@ vy_run_iterator_stop(struct vy_run_iterator *itr)
 		itr->curr = vy_entry_none();
 	}
 	if (itr->curr_page != NULL) {
-		vy_page_delete(itr->curr_page);
+		vy_page_unref(itr->curr_page);
 		if (itr->prev_page != NULL)
-			vy_page_delete(itr->prev_page);
+			vy_page_unref(itr->prev_page);
 		itr->curr_page = itr->prev_page = NULL;
 	}
+	struct vy_page_readahead *ra, *tmp;
+	rlist_foreach_entry_safe(ra, &itr->readahead, in_itr, tmp)
+		vy_page_readahead_discard(ra);
+	itr->readahead_window = 0;
 }
 
 static int
@@ -882,6 +1390,40 @@ vy_run_filename(struct vy_run *run)
 	return buf;
 }
 
+/**
+ * Read data from a run file opened with direct IO. Direct IO
+ * requires the file offset, the size and the address of the
+ * buffer to be aligned by the logical block size so we read
+ * the smallest aligned chunk containing the requested data to
+ * an aligned buffer allocated on the fiber region.
+ *
+ * Returns the number of bytes read, which may be less than
+ * requested on EOF, and sets @a data to point to them. On error
+ * returns -1 with errno set.
+ */
+static ssize_t
+vy_run_read_direct(struct vy_run *run, uint64_t offset, size_t size,
+		   char **data)
+{
+	const size_t mask = VY_DIRECT_IO_ALIGN - 1;
+	uint64_t aligned_offset = offset & ~(uint64_t)mask;
+	size_t skip = offset - aligned_offset;
+	size_t aligned_size = (skip + size + mask) & ~mask;
+	char *buf = region_aligned_alloc(&fiber()->gc, aligned_size,
+					 VY_DIRECT_IO_ALIGN);
+	if (buf == NULL) {
+		errno = ENOMEM;
+		return -1;
+	}
+	ssize_t readen = fio_pread(run->fd, buf, aligned_size,
+				   aligned_offset);
+	if (readen < 0)
+		return -1;
+	*data = buf + skip;
+	return readen > (ssize_t)skip ?
+	       MIN((size_t)readen - skip, size) : 0;
+}
+
 /**
  * Read a page requests from vinyl xlog data file.
  *
@@ -894,13 +1436,21 @@ vy_page_read(struct vy_page *page, const struct vy_page_info *page_info,
 {
 	/* read xlog tx from xlog file */
 	size_t region_svp = region_used(&fiber()->gc);
-	char *data = (char *)region_alloc(&fiber()->gc, page_info->size);
-	if (data == NULL) {
-		diag_set(OutOfMemory, page_info->size, "region gc", "page");
-		return -1;
-	}
-	ssize_t readen = fio_pread(run->fd, data, page_info->size,
+	char *data;
+	ssize_t readen;
+	if (run->env->direct_io) {
+		readen = vy_run_read_direct(run, page_info->offset,
+					    page_info->size, &data);
+	} else {
+		data = (char *)region_alloc(&fiber()->gc, page_info->size);
+		if (data == NULL) {
+			diag_set(OutOfMemory, page_info->size,
+				 "region gc", "page");
+			return -1;
+		}
+		readen = fio_pread(run->fd, data, page_info->size,
 				   page_info->offset);
+	}
 	ERROR_INJECT(ERRINJ_VYRUN_DATA_READ, {
 		readen = -1;
 		errno = EIO;});
@@ -996,46 +1546,231 @@ vy_page_read_cb(struct cbus_call_msg *base)
 	return 0;
 }
 
+/** Free a page readahead message. */
+static void
+vy_page_readahead_delete(struct vy_page_readahead *ra)
+{
+	struct vy_run_env *env = ra->run->env;
+	if (ra->page != NULL)
+		vy_page_unref(ra->page);
+	diag_destroy(&ra->diag);
+	vy_run_unref(ra->run);
+	mempool_free(&env->readahead_pool, ra);
+}
+
 /**
- * Read a page from disk given its number.
- * The function caches two most recently read pages.
- *
- * @retval 0 success
- * @retval -1 critical error
+ * Page readahead callback, called in a reader thread.
  */
-static NODISCARD int
-vy_run_iterator_load_page(struct vy_run_iterator *itr, uint32_t page_no,
-			  struct vy_entry key, enum iterator_type iterator_type,
-			  struct vy_page **result, uint32_t *pos_in_page,
-			  bool *equal_found)
+static void
+vy_page_readahead_read_f(struct cmsg *base)
 {
-	struct vy_slice *slice = itr->slice;
-	struct vy_run_env *env = slice->run->env;
+	struct vy_page_readahead *ra = (struct vy_page_readahead *)base;
+	struct vy_run *run = ra->run;
+	struct vy_page_info *page_info = vy_run_page_info(run, ra->page_no);
+	ZSTD_DStream *zdctx = vy_env_get_zdctx(run->env);
+	if (zdctx != NULL &&
+	    vy_page_read(ra->page, page_info, run, zdctx) == 0) {
+		ra->rc = 0;
+	} else {
+		ra->rc = -1;
+		diag_move(diag_get(), &ra->diag);
+	}
+}
 
-	/* Check cache */
+/**
+ * Called in tx when a page readahead message completes.
+ */
+static void
+vy_page_readahead_done_f(struct cmsg *base)
+{
+	struct vy_page_readahead *ra = (struct vy_page_readahead *)base;
+	ra->is_done = true;
+	if (ra->itr == NULL) {
+		/* The page isn't needed anymore. */
+		vy_page_readahead_delete(ra);
+		return;
+	}
+	if (ra->waiter != NULL)
+		fiber_wakeup(ra->waiter);
+}
+
+/**
+ * Discard a page read ahead by a run iterator. If the page
+ * is still being read, the message will be freed on return
+ * to tx.
+ */
+static void
+vy_page_readahead_discard(struct vy_page_readahead *ra)
+{
+	assert(ra->itr != NULL);
+	rlist_del_entry(ra, in_itr);
+	ra->itr = NULL;
+	if (ra->is_done)
+		vy_page_readahead_delete(ra);
+}
+
+/**
+ * Start reading a page ahead of time. Readahead is best effort
+ * so the function silently gives up on memory allocation error.
+ */
+static void
+vy_run_iterator_start_readahead(struct vy_run_iterator *itr,
+				uint32_t page_no)
+{
+	struct vy_run *run = itr->slice->run;
+	struct vy_run_env *env = run->env;
+	struct vy_page_readahead *ra = mempool_alloc(&env->readahead_pool);
+	if (ra == NULL)
+		return;
+	ra->page = vy_page_new(vy_run_page_info(run, page_no));
+	if (ra->page == NULL) {
+		diag_clear(diag_get());
+		mempool_free(&env->readahead_pool, ra);
+		return;
+	}
+	ra->page->page_no = page_no;
+	ra->page_no = page_no;
+	ra->run = run;
+	vy_run_ref(run);
+	ra->rc = 0;
+	diag_create(&ra->diag);
+	ra->is_done = false;
+	ra->waiter = NULL;
+	ra->itr = itr;
+	rlist_add_tail_entry(&itr->readahead, ra, in_itr);
+
+	struct vy_run_reader *reader = vy_run_env_next_reader(env);
+	ra->route[0].f = vy_page_readahead_read_f;
+	ra->route[0].pipe = &reader->tx_pipe;
+	ra->route[1].f = vy_page_readahead_done_f;
+	ra->route[1].pipe = NULL;
+	cmsg_init(&ra->base, ra->route);
+	cpipe_push(&reader->reader_pipe, &ra->base);
+}
+
+/**
+ * Take a page read ahead by a run iterator, waiting for the
+ * read to complete if necessary. The readahead message is
+ * consumed. Returns NULL on error, including cancellation of
+ * the waiting fiber.
+ */
+static struct vy_page *
+vy_run_iterator_take_readahead(struct vy_run_iterator *itr,
+			       struct vy_page_readahead *ra)
+{
+	assert(ra->itr == itr);
+	(void)itr;
+	if (!ra->is_done) {
+		bool cancellable = fiber_set_cancellable(true);
+		ra->waiter = fiber();
+		while (!ra->is_done && !fiber_is_cancelled())
+			fiber_yield();
+		ra->waiter = NULL;
+		fiber_set_cancellable(cancellable);
+		if (!ra->is_done) {
+			/* Freed by the reader when it's done. */
+			vy_page_readahead_discard(ra);
+			diag_set(FiberIsCancelled);
+			return NULL;
+		}
+	}
+	rlist_del_entry(ra, in_itr);
 	struct vy_page *page = NULL;
-	if (itr->curr_page != NULL &&
-	    itr->curr_page->page_no == page_no) {
-		page = itr->curr_page;
-	} else if (itr->prev_page != NULL &&
-		   itr->prev_page->page_no == page_no) {
-		SWAP(itr->prev_page, itr->curr_page);
-		page = itr->curr_page;
+	if (ra->rc == 0) {
+		page = ra->page;
+		ra->page = NULL;
+	} else {
+		diag_move(&ra->diag, diag_get());
 	}
-	if (page != NULL) {
-		if (key.stmt != NULL)
-			*pos_in_page = vy_page_find_key(page, key, itr->cmp_def,
-							itr->format, iterator_type,
-							equal_found);
-		*result = page;
-		return 0;
+	vy_page_readahead_delete(ra);
+	if (page != NULL && fiber_is_cancelled()) {
+		diag_set(FiberIsCancelled);
+		vy_page_unref(page);
+		return NULL;
+	}
+	return page;
+}
+
+/**
+ * Look up a page read ahead by a run iterator.
+ */
+static struct vy_page_readahead *
+vy_run_iterator_find_readahead(struct vy_run_iterator *itr, uint32_t page_no)
+{
+	struct vy_page_readahead *ra;
+	rlist_foreach_entry(ra, &itr->readahead, in_itr) {
+		if (ra->page_no == page_no)
+			return ra;
 	}
+	return NULL;
+}
+
+/**
+ * Called after a run iterator loads a page. If the iterator
+ * appears to read the run sequentially, start reading the
+ * pages following the loaded one in the iteration order
+ * so that they are ready by the time the iterator needs them.
+ * The number of pages read ahead grows as long as the access
+ * pattern stays sequential.
+ */
+static void
+vy_run_iterator_readahead(struct vy_run_iterator *itr, uint32_t page_no)
+{
+	struct vy_slice *slice = itr->slice;
+	/* No reader threads during WAL recovery. */
+	if (slice->run->env->reader_pool == NULL)
+		return;
+
+	int dir = iterator_direction(itr->iterator_type);
+	bool is_sequential = itr->last_loaded_page_no >= 0 &&
+			     itr->last_loaded_page_no + dir == page_no;
+	itr->last_loaded_page_no = page_no;
+	if (!is_sequential)
+		itr->readahead_window = 0;
+	else if (itr->readahead_window == 0)
+		itr->readahead_window = 1;
+	else
+		itr->readahead_window = MIN(itr->readahead_window * 2,
+					    (uint32_t)VY_RUN_READAHEAD_MAX);
+
+	/* Discard pages that fall out of the readahead window. */
+	struct vy_page_readahead *ra, *tmp;
+	rlist_foreach_entry_safe(ra, &itr->readahead, in_itr, tmp) {
+		int64_t distance = dir * ((int64_t)ra->page_no - page_no);
+		if (distance <= 0 || distance > itr->readahead_window)
+			vy_page_readahead_discard(ra);
+	}
+
+	for (uint32_t i = 1; i <= itr->readahead_window; i++) {
+		int64_t next_page_no = (int64_t)page_no + dir * (int64_t)i;
+		if (next_page_no < slice->first_page_no ||
+		    next_page_no > slice->last_page_no)
+			break;
+		if (slice->run->cached_pages != NULL &&
+		    slice->run->cached_pages[next_page_no] != NULL)
+			continue;
+		if (vy_run_iterator_find_readahead(itr, next_page_no) == NULL)
+			vy_run_iterator_start_readahead(itr, next_page_no);
+	}
+}
+
+/**
+ * Read a page from disk on behalf of a reader thread and look up
+ * the given key in it. Returns NULL on error.
+ */
+static struct vy_page *
+vy_run_iterator_read_page(struct vy_run_iterator *itr,
+			  struct vy_page_info *page_info, struct vy_entry key,
+			  enum iterator_type iterator_type,
+			  uint32_t *pos_in_page, bool *equal_found)
+{
+	struct vy_run *run = itr->slice->run;
+	struct vy_run_env *env = run->env;
 
 	/* Allocate buffers */
-	struct vy_page_info *page_info = vy_run_page_info(slice->run, page_no);
-	page = vy_page_new(page_info);
+	struct vy_page *page = vy_page_new(page_info);
 	if (page == NULL)
-		return -1;
+		return NULL;
 
 	/* Read page data from the disk */
 	struct vy_page_read_task *task = mempool_alloc(&env->read_task_pool);
@@ -1043,9 +1778,9 @@ vy_run_iterator_load_page(struct vy_run_iterator *itr, uint32_t page_no,
 		diag_set(OutOfMemory, sizeof(*task),
 			 "mempool", "vy_page_read_task");
 		vy_page_delete(page);
-		return -1;
+		return NULL;
 	}
-	task->run = slice->run;
+	task->run = run;
 	task->page_info = page_info;
 	task->page = page;
 	task->key = key;
@@ -1063,15 +1798,69 @@ vy_run_iterator_load_page(struct vy_run_iterator *itr, uint32_t page_no,
 	mempool_free(&env->read_task_pool, task);
 	if (rc != 0) {
 		vy_page_delete(page);
-		return -1;
+		return NULL;
 	}
+	return page;
+}
 
-	/* Update cache */
+/**
+ * Make a page loaded by a run iterator current. The page that
+ * was current becomes previous. The iterator takes over the
+ * page reference.
+ */
+static void
+vy_run_iterator_set_curr_page(struct vy_run_iterator *itr,
+			      struct vy_page *page)
+{
 	if (itr->prev_page != NULL)
-		vy_page_delete(itr->prev_page);
+		vy_page_unref(itr->prev_page);
 	itr->prev_page = itr->curr_page;
 	itr->curr_page = page;
+}
+
+/**
+ * Get a page that isn't among the two most recently read ones:
+ * look it up in the page cache, take it from the pages read
+ * ahead or read it from disk. The page becomes current. If the
+ * page is read synchronously, the key is looked up in it by the
+ * reader thread and @a key_found is set.
+ *
+ * Returns NULL on error.
+ */
+static struct vy_page *
+vy_run_iterator_fetch_page(struct vy_run_iterator *itr, uint32_t page_no,
+			   struct vy_entry key,
+			   enum iterator_type iterator_type,
+			   uint32_t *pos_in_page, bool *equal_found,
+			   bool *key_found)
+{
+	struct vy_run *run = itr->slice->run;
+	struct vy_page_info *page_info = vy_run_page_info(run, page_no);
+
+	/* Check the page cache */
+	struct vy_page *page = vy_page_cache_lookup(run, page_no);
+	if (page != NULL) {
+		vy_run_iterator_set_curr_page(itr, page);
+		vy_run_iterator_readahead(itr, page_no);
+		return page;
+	}
+
+	/* Check pages read ahead */
+	struct vy_page_readahead *ra;
+	ra = vy_run_iterator_find_readahead(itr, page_no);
+	if (ra != NULL) {
+		page = vy_run_iterator_take_readahead(itr, ra);
+	} else {
+		page = vy_run_iterator_read_page(itr, page_info, key,
+						 iterator_type, pos_in_page,
+						 equal_found);
+		*key_found = true;
+	}
+	if (page == NULL)
+		return NULL;
 	page->page_no = page_no;
+	vy_page_cache_put(run, page);
+	vy_run_iterator_set_curr_page(itr, page);
 
 	/* Update read statistics. */
 	itr->stat->read.rows += page_info->row_count;
@@ -1079,6 +1868,45 @@ vy_run_iterator_load_page(struct vy_run_iterator *itr, uint32_t page_no,
 	itr->stat->read.bytes_compressed += page_info->size;
 	itr->stat->read.pages++;
 
+	vy_run_iterator_readahead(itr, page_no);
+	return page;
+}
+
+/**
+ * Read a page from disk given its number.
+ * The function caches two most recently read pages.
+ * Pages are also looked up in and added to the page cache.
+ *
+ * @retval 0 success
+ * @retval -1 critical error
+ */
+static NODISCARD int
+vy_run_iterator_load_page(struct vy_run_iterator *itr, uint32_t page_no,
+			  struct vy_entry key, enum iterator_type iterator_type,
+			  struct vy_page **result, uint32_t *pos_in_page,
+			  bool *equal_found)
+{
+	/* Check cache */
+	struct vy_page *page = NULL;
+	bool key_found = false;
+	if (itr->curr_page != NULL &&
+	    itr->curr_page->page_no == page_no) {
+		page = itr->curr_page;
+	} else if (itr->prev_page != NULL &&
+		   itr->prev_page->page_no == page_no) {
+		SWAP(itr->prev_page, itr->curr_page);
+		page = itr->curr_page;
+	} else {
+		page = vy_run_iterator_fetch_page(itr, page_no, key,
+						  iterator_type, pos_in_page,
+						  equal_found, &key_found);
+		if (page == NULL)
+			return -1;
+	}
+	if (key.stmt != NULL && !key_found)
+		*pos_in_page = vy_page_find_key(page, key, itr->cmp_def,
+						itr->format, iterator_type,
+						equal_found);
 	*result = page;
 	return 0;
 }
@@ -1483,6 +2311,10 @@ vy_run_iterator_open(struct vy_run_iterator *itr,
 	itr->curr_pos.page_no = slice->run->info.page_count;
 	itr->curr_page = NULL;
 	itr->prev_page = NULL;
+	rlist_create(&itr->readahead);
+	itr->readahead_window = 0;
+	itr->last_loaded_page_no = -1;
+	itr->blob_batch = NULL;
 	itr->search_started = false;
 
 	/*
@@ -1581,6 +2413,358 @@ next:
 	return 0;
 }
 
+/** Request to read a value from a blob file. */
+struct vy_blob_read_request {
+	/** Blob file to read the value from. */
+	struct vy_blob *blob;
+	/** Reference to the value. */
+	struct vy_blob_ref ref;
+	/** Buffer to read the value to. */
+	char *buf;
+};
+
+/**
+ * Values read from blob files by a run iterator in one go.
+ * Since a value is identified by its blob file id and offset
+ * and never changes, the batch stays valid after the iterator
+ * switches to another page.
+ */
+struct vy_blob_batch {
+	/** Read requests sorted by blob file id and offset. */
+	struct vy_blob_read_request *requests;
+	/** Number of entries in the requests array. */
+	uint32_t request_count;
+	/** Capacity of the requests array. */
+	uint32_t request_capacity;
+	/** Total size of the values. */
+	size_t size;
+	/** Buffer storing the values. */
+	char *data;
+	/** Capacity of the data buffer. */
+	size_t data_capacity;
+};
+
+static void
+vy_blob_batch_delete(struct vy_blob_batch *batch)
+{
+	free(batch->requests);
+	free(batch->data);
+	free(batch);
+}
+
+static int
+vy_blob_read_request_cmp(const void *a_ptr, const void *b_ptr)
+{
+	const struct vy_blob_read_request *a = a_ptr;
+	const struct vy_blob_read_request *b = b_ptr;
+	if (a->ref.blob_id != b->ref.blob_id)
+		return a->ref.blob_id < b->ref.blob_id ? -1 : 1;
+	if (a->ref.offset != b->ref.offset)
+		return a->ref.offset < b->ref.offset ? -1 : 1;
+	return 0;
+}
+
+/**
+ * Look up a value read by a batch. Returns NULL if the value
+ * isn't in the batch.
+ */
+static const char *
+vy_blob_batch_find(struct vy_blob_batch *batch, const struct vy_blob_ref *ref)
+{
+	if (batch == NULL || batch->request_count == 0)
+		return NULL;
+	struct vy_blob_read_request key;
+	key.ref = *ref;
+	struct vy_blob_read_request *request = bsearch(
+		&key, batch->requests, batch->request_count,
+		sizeof(*batch->requests), vy_blob_read_request_cmp);
+	if (request == NULL || request->ref.size != ref->size)
+		return NULL;
+	return request->buf;
+}
+
+/**
+ * Add read requests for all blob references stored in a statement
+ * read from a run to a batch.
+ */
+static int
+vy_blob_batch_add_stmt(struct vy_blob_batch *batch, struct vy_run *run,
+		       struct tuple *stmt)
+{
+	assert(vy_stmt_flags(stmt) & VY_STMT_BLOB_REFS);
+	const char *field = tuple_data(stmt);
+	uint32_t field_count = mp_decode_array(&field);
+	for (uint32_t i = 0; i < field_count; mp_next(&field), i++) {
+		struct vy_blob_ref ref;
+		if (!vy_blob_ref_decode(field, &ref))
+			continue;
+		struct vy_blob *blob = vy_run_lookup_blob(run, ref.blob_id);
+		if (blob == NULL) {
+			diag_set(ClientError, ER_INVALID_RUN_FILE,
+				 tt_sprintf("Reference to unknown blob file "
+					    "%lld in run %lld",
+					    (long long)ref.blob_id,
+					    (long long)run->id));
+			return -1;
+		}
+		if (batch->request_count >= batch->request_capacity) {
+			uint32_t capacity = MAX(batch->request_capacity * 2,
+						16u);
+			struct vy_blob_read_request *requests = realloc(
+				batch->requests, capacity * sizeof(*requests));
+			if (requests == NULL) {
+				diag_set(OutOfMemory,
+					 capacity * sizeof(*requests),
+					 "realloc",
+					 "struct vy_blob_read_request");
+				return -1;
+			}
+			batch->requests = requests;
+			batch->request_capacity = capacity;
+		}
+		struct vy_blob_read_request *request;
+		request = &batch->requests[batch->request_count++];
+		request->blob = blob;
+		request->ref = ref;
+		request->buf = NULL;
+		batch->size += ref.size;
+	}
+	return 0;
+}
+
+/** Cbus task for reading values from blob files. */
+struct vy_blob_read_task {
+	/** parent */
+	struct cbus_call_msg base;
+	/** Batch to read values to. */
+	struct vy_blob_batch *batch;
+};
+
+/**
+ * vinyl read task callback
+ */
+static int
+vy_blob_read_cb(struct cbus_call_msg *base)
+{
+	struct vy_blob_read_task *task = (struct vy_blob_read_task *)base;
+	struct vy_blob_batch *batch = task->batch;
+	for (uint32_t i = 0; i < batch->request_count; i++) {
+		struct vy_blob_read_request *request = &batch->requests[i];
+		if (vy_blob_read(request->blob, &request->ref,
+				 request->buf) != 0)
+			return -1;
+	}
+	return 0;
+}
+
+/**
+ * Read values referenced by a statement read from a run along
+ * with values referenced by statements that follow it in the
+ * same page in the iteration direction, so that a scan over
+ * separated values doesn't need a round trip to a reader thread
+ * per statement. The values are stored in vy_run_iterator::
+ * blob_batch, replacing its previous content.
+ *
+ * Statements invisible from the iterator read view are skipped.
+ * Statements overwritten by newer ones aren't, which is fine,
+ * because compaction leaves few of them. A point lookup reads
+ * only values of the given statement. The total size of read
+ * values is limited by VY_BLOB_BATCH_SIZE.
+ *
+ * This function yields while values are read from disk.
+ */
+static int
+vy_run_iterator_prefetch_blobs(struct vy_run_iterator *itr,
+			       struct tuple *stmt)
+{
+	struct vy_run *run = itr->slice->run;
+	struct vy_blob_batch *batch = itr->blob_batch;
+	if (batch == NULL) {
+		batch = calloc(1, sizeof(*batch));
+		if (batch == NULL) {
+			diag_set(OutOfMemory, sizeof(*batch),
+				 "malloc", "struct vy_blob_batch");
+			return -1;
+		}
+		itr->blob_batch = batch;
+	}
+	batch->request_count = 0;
+	batch->size = 0;
+	if (vy_blob_batch_add_stmt(batch, run, stmt) != 0)
+		return -1;
+
+	struct vy_page *page = itr->curr_page;
+	bool is_point_lookup = itr->iterator_type == ITER_EQ &&
+			       itr->key.stmt != NULL &&
+			       vy_stmt_is_full_key(itr->key.stmt,
+						   itr->cmp_def);
+	if (stmt == itr->curr.stmt && page != NULL &&
+	    page->page_no == itr->curr_pos.page_no && !is_point_lookup) {
+		int dir = iterator_direction(itr->iterator_type);
+		int64_t vlsn = (**itr->read_view).vlsn;
+		for (int64_t pos = (int64_t)itr->curr_pos.pos_in_page + dir;
+		     pos >= 0 && pos < page->row_count &&
+		     batch->size < VY_BLOB_BATCH_SIZE; pos += dir) {
+			struct vy_entry entry = vy_page_stmt(page, pos,
+							     itr->cmp_def,
+							     itr->format);
+			if (entry.stmt == NULL)
+				return -1;
+			int rc = 0;
+			if ((vy_stmt_flags(entry.stmt) &
+			     VY_STMT_BLOB_REFS) != 0 &&
+			    vy_stmt_lsn(entry.stmt) <= vlsn)
+				rc = vy_blob_batch_add_stmt(batch, run,
+							    entry.stmt);
+			tuple_unref(entry.stmt);
+			if (rc != 0)
+				return -1;
+		}
+	}
+
+	/* Sort requests to read values sequentially. */
+	qsort(batch->requests, batch->request_count,
+	      sizeof(*batch->requests), vy_blob_read_request_cmp);
+	if (batch->size > batch->data_capacity) {
+		char *data = realloc(batch->data, batch->size);
+		if (data == NULL) {
+			diag_set(OutOfMemory, batch->size,
+				 "realloc", "blob batch");
+			batch->request_count = 0;
+			return -1;
+		}
+		batch->data = data;
+		batch->data_capacity = batch->size;
+	}
+	char *buf = batch->data;
+	for (uint32_t i = 0; i < batch->request_count; i++) {
+		batch->requests[i].buf = buf;
+		buf += batch->requests[i].ref.size;
+	}
+
+	struct vy_blob_read_task task;
+	task.batch = batch;
+	if (vy_run_env_coio_call(run->env, &task.base, vy_blob_read_cb) != 0) {
+		batch->request_count = 0;
+		return -1;
+	}
+	return 0;
+}
+
+/**
+ * Given a statement read from a run that has VY_STMT_BLOB_REFS
+ * flag set, return a new statement with all blob references
+ * replaced with values they refer to. Returns NULL on error.
+ *
+ * This function yields while values are read from disk.
+ */
+static struct tuple *
+vy_run_iterator_resolve_blob_refs(struct vy_run_iterator *itr,
+				  struct tuple *stmt)
+{
+	assert(vy_stmt_flags(stmt) & VY_STMT_BLOB_REFS);
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	struct tuple *result = NULL;
+
+	uint32_t bsize;
+	const char *data = tuple_data_range(stmt, &bsize);
+	const char *data_end = data + bsize;
+	const char *pos = data;
+	uint32_t field_count = mp_decode_array(&pos);
+
+	/*
+	 * Calculate the new tuple size and check if the referenced
+	 * values have already been read along with a statement
+	 * preceding this one.
+	 */
+	bool is_prefetched = true;
+	uint32_t new_bsize = bsize;
+	const char *field = pos;
+	for (uint32_t i = 0; i < field_count; i++) {
+		const char *field_end = field;
+		mp_next(&field_end);
+		struct vy_blob_ref ref;
+		if (vy_blob_ref_decode(field, &ref)) {
+			new_bsize += ref.size - (field_end - field);
+			if (vy_blob_batch_find(itr->blob_batch, &ref) == NULL)
+				is_prefetched = false;
+		}
+		field = field_end;
+	}
+	if (!is_prefetched && vy_run_iterator_prefetch_blobs(itr, stmt) != 0)
+		goto out;
+
+	char *new_data = region_alloc(region, new_bsize);
+	if (new_data == NULL) {
+		diag_set(OutOfMemory, new_bsize, "region", "tuple");
+		goto out;
+	}
+	/* Copy fields replacing references with values. */
+	char *new_pos = new_data;
+	memcpy(new_pos, data, pos - data);
+	new_pos += pos - data;
+	field = pos;
+	for (uint32_t i = 0; i < field_count; i++) {
+		const char *field_end = field;
+		mp_next(&field_end);
+		struct vy_blob_ref ref;
+		if (vy_blob_ref_decode(field, &ref)) {
+			const char *value = vy_blob_batch_find(
+				itr->blob_batch, &ref);
+			if (value == NULL) {
+				diag_set(ClientError, ER_INVALID_RUN_FILE,
+					 tt_sprintf("Invalid blob reference "
+						    "in run %lld", (long long)
+						    itr->slice->run->id));
+				goto out;
+			}
+			memcpy(new_pos, value, ref.size);
+			new_pos += ref.size;
+		} else {
+			memcpy(new_pos, field, field_end - field);
+			new_pos += field_end - field;
+		}
+		field = field_end;
+	}
+	assert(field == data_end);
+	assert(new_pos == new_data + new_bsize);
+	(void)data_end;
+
+	if (vy_stmt_type(stmt) == IPROTO_INSERT)
+		result = vy_stmt_new_insert(itr->format, new_data, new_pos);
+	else
+		result = vy_stmt_new_replace(itr->format, new_data, new_pos);
+	if (result == NULL)
+		goto out;
+	vy_stmt_set_lsn(result, vy_stmt_lsn(stmt));
+	vy_stmt_set_flags(result, vy_stmt_flags(stmt) & ~VY_STMT_BLOB_REFS);
+out:
+	region_truncate(region, region_svp);
+	return result;
+}
+
+/**
+ * Append a statement read from the run to a history.
+ * Blob references stored in the statement are resolved.
+ */
+static NODISCARD int
+vy_run_iterator_append_history(struct vy_run_iterator *itr,
+			       struct vy_history *history,
+			       struct vy_entry entry)
+{
+	if ((vy_stmt_flags(entry.stmt) & VY_STMT_BLOB_REFS) == 0)
+		return vy_history_append_stmt(history, entry);
+	struct tuple *stmt = vy_run_iterator_resolve_blob_refs(itr,
+							       entry.stmt);
+	if (stmt == NULL)
+		return -1;
+	struct vy_entry resolved = {stmt, entry.hint};
+	int rc = vy_history_append_stmt(history, resolved);
+	tuple_unref(stmt);
+	return rc;
+}
+
 NODISCARD int
 vy_run_iterator_next(struct vy_run_iterator *itr,
 		     struct vy_history *history)
@@ -1590,7 +2774,7 @@ vy_run_iterator_next(struct vy_run_iterator *itr,
 	if (vy_run_iterator_next_key(itr, &entry) != 0)
 		return -1;
 	while (entry.stmt != NULL) {
-		if (vy_history_append_stmt(history, entry) != 0)
+		if (vy_run_iterator_append_history(itr, history, entry) != 0)
 			return -1;
 		if (vy_history_is_terminal(history))
 			break;
@@ -1622,7 +2806,7 @@ vy_run_iterator_skip(struct vy_run_iterator *itr, struct vy_entry last,
 		return -1;
 
 	while (entry.stmt != NULL) {
-		if (vy_history_append_stmt(history, entry) != 0)
+		if (vy_run_iterator_append_history(itr, history, entry) != 0)
 			return -1;
 		if (vy_history_is_terminal(history))
 			break;
@@ -1636,6 +2820,8 @@ void
 vy_run_iterator_close(struct vy_run_iterator *itr)
 {
 	vy_run_iterator_stop(itr);
+	if (itr->blob_batch != NULL)
+		vy_blob_batch_delete(itr->blob_batch);
 	tuple_format_unref(itr->format);
 	TRASH(itr);
 }
@@ -1769,6 +2955,7 @@ vy_run_recover(struct vy_run *run, const char *dir,
 	}
 	run->fd = cursor.fd;
 	xlog_cursor_close(&cursor, true);
+	vy_run_setup_direct_io(run);
 	return 0;
 
 fail_close:
@@ -1966,6 +3153,30 @@ vy_stmt_stat_encode(const struct vy_stmt_stat *stat, char *buf)
 	return buf;
 }
 
+/** Return the size of encoded blob file information. */
+static size_t
+vy_run_blob_info_sizeof(const struct vy_run_info *run_info)
+{
+	size_t size = mp_sizeof_map(run_info->blob_count);
+	for (uint32_t i = 0; i < run_info->blob_count; i++) {
+		size += mp_sizeof_uint(run_info->blob_info[i].id);
+		size += mp_sizeof_uint(run_info->blob_info[i].size);
+	}
+	return size;
+}
+
+/** Encode blob file information to @buf and return advanced @buf. */
+static char *
+vy_run_blob_info_encode(const struct vy_run_info *run_info, char *buf)
+{
+	buf = mp_encode_map(buf, run_info->blob_count);
+	for (uint32_t i = 0; i < run_info->blob_count; i++) {
+		buf = mp_encode_uint(buf, run_info->blob_info[i].id);
+		buf = mp_encode_uint(buf, run_info->blob_info[i].size);
+	}
+	return buf;
+}
+
 /**
  * Encode vy_run_info as xrow
  * Allocates using region alloc
@@ -1991,6 +3202,8 @@ vy_run_info_encode(const struct vy_run_info *run_info,
 	uint32_t key_count = 6;
 	if (run_info->bloom != NULL)
 		key_count++;
+	if (run_info->blob_count > 0)
+		key_count++;
 
 	size_t size = mp_sizeof_map(key_count);
 	size += mp_sizeof_uint(VY_RUN_INFO_MIN_KEY) + min_key_size;
@@ -2006,6 +3219,9 @@ vy_run_info_encode(const struct vy_run_info *run_info,
 			tuple_bloom_size(run_info->bloom);
 	size += mp_sizeof_uint(VY_RUN_INFO_STMT_STAT) +
 		vy_stmt_stat_sizeof(&run_info->stmt_stat);
+	if (run_info->blob_count > 0)
+		size += mp_sizeof_uint(VY_RUN_INFO_BLOBS) +
+			vy_run_blob_info_sizeof(run_info);
 
 	char *pos = region_alloc(&fiber()->gc, size);
 	if (pos == NULL) {
@@ -2034,6 +3250,10 @@ vy_run_info_encode(const struct vy_run_info *run_info,
 	}
 	pos = mp_encode_uint(pos, VY_RUN_INFO_STMT_STAT);
 	pos = vy_stmt_stat_encode(&run_info->stmt_stat, pos);
+	if (run_info->blob_count > 0) {
+		pos = mp_encode_uint(pos, VY_RUN_INFO_BLOBS);
+		pos = vy_run_blob_info_encode(run_info, pos);
+	}
 	xrow->body->iov_len = (void *)pos - xrow->body->iov_base;
 	xrow->bodycnt = 1;
 	xrow->type = VY_INDEX_RUN_INFO;
@@ -2133,12 +3353,247 @@ vy_run_writer_create(struct vy_run_writer *writer, struct vy_run *run,
 	xlog_clear(&writer->data_xlog);
 	ibuf_create(&writer->row_index_buf, &cord()->slabc,
 		    4096 * sizeof(uint32_t));
+	ibuf_create(&writer->blob_buf, &cord()->slabc,
+		    VY_BLOB_WRITE_BUF_SIZE);
 	run->info.min_lsn = INT64_MAX;
 	run->info.max_lsn = -1;
 	assert(run->page_info == NULL);
 	return 0;
 }
 
+void
+vy_run_writer_set_blob(struct vy_run_writer *writer, struct vy_blob *blob,
+		       uint32_t threshold, struct vy_blob **relocated,
+		       int relocated_count)
+{
+	assert(writer->iid == 0);
+	assert(blob->fd < 0);
+	writer->blob = blob;
+	writer->blob_threshold = threshold;
+	writer->relocated_blobs = relocated;
+	writer->relocated_blob_count = relocated_count;
+}
+
+/**
+ * Create a blob file to move big fields to.
+ * @param writer Run writer.
+ * @retval -1 IO error.
+ * @retval  0 Success.
+ */
+static int
+vy_run_writer_create_blob(struct vy_run_writer *writer)
+{
+	struct vy_blob *blob = writer->blob;
+	assert(blob->fd < 0);
+	char path[PATH_MAX];
+	vy_blob_snprint_path(path, sizeof(path), writer->dirpath,
+			     writer->space_id, writer->iid, blob->id, true);
+	say_info("writing `%s'", path);
+	int fd = open(path, O_RDWR | O_CREAT | O_EXCL, 0644);
+	if (fd < 0) {
+		diag_set(SystemError, "failed to create file '%s'", path);
+		return -1;
+	}
+	if (fio_writen(fd, VY_BLOB_SIGNATURE, VY_BLOB_SIGNATURE_LEN) != 0) {
+		diag_set(SystemError, "failed to write file '%s'", path);
+		close(fd);
+		return -1;
+	}
+	blob->fd = fd;
+	blob->size = VY_BLOB_SIGNATURE_LEN;
+	return 0;
+}
+
+/** Write values buffered by a run writer to the blob file. */
+static int
+vy_run_writer_flush_blob(struct vy_run_writer *writer)
+{
+	struct ibuf *buf = &writer->blob_buf;
+	if (ibuf_used(buf) == 0)
+		return 0;
+	if (fio_writen(writer->blob->fd, buf->rpos, ibuf_used(buf)) != 0) {
+		diag_set(SystemError, "failed to write blob file %lld",
+			 (long long)writer->blob->id);
+		return -1;
+	}
+	ibuf_reset(buf);
+	return 0;
+}
+
+/**
+ * Append a value to the blob file and encode a reference to it
+ * as a field of the given type at @pos, advancing @pos.
+ */
+static int
+vy_run_writer_write_blob(struct vy_run_writer *writer, const char *value,
+			 uint32_t size, enum mp_type type, char **pos)
+{
+	struct vy_blob *blob = writer->blob;
+	if (blob->fd < 0 && vy_run_writer_create_blob(writer) != 0)
+		return -1;
+	char *buf = ibuf_alloc(&writer->blob_buf, size);
+	if (buf == NULL) {
+		diag_set(OutOfMemory, size, "ibuf", "blob");
+		return -1;
+	}
+	memcpy(buf, value, size);
+	struct vy_blob_ref ref;
+	ref.blob_id = blob->id;
+	ref.offset = blob->size;
+	ref.size = size;
+	ref.crc32 = crc32_calc(0, value, size);
+	*pos = vy_blob_ref_encode(*pos, type, &ref);
+	blob->size += size;
+	if (ibuf_used(&writer->blob_buf) >= VY_BLOB_WRITE_BUF_SIZE &&
+	    vy_run_writer_flush_blob(writer) != 0)
+		return -1;
+	return vy_run_info_account_blob(&writer->run->info,
+					&writer->blob_info_capacity,
+					blob->id, size);
+}
+
+/** Return a blob file to relocate values from or NULL. */
+static struct vy_blob *
+vy_run_writer_relocated_blob(struct vy_run_writer *writer, int64_t blob_id)
+{
+	for (int i = 0; i < writer->relocated_blob_count; i++) {
+		if (writer->relocated_blobs[i]->id == blob_id)
+			return writer->relocated_blobs[i];
+	}
+	return NULL;
+}
+
+/**
+ * Prepare a primary index statement for writing to a run:
+ * move big fields to the blob file, relocate referenced values
+ * if necessary, and account values stored in blob files.
+ * Returns the statement to write, which is either @stmt or
+ * a new statement that must be unreferenced by the caller,
+ * or NULL on error.
+ */
+static struct tuple *
+vy_run_writer_separate_blobs(struct vy_run_writer *writer, struct tuple *stmt)
+{
+	enum iproto_type type = vy_stmt_type(stmt);
+	if (type != IPROTO_REPLACE && type != IPROTO_INSERT)
+		return stmt;
+	bool has_refs = (vy_stmt_flags(stmt) & VY_STMT_BLOB_REFS) != 0;
+	if (writer->blob == NULL && !has_refs)
+		return stmt;
+
+	struct tuple_format *format = tuple_format(stmt);
+	uint32_t bsize;
+	const char *data = tuple_data_range(stmt, &bsize);
+	const char *pos = data;
+	uint32_t field_count = mp_decode_array(&pos);
+	const char *fields = pos;
+	struct vy_blob_ref ref;
+
+	if (!has_refs) {
+		/*
+		 * Every field that looks like a blob reference is
+		 * treated as such in statements with VY_STMT_BLOB_REFS
+		 * flag so we can only move fields of this statement to
+		 * the blob file if look-alikes can be moved, too.
+		 */
+		bool found = false;
+		for (uint32_t i = 0; i < field_count; i++) {
+			const char *field = pos;
+			mp_next(&pos);
+			uint32_t size = pos - field;
+			if (i < format->index_field_count) {
+				if (vy_blob_ref_decode(field, &ref))
+					return stmt;
+				continue;
+			}
+			enum mp_type field_type = mp_typeof(*field);
+			if ((field_type == MP_STR || field_type == MP_BIN) &&
+			    size >= writer->blob_threshold &&
+			    size > vy_blob_ref_sizeof(field_type))
+				found = true;
+		}
+		if (!found)
+			return stmt;
+		pos = fields;
+	}
+
+	/* References are never bigger than values they replace. */
+	struct region *region = &fiber()->gc;
+	char *new_data = region_alloc(region, bsize);
+	if (new_data == NULL) {
+		diag_set(OutOfMemory, bsize, "region", "tuple");
+		return NULL;
+	}
+	char *new_pos = new_data;
+	memcpy(new_pos, data, fields - data);
+	new_pos += fields - data;
+	bool is_changed = false;
+	for (uint32_t i = 0; i < field_count; i++) {
+		const char *field = pos;
+		mp_next(&pos);
+		uint32_t size = pos - field;
+		enum mp_type field_type = mp_typeof(*field);
+		bool is_ref = vy_blob_ref_decode(field, &ref);
+		if (has_refs && is_ref) {
+			struct vy_blob *blob;
+			blob = vy_run_writer_relocated_blob(writer,
+							    ref.blob_id);
+			if (blob == NULL) {
+				/* Keep the reference. */
+				if (vy_run_info_account_blob(
+						&writer->run->info,
+						&writer->blob_info_capacity,
+						ref.blob_id, ref.size) != 0)
+					return NULL;
+				memcpy(new_pos, field, size);
+				new_pos += size;
+				continue;
+			}
+			char *value = region_alloc(region, ref.size);
+			if (value == NULL) {
+				diag_set(OutOfMemory, ref.size,
+					 "region", "blob value");
+				return NULL;
+			}
+			if (vy_blob_read(blob, &ref, value) != 0 ||
+			    vy_run_writer_write_blob(writer, value, ref.size,
+						     field_type, &new_pos) != 0)
+				return NULL;
+			is_changed = true;
+			continue;
+		}
+		if (writer->blob != NULL &&
+		    i >= format->index_field_count &&
+		    (field_type == MP_STR || field_type == MP_BIN) &&
+		    (is_ref || (size >= writer->blob_threshold &&
+				size > vy_blob_ref_sizeof(field_type)))) {
+			if (vy_run_writer_write_blob(writer, field, size,
+						     field_type,
+						     &new_pos) != 0)
+				return NULL;
+			is_changed = true;
+			continue;
+		}
+		assert(!is_ref);
+		memcpy(new_pos, field, size);
+		new_pos += size;
+	}
+	assert(new_pos <= new_data + bsize);
+	if (!is_changed)
+		return stmt;
+
+	struct tuple *result;
+	if (type == IPROTO_INSERT)
+		result = vy_stmt_new_insert(format, new_data, new_pos);
+	else
+		result = vy_stmt_new_replace(format, new_data, new_pos);
+	if (result == NULL)
+		return NULL;
+	vy_stmt_set_lsn(result, vy_stmt_lsn(stmt));
+	vy_stmt_set_flags(result, vy_stmt_flags(stmt) | VY_STMT_BLOB_REFS);
+	return result;
+}
+
 /**
  * Create an xlog to write run.
  * @param writer Run writer.
@@ -2160,6 +3615,7 @@ vy_run_writer_create_xlog(struct vy_run_writer *writer)
 	struct xlog_opts opts = xlog_opts_default;
 	opts.rate_limit = writer->run->env->snap_io_rate_limit;
 	opts.sync_interval = VY_RUN_SYNC_INTERVAL;
+	opts.free_cache = writer->run->env->direct_io;
 	opts.no_compression = writer->no_compression;
 	if (xlog_create(&writer->data_xlog, path, 0, &meta, &opts) != 0)
 		return -1;
@@ -2231,8 +3687,17 @@ vy_run_writer_write_to_page(struct vy_run_writer *writer, struct vy_entry entry)
 		return -1;
 	}
 	*offset = page->unpacked_size;
-	if (vy_run_dump_stmt(entry, &writer->data_xlog, page,
-			     writer->cmp_def, writer->iid == 0) != 0)
+	struct vy_entry written = entry;
+	if (writer->iid == 0) {
+		written.stmt = vy_run_writer_separate_blobs(writer, entry.stmt);
+		if (written.stmt == NULL)
+			return -1;
+	}
+	int rc = vy_run_dump_stmt(written, &writer->data_xlog, page,
+				  writer->cmp_def, writer->iid == 0);
+	if (written.stmt != entry.stmt)
+		tuple_unref(written.stmt);
+	if (rc != 0)
 		return -1;
 	int64_t lsn = vy_stmt_lsn(entry.stmt);
 	run->info.min_lsn = MIN(run->info.min_lsn, lsn);
@@ -2317,6 +3782,36 @@ vy_run_writer_destroy(struct vy_run_writer *writer, bool reuse_fd)
 	if (writer->bloom != NULL)
 		tuple_bloom_builder_delete(writer->bloom);
 	ibuf_destroy(&writer->row_index_buf);
+	ibuf_destroy(&writer->blob_buf);
+}
+
+/**
+ * Flush and sync the blob file written along with a run,
+ * then link it to the final name.
+ */
+static int
+vy_run_writer_commit_blob(struct vy_run_writer *writer)
+{
+	struct vy_blob *blob = writer->blob;
+	if (blob == NULL || blob->fd < 0)
+		return 0;
+	if (vy_run_writer_flush_blob(writer) != 0)
+		return -1;
+	char path[PATH_MAX];
+	char new_path[PATH_MAX];
+	vy_blob_snprint_path(path, sizeof(path), writer->dirpath,
+			     writer->space_id, writer->iid, blob->id, true);
+	vy_blob_snprint_path(new_path, sizeof(new_path), writer->dirpath,
+			     writer->space_id, writer->iid, blob->id, false);
+	if (fsync(blob->fd) < 0) {
+		diag_set(SystemError, "failed to sync file '%s'", path);
+		return -1;
+	}
+	if (rename(path, new_path) < 0) {
+		diag_set(SystemError, "failed to rename file '%s'", path);
+		return -1;
+	}
+	return 0;
 }
 
 int
@@ -2356,8 +3851,13 @@ vy_run_writer_commit(struct vy_run_writer *writer)
 		goto out;
 	});
 
-	/* Sync data and link the file to the final name. */
-	if (xlog_sync(&writer->data_xlog) < 0 ||
+	/*
+	 * Sync data and link the file to the final name. The blob
+	 * file goes first so that a complete run never references
+	 * an incomplete blob file.
+	 */
+	if (vy_run_writer_commit_blob(writer) != 0 ||
+	    xlog_sync(&writer->data_xlog) < 0 ||
 	    xlog_rename(&writer->data_xlog) < 0)
 		goto out;
 
@@ -2372,6 +3872,7 @@ vy_run_writer_commit(struct vy_run_writer *writer)
 		goto out;
 
 	run->fd = writer->data_xlog.fd;
+	vy_run_setup_direct_io(run);
 	vy_run_writer_destroy(writer, true);
 	rc = 0;
 out:
@@ -2407,6 +3908,7 @@ vy_run_rebuild_index(struct vy_run *run, const char *dir,
 
 	int rc = 0;
 	uint32_t page_info_capacity = 0;
+	uint32_t blob_info_capacity = 0;
 
 	const char *key = NULL;
 	int64_t max_lsn = 0;
@@ -2445,6 +3947,13 @@ vy_run_rebuild_index(struct vy_run *run, const char *dir,
 			struct tuple *tuple = vy_stmt_decode(&xrow, format);
 			if (tuple == NULL)
 				goto close_err;
+			if ((vy_stmt_flags(tuple) & VY_STMT_BLOB_REFS) != 0 &&
+			    vy_run_info_account_blob_refs(&run->info,
+							  &blob_info_capacity,
+							  tuple) != 0) {
+				tuple_unref(tuple);
+				goto close_err;
+			}
 			if (bloom_builder != NULL) {
 				struct vy_entry entry = {tuple, HINT_NONE};
 				if (vy_bloom_builder_add(bloom_builder, entry,
@@ -2508,6 +4017,7 @@ vy_run_rebuild_index(struct vy_run *run, const char *dir,
 	region_truncate(region, mem_used);
 	run->fd = cursor.fd;
 	xlog_cursor_close(&cursor, true);
+	vy_run_setup_direct_io(run);
 
 	if (bloom_builder != NULL) {
 		run->info.bloom = tuple_bloom_new(bloom_builder,
@@ -2563,6 +4073,39 @@ vy_run_remove_files(const char *dir, uint32_t space_id,
 		} else
 			say_info("removed %s", path);
 	}
+	/* Remove the blob file the run was written along with. */
+	vy_blob_snprint_path(path, sizeof(path), dir, space_id, iid,
+			     run_id, true);
+	if (coio_unlink(path) < 0) {
+		if (errno != ENOENT) {
+			say_syserror("error while removing %s", path);
+			ret = -1;
+		}
+	} else
+		say_info("removed %s", path);
+	return ret;
+}
+
+int
+vy_blob_remove_files(const char *dir, uint32_t space_id,
+		     uint32_t iid, int64_t blob_id)
+{
+	ERROR_INJECT(ERRINJ_VY_GC,
+		     {say_error("error injection: vinyl blob %lld not deleted",
+				(long long)blob_id); return -1;});
+	int ret = 0;
+	char path[PATH_MAX];
+	for (int inprogress = 0; inprogress <= 1; inprogress++) {
+		vy_blob_snprint_path(path, sizeof(path), dir, space_id, iid,
+				     blob_id, inprogress);
+		if (coio_unlink(path) < 0) {
+			if (errno != ENOENT) {
+				say_syserror("error while removing %s", path);
+				ret = -1;
+			}
+		} else
+			say_info("removed %s", path);
+	}
 	return ret;
 }
 
@@ -2670,6 +4213,16 @@ vy_slice_stream_next(struct vy_stmt_stream *virt_stream, struct vy_entry *ret)
 		return 0;
 	}
 
+	if (stream->blob_acct != NULL &&
+	    (vy_stmt_flags(entry.stmt) & VY_STMT_BLOB_REFS) != 0 &&
+	    vy_blob_info_account_refs(&stream->blob_acct->blob_info,
+				      &stream->blob_acct->blob_count,
+				      &stream->blob_acct->capacity,
+				      entry.stmt) != 0) {
+		tuple_unref(entry.stmt);
+		return -1;
+	}
+
 	/* We definitely has the next non-null tuple. Save it in stream */
 	if (stream->entry.stmt != NULL)
 		tuple_unref(stream->entry.stmt);
@@ -2731,7 +4284,8 @@ static const struct vy_stmt_stream_iface vy_slice_stream_iface = {
 
 void
 vy_slice_stream_open(struct vy_slice_stream *stream, struct vy_slice *slice,
-		     struct key_def *cmp_def, struct tuple_format *format)
+		     struct key_def *cmp_def, struct tuple_format *format,
+		     struct vy_blob_acct *blob_acct)
 {
 	stream->base.iface = &vy_slice_stream_iface;
 
@@ -2743,5 +4297,6 @@ vy_slice_stream_open(struct vy_slice_stream *stream, struct vy_slice *slice,
 	stream->slice = slice;
 	stream->cmp_def = cmp_def;
 	stream->format = format;
+	stream->blob_acct = blob_acct;
 	tuple_format_ref(format);
 }
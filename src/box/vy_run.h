@@ -33,6 +33,8 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stdlib.h>
+#include <msgpuck.h>
 
 #include "fiber_cond.h"
 #include "iterator_type.h"
@@ -49,15 +51,37 @@
 extern "C" {
 #endif /* defined(__cplusplus) */
 
+struct vy_blob_batch;
 struct vy_history;
 struct vy_run_reader;
 
+/**
+ * Cache of pages read from run files. Pages are cached
+ * decompressed so that a cache hit costs neither disk IO nor
+ * decompression. The cache is meant to be used instead of
+ * the OS page cache when run files are read with direct IO,
+ * see vy_run_env::direct_io.
+ */
+struct vy_page_cache {
+	/**
+	 * Cached pages, most recently used first,
+	 * linked by vy_page::in_cache.
+	 */
+	struct rlist lru;
+	/** Max size of memory used by cached pages, in bytes. */
+	size_t quota;
+	/** Size of memory used by cached pages, in bytes. */
+	size_t used;
+};
+
 /** Part of vinyl environment for run read/write */
 struct vy_run_env {
 	/** Write rate limit, in bytes per second. */
 	uint64_t snap_io_rate_limit;
 	/** Mempool for struct vy_page_read_task */
 	struct mempool read_task_pool;
+	/** Mempool for struct vy_page_readahead */
+	struct mempool readahead_pool;
 	/** Key for thread-local ZSTD context */
 	pthread_key_t zdctx_key;
 	/** Pool of threads used for reading run files. */
@@ -74,8 +98,196 @@ struct vy_run_env {
 	 * unconditionally remove unused runs' files in-place.
 	 */
 	bool initial_join;
+	/**
+	 * If set, run files are read with direct IO, bypassing
+	 * the OS page cache, and dropped from the OS page cache
+	 * after being written.
+	 */
+	bool direct_io;
+	/** Cache of pages read from run files. */
+	struct vy_page_cache page_cache;
+};
+
+/**
+ * Blob file, a.k.a. value log.
+ *
+ * If key-value separation is enabled for an LSM tree (see
+ * index_opts::blob_threshold), the run writer moves big fields
+ * of REPLACE and INSERT statements to a blob file and stores
+ * short references to them in run pages instead, see struct
+ * vy_blob_ref. Such statements are marked with VY_STMT_BLOB_REFS.
+ * References are resolved by the run iterator so readers never
+ * see them, while compaction copies them as is to the output run
+ * so that big values aren't rewritten on each LSM tree level.
+ *
+ * A blob file is written along with a run and has the same id,
+ * but it may outlive the run, because compaction output may keep
+ * referencing it. The life cycle of blob files is tracked in the
+ * metadata log: a blob file is dropped as soon as there's no run
+ * referencing it, see VY_LOG_DROP_BLOB. To reclaim space occupied
+ * by overwritten values, compaction moves values out of blob files
+ * that are mostly garbage (relocation).
+ */
+struct vy_blob {
+	/** Unique ID of this blob file. */
+	int64_t id;
+	/** Blob file descriptor, open for reading. */
+	int fd;
+	/** Size of the blob file. */
+	uint64_t size;
+	/**
+	 * Size of values stored in the blob file that aren't
+	 * referenced by any run any more, because statements
+	 * storing them were discarded by compaction. Updated on
+	 * compaction completion and persisted in the metadata
+	 * log, see VY_LOG_MODIFY_BLOB.
+	 */
+	uint64_t garbage_size;
+	/** Number of runs of the LSM tree referencing this file. */
+	int run_count;
+	/**
+	 * Counter used on completion of a compaction task to check
+	 * if all runs referencing this file have been compacted
+	 * and so the file is not used any more and should be
+	 * dropped.
+	 */
+	int compacted_run_count;
+	/**
+	 * Reference counter, the object is deleted once it hits 0.
+	 * A blob file is referenced by each run storing values in
+	 * it, by the LSM tree while the file is in use, and by each
+	 * pending write task.
+	 */
+	int refs;
+	/** Link in vy_lsm::blobs list. */
+	struct rlist in_lsm;
+};
+
+/**
+ * Reference to a value stored in a blob file.
+ *
+ * In a statement, a reference replaces the value it refers to.
+ * It is encoded as a string or a binary string, depending on
+ * the type of the value, of size VY_BLOB_REF_SIZE, with the
+ * following layout:
+ *
+ *   magic (4) | blob_id (8) | offset (8) | size (4) | crc32 (4)
+ *
+ * The value is stored in the blob file in MsgPack, including
+ * the header, so resolving a reference boils down to copying.
+ */
+struct vy_blob_ref {
+	/** ID of the blob file storing the value. */
+	int64_t blob_id;
+	/** Offset of the value in the blob file. */
+	uint64_t offset;
+	/** Size of the value. */
+	uint32_t size;
+	/** Checksum of the value. */
+	uint32_t crc32;
+};
+
+enum {
+	/** Size of an encoded blob reference, without MsgPack header. */
+	VY_BLOB_REF_SIZE = 28,
+	/** Magic number every encoded blob reference starts with. */
+	VY_BLOB_REF_MAGIC = 0xd5aab10b,
+};
+
+/**
+ * Decode a blob reference from a MsgPack field.
+ * Returns false if the field isn't a blob reference.
+ */
+static inline bool
+vy_blob_ref_decode(const char *field, struct vy_blob_ref *ref)
+{
+	uint32_t len;
+	switch (mp_typeof(*field)) {
+	case MP_STR:
+		len = mp_decode_strl(&field);
+		break;
+	case MP_BIN:
+		len = mp_decode_binl(&field);
+		break;
+	default:
+		return false;
+	}
+	if (len != VY_BLOB_REF_SIZE ||
+	    mp_load_u32(&field) != VY_BLOB_REF_MAGIC)
+		return false;
+	ref->blob_id = mp_load_u64(&field);
+	ref->offset = mp_load_u64(&field);
+	ref->size = mp_load_u32(&field);
+	ref->crc32 = mp_load_u32(&field);
+	return true;
+}
+
+/**
+ * Encode a blob reference to @buf as a field of the given type
+ * (MP_STR or MP_BIN) and return advanced @buf.
+ */
+static inline char *
+vy_blob_ref_encode(char *buf, enum mp_type type, const struct vy_blob_ref *ref)
+{
+	assert(type == MP_STR || type == MP_BIN);
+	buf = type == MP_STR ? mp_encode_strl(buf, VY_BLOB_REF_SIZE) :
+			       mp_encode_binl(buf, VY_BLOB_REF_SIZE);
+	buf = mp_store_u32(buf, VY_BLOB_REF_MAGIC);
+	buf = mp_store_u64(buf, ref->blob_id);
+	buf = mp_store_u64(buf, ref->offset);
+	buf = mp_store_u32(buf, ref->size);
+	buf = mp_store_u32(buf, ref->crc32);
+	return buf;
+}
+
+/** Size of a blob reference encoded by vy_blob_ref_encode(). */
+static inline uint32_t
+vy_blob_ref_sizeof(enum mp_type type)
+{
+	assert(type == MP_STR || type == MP_BIN);
+	return (type == MP_STR ? mp_sizeof_strl(VY_BLOB_REF_SIZE) :
+				 mp_sizeof_binl(VY_BLOB_REF_SIZE)) +
+	       VY_BLOB_REF_SIZE;
+}
+
+/** Information about values stored by a run in a blob file. */
+struct vy_run_blob_info {
+	/** ID of the blob file. */
+	int64_t id;
+	/** Total size of values stored by the run in the file. */
+	uint64_t size;
 };
 
+/**
+ * Sizes of values referenced by a set of statements, by blob file.
+ * Used by compaction for accounting values referenced by the slices
+ * it reads, see vy_slice_stream_open().
+ */
+struct vy_blob_acct {
+	/** Blob files referenced by the statements. */
+	struct vy_run_blob_info *blob_info;
+	/** Number of entries in the blob_info array. */
+	uint32_t blob_count;
+	/** Capacity of the blob_info array. */
+	uint32_t capacity;
+};
+
+/** Initialize blob accounting. */
+static inline void
+vy_blob_acct_create(struct vy_blob_acct *acct)
+{
+	acct->blob_info = NULL;
+	acct->blob_count = 0;
+	acct->capacity = 0;
+}
+
+/** Free memory allocated for blob accounting. */
+static inline void
+vy_blob_acct_destroy(struct vy_blob_acct *acct)
+{
+	free(acct->blob_info);
+}
+
 /**
  * Run metadata. Is a written to a file as a single chunk.
  */
@@ -94,6 +306,10 @@ struct vy_run_info {
 	struct tuple_bloom *bloom;
 	/** Statement statistics. */
 	struct vy_stmt_stat stmt_stat;
+	/** Blob files referenced by the run. */
+	struct vy_run_blob_info *blob_info;
+	/** Number of entries in the blob_info array. */
+	uint32_t blob_count;
 };
 
 /**
@@ -128,6 +344,17 @@ struct vy_run {
 	struct vy_page_info *page_info;
 	/** Run data file. */
 	int fd;
+	/**
+	 * Blob files referenced by the run, in the same order as
+	 * vy_run_info::blob_info. Each of them is referenced by
+	 * the run. Set by vy_run_bind_blobs().
+	 */
+	struct vy_blob **blobs;
+	/**
+	 * Pages of this run stored in the page cache, indexed by
+	 * page number. Allocated when the first page is cached.
+	 */
+	struct vy_page **cached_pages;
 	/** Unique ID of this run. */
 	int64_t id;
 	/** Number of statements in this run. */
@@ -284,6 +511,27 @@ struct vy_run_iterator {
 	 */
 	struct vy_page *curr_page;
 	struct vy_page *prev_page;
+	/**
+	 * Pages that are being read or have been read ahead of
+	 * time, because the iterator is expected to need them
+	 * soon, linked by vy_page_readahead::in_itr.
+	 */
+	struct rlist readahead;
+	/**
+	 * Number of pages to read ahead. Doubled every time the
+	 * iterator loads the page following the previously loaded
+	 * one, up to VY_RUN_READAHEAD_MAX, and reset on random
+	 * access.
+	 */
+	uint32_t readahead_window;
+	/** Number of the page loaded last or -1. */
+	int64_t last_loaded_page_no;
+	/**
+	 * Values referenced by statements of the current page
+	 * read from blob files in one go or NULL if the iterator
+	 * hasn't come across any blob references yet.
+	 */
+	struct vy_blob_batch *blob_batch;
 	/** Is false until first .._get or .._next_.. method is called */
 	bool search_started;
 };
@@ -302,6 +550,15 @@ struct vy_page {
 	uint32_t *row_index;
 	/** Pointer to the page data. */
 	char *data;
+	/**
+	 * Page reference counter. A page is referenced by each
+	 * run iterator that keeps it loaded and by the page cache.
+	 */
+	int refs;
+	/** Run the page belongs to if the page is cached, else NULL. */
+	struct vy_run *run;
+	/** Link in vy_page_cache::lru. */
+	struct rlist in_cache;
 };
 
 /**
@@ -335,6 +592,15 @@ vy_run_env_destroy(struct vy_run_env *env);
 void
 vy_run_env_enable_coio(struct vy_run_env *env);
 
+/**
+ * Set the max size of memory that may be used for caching pages
+ * read from run files. Zero disables the page cache. If the new
+ * limit is less than the size of cached pages, the least recently
+ * used pages are evicted.
+ */
+void
+vy_run_env_set_page_cache(struct vy_run_env *env, size_t quota);
+
 /**
  * Return the size of a run bloom filter.
  */
@@ -375,6 +641,65 @@ vy_run_unref(struct vy_run *run)
 		vy_run_delete(run);
 }
 
+/**
+ * Allocate a new blob file object with the given id.
+ * The object is returned referenced.
+ */
+struct vy_blob *
+vy_blob_new(int64_t id);
+
+void
+vy_blob_delete(struct vy_blob *blob);
+
+static inline void
+vy_blob_ref(struct vy_blob *blob)
+{
+	assert(blob->refs > 0);
+	blob->refs++;
+}
+
+static inline void
+vy_blob_unref(struct vy_blob *blob)
+{
+	assert(blob->refs > 0);
+	if (--blob->refs == 0)
+		vy_blob_delete(blob);
+}
+
+/**
+ * Open a blob file for reading on recovery.
+ * @param blob - blob file object to load
+ * @param dir - path to the vinyl directory
+ * @param space_id - space id
+ * @param iid - index id
+ * @return - 0 on sucess, -1 on fail
+ */
+int
+vy_blob_recover(struct vy_blob *blob, const char *dir,
+		uint32_t space_id, uint32_t iid);
+
+/**
+ * Read a value referenced by @ref from a blob file to @buf,
+ * which must be at least @ref->size bytes long, and check its
+ * checksum. Return 0 on success, -1 on failure.
+ *
+ * This function blocks the calling thread so it must be called
+ * from a reader thread.
+ */
+int
+vy_blob_read(struct vy_blob *blob, const struct vy_blob_ref *ref, char *buf);
+
+/**
+ * Bind a run to blob files it stores values in: look up each
+ * blob file referenced by vy_run_info::blob_info among @blobs
+ * (linked by vy_blob::in_lsm) and @new_blob, which may be NULL,
+ * and reference it. Return 0 on success, -1 if a blob file
+ * isn't found or memory allocation failed.
+ */
+int
+vy_run_bind_blobs(struct vy_run *run, struct rlist *blobs,
+		  struct vy_blob *new_blob);
+
 /**
  * Load run from disk
  * @param run - run to laod
@@ -455,6 +780,27 @@ int
 vy_run_remove_files(const char *dir, uint32_t space_id,
 		    uint32_t iid, int64_t run_id);
 
+static inline int
+vy_blob_snprint_path(char *buf, int size, const char *dir,
+		     uint32_t space_id, uint32_t iid,
+		     int64_t blob_id, bool inprogress)
+{
+	int total = 0;
+	SNPRINT(total, vy_lsm_snprint_path, buf, size,
+		dir, (unsigned)space_id, (unsigned)iid);
+	SNPRINT(total, snprintf, buf, size, "/%020lld.blob%s",
+		(long long)blob_id, inprogress ? inprogress_suffix : "");
+	return total;
+}
+
+/**
+ * Remove a blob file with the given id. Return 0 on success,
+ * -1 if unlink() failed.
+ */
+int
+vy_blob_remove_files(const char *dir, uint32_t space_id,
+		     uint32_t iid, int64_t blob_id);
+
 /**
  * Allocate a new run slice.
  * This function increments @run->refs.
@@ -578,14 +924,22 @@ struct vy_slice_stream {
 	struct key_def *cmp_def;
 	/** Format for allocating REPLACE and DELETE tuples read from pages. */
 	struct tuple_format *format;
+	/**
+	 * If not NULL, values referenced in blob files by
+	 * statements returned by the stream are accounted here.
+	 */
+	struct vy_blob_acct *blob_acct;
 };
 
 /**
  * Open a run stream. Use vy_stmt_stream api for further work.
+ * If @blob_acct is not NULL, sizes of values referenced in blob
+ * files by statements read from the slice are accounted to it.
  */
 void
 vy_slice_stream_open(struct vy_slice_stream *stream, struct vy_slice *slice,
-		     struct key_def *cmp_def, struct tuple_format *format);
+		     struct key_def *cmp_def, struct tuple_format *format,
+		     struct vy_blob_acct *blob_acct);
 
 /**
  * Run_writer fills a created run with statements one by one,
@@ -632,6 +986,24 @@ struct vy_run_writer {
 	 * of max key of a finished run.
 	 */
 	struct vy_entry last;
+	/**
+	 * Blob file to move big fields to or NULL if key-value
+	 * separation is disabled, see vy_run_writer_set_blob().
+	 */
+	struct vy_blob *blob;
+	/** Fields greater than this are moved to the blob file. */
+	uint32_t blob_threshold;
+	/**
+	 * Blob files which values must be moved to the blob file
+	 * rather than referenced by the written run.
+	 */
+	struct vy_blob **relocated_blobs;
+	/** Number of entries in the relocated_blobs array. */
+	int relocated_blob_count;
+	/** Buffer of values not yet written to the blob file. */
+	struct ibuf blob_buf;
+	/** Current blob info capacity of the run. */
+	uint32_t blob_info_capacity;
 };
 
 /** Create a run writer to fill a run with statements. */
@@ -641,6 +1013,22 @@ vy_run_writer_create(struct vy_run_writer *writer, struct vy_run *run,
 		     struct key_def *cmp_def, struct key_def *key_def,
 		     uint64_t page_size, double bloom_fpr, bool no_compression);
 
+/**
+ * Enable key-value separation for a run writer: make it move
+ * MsgPack strings and binary strings of size greater than or
+ * equal to @threshold stored in non-indexed fields of REPLACE
+ * and INSERT statements to @blob, and replace them with blob
+ * references. Values referenced by statements written to the
+ * run are copied to @blob if they are stored in one of blob
+ * files listed in @relocated. The blob file is created on
+ * the first write. The caller must keep all blob files
+ * referenced while the writer is in use.
+ */
+void
+vy_run_writer_set_blob(struct vy_run_writer *writer, struct vy_blob *blob,
+		       uint32_t threshold, struct vy_blob **relocated,
+		       int relocated_count);
+
 /**
  * Write a specified statement into a run.
  * @param writer Writer to write a statement.
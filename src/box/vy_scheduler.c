@@ -205,6 +205,29 @@ struct vy_task {
 	 */
 	double bloom_fpr;
 	int64_t page_size;
+	uint32_t blob_threshold;
+	/**
+	 * Blob file to move big fields of the new run to or NULL
+	 * if key-value separation is disabled for the LSM tree.
+	 * It is only used if the writer actually moves something
+	 * to it, see vy_task_blob_is_used().
+	 */
+	struct vy_blob *new_blob;
+	/**
+	 * Blob files which values are copied to new_blob rather
+	 * than referenced by the new run, because they are mostly
+	 * occupied by values of overwritten statements.
+	 */
+	struct vy_blob **relocated_blobs;
+	/** Number of entries in the relocated_blobs array. */
+	int relocated_blob_count;
+	/**
+	 * Values referenced in blob files by statements of the
+	 * slices a compaction task reads. Used for accounting
+	 * values that aren't referenced by the new run as garbage,
+	 * see vy_task_blob_garbage().
+	 */
+	struct vy_blob_acct input_blobs;
 	/**
 	 * Deferred DELETE handler passed to the write iterator.
 	 * It sends deferred DELETE statements generated during
@@ -260,6 +283,7 @@ vy_task_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 		return NULL;
 	}
 	vy_lsm_ref(lsm);
+	vy_blob_acct_create(&task->input_blobs);
 	diag_create(&task->diag);
 	task->deferred_delete_handler.iface = &vy_task_deferred_delete_iface;
 	return task;
@@ -271,6 +295,12 @@ vy_task_delete(struct vy_task *task)
 {
 	assert(task->deferred_delete_batch == NULL);
 	assert(task->deferred_delete_in_progress == 0);
+	for (int i = 0; i < task->relocated_blob_count; i++)
+		vy_blob_unref(task->relocated_blobs[i]);
+	free(task->relocated_blobs);
+	if (task->new_blob != NULL)
+		vy_blob_unref(task->new_blob);
+	vy_blob_acct_destroy(&task->input_blobs);
 	key_def_delete(task->cmp_def);
 	key_def_delete(task->key_def);
 	vy_lsm_unref(task->lsm);
@@ -817,6 +847,180 @@ vy_run_discard(struct vy_run *run)
 	vy_log_tx_try_commit();
 }
 
+/**
+ * Allocate a blob file for a dump/compaction task if key-value
+ * separation is enabled for the LSM tree. The blob file has the
+ * same id as the new run and is created by the run writer only
+ * if there's something to move to it.
+ */
+static int
+vy_task_prepare_blob(struct vy_task *task)
+{
+	struct vy_lsm *lsm = task->lsm;
+	if (lsm->index_id != 0 || lsm->opts.blob_threshold == 0)
+		return 0;
+	task->new_blob = vy_blob_new(task->new_run->id);
+	if (task->new_blob == NULL)
+		return -1;
+	task->blob_threshold = lsm->opts.blob_threshold;
+	return 0;
+}
+
+/** Return true if a task moved any values to its blob file. */
+static inline bool
+vy_task_blob_is_used(struct vy_task *task)
+{
+	return task->new_blob != NULL && task->new_blob->fd >= 0;
+}
+
+/**
+ * Collect blob files referenced by the runs a compaction task
+ * is going to compact that have more than a half of their space
+ * occupied by values that aren't referenced by any run. The task
+ * will move values stored in them to its own blob file so that
+ * they can be dropped eventually.
+ */
+static int
+vy_task_prepare_relocated_blobs(struct vy_task *task)
+{
+	if (task->new_blob == NULL)
+		return 0;
+	int capacity = 0;
+	struct vy_slice *slice;
+	for (slice = task->first_slice; ;
+	     slice = rlist_next_entry(slice, in_range)) {
+		struct vy_run *run = slice->run;
+		for (uint32_t i = 0; i < run->info.blob_count; i++) {
+			struct vy_blob *blob = run->blobs[i];
+			if (blob->garbage_size * 2 <= blob->size)
+				continue;
+			bool is_found = false;
+			for (int j = 0; j < task->relocated_blob_count; j++) {
+				if (task->relocated_blobs[j] == blob)
+					is_found = true;
+			}
+			if (is_found)
+				continue;
+			if (task->relocated_blob_count >= capacity) {
+				int new_capacity = capacity > 0 ?
+						   capacity * 2 : 4;
+				struct vy_blob **blobs = realloc(
+					task->relocated_blobs,
+					new_capacity * sizeof(*blobs));
+				if (blobs == NULL) {
+					diag_set(OutOfMemory,
+						 new_capacity * sizeof(*blobs),
+						 "realloc", "struct vy_blob *");
+					return -1;
+				}
+				task->relocated_blobs = blobs;
+				capacity = new_capacity;
+			}
+			vy_blob_ref(blob);
+			task->relocated_blobs[task->relocated_blob_count++] =
+				blob;
+		}
+		if (slice == task->last_slice)
+			break;
+	}
+	return 0;
+}
+
+/**
+ * Build the list of blob files that become unused as a result
+ * of compaction: all runs storing values in them are compacted
+ * and the new run doesn't store values in them. The caller is
+ * supposed to free the returned array.
+ */
+static int
+vy_task_find_unused_blobs(struct vy_task *task, struct rlist *unused_runs,
+			  struct vy_blob ***p_blobs, int *p_count)
+{
+	struct vy_run *new_run = task->new_run;
+	struct vy_run *run;
+	int capacity = 0;
+	rlist_foreach_entry(run, unused_runs, in_unused)
+		capacity += run->info.blob_count;
+	*p_blobs = NULL;
+	*p_count = 0;
+	if (capacity == 0)
+		return 0;
+	struct vy_blob **blobs = malloc(capacity * sizeof(*blobs));
+	if (blobs == NULL) {
+		diag_set(OutOfMemory, capacity * sizeof(*blobs),
+			 "malloc", "struct vy_blob *");
+		return -1;
+	}
+	rlist_foreach_entry(run, unused_runs, in_unused) {
+		for (uint32_t i = 0; i < run->info.blob_count; i++)
+			run->blobs[i]->compacted_run_count++;
+	}
+	int count = 0;
+	rlist_foreach_entry(run, unused_runs, in_unused) {
+		for (uint32_t i = 0; i < run->info.blob_count; i++) {
+			struct vy_blob *blob = run->blobs[i];
+			bool is_unused =
+				blob->compacted_run_count == blob->run_count;
+			blob->compacted_run_count = 0;
+			for (uint32_t j = 0; is_unused &&
+			     j < new_run->info.blob_count; j++) {
+				if (new_run->blobs[j] == blob)
+					is_unused = false;
+			}
+			if (is_unused)
+				blobs[count++] = blob;
+		}
+	}
+	*p_blobs = blobs;
+	*p_count = count;
+	return 0;
+}
+
+/**
+ * Return the size of values stored in blob file #@i of the input
+ * blob accounting of a compaction task that became garbage, i.e.
+ * were referenced by the compacted slices, but aren't referenced
+ * by the new run.
+ */
+static uint64_t
+vy_task_blob_garbage(struct vy_task *task, uint32_t i)
+{
+	const struct vy_run_blob_info *input = &task->input_blobs.blob_info[i];
+	const struct vy_run_info *info = &task->new_run->info;
+	uint64_t output = 0;
+	for (uint32_t j = 0; j < info->blob_count; j++) {
+		if (info->blob_info[j].id == input->id)
+			output = info->blob_info[j].size;
+	}
+	assert(output <= input->size);
+	return input->size - output;
+}
+
+/**
+ * Return blob file #@i of the input blob accounting of a compaction
+ * task if its garbage size must be updated on task completion or
+ * NULL if the task didn't leave garbage in it or the file is dropped
+ * by the task (is listed in @unused_blobs).
+ */
+static struct vy_blob *
+vy_task_garbage_blob(struct vy_task *task, uint32_t i,
+		     struct vy_blob **unused_blobs, int unused_blob_count)
+{
+	if (vy_task_blob_garbage(task, i) == 0)
+		return NULL;
+	int64_t blob_id = task->input_blobs.blob_info[i].id;
+	for (int j = 0; j < unused_blob_count; j++) {
+		if (unused_blobs[j]->id == blob_id)
+			return NULL;
+	}
+	struct vy_blob *blob;
+	rlist_foreach_entry(blob, &task->lsm->blobs, in_lsm) {
+		if (blob->id == blob_id)
+			return blob;
+	}
+	return NULL;
+}
+
 /**
  * Encode and write a single deferred DELETE statement to
  * _vinyl_deferred_delete system space. The rest will be
@@ -1077,6 +1281,12 @@ vy_task_write_run(struct vy_task *task, bool no_compression)
 				 task->page_size, task->bloom_fpr,
 				 no_compression) != 0)
 		goto fail;
+	if (task->new_blob != NULL) {
+		vy_run_writer_set_blob(&writer, task->new_blob,
+				       task->blob_threshold,
+				       task->relocated_blobs,
+				       task->relocated_blob_count);
+	}
 
 	if (wi->iface->start(wi) != 0)
 		goto fail_abort_writer;
@@ -1190,11 +1400,16 @@ vy_task_dump_complete(struct vy_task *task)
 		new_slices[i] = slice;
 	}
 
+	if (vy_run_bind_blobs(new_run, &lsm->blobs, task->new_blob) != 0)
+		goto fail_free_slices;
+
 	/*
 	 * Log change in metadata.
 	 */
 	vy_log_tx_begin();
 	vy_log_create_run(lsm->id, new_run->id, dump_lsn, new_run->dump_count);
+	if (vy_task_blob_is_used(task))
+		vy_log_create_blob(lsm->id, task->new_blob->id);
 	for (range = begin_range, i = 0; range != end_range;
 	     range = vy_range_tree_next(&lsm->range_tree, range), i++) {
 		assert(i < lsm->range_count);
@@ -1208,6 +1423,8 @@ vy_task_dump_complete(struct vy_task *task)
 		goto fail_free_slices;
 
 	/* Account the new run. */
+	if (vy_task_blob_is_used(task))
+		vy_lsm_add_blob(lsm, task->new_blob);
 	vy_lsm_add_run(lsm, new_run);
 	/* Drop the reference held by the task. */
 	vy_run_unref(new_run);
@@ -1381,6 +1598,9 @@ vy_task_dump_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 
 	new_run->dump_count = 1;
 	new_run->dump_lsn = dump_lsn;
+	task->new_run = new_run;
+	if (vy_task_prepare_blob(task) != 0)
+		goto err_wi;
 
 	/*
 	 * Note, since deferred DELETE are generated on tx commit
@@ -1394,6 +1614,10 @@ vy_task_dump_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 				   is_last_level, scheduler->read_views, NULL);
 	if (wi == NULL)
 		goto err_wi;
+	if (lsm->opts.ttl > 0) {
+		vy_write_iterator_set_expiration(wi, lsm->opts.ttl_field,
+						 vy_lsm_expire_deadline(lsm));
+	}
 	rlist_foreach_entry(mem, &lsm->sealed, in_sealed) {
 		if (mem->generation > scheduler->dump_generation)
 			continue;
@@ -1401,7 +1625,6 @@ vy_task_dump_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 			goto err_wi_sub;
 	}
 
-	task->new_run = new_run;
 	task->wi = wi;
 	task->bloom_fpr = lsm->opts.bloom_fpr;
 	task->page_size = lsm->opts.page_size;
@@ -1460,6 +1683,8 @@ vy_task_compaction_complete(struct vy_task *task)
 	struct vy_slice *last_slice = task->last_slice;
 	struct vy_slice *slice, *next_slice, *new_slice = NULL;
 	struct vy_run *run;
+	struct vy_blob **unused_blobs;
+	int unused_blob_count;
 
 	/*
 	 * The LSM tree could have been dropped while we were writing the new
@@ -1485,6 +1710,11 @@ vy_task_compaction_complete(struct vy_task *task)
 					 lsm->cmp_def);
 		if (new_slice == NULL)
 			return -1;
+		if (vy_run_bind_blobs(new_run, &lsm->blobs,
+				      task->new_blob) != 0) {
+			vy_slice_delete(new_slice);
+			return -1;
+		}
 	}
 
 	/*
@@ -1506,6 +1736,17 @@ vy_task_compaction_complete(struct vy_task *task)
 			break;
 	}
 
+	/*
+	 * Build the list of blob files that became unused
+	 * as a result of compaction.
+	 */
+	if (vy_task_find_unused_blobs(task, &unused_runs, &unused_blobs,
+				      &unused_blob_count) != 0) {
+		if (new_slice != NULL)
+			vy_slice_delete(new_slice);
+		return -1;
+	}
+
 	/*
 	 * Log change in metadata.
 	 */
@@ -1517,7 +1758,20 @@ vy_task_compaction_complete(struct vy_task *task)
 	}
 	rlist_foreach_entry(run, &unused_runs, in_unused)
 		vy_log_drop_run(run->id, VY_LOG_GC_LSN_CURRENT);
+	for (int i = 0; i < unused_blob_count; i++)
+		vy_log_drop_blob(unused_blobs[i]->id, VY_LOG_GC_LSN_CURRENT);
+	for (uint32_t i = 0; i < task->input_blobs.blob_count; i++) {
+		struct vy_blob *blob;
+		blob = vy_task_garbage_blob(task, i, unused_blobs,
+					    unused_blob_count);
+		if (blob != NULL) {
+			vy_log_modify_blob(blob->id, blob->garbage_size +
+					   vy_task_blob_garbage(task, i));
+		}
+	}
 	if (new_slice != NULL) {
+		if (vy_task_blob_is_used(task))
+			vy_log_create_blob(lsm->id, task->new_blob->id);
 		vy_log_create_run(lsm->id, new_run->id, new_run->dump_lsn,
 				  new_run->dump_count);
 		vy_log_insert_slice(range->id, new_run->id, new_slice->id,
@@ -1527,6 +1781,7 @@ vy_task_compaction_complete(struct vy_task *task)
 	if (vy_log_tx_commit() < 0) {
 		if (new_slice != NULL)
 			vy_slice_delete(new_slice);
+		free(unused_blobs);
 		return -1;
 	}
 
@@ -1546,12 +1801,37 @@ vy_task_compaction_complete(struct vy_task *task)
 			vy_run_remove_files(lsm->env->path, lsm->space_id,
 					    lsm->index_id, run->id);
 	}
+	/*
+	 * We don't know if a blob file is referenced by a checkpoint
+	 * so unused blob files are left for garbage collection unless
+	 * there are no checkpoints at all.
+	 */
+	for (int i = 0; i < unused_blob_count; i++) {
+		if (scheduler->run_env->initial_join)
+			vy_blob_remove_files(lsm->env->path, lsm->space_id,
+					     lsm->index_id,
+					     unused_blobs[i]->id);
+	}
+
+	/*
+	 * Account values referenced by the compacted slices, but
+	 * not by the new run, as garbage in blob files.
+	 */
+	for (uint32_t i = 0; i < task->input_blobs.blob_count; i++) {
+		struct vy_blob *blob;
+		blob = vy_task_garbage_blob(task, i, unused_blobs,
+					    unused_blob_count);
+		if (blob != NULL)
+			blob->garbage_size += vy_task_blob_garbage(task, i);
+	}
 
 	/*
 	 * Account the new run if it is not empty,
 	 * otherwise discard it.
 	 */
 	if (new_slice != NULL) {
+		if (vy_task_blob_is_used(task))
+			vy_lsm_add_blob(lsm, task->new_blob);
 		vy_lsm_add_run(lsm, new_run);
 		/* Drop the reference held by the task. */
 		vy_run_unref(new_run);
@@ -1595,6 +1875,9 @@ vy_task_compaction_complete(struct vy_task *task)
 	 */
 	rlist_foreach_entry(run, &unused_runs, in_unused)
 		vy_lsm_remove_run(lsm, run);
+	for (int i = 0; i < unused_blob_count; i++)
+		vy_lsm_remove_blob(lsm, unused_blobs[i]);
+	free(unused_blobs);
 	rlist_foreach_entry_safe(slice, &compacted_slices,
 				 in_range, next_slice) {
 		vy_slice_wait_pinned(slice);
@@ -1649,7 +1932,13 @@ vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	assert(range != NULL);
 	assert(range->compaction_priority > 1);
 
-	if (vy_lsm_split_range(lsm, range) ||
+	/*
+	 * If the range is too big, split it before compaction so
+	 * that the parts are compacted in parallel.
+	 */
+	if (vy_lsm_split_range_parallel(lsm, range,
+					scheduler->compaction_pool.size) ||
+	    vy_lsm_split_range(lsm, range) ||
 	    vy_lsm_coalesce_range(lsm, range)) {
 		vy_scheduler_update_lsm(scheduler, lsm);
 		return 0;
@@ -1663,6 +1952,9 @@ vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	struct vy_run *new_run = vy_run_prepare(scheduler->run_env, lsm);
 	if (new_run == NULL)
 		goto err_run;
+	task->new_run = new_run;
+	if (vy_task_prepare_blob(task) != 0)
+		goto err_wi;
 
 	struct vy_stmt_stream *wi;
 	bool is_last_level = (range->compaction_priority == range->slice_count);
@@ -1672,13 +1964,17 @@ vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 				   &task->deferred_delete_handler);
 	if (wi == NULL)
 		goto err_wi;
+	if (lsm->opts.ttl > 0) {
+		vy_write_iterator_set_expiration(wi, lsm->opts.ttl_field,
+						 vy_lsm_expire_deadline(lsm));
+	}
 
 	struct vy_slice *slice;
 	int32_t dump_count = 0;
 	int n = range->compaction_priority;
 	rlist_foreach_entry(slice, &range->slices, in_range) {
-		if (vy_write_iterator_new_slice(wi, slice,
-						lsm->disk_format) != 0)
+		if (vy_write_iterator_new_slice(wi, slice, lsm->disk_format,
+						&task->input_blobs) != 0)
 			goto err_wi_sub;
 		new_run->dump_lsn = MAX(new_run->dump_lsn,
 					slice->run->dump_lsn);
@@ -1693,6 +1989,8 @@ vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	}
 	assert(n == 0);
 	assert(new_run->dump_lsn >= 0);
+	if (vy_task_prepare_relocated_blobs(task) != 0)
+		goto err_wi_sub;
 	if (range->compaction_priority == range->slice_count)
 		dump_count -= slice->run->dump_count;
 	/*
@@ -1708,7 +2006,6 @@ vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	range->needs_compaction = false;
 
 	task->range = range;
-	task->new_run = new_run;
 	task->wi = wi;
 	task->bloom_fpr = lsm->opts.bloom_fpr;
 	task->page_size = lsm->opts.page_size;
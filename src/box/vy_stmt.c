@@ -77,6 +77,8 @@ vy_stmt_persistent_flags(struct tuple *stmt, bool is_primary)
 		 * only be generated by primary index compaction.
 		 */
 		mask &= ~VY_STMT_DEFERRED_DELETE;
+		/* Blob files are only used by primary indexes. */
+		mask &= ~VY_STMT_BLOB_REFS;
 	}
 	return vy_stmt_flags(stmt) & mask;
 }
@@ -141,7 +143,7 @@ vy_stmt_format_new(struct vy_stmt_env *env, struct key_def *const *keys,
 {
 	return tuple_format_new(&env->tuple_format_vtab, env, keys, key_count,
 				fields, field_count, exact_field_count, dict,
-				false, false);
+				false, false, false);
 }
 
 /**
@@ -136,11 +136,20 @@ enum {
 	 * compaction. It is never written to disk.
 	 */
 	VY_STMT_UPDATE			= 1 << 2,
+	/**
+	 * This flag is set for REPLACE and INSERT statements stored
+	 * in primary index runs that have some fields moved to blob
+	 * files (see struct vy_blob). Such statements are written by
+	 * the run writer and never leave the run iterator: it looks
+	 * up referenced values in blob files and returns statements
+	 * with original fields and this flag cleared.
+	 */
+	VY_STMT_BLOB_REFS		= 1 << 3,
 	/**
 	 * Bit mask of all statement flags.
 	 */
 	VY_STMT_FLAGS_ALL = (VY_STMT_DEFERRED_DELETE | VY_STMT_SKIP_READ |
-			     VY_STMT_UPDATE),
+			     VY_STMT_UPDATE | VY_STMT_BLOB_REFS),
 };
 
 /**
@@ -308,6 +317,26 @@ vy_stmt_is_empty_key(struct tuple *stmt)
 	return tuple_field_count(stmt) == 0;
 }
 
+/**
+ * Return true if the given REPLACE or INSERT statement has
+ * expired, i.e. the time stored in field @fieldno is less than
+ * or equal to @deadline. Statements of other types never expire
+ * neither do tuples that lack the field or store a non-numeric
+ * value in it.
+ */
+static inline bool
+vy_stmt_is_expired(struct tuple *stmt, uint32_t fieldno, double deadline)
+{
+	enum iproto_type type = vy_stmt_type(stmt);
+	if (type != IPROTO_REPLACE && type != IPROTO_INSERT)
+		return false;
+	const char *field = tuple_field(stmt, fieldno);
+	double time;
+	if (field == NULL || mp_read_double(&field, &time) != 0)
+		return false;
+	return time <= deadline;
+}
+
 /**
  * Duplicate the statememnt.
  *
@@ -501,6 +501,12 @@ vy_tx_write(struct vy_lsm *lsm, struct vy_mem *mem,
 		struct vy_entry deleted = vy_entry_none();
 		/* Invalidate cache element. */
 		vy_cache_on_write(&lsm->cache, entry, &deleted);
+		if (deleted.stmt != NULL &&
+		    vy_lsm_tuple_is_expired(lsm, deleted.stmt)) {
+			/* Let readers apply the UPSERT to no tuple. */
+			tuple_unref(deleted.stmt);
+			deleted = vy_entry_none();
+		}
 		if (deleted.stmt != NULL) {
 			struct vy_entry applied;
 			applied = vy_entry_apply_upsert(entry, deleted,
@@ -1072,7 +1078,11 @@ vy_tx_set_entry(struct vy_tx *tx, struct vy_lsm *lsm, struct vy_entry entry)
 		       old_type == IPROTO_DELETE);
 		(void) old_type;
 
-		applied = vy_entry_apply_upsert(entry, old->entry,
+		/* An UPSERT is applied to an expired tuple as to none. */
+		struct vy_entry base = old->entry;
+		if (vy_lsm_tuple_is_expired(lsm, base.stmt))
+			base = vy_entry_none();
+		applied = vy_entry_apply_upsert(entry, base,
 						lsm->cmp_def, true);
 		lsm->stat.upsert.applied++;
 		if (applied.stmt == NULL)
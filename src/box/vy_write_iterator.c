@@ -34,6 +34,8 @@
 #include "vy_upsert.h"
 #include "fiber.h"
 
+#include <math.h>
+
 #define HEAP_FORWARD_DECLARATION
 #include "salad/heap.h"
 
@@ -181,6 +183,14 @@ struct vy_write_iterator {
 	 * key and its tuple format is different.
 	 */
 	bool is_primary;
+	/**
+	 * Number of the field storing statement time and the time
+	 * up to which statements are considered expired, or
+	 * -INFINITY if statements never expire.
+	 * @sa vy_write_iterator_set_expiration().
+	 */
+	uint32_t expire_fieldno;
+	double expire_deadline;
 	/** Deferred DELETE handler. */
 	struct vy_deferred_delete_handler *deferred_delete_handler;
 	/**
@@ -388,12 +398,23 @@ vy_write_iterator_new(struct key_def *cmp_def, bool is_primary,
 	stream->cmp_def = cmp_def;
 	stream->is_primary = is_primary;
 	stream->is_last_level = is_last_level;
+	stream->expire_deadline = -INFINITY;
 	stream->deferred_delete_handler = handler;
 	stream->deferred_delete = vy_entry_none();
 	stream->last = vy_entry_none();
 	return &stream->base;
 }
 
+void
+vy_write_iterator_set_expiration(struct vy_stmt_stream *vstream,
+				 uint32_t fieldno, double deadline)
+{
+	struct vy_write_iterator *stream = (struct vy_write_iterator *)vstream;
+	assert(stream->is_primary);
+	stream->expire_fieldno = fieldno;
+	stream->expire_deadline = deadline;
+}
+
 /**
  * Start the search. Must be called after *new* methods and
  * before *next* method.
@@ -491,14 +512,15 @@ vy_write_iterator_new_mem(struct vy_stmt_stream *vstream, struct vy_mem *mem)
 NODISCARD int
 vy_write_iterator_new_slice(struct vy_stmt_stream *vstream,
 			    struct vy_slice *slice,
-			    struct tuple_format *disk_format)
+			    struct tuple_format *disk_format,
+			    struct vy_blob_acct *blob_acct)
 {
 	struct vy_write_iterator *stream = (struct vy_write_iterator *)vstream;
 	struct vy_write_src *src = vy_write_iterator_new_src(stream);
 	if (src == NULL)
 		return -1;
 	vy_slice_stream_open(&src->slice_stream, slice, stream->cmp_def,
-			     disk_format);
+			     disk_format, blob_acct);
 	return 0;
 }
 
@@ -521,6 +543,22 @@ vy_write_iterator_merge_step(struct vy_write_iterator *stream)
 	return 0;
 }
 
+/**
+ * Return the statement an UPSERT should be applied to given
+ * the preceding statement. Readers apply an UPSERT to an
+ * expired tuple as if there were no tuple so should we.
+ */
+static inline struct vy_entry
+vy_write_iterator_upsert_base(struct vy_write_iterator *stream,
+			      struct vy_entry prev)
+{
+	if (prev.stmt != NULL && stream->expire_deadline > -INFINITY &&
+	    vy_stmt_is_expired(prev.stmt, stream->expire_fieldno,
+			       stream->expire_deadline))
+		return vy_entry_none();
+	return prev;
+}
+
 /**
  * Try to get VLSN of the read view with the specified number in
  * the vy_write_iterator.read_views array.
@@ -708,6 +746,7 @@ vy_write_iterator_build_history(struct vy_write_iterator *stream,
 	int current_rv_i = 0;
 	int64_t current_rv_lsn = vy_write_iterator_get_vlsn(stream, 0);
 	int64_t merge_until_lsn = vy_write_iterator_get_vlsn(stream, 1);
+	bool is_newest = true;
 
 	while (true) {
 		*is_first_insert = vy_stmt_type(src->entry.stmt) == IPROTO_INSERT;
@@ -772,6 +811,20 @@ vy_write_iterator_build_history(struct vy_write_iterator *stream,
 			goto next_lsn;
 		}
 
+		/*
+		 * Optimization 6: skip an expired key on the last
+		 * level.
+		 */
+		if (is_newest && stream->is_last_level &&
+		    merge_until_lsn < 0 &&
+		    stream->expire_deadline > -INFINITY &&
+		    vy_stmt_is_expired(src->entry.stmt,
+				       stream->expire_fieldno,
+				       stream->expire_deadline)) {
+			current_rv_lsn = -1; /* Force skip */
+			goto next_lsn;
+		}
+
 		rc = vy_write_iterator_push_rv(stream, src->entry,
 					       current_rv_i);
 		if (rc != 0)
@@ -792,6 +845,7 @@ vy_write_iterator_build_history(struct vy_write_iterator *stream,
 							   current_rv_i + 1);
 		}
 next_lsn:
+		is_newest = false;
 		rc = vy_write_iterator_merge_step(stream);
 		if (rc != 0)
 			break;
@@ -876,8 +930,9 @@ vy_read_view_merge(struct vy_write_iterator *stream, struct vy_entry prev,
 		assert(!stream->is_last_level || prev.stmt == NULL ||
 		       vy_stmt_type(prev.stmt) != IPROTO_UPSERT);
 		struct vy_entry applied;
-		applied = vy_entry_apply_upsert(h->entry, prev,
-						stream->cmp_def, false);
+		applied = vy_entry_apply_upsert(h->entry,
+				vy_write_iterator_upsert_base(stream, prev),
+				stream->cmp_def, false);
 		if (applied.stmt == NULL)
 			return -1;
 		vy_stmt_unref_if_possible(h->entry.stmt);
@@ -891,8 +946,10 @@ vy_read_view_merge(struct vy_write_iterator *stream, struct vy_entry prev,
 		       vy_stmt_type(h->entry.stmt) == IPROTO_UPSERT);
 		assert(result->entry.stmt != NULL);
 		struct vy_entry applied;
-		applied = vy_entry_apply_upsert(h->entry, result->entry,
-						stream->cmp_def, false);
+		applied = vy_entry_apply_upsert(h->entry,
+				vy_write_iterator_upsert_base(stream,
+							      result->entry),
+				stream->cmp_def, false);
 		if (applied.stmt == NULL)
 			return -1;
 		vy_stmt_unref_if_possible(result->entry.stmt);
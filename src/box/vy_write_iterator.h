@@ -190,6 +190,22 @@
  * also turn the first INSERT in the resulting key's history to a
  * REPLACE in case the oldest statement among all sources is not
  * an INSERT.
+ * ---------------------------------------------------------------
+ * Optimization #6: when merging the last level of the LSM tree,
+ * skip a key if its newest statement is an expired REPLACE or
+ * INSERT (see index_opts::ttl) visible to all read views. Such
+ * a key is hidden from readers, just like a deleted one, so we
+ * don't need to store it on disk. An UPSERT is applied to an
+ * expired tuple as if there were no tuple, both by readers and
+ * by the write iterator.
+ *                         --------
+ *                         SAME KEY
+ *                         --------
+ * 0                                                  INT64_MAX
+ * |                                                      |
+ * | LSN1  LSN2   ...   LSNi  ...   LSN_N (expired REPLACE) |
+ * \______________________________________________________/
+ *                          skip
  */
 
 struct vy_write_iterator;
@@ -199,6 +215,7 @@ struct tuple_format;
 struct tuple;
 struct vy_mem;
 struct vy_slice;
+struct vy_blob_acct;
 
 /**
  * Callback invoked by the write iterator for tuples that were
@@ -252,6 +269,16 @@ vy_write_iterator_new(struct key_def *cmp_def, bool is_primary,
 		      bool is_last_level, struct rlist *read_views,
 		      struct vy_deferred_delete_handler *handler);
 
+/**
+ * Make the write iterator drop keys expired by @deadline on the
+ * last level (see optimization #6). @fieldno is the number of
+ * the field storing statement time. Only relevant to primary
+ * index iterators.
+ */
+void
+vy_write_iterator_set_expiration(struct vy_stmt_stream *stream,
+				 uint32_t fieldno, double deadline);
+
 /**
  * Add a mem as a source to the iterator.
  * @return 0 on success, -1 on error (diag is set).
@@ -261,12 +288,15 @@ vy_write_iterator_new_mem(struct vy_stmt_stream *stream, struct vy_mem *mem);
 
 /**
  * Add a run slice as a source to the iterator.
+ * If @blob_acct is not NULL, values referenced in blob files by
+ * statements read from the slice are accounted to it.
  * @return 0 on success, -1 on error (diag is set).
  */
 NODISCARD int
 vy_write_iterator_new_slice(struct vy_stmt_stream *stream,
 			    struct vy_slice *slice,
-			    struct tuple_format *disk_format);
+			    struct tuple_format *disk_format,
+			    struct vy_blob_acct *blob_acct);
 
 #endif /* INCLUDES_TARANTOOL_BOX_VY_WRITE_STREAM_H */
 
@@ -38,6 +38,7 @@
 
 #include "xlog.h"
 #include "xrow.h"
+#include "xrow_ring.h"
 #include "vy_log.h"
 #include "cbus.h"
 #include "coio_task.h"
@@ -170,6 +171,16 @@ struct wal_writer
 	 * Used for replication relays.
 	 */
 	struct rlist watchers;
+	/**
+	 * Size of the ring of recently written rows or 0 if
+	 * the ring is disabled, box.cfg.wal_ring_size.
+	 */
+	size_t ring_size;
+	/**
+	 * Rows recently written to the WAL. Relays read rows
+	 * from it instead of WAL files unless they lag behind.
+	 */
+	struct xrow_ring ring;
 };
 
 struct wal_msg {
@@ -210,6 +221,13 @@ wal_dir(void)
 	return wal_writer_singleton.wal_dir.dirname;
 }
 
+struct xrow_ring *
+wal_ring(void)
+{
+	struct wal_writer *writer = &wal_writer_singleton;
+	return writer->ring_size > 0 ? &writer->ring : NULL;
+}
+
 static void
 wal_write_to_disk(struct cmsg *msg);
 
@@ -414,7 +432,7 @@ tx_notify_checkpoint(struct cmsg *msg)
 static void
 wal_writer_create(struct wal_writer *writer, enum wal_mode wal_mode,
 		  const char *wal_dirname, int64_t wal_max_size,
-		  const struct tt_uuid *instance_uuid,
+		  size_t ring_size, const struct tt_uuid *instance_uuid,
 		  wal_on_garbage_collection_f on_garbage_collection,
 		  wal_on_checkpoint_threshold_f on_checkpoint_threshold)
 {
@@ -444,6 +462,10 @@ wal_writer_create(struct wal_writer *writer, enum wal_mode wal_mode,
 	vclock_create(&writer->vclock);
 	vclock_create(&writer->checkpoint_vclock);
 	rlist_create(&writer->watchers);
+	/* Nobody reads rows written to /dev/null. */
+	writer->ring_size = wal_mode == WAL_NONE ? 0 : ring_size;
+	if (writer->ring_size > 0)
+		xrow_ring_create(&writer->ring, writer->ring_size);
 
 	writer->on_garbage_collection = on_garbage_collection;
 	writer->on_checkpoint_threshold = on_checkpoint_threshold;
@@ -457,6 +479,8 @@ static void
 wal_writer_destroy(struct wal_writer *writer)
 {
 	xdir_destroy(&writer->wal_dir);
+	if (writer->ring_size > 0)
+		xrow_ring_destroy(&writer->ring);
 }
 
 /** WAL writer thread routine. */
@@ -534,14 +558,15 @@ wal_open(struct wal_writer *writer)
 
 int
 wal_init(enum wal_mode wal_mode, const char *wal_dirname,
-	 int64_t wal_max_size, const struct tt_uuid *instance_uuid,
+	 int64_t wal_max_size, size_t ring_size,
+	 const struct tt_uuid *instance_uuid,
 	 wal_on_garbage_collection_f on_garbage_collection,
 	 wal_on_checkpoint_threshold_f on_checkpoint_threshold)
 {
 	/* Initialize the state. */
 	struct wal_writer *writer = &wal_writer_singleton;
 	wal_writer_create(writer, wal_mode, wal_dirname, wal_max_size,
-			  instance_uuid, on_garbage_collection,
+			  ring_size, instance_uuid, on_garbage_collection,
 			  on_checkpoint_threshold);
 
 	/* Start WAL thread. */
@@ -561,6 +586,8 @@ wal_enable(void)
 
 	/* Initialize the writer vclock from the recovery state. */
 	vclock_copy(&writer->vclock, &replicaset.vclock);
+	if (writer->ring_size > 0)
+		xrow_ring_reset(&writer->ring, &writer->vclock);
 
 	/*
 	 * Scan the WAL directory to build an index of all
@@ -1031,6 +1058,25 @@ wal_assign_lsn(struct vclock *vclock_diff, struct vclock *base,
 		(*row)->tsn = tsn;
 }
 
+/**
+ * Append rows of committed journal entries to the ring of
+ * recently written rows.
+ */
+static void
+wal_append_ring(struct wal_writer *writer, struct stailq *commit)
+{
+	struct journal_entry *entry;
+	stailq_foreach_entry(entry, commit, fifo) {
+		for (int i = 0; i < entry->n_rows; i++) {
+			if (xrow_ring_append(&writer->ring,
+					     entry->rows[i]) != 0) {
+				diag_log();
+				diag_clear(diag_get());
+			}
+		}
+	}
+}
+
 static void
 wal_write_to_disk(struct cmsg *msg)
 {
@@ -1186,6 +1232,12 @@ done:
 	} else {
 		assert(err_code == JOURNAL_ENTRY_ERR_UNKNOWN);
 	}
+	/*
+	 * Publish the written rows before notifying relays so
+	 * that they don't have to read them from the WAL file.
+	 */
+	if (writer->ring_size > 0)
+		wal_append_ring(writer, &wal_msg->commit);
 	fiber_gc();
 	wal_notify_watchers(writer, WAL_EVENT_WRITE);
 	ERROR_INJECT_SLEEP(ERRINJ_RELAY_FASTER_THAN_TX);
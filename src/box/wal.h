@@ -101,7 +101,8 @@ typedef void (*wal_on_checkpoint_threshold_f)(void);
  */
 int
 wal_init(enum wal_mode wal_mode, const char *wal_dirname,
-	 int64_t wal_max_size, const struct tt_uuid *instance_uuid,
+	 int64_t wal_max_size, size_t ring_size,
+	 const struct tt_uuid *instance_uuid,
 	 wal_on_garbage_collection_f on_garbage_collection,
 	 wal_on_checkpoint_threshold_f on_checkpoint_threshold);
 
@@ -124,6 +125,16 @@ wal_free(void);
 const char *
 wal_dir(void);
 
+struct xrow_ring;
+
+/**
+ * Return the ring of rows recently written to the WAL or NULL
+ * if it's disabled. The ring is filled by the WAL thread and
+ * may be read from any thread.
+ */
+struct xrow_ring *
+wal_ring(void);
+
 struct wal_watcher_msg {
 	struct cmsg cmsg;
 	struct wal_watcher *watcher;
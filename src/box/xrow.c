@@ -911,6 +911,44 @@ done:
 	return 0;
 }
 
+int
+xrow_decode_space_id(const struct xrow_header *row, uint32_t *space_id)
+{
+	if (row->bodycnt == 0)
+		goto missing;
+	/*
+	 * Rows sent on initial join may store the tuple in a separate
+	 * iovec, but the space id is always in the first one.
+	 */
+	assert(row->bodycnt >= 1);
+	const char *data = (const char *)row->body[0].iov_base;
+	if (mp_typeof(*data) != MP_MAP) {
+error:
+		xrow_on_decode_err(row, ER_INVALID_MSGPACK, "packet body");
+		return -1;
+	}
+	uint32_t size = mp_decode_map(&data);
+	for (uint32_t i = 0; i < size; i++) {
+		if (mp_typeof(*data) != MP_UINT) {
+			mp_next(&data);
+			mp_next(&data);
+			continue;
+		}
+		if (mp_decode_uint(&data) != IPROTO_SPACE_ID) {
+			mp_next(&data);
+			continue;
+		}
+		if (mp_typeof(*data) != MP_UINT)
+			goto error;
+		*space_id = mp_decode_uint(&data);
+		return 0;
+	}
+missing:
+	xrow_on_decode_err(row, ER_MISSING_REQUEST_FIELD,
+			   iproto_key_name(IPROTO_SPACE_ID));
+	return -1;
+}
+
 static int
 request_snprint(char *buf, int size, const struct request *request)
 {
@@ -1710,11 +1748,13 @@ xrow_encode_subscribe(struct xrow_header *row,
 		      const struct tt_uuid *replicaset_uuid,
 		      const struct tt_uuid *instance_uuid,
 		      const struct vclock *vclock, bool anon,
-		      uint32_t id_filter)
+		      uint32_t id_filter, const uint32_t *space_filter,
+		      uint32_t space_filter_size)
 {
 	memset(row, 0, sizeof(*row));
 	size_t size = XROW_BODY_LEN_MAX +
-		      mp_sizeof_vclock_ignore0(vclock);
+		      mp_sizeof_vclock_ignore0(vclock) +
+		      space_filter_size * mp_sizeof_uint(UINT32_MAX);
 	char *buf = (char *) region_alloc(&fiber()->gc, size);
 	if (buf == NULL) {
 		diag_set(OutOfMemory, size, "region_alloc", "buf");
@@ -1722,7 +1762,8 @@ xrow_encode_subscribe(struct xrow_header *row,
 	}
 	char *data = buf;
 	int filter_size = bit_count_u32(id_filter);
-	data = mp_encode_map(data, filter_size != 0 ? 6 : 5);
+	data = mp_encode_map(data, 5 + (filter_size != 0) +
+				   (space_filter_size != 0));
 	data = mp_encode_uint(data, IPROTO_CLUSTER_UUID);
 	data = xrow_encode_uuid(data, replicaset_uuid);
 	data = mp_encode_uint(data, IPROTO_INSTANCE_UUID);
@@ -1744,6 +1785,12 @@ xrow_encode_subscribe(struct xrow_header *row,
 			data = mp_encode_uint(data, id);
 		}
 	}
+	if (space_filter_size != 0) {
+		data = mp_encode_uint(data, IPROTO_SPACE_FILTER);
+		data = mp_encode_array(data, space_filter_size);
+		for (uint32_t i = 0; i < space_filter_size; i++)
+			data = mp_encode_uint(data, space_filter[i]);
+	}
 	assert(data <= buf + size);
 	row->body[0].iov_base = buf;
 	row->body[0].iov_len = (data - buf);
@@ -1756,7 +1803,10 @@ int
 xrow_decode_subscribe(const struct xrow_header *row,
 		      struct tt_uuid *replicaset_uuid,
 		      struct tt_uuid *instance_uuid, struct vclock *vclock,
-		      uint32_t *version_id, bool *anon, uint32_t *id_filter)
+		      uint32_t *version_id, bool *anon, uint32_t *id_filter,
+		      uint32_t **space_filter, uint32_t *space_filter_size,
+		      bool *checkpoint_join, uint32_t *join_streams,
+		      uint32_t *join_id, double *echo_tm)
 {
 	if (row->bodycnt == 0) {
 		diag_set(ClientError, ER_INVALID_MSGPACK, "request body");
@@ -1781,6 +1831,18 @@ xrow_decode_subscribe(const struct xrow_header *row,
 		*anon = false;
 	if (id_filter != NULL)
 		*id_filter = 0;
+	if (space_filter != NULL) {
+		*space_filter = NULL;
+		*space_filter_size = 0;
+	}
+	if (checkpoint_join != NULL)
+		*checkpoint_join = false;
+	if (join_streams != NULL)
+		*join_streams = 1;
+	if (join_id != NULL)
+		*join_id = 0;
+	if (echo_tm != NULL)
+		*echo_tm = 0;
 
 	uint32_t map_size = mp_decode_map(&d);
 	for (uint32_t i = 0; i < map_size; i++) {
@@ -1856,6 +1918,78 @@ id_filter_decode_err:		xrow_on_decode_err(row, ER_INVALID_MSGPACK,
 				*id_filter |= 1 << val;
 			}
 			break;
+		case IPROTO_SPACE_FILTER: {
+			if (space_filter == NULL)
+				goto skip;
+			if (mp_typeof(*d) != MP_ARRAY) {
+space_filter_decode_err:	xrow_on_decode_err(row, ER_INVALID_MSGPACK,
+						   "invalid SPACE_FILTER");
+				return -1;
+			}
+			uint32_t len = mp_decode_array(&d);
+			size_t size;
+			uint32_t *ids = region_alloc_array(&fiber()->gc,
+							   uint32_t, len,
+							   &size);
+			if (ids == NULL) {
+				diag_set(OutOfMemory, size,
+					 "region_alloc_array", "ids");
+				return -1;
+			}
+			for (uint32_t i = 0; i < len; ++i) {
+				if (mp_typeof(*d) != MP_UINT)
+					goto space_filter_decode_err;
+				uint64_t val = mp_decode_uint(&d);
+				if (val > UINT32_MAX)
+					goto space_filter_decode_err;
+				ids[i] = val;
+			}
+			*space_filter = ids;
+			*space_filter_size = len;
+			break;
+		}
+		case IPROTO_CHECKPOINT_JOIN:
+			if (checkpoint_join == NULL)
+				goto skip;
+			if (mp_typeof(*d) != MP_BOOL) {
+				xrow_on_decode_err(row, ER_INVALID_MSGPACK,
+						   "invalid CHECKPOINT_JOIN");
+				return -1;
+			}
+			*checkpoint_join = mp_decode_bool(&d);
+			break;
+		case IPROTO_JOIN_STREAMS:
+			if (join_streams == NULL)
+				goto skip;
+			if (mp_typeof(*d) != MP_UINT) {
+join_streams_decode_err:	xrow_on_decode_err(row, ER_INVALID_MSGPACK,
+						   "invalid JOIN_STREAMS");
+				return -1;
+			}
+			*join_streams = mp_decode_uint(&d);
+			if (*join_streams == 0)
+				goto join_streams_decode_err;
+			break;
+		case IPROTO_JOIN_ID:
+			if (join_id == NULL)
+				goto skip;
+			if (mp_typeof(*d) != MP_UINT) {
+				xrow_on_decode_err(row, ER_INVALID_MSGPACK,
+						   "invalid JOIN_ID");
+				return -1;
+			}
+			*join_id = mp_decode_uint(&d);
+			break;
+		case IPROTO_ECHO_TM:
+			if (echo_tm == NULL)
+				goto skip;
+			if (mp_typeof(*d) != MP_DOUBLE) {
+				xrow_on_decode_err(row, ER_INVALID_MSGPACK,
+						   "invalid ECHO_TM");
+				return -1;
+			}
+			*echo_tm = mp_decode_double(&d);
+			break;
 		default: skip:
 			mp_next(&d); /* value */
 		}
@@ -1864,7 +1998,8 @@ id_filter_decode_err:		xrow_on_decode_err(row, ER_INVALID_MSGPACK,
 }
 
 int
-xrow_encode_join(struct xrow_header *row, const struct tt_uuid *instance_uuid)
+xrow_encode_join(struct xrow_header *row, const struct tt_uuid *instance_uuid,
+		 bool checkpoint_join, uint32_t join_streams)
 {
 	memset(row, 0, sizeof(*row));
 
@@ -1875,12 +2010,51 @@ xrow_encode_join(struct xrow_header *row, const struct tt_uuid *instance_uuid)
 		return -1;
 	}
 	char *data = buf;
-	data = mp_encode_map(data, 2);
+	data = mp_encode_map(data, 2 + (checkpoint_join ? 1 : 0) +
+				   (join_streams > 1 ? 1 : 0));
 	data = mp_encode_uint(data, IPROTO_INSTANCE_UUID);
 	/* Greet the remote replica with our replica UUID */
 	data = xrow_encode_uuid(data, instance_uuid);
 	data = mp_encode_uint(data, IPROTO_SERVER_VERSION);
 	data = mp_encode_uint(data, tarantool_version_id());
+	if (checkpoint_join) {
+		data = mp_encode_uint(data, IPROTO_CHECKPOINT_JOIN);
+		data = mp_encode_bool(data, true);
+	}
+	if (join_streams > 1) {
+		data = mp_encode_uint(data, IPROTO_JOIN_STREAMS);
+		data = mp_encode_uint(data, join_streams);
+	}
+	assert(data <= buf + size);
+
+	row->body[0].iov_base = buf;
+	row->body[0].iov_len = (data - buf);
+	row->bodycnt = 1;
+	row->type = IPROTO_JOIN;
+	return 0;
+}
+
+int
+xrow_encode_join_stream(struct xrow_header *row,
+			const struct tt_uuid *instance_uuid,
+			uint32_t join_id)
+{
+	memset(row, 0, sizeof(*row));
+
+	size_t size = 64;
+	char *buf = (char *)region_alloc(&fiber()->gc, size);
+	if (buf == NULL) {
+		diag_set(OutOfMemory, size, "region_alloc", "buf");
+		return -1;
+	}
+	char *data = buf;
+	data = mp_encode_map(data, 3);
+	data = mp_encode_uint(data, IPROTO_INSTANCE_UUID);
+	data = xrow_encode_uuid(data, instance_uuid);
+	data = mp_encode_uint(data, IPROTO_SERVER_VERSION);
+	data = mp_encode_uint(data, tarantool_version_id());
+	data = mp_encode_uint(data, IPROTO_JOIN_ID);
+	data = mp_encode_uint(data, join_id);
 	assert(data <= buf + size);
 
 	row->body[0].iov_base = buf;
@@ -1892,20 +2066,33 @@ xrow_encode_join(struct xrow_header *row, const struct tt_uuid *instance_uuid)
 
 int
 xrow_encode_vclock(struct xrow_header *row, const struct vclock *vclock)
+{
+	return xrow_encode_ack(row, vclock, 0);
+}
+
+int
+xrow_encode_ack(struct xrow_header *row, const struct vclock *vclock,
+		double echo_tm)
 {
 	memset(row, 0, sizeof(*row));
 
 	/* Add vclock to response body */
-	size_t size = 8 + mp_sizeof_vclock_ignore0(vclock);
+	size_t size = 8 + mp_sizeof_vclock_ignore0(vclock) +
+		      mp_sizeof_uint(IPROTO_ECHO_TM) +
+		      mp_sizeof_double(echo_tm);
 	char *buf = (char *) region_alloc(&fiber()->gc, size);
 	if (buf == NULL) {
 		diag_set(OutOfMemory, size, "region_alloc", "buf");
 		return -1;
 	}
 	char *data = buf;
-	data = mp_encode_map(data, 1);
+	data = mp_encode_map(data, echo_tm != 0 ? 2 : 1);
 	data = mp_encode_uint(data, IPROTO_VCLOCK);
 	data = mp_encode_vclock_ignore0(data, vclock);
+	if (echo_tm != 0) {
+		data = mp_encode_uint(data, IPROTO_ECHO_TM);
+		data = mp_encode_double(data, echo_tm);
+	}
 	assert(data <= buf + size);
 	row->body[0].iov_base = buf;
 	row->body[0].iov_len = (data - buf);
@@ -1960,6 +2147,103 @@ xrow_encode_type(struct xrow_header *row, uint16_t type)
 	row->type = type;
 }
 
+int
+xrow_encode_join_snapshot(struct xrow_header *row, uint64_t file_size,
+			  uint32_t join_streams, uint32_t join_id)
+{
+	memset(row, 0, sizeof(*row));
+	row->type = IPROTO_JOIN_SNAPSHOT;
+	uint32_t map_size = (file_size > 0 ? 1 : 0) +
+			    (join_streams > 1 ? 2 : 0);
+	/* Don't confuse old replicas with a body they don't expect. */
+	if (map_size == 0)
+		return 0;
+	size_t size = mp_sizeof_map(map_size) +
+		      mp_sizeof_uint(IPROTO_FILE_SIZE) +
+		      mp_sizeof_uint(file_size) +
+		      mp_sizeof_uint(IPROTO_JOIN_STREAMS) +
+		      mp_sizeof_uint(join_streams) +
+		      mp_sizeof_uint(IPROTO_JOIN_ID) +
+		      mp_sizeof_uint(join_id);
+	char *buf = (char *)region_alloc(&fiber()->gc, size);
+	if (buf == NULL) {
+		diag_set(OutOfMemory, size, "region_alloc", "buf");
+		return -1;
+	}
+	char *data = buf;
+	data = mp_encode_map(data, map_size);
+	if (file_size > 0) {
+		data = mp_encode_uint(data, IPROTO_FILE_SIZE);
+		data = mp_encode_uint(data, file_size);
+	}
+	if (join_streams > 1) {
+		data = mp_encode_uint(data, IPROTO_JOIN_STREAMS);
+		data = mp_encode_uint(data, join_streams);
+		data = mp_encode_uint(data, IPROTO_JOIN_ID);
+		data = mp_encode_uint(data, join_id);
+	}
+	assert(data <= buf + size);
+	row->body[0].iov_base = buf;
+	row->body[0].iov_len = data - buf;
+	row->bodycnt = 1;
+	return 0;
+}
+
+int
+xrow_decode_join_snapshot(const struct xrow_header *row, uint64_t *file_size,
+			  uint32_t *join_streams, uint32_t *join_id)
+{
+	assert(row->type == IPROTO_JOIN_SNAPSHOT);
+	*file_size = 0;
+	*join_streams = 1;
+	*join_id = 0;
+	if (row->bodycnt == 0)
+		return 0;
+	assert(row->bodycnt == 1);
+	const char *d = (const char *)row->body[0].iov_base;
+	if (mp_typeof(*d) != MP_MAP) {
+		xrow_on_decode_err(row, ER_INVALID_MSGPACK, "request body");
+		return -1;
+	}
+	uint32_t map_size = mp_decode_map(&d);
+	for (uint32_t i = 0; i < map_size; i++) {
+		if (mp_typeof(*d) != MP_UINT) {
+			mp_next(&d); /* key */
+			mp_next(&d); /* value */
+			continue;
+		}
+		switch (mp_decode_uint(&d)) {
+		case IPROTO_FILE_SIZE:
+			if (mp_typeof(*d) != MP_UINT) {
+				xrow_on_decode_err(row, ER_INVALID_MSGPACK,
+						   "invalid FILE_SIZE");
+				return -1;
+			}
+			*file_size = mp_decode_uint(&d);
+			break;
+		case IPROTO_JOIN_STREAMS:
+			if (mp_typeof(*d) != MP_UINT) {
+				xrow_on_decode_err(row, ER_INVALID_MSGPACK,
+						   "invalid JOIN_STREAMS");
+				return -1;
+			}
+			*join_streams = MAX(mp_decode_uint(&d), 1);
+			break;
+		case IPROTO_JOIN_ID:
+			if (mp_typeof(*d) != MP_UINT) {
+				xrow_on_decode_err(row, ER_INVALID_MSGPACK,
+						   "invalid JOIN_ID");
+				return -1;
+			}
+			*join_id = mp_decode_uint(&d);
+			break;
+		default:
+			mp_next(&d); /* value */
+		}
+	}
+	return 0;
+}
+
 void
 greeting_encode(char *greetingbuf, uint32_t version_id,
 		const struct tt_uuid *uuid, const char *salt, uint32_t salt_len)
@@ -216,6 +216,17 @@ int
 xrow_decode_dml(struct xrow_header *xrow, struct request *request,
 		uint64_t key_map);
 
+/**
+ * Decode only the space id of a DML request, skipping other keys.
+ * Cheaper than xrow_decode_dml() when nothing else is needed.
+ * @param row request header.
+ * @param[out] space_id space id.
+ * @retval 0 on success
+ * @retval -1 on error
+ */
+int
+xrow_decode_space_id(const struct xrow_header *row, uint32_t *space_id);
+
 /**
  * Encode the request fields to iovec using region_alloc().
  * @param request request to encode
@@ -476,6 +487,9 @@ xrow_encode_register(struct xrow_header *row,
  * @param anon Whether it is an anonymous subscribe request or not.
  * @param id_filter A List of replica ids to skip rows from
  *		    when feeding a replica.
+ * @param space_filter A list of ids of spaces to feed a replica
+ *		       with. Not sent if empty.
+ * @param space_filter_size Number of ids in @a space_filter.
  *
  * @retval  0 Success.
  * @retval -1 Memory error.
@@ -485,7 +499,8 @@ xrow_encode_subscribe(struct xrow_header *row,
 		      const struct tt_uuid *replicaset_uuid,
 		      const struct tt_uuid *instance_uuid,
 		      const struct vclock *vclock, bool anon,
-		      uint32_t id_filter);
+		      uint32_t id_filter, const uint32_t *space_filter,
+		      uint32_t space_filter_size);
 
 /**
  * Decode SUBSCRIBE command.
@@ -497,6 +512,19 @@ xrow_encode_subscribe(struct xrow_header *row,
  * @param[out] anon Whether it is an anonymous subscribe.
  * @param[out] id_filter A list of ids to skip rows from when
  *			 feeding a replica.
+ * @param[out] space_filter A list of ids of spaces to feed
+ *			    a replica with, allocated on the fiber
+ *			    region. NULL if the replica needs all
+ *			    spaces.
+ * @param[out] space_filter_size Number of ids in @a space_filter.
+ * @param[out] checkpoint_join Whether the replica can join from
+ *			       a checkpoint file.
+ * @param[out] join_streams Number of streams the replica can
+ *			    receive the initial data over.
+ * @param[out] join_id Id of the initial join an additional
+ *		       stream is opened for, 0 for the main one.
+ * @param[out] echo_tm Timestamp echoed by a replica in an ack,
+ *		       0 if there is none.
  *
  * @retval  0 Success.
  * @retval -1 Memory or format error.
@@ -505,34 +533,63 @@ int
 xrow_decode_subscribe(const struct xrow_header *row,
 		      struct tt_uuid *replicaset_uuid,
 		      struct tt_uuid *instance_uuid, struct vclock *vclock,
-		      uint32_t *version_id, bool *anon, uint32_t *id_filter);
+		      uint32_t *version_id, bool *anon, uint32_t *id_filter,
+		      uint32_t **space_filter, uint32_t *space_filter_size,
+		      bool *checkpoint_join, uint32_t *join_streams,
+		      uint32_t *join_id, double *echo_tm);
 
 /**
  * Encode JOIN command.
  * @param[out] row Row to encode into.
  * @param instance_uuid.
+ * @param checkpoint_join Whether the replica can join from
+ *			  a checkpoint file.
+ * @param join_streams Number of streams the replica can receive
+ *		       the initial data over.
  *
  * @retval  0 Success.
  * @retval -1 Memory error.
  */
 int
-xrow_encode_join(struct xrow_header *row, const struct tt_uuid *instance_uuid);
+xrow_encode_join(struct xrow_header *row, const struct tt_uuid *instance_uuid,
+		 bool checkpoint_join, uint32_t join_streams);
+
+/**
+ * Encode JOIN command opening an additional stream of an initial
+ * join that is already in progress.
+ * @param[out] row Row to encode into.
+ * @param instance_uuid.
+ * @param join_id Id of the initial join, received from the
+ *		  master in JOIN_SNAPSHOT.
+ *
+ * @retval  0 Success.
+ * @retval -1 Memory error.
+ */
+int
+xrow_encode_join_stream(struct xrow_header *row,
+			const struct tt_uuid *instance_uuid,
+			uint32_t join_id);
 
 /**
  * Decode JOIN command.
  * @param row Row to decode.
  * @param[out] instance_uuid.
  * @param[out] version_id.
+ * @param[out] checkpoint_join.
+ * @param[out] join_streams.
+ * @param[out] join_id.
  *
  * @retval  0 Success.
  * @retval -1 Memory or format error.
  */
 static inline int
 xrow_decode_join(const struct xrow_header *row, struct tt_uuid *instance_uuid,
-		 uint32_t *version_id)
+		 uint32_t *version_id, bool *checkpoint_join,
+		 uint32_t *join_streams, uint32_t *join_id)
 {
 	return xrow_decode_subscribe(row, NULL, instance_uuid, NULL, version_id,
-				     NULL, NULL);
+				     NULL, NULL, NULL, NULL, checkpoint_join,
+				     join_streams, join_id, NULL);
 }
 
 /**
@@ -551,7 +608,8 @@ xrow_decode_register(const struct xrow_header *row,
 		     uint32_t *version_id)
 {
 	return xrow_decode_subscribe(row, NULL, instance_uuid, vclock,
-				     version_id, NULL, NULL);
+				     version_id, NULL, NULL, NULL, NULL, NULL,
+				     NULL, NULL, NULL);
 }
 
 /**
@@ -576,7 +634,40 @@ xrow_encode_vclock(struct xrow_header *row, const struct vclock *vclock);
 static inline int
 xrow_decode_vclock(const struct xrow_header *row, struct vclock *vclock)
 {
-	return xrow_decode_subscribe(row, NULL, NULL, vclock, NULL, NULL, NULL);
+	return xrow_decode_subscribe(row, NULL, NULL, vclock, NULL, NULL, NULL,
+				     NULL, NULL, NULL, NULL, NULL, NULL);
+}
+
+/**
+ * Encode an ack sent by a replica to its master.
+ * @param row[out] Row to encode into.
+ * @param vclock Replica vclock.
+ * @param echo_tm Timestamp of the latest heartbeat or row of the
+ *		  master received by the replica, 0 if unknown.
+ *
+ * @retval  0 Success.
+ * @retval -1 Memory error.
+ */
+int
+xrow_encode_ack(struct xrow_header *row, const struct vclock *vclock,
+		double echo_tm);
+
+/**
+ * Decode an ack sent by a replica to its master.
+ * @param row Row to decode.
+ * @param[out] vclock Replica vclock.
+ * @param[out] echo_tm Timestamp echoed by the replica, 0 if the
+ *		       replica doesn't send it.
+ *
+ * @retval  0 Success.
+ * @retval -1 Memory or format error.
+ */
+static inline int
+xrow_decode_ack(const struct xrow_header *row, struct vclock *vclock,
+		double *echo_tm)
+{
+	return xrow_decode_subscribe(row, NULL, NULL, vclock, NULL, NULL, NULL,
+				     NULL, NULL, NULL, NULL, NULL, echo_tm);
 }
 
 /**
@@ -608,7 +699,8 @@ xrow_decode_subscribe_response(const struct xrow_header *row,
 			       struct vclock *vclock)
 {
 	return xrow_decode_subscribe(row, replicaset_uuid, NULL, vclock, NULL,
-				     NULL, NULL);
+				     NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+				     NULL);
 }
 
 /**
@@ -628,6 +720,43 @@ xrow_encode_timestamp(struct xrow_header *row, uint32_t replica_id, double tm);
 void
 xrow_encode_type(struct xrow_header *row, uint16_t type);
 
+/**
+ * Encode a JOIN_SNAPSHOT message marking the end of the join
+ * metadata and the beginning of the initial data.
+ * @param row[out] Row to encode into.
+ * @param file_size Size of the checkpoint file the initial data
+ *		    follows as, in bytes, or 0 if it's sent as rows.
+ * @param join_streams Number of streams the initial data is sent
+ *		       over. The replica is supposed to open the
+ *		       additional streams with xrow_encode_join_stream().
+ * @param join_id Id of the initial join the additional streams
+ *		  attach to.
+ *
+ * @retval 0 Success.
+ * @retval -1 Memory error.
+ */
+int
+xrow_encode_join_snapshot(struct xrow_header *row, uint64_t file_size,
+			  uint32_t join_streams, uint32_t join_id);
+
+/**
+ * Decode a JOIN_SNAPSHOT message.
+ * @param row Row to decode.
+ * @param[out] file_size Size of the checkpoint file following
+ *			 the message or 0 if the initial data is
+ *			 sent as rows.
+ * @param[out] join_streams Number of streams the initial data
+ *			    is sent over.
+ * @param[out] join_id Id of the initial join the additional
+ *		       streams attach to.
+ *
+ * @retval 0 Success.
+ * @retval -1 Format error.
+ */
+int
+xrow_decode_join_snapshot(const struct xrow_header *row, uint64_t *file_size,
+			  uint32_t *join_streams, uint32_t *join_id);
+
 /**
  * Fast encode xrow header using the specified header fields.
  * It is faster than the xrow_header_encode, because uses
@@ -1049,10 +1178,12 @@ xrow_encode_subscribe_xc(struct xrow_header *row,
 			 const struct tt_uuid *replicaset_uuid,
 			 const struct tt_uuid *instance_uuid,
 			 const struct vclock *vclock, bool anon,
-			 uint32_t id_filter)
+			 uint32_t id_filter, const uint32_t *space_filter,
+			 uint32_t space_filter_size)
 {
 	if (xrow_encode_subscribe(row, replicaset_uuid, instance_uuid,
-				  vclock, anon, id_filter) != 0)
+				  vclock, anon, id_filter, space_filter,
+				  space_filter_size) != 0)
 		diag_raise();
 }
 
@@ -1062,29 +1193,68 @@ xrow_decode_subscribe_xc(const struct xrow_header *row,
 			 struct tt_uuid *replicaset_uuid,
 			 struct tt_uuid *instance_uuid, struct vclock *vclock,
 			 uint32_t *replica_version_id, bool *anon,
-			 uint32_t *id_filter)
+			 uint32_t *id_filter, uint32_t **space_filter,
+			 uint32_t *space_filter_size)
 {
 	if (xrow_decode_subscribe(row, replicaset_uuid, instance_uuid,
 				  vclock, replica_version_id, anon,
-				  id_filter) != 0)
+				  id_filter, space_filter,
+				  space_filter_size, NULL, NULL, NULL,
+				  NULL) != 0)
 		diag_raise();
 }
 
 /** @copydoc xrow_encode_join. */
 static inline void
 xrow_encode_join_xc(struct xrow_header *row,
-		    const struct tt_uuid *instance_uuid)
+		    const struct tt_uuid *instance_uuid, bool checkpoint_join,
+		    uint32_t join_streams)
 {
-	if (xrow_encode_join(row, instance_uuid) != 0)
+	if (xrow_encode_join(row, instance_uuid, checkpoint_join,
+			     join_streams) != 0)
+		diag_raise();
+}
+
+/** @copydoc xrow_encode_join_stream. */
+static inline void
+xrow_encode_join_stream_xc(struct xrow_header *row,
+			   const struct tt_uuid *instance_uuid,
+			   uint32_t join_id)
+{
+	if (xrow_encode_join_stream(row, instance_uuid, join_id) != 0)
 		diag_raise();
 }
 
 /** @copydoc xrow_decode_join. */
 static inline void
 xrow_decode_join_xc(const struct xrow_header *row,
-		    struct tt_uuid *instance_uuid, uint32_t *version_id)
+		    struct tt_uuid *instance_uuid, uint32_t *version_id,
+		    bool *checkpoint_join, uint32_t *join_streams,
+		    uint32_t *join_id)
 {
-	if (xrow_decode_join(row, instance_uuid, version_id) != 0)
+	if (xrow_decode_join(row, instance_uuid, version_id, checkpoint_join,
+			     join_streams, join_id) != 0)
+		diag_raise();
+}
+
+/** @copydoc xrow_encode_join_snapshot. */
+static inline void
+xrow_encode_join_snapshot_xc(struct xrow_header *row, uint64_t file_size,
+			     uint32_t join_streams, uint32_t join_id)
+{
+	if (xrow_encode_join_snapshot(row, file_size, join_streams,
+				      join_id) != 0)
+		diag_raise();
+}
+
+/** @copydoc xrow_decode_join_snapshot. */
+static inline void
+xrow_decode_join_snapshot_xc(const struct xrow_header *row,
+			     uint64_t *file_size, uint32_t *join_streams,
+			     uint32_t *join_id)
+{
+	if (xrow_decode_join_snapshot(row, file_size, join_streams,
+				      join_id) != 0)
 		diag_raise();
 }
 
@@ -1114,6 +1284,24 @@ xrow_decode_vclock_xc(const struct xrow_header *row, struct vclock *vclock)
 		diag_raise();
 }
 
+/** @copydoc xrow_encode_ack. */
+static inline void
+xrow_encode_ack_xc(struct xrow_header *row, const struct vclock *vclock,
+		   double echo_tm)
+{
+	if (xrow_encode_ack(row, vclock, echo_tm) != 0)
+		diag_raise();
+}
+
+/** @copydoc xrow_decode_ack. */
+static inline void
+xrow_decode_ack_xc(const struct xrow_header *row, struct vclock *vclock,
+		   double *echo_tm)
+{
+	if (xrow_decode_ack(row, vclock, echo_tm) != 0)
+		diag_raise();
+}
+
 /** @copydoc xrow_encode_subscribe_response. */
 static inline void
 xrow_encode_subscribe_response_xc(struct xrow_header *row,
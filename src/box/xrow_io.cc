@@ -62,7 +62,7 @@ coio_read_xrow(struct iostream *io, struct ibuf *in, struct xrow_header *row)
 			      true);
 }
 
-void
+size_t
 coio_read_xrow_timeout_xc(struct iostream *io, struct ibuf *in,
 			  struct xrow_header *row, ev_tstamp timeout)
 {
@@ -83,7 +83,13 @@ coio_read_xrow_timeout_xc(struct iostream *io, struct ibuf *in,
 		coio_breadn_timeout(io, in, to_read, delay);
 	coio_timeout_update(&start, &delay);
 
+	const char *pos = in->rpos;
 	uint32_t len = mp_decode_uint((const char **) &in->rpos);
+	/*
+	 * Count the length the way the sender encoded it: it is
+	 * usually a fixed size header, not the shortest encoding.
+	 */
+	size_t size = in->rpos - pos + len;
 
 	/* Read header and body */
 	to_read = len - ibuf_used(in);
@@ -92,15 +98,18 @@ coio_read_xrow_timeout_xc(struct iostream *io, struct ibuf *in,
 
 	xrow_header_decode_xc(row, (const char **) &in->rpos, in->rpos + len,
 			      true);
+	return size;
 }
 
 
-void
+size_t
 coio_write_xrow(struct iostream *io, const struct xrow_header *row)
 {
 	struct iovec iov[XROW_IOVMAX];
 	int iovcnt = xrow_to_iovec_xc(row, iov);
-	if (coio_writev(io, iov, iovcnt, 0) < 0)
+	ssize_t size = coio_writev(io, iov, iovcnt, 0);
+	if (size < 0)
 		diag_raise();
+	return size;
 }
 
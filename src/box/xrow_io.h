@@ -30,6 +30,8 @@
  * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
  * SUCH DAMAGE.
  */
+#include <stddef.h>
+
 #if defined(__cplusplus)
 extern "C" {
 #endif
@@ -41,11 +43,13 @@ struct xrow_header;
 void
 coio_read_xrow(struct iostream *io, struct ibuf *in, struct xrow_header *row);
 
-void
+/** Read a row and return the size of its packet, in bytes. */
+size_t
 coio_read_xrow_timeout_xc(struct iostream *io, struct ibuf *in,
 			  struct xrow_header *row, double timeout);
 
-void
+/** Write a row and return the size of its packet, in bytes. */
+size_t
 coio_write_xrow(struct iostream *io, const struct xrow_header *row);
 
 
@@ -0,0 +1,253 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2022, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "xrow_ring.h"
+
+#include <small/ibuf.h>
+#include <string.h>
+#include <sys/uio.h>
+
+#include "diag.h"
+#include "tt_pthread.h"
+#include "xrow.h"
+
+/** Size of the header preceding each row stored in a ring. */
+static const size_t XROW_RING_ROW_HEADER_SIZE = sizeof(uint32_t);
+
+void
+xrow_ring_create(struct xrow_ring *ring, size_t size)
+{
+	tt_pthread_mutex_init(&ring->mutex, NULL);
+	ring->block_size = size / XROW_RING_BLOCK_COUNT;
+	for (int i = 0; i < XROW_RING_BLOCK_COUNT; i++)
+		ring->blocks[i].data = NULL;
+	ring->next_pos = 0;
+	ring->first_block = 0;
+	ring->last_block = 0;
+	struct vclock vclock;
+	vclock_create(&vclock);
+	xrow_ring_reset(ring, &vclock);
+}
+
+void
+xrow_ring_destroy(struct xrow_ring *ring)
+{
+	for (int i = 0; i < XROW_RING_BLOCK_COUNT; i++)
+		free(ring->blocks[i].data);
+	tt_pthread_mutex_destroy(&ring->mutex);
+}
+
+/**
+ * Discard all rows stored in a ring. The newest block is reused
+ * for rows appended next. Must be called under the ring mutex.
+ */
+static void
+xrow_ring_discard(struct xrow_ring *ring)
+{
+	struct xrow_ring_block *block = &ring->blocks[ring->last_block];
+	block->first_pos = ring->next_pos;
+	block->row_count = 0;
+	block->used = 0;
+	vclock_copy(&block->vclock, &ring->vclock);
+	ring->first_block = ring->last_block;
+}
+
+void
+xrow_ring_reset(struct xrow_ring *ring, const struct vclock *vclock)
+{
+	tt_pthread_mutex_lock(&ring->mutex);
+	vclock_copy(&ring->vclock, vclock);
+	xrow_ring_discard(ring);
+	tt_pthread_mutex_unlock(&ring->mutex);
+}
+
+/**
+ * Return a block to append a row of the given size to, switching
+ * to the next block and discarding the oldest one if necessary.
+ * Must be called under the ring mutex.
+ */
+static struct xrow_ring_block *
+xrow_ring_prepare_block(struct xrow_ring *ring, size_t size)
+{
+	struct xrow_ring_block *block = &ring->blocks[ring->last_block];
+	if (block->used + size > ring->block_size) {
+		int next = (ring->last_block + 1) % XROW_RING_BLOCK_COUNT;
+		if (next == ring->first_block) {
+			ring->first_block = (ring->first_block + 1) %
+					    XROW_RING_BLOCK_COUNT;
+		}
+		ring->last_block = next;
+		block = &ring->blocks[next];
+		block->first_pos = ring->next_pos;
+		block->row_count = 0;
+		block->used = 0;
+		vclock_copy(&block->vclock, &ring->vclock);
+	}
+	if (block->data == NULL) {
+		block->data = malloc(ring->block_size);
+		if (block->data == NULL) {
+			diag_set(OutOfMemory, ring->block_size,
+				 "malloc", "xrow ring block");
+			return NULL;
+		}
+	}
+	return block;
+}
+
+int
+xrow_ring_append(struct xrow_ring *ring, const struct xrow_header *row)
+{
+	struct iovec iov[XROW_IOVMAX];
+	int iovcnt = xrow_header_encode(row, 0, iov, 0);
+	if (iovcnt < 0)
+		return -1;
+	size_t size = 0;
+	for (int i = 0; i < iovcnt; i++)
+		size += iov[i].iov_len;
+	int rc = 0;
+	tt_pthread_mutex_lock(&ring->mutex);
+	struct xrow_ring_block *block = NULL;
+	if (XROW_RING_ROW_HEADER_SIZE + size <= ring->block_size) {
+		block = xrow_ring_prepare_block(ring,
+				XROW_RING_ROW_HEADER_SIZE + size);
+		if (block == NULL)
+			rc = -1;
+	}
+	if (block != NULL) {
+		char *data = block->data + block->used;
+		uint32_t len = size;
+		memcpy(data, &len, sizeof(len));
+		data += XROW_RING_ROW_HEADER_SIZE;
+		for (int i = 0; i < iovcnt; i++) {
+			memcpy(data, iov[i].iov_base, iov[i].iov_len);
+			data += iov[i].iov_len;
+		}
+		block->used += XROW_RING_ROW_HEADER_SIZE + size;
+		block->row_count++;
+	}
+	vclock_follow_xrow(&ring->vclock, row);
+	ring->next_pos++;
+	/*
+	 * A row that doesn't fit in a block or can't be stored
+	 * leaves a gap so all rows preceding it are discarded.
+	 */
+	if (block == NULL)
+		xrow_ring_discard(ring);
+	tt_pthread_mutex_unlock(&ring->mutex);
+	return rc;
+}
+
+/**
+ * Check if a reader that has seen all rows up to @a vclock has
+ * seen all rows preceding a block. Component 0 and the component
+ * of the reader itself are ignored: they are advanced by rows the
+ * reader doesn't get from the ring anyway.
+ */
+static bool
+xrow_ring_block_is_seen(const struct xrow_ring_block *block,
+			const struct vclock *vclock, uint32_t reader_id)
+{
+	struct vclock_iterator it;
+	vclock_iterator_init(&it, &block->vclock);
+	vclock_foreach(&it, replica) {
+		if (replica.id == 0 || replica.id == reader_id)
+			continue;
+		if (replica.lsn > vclock_get(vclock, replica.id))
+			return false;
+	}
+	return true;
+}
+
+int
+xrow_ring_seek(struct xrow_ring *ring, const struct vclock *vclock,
+	       uint32_t reader_id, int64_t *pos)
+{
+	int rc = -1;
+	tt_pthread_mutex_lock(&ring->mutex);
+	int i = ring->last_block;
+	while (true) {
+		struct xrow_ring_block *block = &ring->blocks[i];
+		if (xrow_ring_block_is_seen(block, vclock, reader_id)) {
+			*pos = block->first_pos;
+			rc = 0;
+			break;
+		}
+		if (i == ring->first_block)
+			break;
+		i = (i + XROW_RING_BLOCK_COUNT - 1) % XROW_RING_BLOCK_COUNT;
+	}
+	tt_pthread_mutex_unlock(&ring->mutex);
+	return rc;
+}
+
+int
+xrow_ring_read(struct xrow_ring *ring, int64_t *pos, struct ibuf *buf,
+	       size_t max_size)
+{
+	int count = 0;
+	size_t copied = 0;
+	tt_pthread_mutex_lock(&ring->mutex);
+	if (*pos < ring->blocks[ring->first_block].first_pos) {
+		count = -1;
+		goto out;
+	}
+	int i = ring->first_block;
+	while (true) {
+		struct xrow_ring_block *block = &ring->blocks[i];
+		int64_t block_end = block->first_pos + block->row_count;
+		if (*pos < block_end) {
+			/* Skip rows preceding the position. */
+			const char *data = block->data;
+			for (int64_t p = block->first_pos; p < *pos; p++) {
+				uint32_t len;
+				memcpy(&len, data, sizeof(len));
+				data += XROW_RING_ROW_HEADER_SIZE + len;
+			}
+			const char *end = block->data + block->used;
+			while (data < end && (count == 0 ||
+					      copied < max_size)) {
+				uint32_t len;
+				memcpy(&len, data, sizeof(len));
+				size_t size = XROW_RING_ROW_HEADER_SIZE + len;
+				char *dst = ibuf_alloc(buf, size);
+				if (dst == NULL) {
+					diag_set(OutOfMemory, size,
+						 "ibuf_alloc", "xrow");
+					count = -1;
+					goto out;
+				}
+				memcpy(dst, data, size);
+				data += size;
+				copied += size;
+				count++;
+				(*pos)++;
+			}
+			if (copied >= max_size)
+				break;
+		}
+		if (i == ring->last_block)
+			break;
+		i = (i + 1) % XROW_RING_BLOCK_COUNT;
+	}
+out:
+	tt_pthread_mutex_unlock(&ring->mutex);
+	return count;
+}
+
+int
+xrow_ring_decode(struct xrow_header *row, const char **data)
+{
+	uint32_t len;
+	memcpy(&len, *data, sizeof(len));
+	*data += XROW_RING_ROW_HEADER_SIZE;
+	return xrow_header_decode(row, data, *data + len, true);
+}
+
+const char *
+xrow_ring_row_data(const char *data, uint32_t *len)
+{
+	memcpy(len, data, sizeof(*len));
+	return data + XROW_RING_ROW_HEADER_SIZE;
+}
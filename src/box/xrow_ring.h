@@ -0,0 +1,149 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2022, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "vclock/vclock.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+struct ibuf;
+struct xrow_header;
+
+enum {
+	/** Number of blocks a ring is split into. */
+	XROW_RING_BLOCK_COUNT = 16,
+};
+
+/**
+ * A block of an xrow ring. Rows are appended to the newest block
+ * of a ring until it is full, then the oldest block is discarded
+ * and reused.
+ */
+struct xrow_ring_block {
+	/** Position of the first row stored in the block. */
+	int64_t first_pos;
+	/** Number of rows stored in the block. */
+	uint32_t row_count;
+	/** Number of bytes used in the block. */
+	size_t used;
+	/** Vclock preceding the first row stored in the block. */
+	struct vclock vclock;
+	/** Row data, allocated on the first use. */
+	char *data;
+};
+
+/**
+ * A bounded ring buffer of encoded rows appended by one thread and
+ * read by many threads. Each row is assigned a position, which is
+ * incremented by one with each appended row. Readers look up the
+ * position to start from by vclock and then fetch rows following
+ * it until the ring wraps around and discards them.
+ *
+ * Every row is stored as a 32-bit length followed by the row
+ * encoded with xrow_header_encode().
+ */
+struct xrow_ring {
+	/** Protects all members below. */
+	pthread_mutex_t mutex;
+	/** Size of a block, in bytes. */
+	size_t block_size;
+	/** Blocks, used in a circular manner. */
+	struct xrow_ring_block blocks[XROW_RING_BLOCK_COUNT];
+	/** Index of the oldest block. */
+	int first_block;
+	/** Index of the newest block, rows are appended to it. */
+	int last_block;
+	/** Position the next appended row will be assigned. */
+	int64_t next_pos;
+	/** Vclock of the last appended row. */
+	struct vclock vclock;
+};
+
+/**
+ * Create a ring of the given size (in bytes). Rows longer than
+ * size / XROW_RING_BLOCK_COUNT aren't stored in the ring: they
+ * make it discard all rows and start over.
+ */
+void
+xrow_ring_create(struct xrow_ring *ring, size_t size);
+
+void
+xrow_ring_destroy(struct xrow_ring *ring);
+
+/**
+ * Discard all rows stored in the ring and set the vclock the next
+ * appended row will follow.
+ */
+void
+xrow_ring_reset(struct xrow_ring *ring, const struct vclock *vclock);
+
+/**
+ * Append a row to the ring, discarding the oldest rows if there's
+ * not enough space.
+ *
+ * @retval 0 Success.
+ * @retval -1 Memory error, diag is set. The ring is reset.
+ */
+int
+xrow_ring_append(struct xrow_ring *ring, const struct xrow_header *row);
+
+/**
+ * Find the position of the first row stored in the ring that is
+ * needed by a reader that has seen all rows up to @a vclock. Rows
+ * following the position may still include rows already seen by
+ * the reader so it should skip rows with LSN less than or equal
+ * to the corresponding @a vclock component. Component 0 and
+ * the component of @a reader_id, which is the id of the replica
+ * the rows are read for or 0, aren't taken into account.
+ *
+ * @retval 0 Success, the position is stored in @a pos.
+ * @retval -1 Some of the rows the reader needs have been
+ *            discarded.
+ */
+int
+xrow_ring_seek(struct xrow_ring *ring, const struct vclock *vclock,
+	       uint32_t reader_id, int64_t *pos);
+
+/**
+ * Copy rows starting at position @a pos to @a buf, at most
+ * @a max_size bytes, but at least one row if any. Rows are copied
+ * in the ring format, see struct xrow_ring. On success @a pos is
+ * advanced past the copied rows.
+ *
+ * @retval >= 0 Number of copied rows.
+ * @retval -1 The row at @a pos has been discarded.
+ */
+int
+xrow_ring_read(struct xrow_ring *ring, int64_t *pos, struct ibuf *buf,
+	       size_t max_size);
+
+/**
+ * Decode the next row copied by xrow_ring_read(). The row body
+ * points to the buffer.
+ *
+ * @retval 0 Success, @a data is advanced.
+ * @retval -1 Decode error, diag is set.
+ */
+int
+xrow_ring_decode(struct xrow_header *row, const char **data);
+
+/**
+ * Get the next row copied by xrow_ring_read() as it was encoded
+ * by xrow_header_encode() without sync, i.e. the header followed
+ * by the body. The length is stored in @a len.
+ */
+const char *
+xrow_ring_row_data(const char *data, uint32_t *len);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
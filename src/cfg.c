@@ -76,6 +76,15 @@ cfg_isnumber(const char *param)
 	return ret;
 }
 
+bool
+cfg_isnil(const char *param)
+{
+	cfg_get(param);
+	bool ret = lua_isnil(tarantool_L, -1);
+	lua_pop(tarantool_L, 1);
+	return ret;
+}
+
 int
 cfg_getb(const char *param)
 {
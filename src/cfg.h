@@ -55,6 +55,12 @@ cfg_geti(const char *param);
 bool
 cfg_isnumber(const char *param);
 
+/**
+ * Test if cfg parameter is nil.
+ */
+bool
+cfg_isnil(const char *param);
+
 /**
  * Gets boolean parameter of cfg.
  * Returns -1 in case of nil
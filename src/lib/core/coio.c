@@ -469,6 +469,39 @@ coio_writev_timeout(struct iostream *io, struct iovec *iov, int iovcnt,
 	return total;
 }
 
+ssize_t
+coio_sendfile_timeout(struct iostream *io, int fd, off_t offset,
+		      size_t count, ev_tstamp timeout)
+{
+	size_t left = count;
+	ev_tstamp start, delay;
+	coio_timeout_init(&start, &delay, timeout);
+	while (left > 0) {
+		ssize_t nwr = iostream_sendfile(io, fd, offset, left);
+		if (nwr > 0) {
+			offset += nwr;
+			left -= nwr;
+			continue;
+		} else if (nwr == 0) {
+			diag_set(IllegalParams, "unexpected end of file");
+			return -1;
+		} else if (nwr == IOSTREAM_ERROR) {
+			return -1;
+		}
+		if (delay <= 0) {
+			diag_set(TimedOut);
+			return -1;
+		}
+		coio_wait(io->fd, iostream_status_to_events(nwr), delay);
+		if (fiber_is_cancelled()) {
+			diag_set(FiberIsCancelled);
+			return -1;
+		}
+		coio_timeout_update(&start, &delay);
+	}
+	return count;
+}
+
 void
 coio_stat_init(ev_stat *stat, const char *path)
 {
@@ -138,6 +138,20 @@ coio_writev(struct iostream *io, struct iovec *iov, int iovcnt, size_t size)
 	return coio_writev_timeout(io, iov, iovcnt, size, TIMEOUT_INFINITY);
 }
 
+/**
+ * Write count bytes of the file fd starting at offset to a stream,
+ * see iostream_sendfile(). Fails if the file is shorter.
+ */
+ssize_t
+coio_sendfile_timeout(struct iostream *io, int fd, off_t offset,
+		      size_t count, ev_tstamp timeout);
+
+static inline ssize_t
+coio_sendfile(struct iostream *io, int fd, off_t offset, size_t count)
+{
+	return coio_sendfile_timeout(io, fd, offset, count, TIMEOUT_INFINITY);
+}
+
 void
 coio_stat_init(ev_stat *stat, const char *path);
 
@@ -12,6 +12,11 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include "trivia/config.h"
+#if defined(HAVE_SENDFILE_LINUX)
+#include <sys/sendfile.h>
+#endif
+
 #include "diag.h"
 #include "sio.h"
 #include "ssl.h"
@@ -78,13 +83,48 @@ plain_iostream_writev(struct iostream *io, const struct iovec *iov, int iovcnt)
 	return IOSTREAM_ERROR;
 }
 
+#if defined(HAVE_SENDFILE_LINUX)
+static ssize_t
+plain_iostream_sendfile(struct iostream *io, int fd, off_t offset,
+			size_t count)
+{
+	assert(io->fd >= 0);
+	ssize_t ret = sendfile(io->fd, fd, &offset, count);
+	if (ret >= 0)
+		return ret;
+	if (sio_wouldblock(errno))
+		return IOSTREAM_WANT_WRITE;
+	diag_set(SocketError, sio_socketname(io->fd), "sendfile(%zu)", count);
+	return IOSTREAM_ERROR;
+}
+#else
+#define plain_iostream_sendfile NULL
+#endif
+
 static const struct iostream_vtab plain_iostream_vtab = {
 	/* .destroy = */ plain_iostream_destroy,
 	/* .read = */ plain_iostream_read,
 	/* .write = */ plain_iostream_write,
 	/* .writev = */ plain_iostream_writev,
+	/* .sendfile = */ plain_iostream_sendfile,
 };
 
+ssize_t
+iostream_sendfile(struct iostream *io, int fd, off_t offset, size_t count)
+{
+	if (io->vtab->sendfile != NULL)
+		return io->vtab->sendfile(io, fd, offset, count);
+	char buf[16 * 1024];
+	ssize_t ret = pread(fd, buf, MIN(count, sizeof(buf)), offset);
+	if (ret < 0) {
+		diag_set(SystemError, "pread");
+		return IOSTREAM_ERROR;
+	}
+	if (ret == 0)
+		return 0;
+	return iostream_write(io, buf, ret);
+}
+
 int
 iostream_ctx_create(struct iostream_ctx *ctx, enum iostream_mode mode,
 		    const struct uri *uri)
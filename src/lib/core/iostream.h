@@ -76,6 +76,12 @@ struct iostream_vtab {
 	/** See iostream_writev. */
 	ssize_t
 	(*writev)(struct iostream *io, const struct iovec *iov, int iovcnt);
+	/**
+	 * See iostream_sendfile. Optional: if NULL, the file is
+	 * read to a buffer and written with the write method.
+	 */
+	ssize_t
+	(*sendfile)(struct iostream *io, int fd, off_t offset, size_t count);
 };
 
 /**
@@ -182,6 +188,17 @@ iostream_writev(struct iostream *io, const struct iovec *iov, int iovcnt)
 	return io->vtab->writev(io, iov, iovcnt);
 }
 
+/**
+ * Writes up to count bytes of the file fd starting at offset to
+ * a stream. The data is sent without copying it to user space if
+ * the stream supports it (e.g. a plain stream on Linux).
+ * On success returns the number of bytes written (>= 0); 0 means
+ * that the end of the file was reached.
+ * On failure returns iostream_status (< 0).
+ */
+ssize_t
+iostream_sendfile(struct iostream *io, int fd, off_t offset, size_t count);
+
 enum iostream_mode {
 	/** Uninitilized context (see iostream_ctx_clear). */
 	IOSTREAM_MODE_UNINITIALIZED = 0,
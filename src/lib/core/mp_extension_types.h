@@ -45,6 +45,7 @@ enum mp_extension_type {
     MP_UUID = 2,
     MP_ERROR = 3,
     MP_DATETIME = 4,
+    MP_COMPRESSION = 5,
     mp_extension_type_MAX,
 };
 
@@ -304,6 +304,56 @@ raft_sm_follow_leader(struct raft *raft, uint32_t leader);
 static void
 raft_sm_become_candidate(struct raft *raft);
 
+/**
+ * Check if this instance is a follower which has heard from the leader within
+ * the death timeout, when the leader lease is enabled. Such a follower must not
+ * help to elect another leader, because the current one may still hold the
+ * lease.
+ */
+static bool
+raft_is_leader_alive(const struct raft *raft)
+{
+	if (!raft->is_lease_enabled || raft->leader == 0 ||
+	    raft->leader == raft->self)
+		return false;
+	double now = raft_ev_monotonic_now(raft_loop());
+	return now < raft->leader_last_seen + raft->death_timeout;
+}
+
+/**
+ * Recalculate the leader lease deadline. The lease lasts for half of the death
+ * timeout since the moment when a quorum of instances, the leader included, is
+ * known to have heard from the leader. The ack times are the times when the
+ * leader sent the acknowledged messages, so the followers heard from it at
+ * that moment or later and won't vote for anybody else until the death timeout
+ * passes since then. The other half of the death timeout is left for clock
+ * rate differences.
+ */
+static void
+raft_update_lease(struct raft *raft)
+{
+	assert(raft->state == RAFT_STATE_LEADER);
+	/* Ack times sorted in descending order. */
+	double times[VCLOCK_MAX];
+	int count = 0;
+	for (int i = 0; i < VCLOCK_MAX; i++) {
+		double time = raft->ack_time[i];
+		if (time == 0)
+			continue;
+		int j = count++;
+		for (; j > 0 && times[j - 1] < time; j--)
+			times[j] = times[j - 1];
+		times[j] = time;
+	}
+	/* The leader doesn't need to hear from self. */
+	int need = raft->election_quorum - 1;
+	if (need <= 0 || count < need) {
+		raft->lease_deadline = 0;
+		return;
+	}
+	raft->lease_deadline = times[need - 1] + raft->death_timeout / 2;
+}
+
 static const char *
 raft_msg_to_string(const struct raft_msg *req)
 {
@@ -399,6 +449,16 @@ raft_process_msg(struct raft *raft, const struct raft_msg *req, uint32_t source)
 		return 0;
 	}
 
+	/*
+	 * The leader may still hold a lease. Don't let anybody start a new term
+	 * until the leader is dead or is elected already.
+	 */
+	if (req->term > raft->volatile_term && raft_is_leader_alive(raft) &&
+	    source != raft->leader && req->state != RAFT_STATE_LEADER) {
+		say_info("RAFT: the message is ignored - leader %u is alive",
+			 raft->leader);
+		return 0;
+	}
 	/* Term bump. */
 	if (req->term > raft->volatile_term)
 		raft_sm_schedule_new_term(raft, req->term);
@@ -528,6 +588,8 @@ raft_process_heartbeat(struct raft *raft, uint32_t source)
 	 */
 	if (source == 0)
 		return;
+	if (raft->leader == source && raft->state != RAFT_STATE_LEADER)
+		raft->leader_last_seen = raft_ev_monotonic_now(raft_loop());
 	/*
 	 * When not a candidate - don't wait for anything. Therefore do not care
 	 * about the leader being dead.
@@ -557,6 +619,35 @@ raft_process_heartbeat(struct raft *raft, uint32_t source)
 	raft_sm_wait_leader_dead(raft);
 }
 
+bool
+raft_has_lease(const struct raft *raft)
+{
+	if (!raft->is_lease_enabled || raft->state != RAFT_STATE_LEADER)
+		return false;
+	if (raft->election_quorum <= 1)
+		return true;
+	return raft_ev_monotonic_now(raft_loop()) < raft->lease_deadline;
+}
+
+void
+raft_process_ack(struct raft *raft, uint32_t source, double time)
+{
+	assert(source < VCLOCK_MAX);
+	if (raft->state != RAFT_STATE_LEADER || source == 0 ||
+	    source == raft->self)
+		return;
+	/*
+	 * The instance could have received the message before it learned about
+	 * the new leader. Then it wouldn't prevent election of another one.
+	 */
+	if (time < raft->leader_since + raft->death_timeout / 2)
+		return;
+	if (time <= raft->ack_time[source])
+		return;
+	raft->ack_time[source] = time;
+	raft_update_lease(raft);
+}
+
 /* Dump Raft state to WAL in a blocking way. */
 static void
 raft_worker_handle_io(struct raft *raft)
@@ -686,6 +777,9 @@ raft_sm_become_leader(struct raft *raft)
 	assert(!raft->is_write_in_progress);
 	raft->state = RAFT_STATE_LEADER;
 	raft->leader = raft->self;
+	raft->leader_since = raft_ev_monotonic_now(raft_loop());
+	memset(raft->ack_time, 0, sizeof(raft->ack_time));
+	raft->lease_deadline = 0;
 	raft_ev_timer_stop(raft_loop(), &raft->timer);
 	/* State is visible and it is changed - broadcast. */
 	raft_schedule_broadcast(raft);
@@ -699,6 +793,7 @@ raft_sm_follow_leader(struct raft *raft, uint32_t leader)
 	assert(raft->leader == 0);
 	raft->state = RAFT_STATE_FOLLOWER;
 	raft->leader = leader;
+	raft->leader_last_seen = raft_ev_monotonic_now(raft_loop());
 	if (!raft->is_write_in_progress && raft->is_candidate) {
 		raft_ev_timer_stop(raft_loop(), &raft->timer);
 		raft_sm_wait_leader_dead(raft);
@@ -1038,6 +1133,8 @@ raft_cfg_election_quorum(struct raft *raft, int election_quorum)
 	/* At least self is always a part of the quorum. */
 	assert(election_quorum > 0);
 	raft->election_quorum = election_quorum;
+	if (raft->state == RAFT_STATE_LEADER)
+		raft_update_lease(raft);
 	if (raft->state == RAFT_STATE_CANDIDATE &&
 	    raft_vote_count(raft) >= raft->election_quorum)
 		raft_sm_become_leader(raft);
@@ -1045,6 +1142,12 @@ raft_cfg_election_quorum(struct raft *raft, int election_quorum)
 		raft_check_split_vote(raft);
 }
 
+void
+raft_cfg_is_lease_enabled(struct raft *raft, bool is_lease_enabled)
+{
+	raft->is_lease_enabled = is_lease_enabled;
+}
+
 void
 raft_cfg_death_timeout(struct raft *raft, double timeout)
 {
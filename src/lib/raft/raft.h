@@ -225,6 +225,30 @@ struct raft {
 	double death_timeout;
 	/** Number of instances registered in the cluster. */
 	int cluster_size;
+	/**
+	 * Flag whether the leader lease is enabled. The leader holds the
+	 * lease while it knows that a quorum of instances has heard from
+	 * it recently. Followers which hear from the leader don't start
+	 * new terms and don't vote until the leader is dead. Hence no
+	 * other leader can appear while the lease is held, and the
+	 * leader can serve reads without asking anybody. That is true as
+	 * long as messages are delivered within half of the death
+	 * timeout, and all instances have the same death timeout.
+	 */
+	bool is_lease_enabled;
+	/** Time when the current leader was heard from last time. */
+	double leader_last_seen;
+	/** Time when this instance became the leader. */
+	double leader_since;
+	/**
+	 * Time when each instance is known to have heard from this
+	 * instance last time, since it became the leader. It is the
+	 * time when this instance sent the latest message the other
+	 * one acknowledged.
+	 */
+	double ack_time[VCLOCK_MAX];
+	/** Time when the leader lease expires. */
+	double lease_deadline;
 	/** Virtual table to perform application-specific actions. */
 	const struct raft_vtab *vtab;
 	/**
@@ -252,6 +276,13 @@ raft_is_enabled(const struct raft *raft)
 	return raft->is_enabled;
 }
 
+/**
+ * Check if the instance is the leader and holds the leader lease, i.e. no other
+ * leader can be elected until the lease expires.
+ */
+bool
+raft_has_lease(const struct raft *raft);
+
 /** Number of votes for self. */
 static inline int
 raft_vote_count(const struct raft *raft)
@@ -279,6 +310,15 @@ raft_process_async(struct raft *raft);
 void
 raft_process_heartbeat(struct raft *raft, uint32_t source);
 
+/**
+ * Process an acknowledgement of data receipt from an instance with the given
+ * ID. @a time is the time when this instance sent the latest message the
+ * acknowledgement covers, so the instance heard from this one at @a time or
+ * later. It is used by the leader to prolong its lease.
+ */
+void
+raft_process_ack(struct raft *raft, uint32_t source, double time);
+
 /** Configure whether Raft is enabled. */
 void
 raft_cfg_is_enabled(struct raft *raft, bool is_enabled);
@@ -306,6 +346,10 @@ raft_promote(struct raft *raft);
 void
 raft_restore(struct raft *raft);
 
+/** Configure whether the leader lease is enabled. */
+void
+raft_cfg_is_lease_enabled(struct raft *raft, bool is_lease_enabled);
+
 /** Configure Raft leader election timeout. */
 void
 raft_cfg_election_timeout(struct raft *raft, double timeout);
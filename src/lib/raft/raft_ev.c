@@ -55,3 +55,9 @@ raft_loop(void)
 {
 	return loop();
 }
+
+double
+raft_ev_monotonic_now(struct ev_loop *loop)
+{
+	return ev_monotonic_now(loop);
+}
@@ -620,6 +620,43 @@ LIGHT(detach_empty)(struct LIGHT(core) *ht, uint32_t slot)
 	return record;
 }
 
+/*
+ * Find an empty record that shares a cache line with the record
+ * in the given slot. Placing a collided value there instead of
+ * an arbitrary empty record lets a lookup walk the chain without
+ * taking another cache miss. Return LIGHT(end) if there is none.
+ */
+static inline uint32_t
+LIGHT(find_near_empty)(const struct LIGHT(core) *ht, uint32_t slot)
+{
+	enum {
+		LIGHT_CACHE_LINE_SIZE = 64,
+		LIGHT_GROUP_MAX = LIGHT_CACHE_LINE_SIZE /
+				  sizeof(struct LIGHT(record)),
+		/*
+		 * Slots of a group are found by masking the slot
+		 * number so the group size must be a power of two.
+		 */
+		LIGHT_GROUP_SIZE = LIGHT_GROUP_MAX >= 16 ? 16 :
+				   LIGHT_GROUP_MAX >= 8 ? 8 :
+				   LIGHT_GROUP_MAX >= 4 ? 4 :
+				   LIGHT_GROUP_MAX >= 2 ? 2 : 1,
+	};
+	if (LIGHT_GROUP_SIZE <= 1)
+		return LIGHT(end);
+	uint32_t first = slot & ~(uint32_t)(LIGHT_GROUP_SIZE - 1);
+	for (uint32_t i = first; i < first + LIGHT_GROUP_SIZE &&
+	     i < ht->table_size; i++) {
+		if (i == slot)
+			continue;
+		struct LIGHT(record) *record = (struct LIGHT(record) *)
+			matras_get(&ht->mtable, i);
+		if (record->next == i)
+			return i;
+	}
+	return LIGHT(end);
+}
+
 /*
  * Allocate memory and initialize empty list to get ready for first insertion
  */
@@ -801,8 +838,14 @@ LIGHT(insert)(struct LIGHT(core) *ht, uint32_t hash, LIGHT_DATA_TYPE value)
 			return LIGHT(end);
 	}
 
-	uint32_t empty_slot = ht->empty_slot;
-	struct LIGHT(record) *empty_record = LIGHT(detach_first_empty)(ht);
+	struct LIGHT(record) *empty_record;
+	uint32_t empty_slot = LIGHT(find_near_empty)(ht, slot);
+	if (empty_slot != LIGHT(end)) {
+		empty_record = LIGHT(detach_empty)(ht, empty_slot);
+	} else {
+		empty_slot = ht->empty_slot;
+		empty_record = LIGHT(detach_first_empty)(ht);
+	}
 	if (!empty_record)
 		return LIGHT(end);
 
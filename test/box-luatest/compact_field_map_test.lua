@@ -0,0 +1,90 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all = function()
+    g.server = server:new({alias = 'master'})
+    g.server:start()
+end
+
+g.after_all = function()
+    g.server:stop()
+end
+
+g.after_each(function()
+    g.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_compact_field_map_opts = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {compact_field_map = true})
+        t.assert_equals(box.space._space:get(s.id).flags,
+                        {compact_field_map = true})
+        s:alter({compact_field_map = false})
+        t.assert_equals(box.space._space:get(s.id).flags,
+                        {compact_field_map = false})
+        s:drop()
+        t.assert_error_msg_content_equals(
+            "Can't modify space 'test': " ..
+            "engine does not support compact_field_map flag",
+            box.schema.space.create, 'test',
+            {engine = 'vinyl', compact_field_map = true})
+    end)
+end
+
+g.test_compact_field_map_access = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {compact_field_map = true})
+        s:create_index('pk')
+        s:create_index('sk', {parts = {{3, 'string'}, {2, 'unsigned'}}})
+        s:create_index('path', {parts = {{4, 'unsigned', path = 'a'}},
+                                unique = false})
+        s:create_index('multikey', {parts = {{5, 'unsigned', path = '[*]'}},
+                                    unique = false})
+        for i = 1, 100 do
+            s:insert({i, i * 2, tostring(i), {a = i % 10}, {i, i + 1000}})
+        end
+        t.assert_equals(s.index.sk:get({'42', 84}),
+                        {42, 84, '42', {a = 2}, {42, 1042}})
+        t.assert_equals(s.index.path:count(3), 10)
+        t.assert_equals(s.index.multikey:get(1042)[1], 42)
+        s:update(42, {{'=', 3, 'x'}, {'=', 4, {a = 100}}})
+        t.assert_equals(s.index.sk:get({'x', 84})[1], 42)
+        t.assert_equals(s.index.path:select(100)[1][1], 42)
+        -- Tuples of the old format remain accessible after alter.
+        s:alter({compact_field_map = false})
+        s:insert({101, 202, '101', {a = 1}, {101}})
+        t.assert_equals(s.index.path:count(1), 11)
+        t.assert_equals(s.index.sk:select({'101'})[1][1], 101)
+    end)
+end
+
+-- Tuples of a space with compact field map take less memory.
+g.test_compact_field_map_size = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local function used(compact)
+            local s = box.schema.space.create('test',
+                                              {compact_field_map = compact})
+            s:create_index('pk')
+            for i = 2, 4 do
+                s:create_index('sk' .. i, {parts = {i, 'unsigned'}})
+            end
+            collectgarbage()
+            local before = box.slab.info().items_used
+            for i = 1, 1000 do
+                s:insert({i, i, i, i})
+            end
+            local size = box.slab.info().items_used - before
+            s:drop()
+            return size
+        end
+        t.assert_lt(used(true), used(false))
+    end)
+end
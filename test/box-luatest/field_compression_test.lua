@@ -0,0 +1,174 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all = function()
+    g.server = server:new({alias = 'master'})
+    g.server:start()
+end
+
+g.after_all = function()
+    g.server:stop()
+end
+
+g.after_each(function()
+    g.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_compression_opts = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test')
+        t.assert_error_msg_content_equals(
+            "Can't modify space 'test': compression is reasonable only " ..
+            "for string, varbinary, array, map and any fields",
+            s.format, s, {{'id', 'unsigned'},
+                          {'data', 'unsigned', compression = 'zstd'}})
+        t.assert_error_msg_content_equals(
+            "Can't modify space 'test': field 2 has unknown compression type",
+            s.format, s, {{'id', 'unsigned'},
+                          {'data', 'string', compression = 'foo'}})
+        s:format({{'id', 'unsigned'}, {'data', 'string', compression = 'zstd'}})
+        s:create_index('pk')
+        t.assert_error_msg_content_equals(
+            "Compressed field 2 (data) does not support indexing",
+            s.create_index, s, 'sk', {parts = {'data'}})
+        s:format({{'id', 'unsigned'}, {'data', 'map', compression = 'zstd'}})
+        t.assert_error_msg_content_equals(
+            "Compressed field 2 (data) does not support indexing",
+            s.create_index, s, 'sk', {parts = {{'data.a', 'string'}}})
+        s:drop()
+        t.assert_error_msg_content_equals(
+            "Can't modify space 'test': " ..
+            "engine does not support field compression",
+            box.schema.space.create, 'test',
+            {engine = 'vinyl', format = {{'data', compression = 'zstd'}}})
+    end)
+end
+
+g.test_compression = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test')
+        s:format({{'id', 'unsigned'},
+                  {'str', 'string', compression = 'zstd'},
+                  {'map', 'map', compression = 'zstd', is_nullable = true},
+                  {'val', 'unsigned', is_nullable = true}})
+        s:create_index('pk')
+        s:create_index('val', {parts = {'val'}, unique = false})
+        local str = string.rep('abcd', 1000)
+        local map = {a = string.rep('x', 100), b = {1, 2, 3}}
+        s:insert({1, str, map, 10})
+        s:insert({2, 'short', box.NULL, 20})
+        t.assert_lt(s:bsize(), #str)
+        t.assert_equals(s:get(1), {1, str, map, 10})
+        t.assert_equals(s:get(1).str, str)
+        t.assert_equals(s:get(1):totable(), {1, str, map, 10})
+        t.assert_equals(s:get(2), {2, 'short', box.NULL, 20})
+        t.assert_equals(s.index.val:select(10)[1][2], str)
+        -- Type is checked before compression.
+        t.assert_error_msg_content_equals(
+            "Tuple field 2 (str) type does not match one required by " ..
+            "operation: expected string, got unsigned",
+            s.insert, s, {3, 3})
+        -- Fields following a compressed field are updated in place.
+        s:update(1, {{'+', 'val', 5}})
+        t.assert_equals(s:get(1), {1, str, map, 15})
+        s:update(1, {{'=', 'str', str .. 'e'}})
+        t.assert_equals(s:get(1).str, str .. 'e')
+        -- Compressed values survive recovery.
+        box.snapshot()
+    end)
+    g.server:restart()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        local str = string.rep('abcd', 1000)
+        t.assert_equals(s:get(1).str, str .. 'e')
+        t.assert_equals(s:get(1).map.b, {1, 2, 3})
+        t.assert_lt(s:bsize(), #str)
+    end)
+end
+
+-- Compressed values supplied by the user are checked.
+g.test_compression_user_value = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local msgpack = require('msgpack')
+        local s = box.schema.space.create('test')
+        s:format({{'id', 'unsigned'}, {'str', 'string', compression = 'zstd'}})
+        s:create_index('pk')
+        local str = string.rep('abcd', 1000)
+        local tuple = s:insert({1, str})
+        s:replace(tuple:update({{'=', 1, 2}}))
+        s:replace(tuple)
+        t.assert_equals(s:get(1).str, str)
+        local function raw(payload)
+            -- [1, ext8(MP_COMPRESSION, payload)]
+            return msgpack.object_from_raw('\x92\x01\xc7' ..
+                                           string.char(#payload) ..
+                                           '\x05' .. payload)
+        end
+        local errmsg = "Decompression error: invalid compressed value"
+        -- Unknown compression type.
+        t.assert_error_msg_content_equals(errmsg, s.replace, s,
+                                          raw('\x05\x10garbage'))
+        -- Huge original size.
+        t.assert_error_msg_content_equals(errmsg, s.replace, s,
+                                          raw('\x01\xce\x7f\xff\xff\xff' ..
+                                              'garbage'))
+        -- Size that doesn't match the compressed data.
+        t.assert_error_msg_content_equals(errmsg, s.replace, s,
+                                          raw('\x01\x10garbage'))
+        t.assert_equals(s:get(1).str, str)
+    end)
+end
+
+-- Compressed values are decompressed wherever tuple data leaves
+-- the storage, not only by the Lua MsgPack decoder.
+g.test_compression_consumers = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local msgpack = require('msgpack')
+        local s = box.schema.space.create('test')
+        s:format({{'id', 'unsigned'}, {'str', 'string', compression = 'zstd'}})
+        s:create_index('pk')
+        local str = string.rep('abcd', 1000)
+        local tuple = s:insert({1, str})
+        t.assert_lt(tuple:bsize(), #str)
+        t.assert_gt(#msgpack.encode(tuple), #str)
+        t.assert_gt(#msgpack.encode({tuple}), #str)
+        t.assert_equals(tuple:totable(), {1, str})
+        t.assert_equals(tuple:totable(2, 2), {str})
+        local fields = {}
+        for _, v in tuple:pairs() do
+            table.insert(fields, v)
+        end
+        t.assert_equals(fields, {1, str})
+        t.assert_equals(box.execute([[SELECT "str" FROM "test"]]).rows,
+                        {{str}})
+        t.assert_equals(box.execute([[SELECT LENGTH("str") FROM "test"]]).rows,
+                        {{#str}})
+    end)
+    -- Raw IPROTO responses carry decompressed values.
+    g.server:exec(function()
+        box.schema.user.grant('guest', 'super', nil, nil,
+                              {if_not_exists = true})
+    end)
+    local conn = g.server.net_box
+    conn:reload_schema()
+    local ibuf = require('buffer').ibuf()
+    conn.space.test:select({}, {buffer = ibuf, skip_header = true})
+    t.assert_gt(ibuf.wpos - ibuf.rpos, 4000)
+    ibuf:recycle()
+    conn:call('box.space.test:get', {1}, {buffer = ibuf, skip_header = true})
+    t.assert_gt(ibuf.wpos - ibuf.rpos, 4000)
+    ibuf:recycle()
+    g.server:exec(function()
+        box.schema.user.revoke('guest', 'super')
+    end)
+end
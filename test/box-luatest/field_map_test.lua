@@ -0,0 +1,51 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group('field_map', {{engine = 'memtx'}, {engine = 'vinyl'}})
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:stop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_field_map = function(cg)
+    cg.server:exec(function(engine)
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = engine})
+        s:format({{'a', 'unsigned'}, {'b', 'string'},
+                  {'c', 'unsigned', is_nullable = true}, {'d', 'any'},
+                  {'e', 'unsigned'}, {'f', 'any', is_nullable = true}})
+        s:create_index('pk')
+        s:create_index('sk', {parts = {{3, 'unsigned', is_nullable = true}},
+                              unique = false})
+        t.assert_error_msg_content_equals(
+            "Tuple field 5 (e) required by space format is missing",
+            s.insert, s, {1, 'x', 1, 1})
+        t.assert_error_msg_content_equals(
+            "Tuple field 2 (b) type does not match one required by " ..
+            "operation: expected string, got unsigned",
+            s.insert, s, {1, 2})
+        local tail = {}
+        for i = 1, 100 do
+            tail[i] = i
+        end
+        s:insert({1, 'x', 10, 1, 1, unpack(tail)})
+        s:insert({2, 'y', box.NULL, 1, 1})
+        s:insert({3, 'z', 5, {1, 2}, 1})
+        t.assert_equals(s.index.sk:select({5}), {{3, 'z', 5, {1, 2}, 1}})
+        t.assert_equals(#s.index.sk:select({10})[1], 105)
+        t.assert_equals(s.index.sk:select({box.NULL}, {limit = 1}),
+                        {{2, 'y', box.NULL, 1, 1}})
+    end, {cg.params.engine})
+end
@@ -0,0 +1,98 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group('index_aggregate', {{engine = 'memtx'}, {engine = 'vinyl'}})
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:stop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_aggregate = function(cg)
+    cg.server:exec(function(engine)
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = engine})
+        s:format({{'id', 'unsigned'}, {'grp', 'unsigned'},
+                  {'val', 'number', is_nullable = true}})
+        s:create_index('pk')
+        s:create_index('grp', {parts = {'grp'}, unique = false})
+        t.assert_equals(s:aggregate('val'), {count = 0})
+        for i = 1, 100 do
+            s:insert({i, i % 3, i - 50})
+        end
+        s:insert({101, 0, box.NULL})
+        s:insert({102, 0})
+        t.assert_equals(s:aggregate('val'),
+                        {count = 100, sum = 50, min = -49, max = 50})
+        t.assert_equals(s:aggregate(3, {10}, {iterator = 'le'}),
+                        {count = 10, sum = -445, min = -49, max = -40})
+        t.assert_equals(s.index.grp:aggregate('id', 1),
+                        {count = 34, sum = 1717, min = 1, max = 100})
+        s:replace({1, 1, 0.5})
+        t.assert_equals(s.index.grp:aggregate('val', 1),
+                        {count = 34, sum = 66.5, min = -46, max = 50})
+        -- Integer overflow switches the result to floating point.
+        s:replace({2, 2, 2^62})
+        s:replace({5, 2, 2^62})
+        local res = s.index.grp:aggregate('val', 2)
+        t.assert_equals(res.count, 33)
+        t.assert_equals(type(res.sum), 'number')
+        t.assert_almost_equals(res.sum, 2^63, 1e6)
+        s:insert({103, 0, box.NULL, 'x'})
+        t.assert_error_msg_content_equals(
+            "Tuple field 4 type does not match one required by operation: " ..
+            "expected number, got string",
+            s.index.grp.aggregate, s.index.grp, 4)
+        t.assert_error_msg_content_equals(
+            "Field 'foo' was not found in space 'test' format",
+            s.aggregate, s, 'foo')
+    end, {cg.params.engine})
+end
+
+g.test_aggregate_decimal = function(cg)
+    cg.server:exec(function(engine)
+        local t = require('luatest')
+        local decimal = require('decimal')
+        local s = box.schema.space.create('test', {engine = engine})
+        s:format({{'id', 'unsigned'}, {'val', 'number'}})
+        s:create_index('pk')
+        s:insert({1, 10})
+        s:insert({2, decimal.new('0.1')})
+        s:insert({3, -2})
+        s:insert({4, decimal.new('100.25')})
+        s:insert({5, 0.5})
+        local res = s:aggregate('val')
+        t.assert_equals(res.count, 5)
+        t.assert(decimal.is_decimal(res.sum))
+        t.assert_equals(res.sum, decimal.new('108.85'))
+        t.assert_equals(res.min, decimal.new(-2))
+        t.assert_equals(res.max, decimal.new('100.25'))
+        -- Values accounted before the first decimal are converted.
+        res = s:aggregate('val', {2}, {iterator = 'le'})
+        t.assert_equals(res, {count = 2, sum = decimal.new('10.1'),
+                              min = decimal.new('0.1'),
+                              max = decimal.new(10)})
+        res = s:aggregate('val', {3}, {iterator = 'ge'})
+        t.assert_equals(res, {count = 3, sum = decimal.new('98.75'),
+                              min = decimal.new(-2),
+                              max = decimal.new('100.25')})
+        -- Uuid is an extension but not a number.
+        s:format({{'id', 'unsigned'}, {'val', 'any'}})
+        s:insert({6, require('uuid').new()})
+        t.assert_error_msg_content_equals(
+            "Tuple field 2 type does not match one required by operation: " ..
+            "expected number, got extension",
+            s.aggregate, s, 'val')
+    end, {cg.params.engine})
+end
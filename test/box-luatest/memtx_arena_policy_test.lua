@@ -0,0 +1,40 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all = function()
+    g.server = server:new({
+        alias = 'master',
+        box_cfg = {memtx_use_huge_pages = true, memtx_numa_node = 0},
+    })
+    g.server:start()
+end
+
+g.after_all = function()
+    g.server:stop()
+end
+
+g.test_arena_policy = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.cfg.memtx_use_huge_pages, true)
+        t.assert_equals(box.cfg.memtx_numa_node, 0)
+        t.assert_error_msg_content_equals(
+            "Can't set option 'memtx_numa_node' dynamically",
+            box.cfg, {memtx_numa_node = 1})
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        for i = 1, 1000 do
+            s:insert({i, string.rep('x', 1000)})
+        end
+        -- Huge page coverage is reported if the kernel accepted
+        -- the advice (transparent huge pages may be disabled).
+        t.assert_equals(box.slab.info().arena_huge_pages_size, nil)
+        local size = box.slab.huge_pages_size()
+        if size ~= nil then
+            t.assert_ge(size, 0)
+            t.assert_le(size, box.slab.info().arena_size)
+        end
+        s:drop()
+    end)
+end
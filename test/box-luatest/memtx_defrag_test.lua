@@ -0,0 +1,103 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all = function()
+    g.server = server:new({alias = 'master'})
+    g.server:start()
+end
+
+g.after_all = function()
+    g.server:stop()
+end
+
+g.after_each(function()
+    g.server:exec(function()
+        box.cfg({memtx_defrag_ratio = 0})
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_defrag_cfg = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.cfg.memtx_defrag_ratio, 0)
+        local msg = "Incorrect value for option 'memtx_defrag_ratio': " ..
+                    "the value must be greater than or equal to 0 " ..
+                    "and less than 1"
+        t.assert_error_msg_content_equals(msg, box.cfg,
+                                          {memtx_defrag_ratio = -0.1})
+        t.assert_error_msg_content_equals(msg, box.cfg,
+                                          {memtx_defrag_ratio = 1})
+        box.cfg({memtx_defrag_ratio = 0.5})
+        t.assert_equals(box.cfg.memtx_defrag_ratio, 0.5)
+    end)
+end
+
+g.test_defrag = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:create_index('sk', {parts = {2, 'string'}})
+        local function data(i)
+            return string.format('%08d', i) .. string.rep('x', 200)
+        end
+        for i = 1, 20000 do
+            s:insert({i, data(i)})
+        end
+        -- Leave every slab sparsely filled.
+        for i = 1, 20000 do
+            if i % 10 ~= 0 then
+                s:delete(i)
+            end
+        end
+        -- A tuple referenced from Lua must not be moved.
+        local pinned = s:get(20000)
+        local items_size = box.slab.info().items_size
+        box.cfg({memtx_defrag_ratio = 0.9})
+        t.helpers.retrying({}, function()
+            t.assert_lt(box.slab.info().items_size, items_size / 2)
+        end)
+        t.assert_equals(s:count(), 2000)
+        for i = 10, 20000, 10 do
+            t.assert_equals(s:get(i), {i, data(i)})
+            t.assert_equals(s.index.sk:get(data(i)), {i, data(i)})
+        end
+        t.assert_equals(pinned, {20000, data(20000)})
+        t.assert_equals(s.index.sk:select({}, {limit = 1}), {{10, data(10)}})
+    end)
+end
+
+-- The defragmentation fiber yields between batches, so the space it
+-- walks may be recreated with a different primary key meanwhile.
+g.test_defrag_ddl = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local fiber = require('fiber')
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        local id = s.id
+        for i = 1, 20000 do
+            s:insert({i, string.rep('x', 200)})
+        end
+        for i = 1, 20000 do
+            if i % 10 ~= 0 then
+                s:delete(i)
+            end
+        end
+        box.cfg({memtx_defrag_ratio = 0.9})
+        fiber.yield()
+        s:drop()
+        s = box.schema.space.create('test', {id = id})
+        s:create_index('pk', {parts = {1, 'string'}})
+        for i = 1, 1000 do
+            s:insert({tostring(i), string.rep('x', 200)})
+        end
+        fiber.sleep(0.1)
+        t.assert_equals(s:count(), 1000)
+        t.assert_equals(s:get('1'), {'1', string.rep('x', 200)})
+    end)
+end
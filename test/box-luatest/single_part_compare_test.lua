@@ -0,0 +1,98 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all = function()
+    g.server = server:new({alias = 'master'})
+    g.server:start()
+end
+
+g.after_all = function()
+    g.server:stop()
+end
+
+g.after_each(function()
+    g.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_order = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local decimal = require('decimal')
+        local uuid = require('uuid')
+        local datetime = require('datetime')
+        local cases = {
+            {'boolean', {false, true}},
+            {'unsigned', {0, 1, 100, 2^40}},
+            {'integer', {-2^40, -1, 0, 1, 2^40}},
+            {'number', {-1.5, -1, 0, 0.5, 1, 2^40}},
+            {'double', {-1.5, 0.5, 1.25, 100.5}},
+            {'string', {'', 'a', 'ab', 'b'}},
+            {'scalar', {false, true, -1, 0.5, 10, '', 'a'}},
+            {'decimal', {decimal.new('-1.5'), decimal.new(0),
+                         decimal.new('0.001'), decimal.new(10)}},
+            {'uuid', {uuid.fromstr('00000000-0000-0000-0000-000000000001'),
+                      uuid.fromstr('10000000-0000-0000-0000-000000000000'),
+                      uuid.fromstr('f0000000-0000-0000-0000-000000000000')}},
+            {'datetime', {datetime.new({year = 1970}),
+                          datetime.new({year = 2000}),
+                          datetime.new({year = 2022, nsec = 1})}},
+        }
+        for _, engine in ipairs({'memtx', 'vinyl'}) do
+            for _, case in ipairs(cases) do
+                local type, values = case[1], case[2]
+                local s = box.schema.space.create('test', {engine = engine})
+                s:create_index('pk', {parts = {1, type}})
+                for i = #values, 1, -1 do
+                    s:insert({values[i], i})
+                end
+                local res = s:select({}, {iterator = 'ge'})
+                t.assert_equals(#res, #values, type)
+                for i, tuple in ipairs(res) do
+                    t.assert_equals(tuple[2], i, type)
+                end
+                for i, v in ipairs(values) do
+                    t.assert_equals(s:get(v)[2], i, type)
+                    t.assert_equals(s:count(v, {iterator = 'lt'}), i - 1,
+                                    type)
+                end
+                s:drop()
+            end
+        end
+    end)
+end
+
+g.test_nullable_collation = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local key_def = require('key_def')
+        local def = key_def.new({{fieldno = 1, type = 'string',
+                                  collation = 'unicode_ci',
+                                  is_nullable = true}})
+        t.assert_equals(def:compare({'a'}, {'A'}), 0)
+        t.assert_equals(def:compare({'a'}, {'B'}), -1)
+        t.assert_equals(def:compare({box.NULL}, {'a'}), -1)
+        t.assert_equals(def:compare({}, {box.NULL}), 0)
+        t.assert_equals(def:compare({'b'}, {}), 1)
+        t.assert_equals(def:compare_with_key({'A'}, {'a'}), 0)
+        t.assert_equals(def:compare_with_key({}, {box.NULL}), 0)
+        t.assert_equals(def:compare_with_key({'b'}, {'a'}), 1)
+
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:create_index('sk', {parts = {{2, 'string', collation = 'unicode_ci',
+                                        is_nullable = true}},
+                              unique = false})
+        s:insert({1, 'b'})
+        s:insert({2})
+        s:insert({3, 'A'})
+        s:insert({4, box.NULL})
+        t.assert_equals(s.index.sk:select({}, {iterator = 'ge'}),
+                        {{2}, {4, box.NULL}, {3, 'A'}, {1, 'b'}})
+        t.assert_equals(s.index.sk:select('a'), {{3, 'A'}})
+    end)
+end
@@ -0,0 +1,140 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all = function()
+    g.server = server:new({alias = 'master'})
+    g.server:start()
+end
+
+g.after_all = function()
+    g.server:stop()
+end
+
+g.after_each(function()
+    g.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+        if box.func.test_func ~= nil then
+            box.func.test_func:drop()
+        end
+    end)
+end)
+
+-- Tree elements are compared by hints whenever hints differ, so
+-- check that a hinted index orders values that are hard to tell apart
+-- by hints the same way as an index without hints, both when the
+-- index is built and when tuples are inserted into it one by one.
+g.test_hint_order = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local ffi = require('ffi')
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        local values = {
+            box.NULL, false, true,
+            -2^63, -2^53 - 1, -2^53, -1.5, -1, -0.5, 0, 0.5, 1, 1.5,
+            2^53, 2^53 + 1, 2^63, 18446744073709551615ULL,
+            ffi.cast('int64_t', -2^53 - 1), ffi.cast('uint64_t', 2^53 + 1),
+            '', 'a', 'aaaaaaaaaaaaaaaaaaaa', 'aaaaaaaaaaaaaaaaaaab', 'b',
+            require('decimal').new('1.0000000000000000001'),
+            require('uuid').fromstr('00000000-0000-0000-0000-000000000001'),
+        }
+        for i, v in ipairs(values) do
+            s:insert({i, v, i % 3})
+        end
+        local parts = {{2, 'scalar', is_nullable = true}, {3, 'unsigned'}}
+        s:create_index('built_hint', {parts = parts, unique = false,
+                                      hint = true})
+        s:create_index('built_no_hint', {parts = parts, unique = false,
+                                         hint = false})
+        local function check()
+            local expected = s.index.built_no_hint:select()
+            t.assert_equals(#expected, s:count())
+            t.assert_equals(s.index.built_hint:select(), expected)
+            t.assert_equals(s.index.built_hint:select({}, {iterator = 'le'}),
+                            s.index.built_no_hint:select({},
+                                                         {iterator = 'le'}))
+            for _, v in ipairs(values) do
+                for _, it in ipairs({'eq', 'ge', 'gt', 'le', 'lt'}) do
+                    t.assert_equals(
+                        s.index.built_hint:select({v}, {iterator = it}),
+                        s.index.built_no_hint:select({v}, {iterator = it}))
+                end
+            end
+        end
+        check()
+        -- Tuples inserted into an existing index.
+        for i, v in ipairs(values) do
+            s:insert({#values + i, v, (i + 1) % 3})
+        end
+        check()
+    end)
+end
+
+-- Multikey and functional indexes store something other than
+-- comparison hints in tree elements, so they must not be ordered by
+-- hints.
+g.test_hint_order_multikey = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        box.schema.func.create('test_func', {
+            body = [[function(tuple)
+                local res = {}
+                for _, v in ipairs(tuple[2]) do
+                    table.insert(res, {-v})
+                end
+                return res
+            end]],
+            is_deterministic = true, is_sandboxed = true,
+            opts = {is_multikey = true},
+        })
+        for i = 1, 50 do
+            s:insert({i, {(i * 7) % 50, (i * 13) % 50 + 100, 300 - i}})
+        end
+        s:create_index('mk', {
+            parts = {{field = 2, path = '[*]', type = 'unsigned'}},
+            unique = false,
+        })
+        s:create_index('fk', {func = 'test_func', unique = false,
+                              parts = {{1, 'integer'}}})
+        for i = 51, 100 do
+            s:insert({i, {(i * 7) % 50, (i * 13) % 50 + 100, 300 - i}})
+        end
+        local function keys(index)
+            local res = {}
+            for _, tuple in index:pairs() do
+                table.insert(res, tuple[1])
+            end
+            return res
+        end
+        local mk = {}
+        local fk = {}
+        for _, tuple in s:pairs() do
+            for _, v in ipairs(tuple[2]) do
+                table.insert(mk, {v, tuple[1]})
+                table.insert(fk, {-v, tuple[1]})
+            end
+        end
+        local function cmp(a, b)
+            return a[1] < b[1] or (a[1] == b[1] and a[2] < b[2])
+        end
+        table.sort(mk, cmp)
+        table.sort(fk, cmp)
+        local function ids(list)
+            local res = {}
+            for _, v in ipairs(list) do
+                table.insert(res, v[2])
+            end
+            return res
+        end
+        t.assert_equals(keys(s.index.mk), ids(mk))
+        t.assert_equals(keys(s.index.fk), ids(fk))
+        t.assert_equals(#s.index.mk:select({7}), 2)
+        t.assert_equals(#s.index.fk:select({-7}), 2)
+        t.assert_equals(#s.index.mk:select({120}), 2)
+    end)
+end
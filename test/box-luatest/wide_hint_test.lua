@@ -0,0 +1,107 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all = function()
+    g.server = server:new({alias = 'master'})
+    g.server:start()
+end
+
+g.after_all = function()
+    g.server:stop()
+end
+
+g.after_each(function()
+    g.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_wide_hint_opts = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test')
+        local pk = s:create_index('pk', {wide_hint = true})
+        t.assert_equals(pk.hint, true)
+        t.assert_equals(pk.wide_hint, true)
+        pk:alter({wide_hint = false})
+        t.assert_equals(s.index.pk.wide_hint, nil)
+        t.assert_error_msg_content_equals(
+            "Can't create or modify index 'sk' in space 'test': " ..
+            "wide_hint requires hint",
+            s.create_index, s, 'sk', {hint = false, wide_hint = true})
+        t.assert_error_msg_content_equals(
+            "Can't create or modify index 'sk' in space 'test': " ..
+            "wide_hint is only reasonable with memtx tree index",
+            s.create_index, s, 'sk', {type = 'hash', wide_hint = true})
+        t.assert_error_msg_content_equals(
+            "Can't create or modify index 'sk' in space 'test': " ..
+            "multikey index can't use hints",
+            s.create_index, s, 'sk', {parts = {{field = 2, path = '[*]',
+                                                type = 'unsigned'}},
+                                      wide_hint = true})
+    end)
+end
+
+-- Compare results of a wide hint index with those of a regular one
+-- for strings sharing a long prefix and for composite keys.
+g.test_wide_hint_order = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        local parts = {
+            str = {{2, 'string'}},
+            str_ci = {{2, 'string', collation = 'unicode_ci'}},
+            composite = {{3, 'integer'}, {2, 'string'}},
+            scalar = {{4, 'scalar', is_nullable = true}, {3, 'integer'}},
+        }
+        for name, p in pairs(parts) do
+            s:create_index(name, {parts = p, unique = false})
+            s:create_index(name .. '_wide', {parts = p, unique = false,
+                                             wide_hint = true})
+        end
+        local prefix = string.rep('x', 10)
+        local scalars = {box.NULL, true, -1, 1, 1.5, prefix, 'y'}
+        for i = 1, 200 do
+            local str = prefix .. string.char(65 + i % 26) ..
+                        string.rep('z', i % 3)
+            if i % 2 == 0 then
+                str = str:lower()
+            end
+            s:insert({i, str, i % 5 - 2, scalars[i % #scalars + 1]})
+        end
+        -- Delete and reinsert some tuples to exercise lookups.
+        for i = 1, 200, 7 do
+            s:insert(s:delete(i))
+        end
+        for name, p in pairs(parts) do
+            local idx = s.index[name]
+            local wide = s.index[name .. '_wide']
+            t.assert_equals(wide:select(), idx:select(), name)
+            t.assert_equals(wide:select({}, {iterator = 'le'}),
+                            idx:select({}, {iterator = 'le'}), name)
+            for i = 1, 200, 3 do
+                local tuple = s:get(i)
+                local full_key, short_key = {}, {tuple[p[1][1]]}
+                for _, part in ipairs(p) do
+                    table.insert(full_key, tuple[part[1]])
+                end
+                for _, key in ipairs({full_key, short_key}) do
+                    for _, it in ipairs({'eq', 'ge', 'gt', 'le', 'lt'}) do
+                        local opts = {iterator = it, limit = 5}
+                        t.assert_equals(wide:select(key, opts),
+                                        idx:select(key, opts),
+                                        name .. ' ' .. it)
+                    end
+                end
+            end
+        end
+        -- Index rebuild sorts entries by wide hints too.
+        s.index.str_wide:alter({wide_hint = false})
+        s.index.str_wide:alter({wide_hint = true})
+        t.assert_equals(s.index.str_wide:select(), s.index.str:select())
+    end)
+end
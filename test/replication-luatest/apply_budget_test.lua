@@ -0,0 +1,84 @@
+local t = require('luatest')
+local cluster = require('test.luatest_helpers.cluster')
+local helpers = require('test.luatest_helpers')
+
+local g = t.group('apply_budget')
+
+g.before_each(function(cg)
+    cg.cluster = cluster:new({})
+    cg.master = cg.cluster:build_server({alias = 'master'})
+    cg.replica = cg.cluster:build_server({
+        alias = 'replica',
+        box_cfg = {
+            replication = {
+                helpers.instance_uri('master'),
+            },
+            replication_timeout = 1,
+            replication_apply_budget = 0.000001,
+            replication_anon = true,
+            read_only = true,
+        },
+    })
+    cg.cluster:add_server(cg.master)
+    cg.cluster:add_server(cg.replica)
+    cg.cluster:start()
+end)
+
+g.after_each(function(cg)
+    cg.cluster.servers = nil
+    cg.cluster:drop()
+end)
+
+g.test_cfg = function(cg)
+    cg.replica:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.cfg.replication_apply_budget, 0.000001)
+        t.assert_error_msg_content_equals(
+            "Incorrect value for option 'replication_apply_budget': " ..
+            "the value must be greater than or equal to 0",
+            box.cfg, {replication_apply_budget = -1})
+        box.cfg{replication_apply_budget = 0}
+        t.assert_equals(box.cfg.replication_apply_budget, 0)
+        box.cfg{replication_apply_budget = 0.000001}
+    end)
+end
+
+-- The applier yields between transactions once the budget is
+-- exhausted, which mustn't affect the applied data.
+g.test_apply = function(cg)
+    cg.master:exec(function()
+        local fiber = require('fiber')
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        for i = 1, 10 do
+            fiber.create(function()
+                for j = 1, 100 do
+                    s:replace({j, i})
+                    s:insert({i * 1000 + j})
+                end
+            end)
+        end
+    end)
+    t.helpers.retrying({}, function()
+        t.assert_equals(cg.master:exec(function()
+            return box.space.test:count()
+        end), 1100)
+    end)
+    local vclock = helpers:get_vclock(cg.master)
+    vclock[0] = nil
+    helpers:wait_vclock(cg.replica, vclock)
+
+    local function select_all(server)
+        return server:exec(function()
+            return box.space.test:select()
+        end)
+    end
+    t.assert_equals(select_all(cg.replica), select_all(cg.master))
+    cg.replica:exec(function()
+        local t = require('luatest')
+        local upstream = box.info.replication[1].upstream
+        t.assert_equals(upstream.status, 'follow')
+        t.assert_gt(upstream.stat.apply_time, 0)
+        t.assert_gt(upstream.stat.apply_yields, 0)
+    end)
+end
@@ -0,0 +1,97 @@
+local t = require('luatest')
+local cluster = require('test.luatest_helpers.cluster')
+local helpers = require('test.luatest_helpers')
+
+local g = t.group('cascade_forward')
+
+g.before_each(function(cg)
+    cg.cluster = cluster:new({})
+    cg.master = cg.cluster:build_server({alias = 'master'})
+    cg.hub = cg.cluster:build_server({
+        alias = 'hub',
+        box_cfg = {
+            replication = {
+                helpers.instance_uri('master'),
+            },
+            replication_timeout = 0.1,
+            read_only = true,
+        },
+    })
+    cg.replica = cg.cluster:build_server({
+        alias = 'replica',
+        box_cfg = {
+            replication = {
+                helpers.instance_uri('hub'),
+            },
+            replication_timeout = 0.1,
+            replication_anon = true,
+            read_only = true,
+        },
+    })
+    cg.cluster:add_server(cg.master)
+    cg.cluster:add_server(cg.hub)
+    cg.cluster:add_server(cg.replica)
+    cg.cluster:start()
+end)
+
+g.after_each(function(cg)
+    cg.cluster.servers = nil
+    cg.cluster:drop()
+end)
+
+local function select_all(server)
+    return server:exec(function()
+        return {box.space.test:select(), box.space.test2:select()}
+    end)
+end
+
+-- Rows received by the hub must reach the replica intact, whether
+-- the hub forwards them as they are or has to send them as NOPs.
+g.test_forward = function(cg)
+    cg.master:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        local s2 = box.schema.space.create('test2')
+        s2:create_index('pk')
+        for i = 1, 1000 do
+            s:insert({i, string.rep('x', i % 100)})
+        end
+        box.atomic(function()
+            for i = 1, 100 do
+                s:replace({i, i})
+                s2:insert({i})
+            end
+        end)
+    end)
+    cg.hub:exec(function()
+        box.cfg{read_only = false}
+        local s = box.schema.space.create('loc', {is_local = true})
+        s:create_index('pk')
+        box.atomic(function()
+            s:insert({1})
+            s:insert({2})
+        end)
+        box.cfg{read_only = true}
+    end)
+    cg.master:exec(function()
+        box.space.test:delete(1000)
+        box.space.test2:delete(1)
+    end)
+    local vclock = helpers:get_vclock(cg.master)
+    vclock[0] = nil
+    helpers:wait_vclock(cg.hub, vclock)
+    vclock = helpers:get_vclock(cg.hub)
+    vclock[0] = nil
+    helpers:wait_vclock(cg.replica, vclock)
+
+    t.assert_equals(select_all(cg.replica), select_all(cg.master))
+    cg.replica:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.space.loc:select(), {})
+        for _, r in pairs(box.info.replication) do
+            if r.upstream ~= nil then
+                t.assert_equals(r.upstream.status, 'follow')
+            end
+        end
+    end)
+end
@@ -0,0 +1,117 @@
+local t = require('luatest')
+local cluster = require('test.luatest_helpers.cluster')
+local helpers = require('test.luatest_helpers')
+
+local g = t.group('checkpoint_join')
+
+g.before_each(function(cg)
+    cg.cluster = cluster:new({})
+    cg.master = cg.cluster:build_server({alias = 'master'})
+    cg.cluster:add_server(cg.master)
+    cg.cluster:start()
+end)
+
+g.after_each(function(cg)
+    cg.cluster.servers = nil
+    cg.cluster:drop()
+end)
+
+local function start_replica(cg)
+    cg.replica = cg.cluster:build_server({
+        alias = 'replica',
+        box_cfg = {
+            replication = {
+                helpers.instance_uri('master'),
+            },
+            replication_timeout = 1,
+            replication_join_from_checkpoint = true,
+            read_only = true,
+        },
+    })
+    cg.cluster:add_server(cg.replica)
+    cg.replica:start()
+    local vclock = helpers:get_vclock(cg.master)
+    vclock[0] = nil
+    helpers:wait_vclock(cg.replica, vclock)
+end
+
+local function select_all(server)
+    return server:exec(function()
+        local result = {}
+        for _, s in box.space._space:pairs({512}, {iterator = 'ge'}) do
+            result[s.name] = box.space[s.name]:select()
+        end
+        return result
+    end)
+end
+
+-- The replica must get both the data stored in the checkpoint and
+-- the data written after it.
+g.test_join = function(cg)
+    cg.master:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        for i = 1, 100 do
+            s:insert({i, string.rep('x', i)})
+        end
+        box.snapshot()
+        for i = 101, 200 do
+            s:insert({i})
+        end
+        s:delete(1)
+        local s2 = box.schema.space.create('test2')
+        s2:create_index('pk')
+        s2:insert({1})
+    end)
+    start_replica(cg)
+    t.assert(cg.master:grep_log('sending checkpoint'))
+    t.assert(cg.replica:grep_log('receiving checkpoint'))
+    t.assert_equals(select_all(cg.replica), select_all(cg.master))
+    cg.replica:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.info.replication[1].upstream.status, 'follow')
+    end)
+end
+
+-- Vinyl data isn't stored in memtx checkpoints so the master must
+-- fall back on sending data rows.
+g.test_join_vinyl = function(cg)
+    cg.master:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk')
+        for i = 1, 100 do
+            s:insert({i})
+        end
+        box.snapshot()
+    end)
+    start_replica(cg)
+    t.assert_not(cg.master:grep_log('sending checkpoint'))
+    t.assert_equals(select_all(cg.replica), select_all(cg.master))
+end
+
+-- Data of local spaces isn't replicated so the replica must skip it
+-- when it loads the checkpoint received from the master.
+g.test_join_local = function(cg)
+    cg.master:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        local l = box.schema.space.create('loc', {is_local = true})
+        l:create_index('pk')
+        for i = 1, 10 do
+            s:insert({i})
+            l:insert({i})
+        end
+        box.snapshot()
+        l:insert({11})
+        s:insert({11})
+    end)
+    start_replica(cg)
+    t.assert(cg.master:grep_log('sending checkpoint'))
+    cg.replica:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.space.test:count(), 11)
+        t.assert(box.space.loc.is_local)
+        t.assert_equals(box.space.loc:select(), {})
+        t.assert_equals(box.info.replication[1].upstream.status, 'follow')
+    end)
+end
@@ -0,0 +1,87 @@
+local t = require('luatest')
+local cluster = require('test.luatest_helpers.cluster')
+local helpers = require('test.luatest_helpers')
+
+local g = t.group('join_streams')
+
+g.before_each(function(cg)
+    cg.cluster = cluster:new({})
+    cg.master = cg.cluster:build_server({alias = 'master'})
+    cg.cluster:add_server(cg.master)
+    cg.cluster:start()
+end)
+
+g.after_each(function(cg)
+    cg.cluster.servers = nil
+    cg.cluster:drop()
+end)
+
+local function start_replica(cg)
+    cg.replica = cg.cluster:build_server({
+        alias = 'replica',
+        box_cfg = {
+            replication = {
+                helpers.instance_uri('master'),
+            },
+            replication_timeout = 1,
+            replication_join_streams = 4,
+            read_only = true,
+        },
+    })
+    cg.cluster:add_server(cg.replica)
+    cg.replica:start()
+    local vclock = helpers:get_vclock(cg.master)
+    vclock[0] = nil
+    helpers:wait_vclock(cg.replica, vclock)
+end
+
+local function select_all(server)
+    return server:exec(function()
+        local result = {}
+        for _, s in box.space._space:pairs({512}, {iterator = 'ge'}) do
+            result[s.name] = box.space[s.name]:select()
+        end
+        return result
+    end)
+end
+
+g.test_cfg = function(cg)
+    start_replica(cg)
+    cg.replica:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.cfg.replication_join_streams, 4)
+        t.assert_error_msg_content_equals(
+            "Can't set option 'replication_join_streams' dynamically",
+            box.cfg, {replication_join_streams = 2})
+    end)
+end
+
+-- Memtx data must be split between all connections while the replica
+-- must end up with the same data as the master.
+g.test_join = function(cg)
+    cg.master:exec(function()
+        for i = 1, 3 do
+            local s = box.schema.space.create('test' .. i)
+            s:create_index('pk')
+            s:create_index('sk', {parts = {2, 'string'}, unique = false})
+            box.begin()
+            for j = 1, 5000 * i do
+                s:insert({j, string.rep('x', j % 100)})
+            end
+            box.commit()
+        end
+        local s = box.schema.space.create('test_vinyl', {engine = 'vinyl'})
+        s:create_index('pk')
+        for i = 1, 100 do
+            s:insert({i})
+        end
+    end)
+    start_replica(cg)
+    t.assert(cg.master:grep_log('sending initial data to replica'))
+    t.assert(cg.replica:grep_log('receiving initial data over 4 connections'))
+    t.assert_equals(select_all(cg.replica), select_all(cg.master))
+    cg.replica:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.info.replication[1].upstream.status, 'follow')
+    end)
+end
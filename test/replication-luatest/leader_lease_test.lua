@@ -0,0 +1,95 @@
+local t = require('luatest')
+local cluster = require('test.luatest_helpers.cluster')
+local helpers = require('test.luatest_helpers')
+
+local g = t.group('leader_lease')
+
+g.before_each(function(cg)
+    cg.cluster = cluster:new({})
+    local node1_uri = helpers.instance_uri('node1')
+    local node2_uri = helpers.instance_uri('node2')
+    local box_cfg = {
+        listen = node1_uri,
+        replication = {node1_uri, node2_uri},
+        replication_timeout = 0.1,
+        replication_synchro_quorum = 2,
+        election_mode = 'candidate',
+        election_leader_lease = true,
+    }
+    cg.node1 = cg.cluster:build_server({alias = 'node1', box_cfg = box_cfg})
+
+    box_cfg.listen = node2_uri
+    box_cfg.election_mode = 'voter'
+    cg.node2 = cg.cluster:build_server({alias = 'node2', box_cfg = box_cfg})
+
+    cg.cluster:add_server(cg.node1)
+    cg.cluster:add_server(cg.node2)
+    cg.cluster:start()
+    cg.node1:wait_election_leader()
+    cg.node1:exec(function()
+        local s = box.schema.space.create('test', {is_sync = true})
+        s:create_index('pk')
+        s:insert({1})
+    end)
+end)
+
+g.after_each(function(cg)
+    cg.cluster.servers = nil
+    cg.cluster:drop()
+end)
+
+g.test_cfg = function(cg)
+    cg.node1:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.cfg.election_leader_lease, true)
+        t.assert_error_msg_content_equals(
+            "Incorrect value for option 'election_leader_lease': " ..
+            "should be of type boolean",
+            box.cfg, {election_leader_lease = 1})
+    end)
+end
+
+-- Only the leader holding the lease may serve linearizable reads.
+g.test_read = function(cg)
+    cg.node1:exec(function()
+        local t = require('luatest')
+        t.helpers.retrying({}, function()
+            t.assert(box.info.election.lease)
+        end)
+        local s = box.space.test
+        t.assert_equals(s:select({}, {linearizable = true}), {{1}})
+        t.assert_equals(s.index.pk:select({1}, {linearizable = true}), {{1}})
+    end)
+    cg.node2:exec(function()
+        local t = require('luatest')
+        t.assert_not(box.info.election.lease)
+        t.assert_error_msg_content_equals(
+            "The instance doesn't hold the leader lease",
+            box.space.test.select, box.space.test, {}, {linearizable = true})
+        -- Regular reads are still allowed.
+        t.assert_equals(box.space.test:select(), {{1}})
+    end)
+end
+
+-- The leader loses the lease when it stops getting acks from the
+-- quorum and regains it once the quorum is back.
+g.test_expire = function(cg)
+    cg.node1:exec(function()
+        local t = require('luatest')
+        t.helpers.retrying({}, function()
+            t.assert(box.info.election.lease)
+        end)
+    end)
+    cg.node2:stop()
+    cg.node1:exec(function()
+        local t = require('luatest')
+        t.helpers.retrying({}, function()
+            t.assert_not(box.info.election.lease)
+        end)
+        t.assert_error_msg_content_equals(
+            "The instance doesn't hold the leader lease",
+            box.space.test.select, box.space.test, {}, {linearizable = true})
+        box.cfg{election_leader_lease = false}
+        t.assert_not(box.info.election.lease)
+    end)
+end
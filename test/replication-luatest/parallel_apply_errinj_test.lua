@@ -0,0 +1,111 @@
+local t = require('luatest')
+local cluster = require('test.luatest_helpers.cluster')
+local helpers = require('test.luatest_helpers')
+
+local g = t.group('parallel_apply_errinj')
+
+g.before_each(function(cg)
+    cg.cluster = cluster:new({})
+
+    local box_cfg = {
+        replication_timeout = 1,
+    }
+    cg.master = cg.cluster:build_server({alias = 'master', engine = 'vinyl',
+                                         box_cfg = box_cfg})
+
+    box_cfg = {
+        replication = {
+            helpers.instance_uri('master'),
+        },
+        replication_timeout = 1,
+        replication_parallel_apply = 8,
+        vinyl_cache = 0,
+        read_only = true,
+    }
+    cg.replica = cg.cluster:build_server({alias = 'replica', engine = 'vinyl',
+                                          box_cfg = box_cfg})
+
+    cg.cluster:add_server(cg.master)
+    cg.cluster:add_server(cg.replica)
+    cg.cluster:start()
+end)
+
+g.after_each(function(cg)
+    cg.cluster.servers = nil
+    cg.cluster:drop()
+end)
+
+local function wait_sync(cg)
+    local vclock = helpers:get_vclock(cg.master)
+    vclock[0] = nil
+    helpers:wait_vclock(cg.replica, vclock)
+end
+
+-- Vinyl transactions yielding on disk reads must be applied
+-- concurrently while transactions updating the same keys must
+-- still be applied one after another.
+g.test_vinyl_conflicts = function(cg)
+    cg.master:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk')
+        for i = 1, 20 do
+            s:insert({i, 0})
+        end
+    end)
+    wait_sync(cg)
+    cg.replica:exec(function()
+        local fiber = require('fiber')
+        -- Make updates read the data from disk slowly.
+        box.snapshot()
+        box.error.injection.set('ERRINJ_VY_READ_PAGE_TIMEOUT', 0.01)
+        rawset(_G, 'max_apply_fibers', 0)
+        rawset(_G, 'watcher', fiber.new(function()
+            while true do
+                local count = 0
+                for _, f in pairs(fiber.info()) do
+                    if f.name == 'applier_apply' then
+                        count = count + 1
+                    end
+                end
+                _G.max_apply_fibers = math.max(_G.max_apply_fibers, count)
+                fiber.sleep(0.001)
+            end
+        end))
+    end)
+    cg.master:exec(function()
+        local fiber = require('fiber')
+        local s = box.space.test
+        local fibers = {}
+        for i = 1, 10 do
+            local f = fiber.new(function()
+                for j = 1, 20 do
+                    s:update((i + j) % 20 + 1, {{'+', 2, 1}})
+                end
+            end)
+            f:set_joinable(true)
+            table.insert(fibers, f)
+        end
+        for _, f in ipairs(fibers) do
+            f:join()
+        end
+    end)
+    wait_sync(cg)
+    cg.replica:exec(function()
+        local t = require('luatest')
+        _G.watcher:cancel()
+        box.error.injection.set('ERRINJ_VY_READ_PAGE_TIMEOUT', 0)
+        t.assert_gt(_G.max_apply_fibers, 1)
+        t.assert_equals(box.info.replication[1].upstream.status, 'follow')
+        local sum = 0
+        for _, tuple in box.space.test:pairs() do
+            sum = sum + tuple[2]
+        end
+        t.assert_equals(sum, 200)
+    end)
+    local function select_all(server)
+        return server:exec(function()
+            return box.space.test:select()
+        end)
+    end
+    t.assert_equals(select_all(cg.replica), select_all(cg.master))
+end
@@ -0,0 +1,153 @@
+local t = require('luatest')
+local cluster = require('test.luatest_helpers.cluster')
+local helpers = require('test.luatest_helpers')
+
+local g = t.group('parallel_apply', {{engine = 'memtx'}, {engine = 'vinyl'}})
+
+g.before_each(function(cg)
+    local engine = cg.params.engine
+
+    cg.cluster = cluster:new({})
+
+    local box_cfg = {
+        replication_timeout = 1,
+    }
+    cg.master = cg.cluster:build_server({alias = 'master', engine = engine,
+                                         box_cfg = box_cfg})
+
+    box_cfg = {
+        replication = {
+            helpers.instance_uri('master'),
+        },
+        replication_timeout = 1,
+        replication_parallel_apply = 8,
+        read_only = true,
+    }
+    cg.replica = cg.cluster:build_server({alias = 'replica', engine = engine,
+                                          box_cfg = box_cfg})
+
+    cg.cluster:add_server(cg.master)
+    cg.cluster:add_server(cg.replica)
+    cg.cluster:start()
+end)
+
+g.after_each(function(cg)
+    cg.cluster.servers = nil
+    cg.cluster:drop()
+end)
+
+g.test_cfg = function(cg)
+    cg.replica:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.cfg.replication_parallel_apply, 8)
+        t.assert_error_msg_content_equals(
+            "Incorrect value for option 'replication_parallel_apply': " ..
+            "must be greater than 0, less than or equal to 1000",
+            box.cfg, {replication_parallel_apply = 0})
+        box.cfg{replication_parallel_apply = 1}
+        t.assert_equals(box.cfg.replication_parallel_apply, 1)
+        box.cfg{replication_parallel_apply = 8}
+    end)
+end
+
+-- Concurrent transactions modifying overlapping keys of spaces with
+-- and without secondary unique indexes must be applied on the replica
+-- with the same result as on the master.
+g.test_apply = function(cg)
+    cg.master:exec(function(engine)
+        local s1 = box.schema.space.create('test1', {engine = engine})
+        s1:create_index('pk')
+        s1:create_index('sk', {parts = {2, 'unsigned'}, unique = false})
+        local s2 = box.schema.space.create('test2', {engine = engine})
+        s2:create_index('pk')
+        s2:create_index('sk', {parts = {2, 'unsigned'}})
+    end, {cg.params.engine})
+    cg.master:exec(function()
+        local fiber = require('fiber')
+        local s1 = box.space.test1
+        local s2 = box.space.test2
+        local fibers = {}
+        for i = 1, 10 do
+            local f = fiber.new(function()
+                for j = 1, 100 do
+                    local k = (i * 7 + j) % 50
+                    -- Vinyl may abort conflicting transactions, which
+                    -- is fine as long as the replica gets the same data.
+                    pcall(box.atomic, function()
+                        s1:replace({k, i * j})
+                        s1:upsert({k + 100, 1}, {{'+', 2, 1}})
+                    end)
+                    if j % 3 == 0 then
+                        pcall(s1.delete, s1, k)
+                    end
+                    pcall(s2.replace, s2, {k, i * 1000 + j})
+                    pcall(s2.update, s2, k, {{'=', 2, 100000 + i * 1000 + j}})
+                end
+            end)
+            f:set_joinable(true)
+            table.insert(fibers, f)
+        end
+        for _, f in ipairs(fibers) do
+            f:join()
+        end
+    end)
+    local vclock = helpers:get_vclock(cg.master)
+    vclock[0] = nil
+    helpers:wait_vclock(cg.replica, vclock)
+
+    local function select_all(server)
+        return server:exec(function()
+            return {box.space.test1:select(), box.space.test2:select()}
+        end)
+    end
+    t.assert_equals(select_all(cg.replica), select_all(cg.master))
+    cg.replica:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.info.replication[1].upstream.status, 'follow')
+    end)
+end
+
+-- Transactions applied in parallel must be executed in the applier
+-- session, like the ones applied sequentially.
+g.test_session_type = function(cg)
+    cg.master:exec(function(engine)
+        local s = box.schema.space.create('test', {engine = engine})
+        s:create_index('pk')
+    end, {cg.params.engine})
+    local vclock = helpers:get_vclock(cg.master)
+    vclock[0] = nil
+    helpers:wait_vclock(cg.replica, vclock)
+    cg.replica:exec(function()
+        rawset(_G, 'session_types', {})
+        box.space.test:on_replace(function()
+            local types = _G.session_types
+            local type = box.session.type()
+            types[type] = (types[type] or 0) + 1
+        end)
+    end)
+    cg.master:exec(function()
+        local fiber = require('fiber')
+        local s = box.space.test
+        local fibers = {}
+        for i = 1, 10 do
+            local f = fiber.new(function()
+                for j = 1, 100 do
+                    s:replace({i * 1000 + j})
+                end
+            end)
+            f:set_joinable(true)
+            table.insert(fibers, f)
+        end
+        for _, f in ipairs(fibers) do
+            f:join()
+        end
+    end)
+    vclock = helpers:get_vclock(cg.master)
+    vclock[0] = nil
+    helpers:wait_vclock(cg.replica, vclock)
+    cg.replica:exec(function()
+        local t = require('luatest')
+        t.assert_equals(_G.session_types, {applier = 1000})
+        t.assert_equals(box.space.test:count(), 1000)
+    end)
+end
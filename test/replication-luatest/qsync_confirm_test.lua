@@ -0,0 +1,70 @@
+local t = require('luatest')
+local cluster = require('test.luatest_helpers.cluster')
+local helpers = require('test.luatest_helpers')
+
+local g = t.group('qsync_confirm')
+
+g.before_each(function(cg)
+    cg.cluster = cluster:new({})
+
+    local box_cfg = {
+        replication_synchro_quorum = 2,
+        replication_synchro_timeout = 30,
+        replication_timeout = 1,
+    }
+    cg.master = cg.cluster:build_server({alias = 'master', box_cfg = box_cfg})
+
+    box_cfg = {
+        replication = {
+            helpers.instance_uri('master'),
+        },
+        replication_timeout = 1,
+        read_only = true,
+    }
+    cg.replica = cg.cluster:build_server({alias = 'replica',
+                                          box_cfg = box_cfg})
+
+    cg.cluster:add_server(cg.master)
+    cg.cluster:add_server(cg.replica)
+    cg.cluster:start()
+end)
+
+g.after_each(function(cg)
+    cg.cluster.servers = nil
+    cg.cluster:drop()
+end)
+
+-- Transactions gathering quorum at the same time must be confirmed
+-- with fewer CONFIRM entries than there are transactions.
+g.test_confirm_batch = function(cg)
+    cg.master:exec(function()
+        local fiber = require('fiber')
+        local t = require('luatest')
+        box.schema.space.create('sync', {is_sync = true})
+        box.space.sync:create_index('pk')
+        box.ctl.promote()
+        local count = box.info.synchro.queue.confirm.count
+        local fibers = {}
+        for i = 1, 100 do
+            local f = fiber.new(box.space.sync.insert, box.space.sync, {i})
+            f:set_joinable(true)
+            table.insert(fibers, f)
+        end
+        for _, f in ipairs(fibers) do
+            t.assert(f:join())
+        end
+        local queue = box.info.synchro.queue
+        t.assert_equals(queue.len, 0)
+        t.assert_gt(queue.confirm.count, count)
+        t.assert_lt(queue.confirm.count, count + 100)
+        t.assert_gt(queue.confirm.latency.p50, 0)
+        t.assert_gt(queue.latency.p99, 0)
+        t.assert_ge(queue.latency.p99, queue.latency.p50)
+    end)
+    local vclock = helpers:get_vclock(cg.master)
+    vclock[0] = nil
+    helpers:wait_vclock(cg.replica, vclock)
+    t.assert_equals(cg.replica:exec(function()
+        return box.space.sync:count()
+    end), 100)
+end
@@ -0,0 +1,70 @@
+local t = require('luatest')
+local cluster = require('test.luatest_helpers.cluster')
+local helpers = require('test.luatest_helpers')
+
+local g = t.group('replication_stat')
+
+g.before_each(function(cg)
+    cg.cluster = cluster:new({})
+    cg.master = cg.cluster:build_server({alias = 'master'})
+    cg.replica = cg.cluster:build_server({
+        alias = 'replica',
+        box_cfg = {
+            replication = {
+                helpers.instance_uri('master'),
+            },
+            replication_timeout = 0.1,
+            read_only = true,
+        },
+    })
+    cg.cluster:add_server(cg.master)
+    cg.cluster:add_server(cg.replica)
+    cg.cluster:start()
+end)
+
+g.after_each(function(cg)
+    cg.cluster.servers = nil
+    cg.cluster:drop()
+end)
+
+local function check_percentiles(hist)
+    t.assert_type(hist, 'table')
+    for _, pct in ipairs({'p50', 'p75', 'p90', 'p95', 'p99'}) do
+        t.assert_type(hist[pct], 'number')
+    end
+    t.assert_le(hist.p50, hist.p99)
+end
+
+g.test_stat = function(cg)
+    cg.master:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        for i = 1, 100 do
+            s:insert({i, string.rep('x', 100)})
+        end
+    end)
+    local vclock = helpers:get_vclock(cg.master)
+    vclock[0] = nil
+    helpers:wait_vclock(cg.replica, vclock)
+
+    local upstream = cg.replica:exec(function()
+        return box.info.replication[1].upstream.stat
+    end)
+    check_percentiles(upstream.lag)
+    check_percentiles(upstream.apply_lag)
+    check_percentiles(upstream.queue)
+    t.assert_ge(upstream.queue.p99, 1)
+    t.assert_ge(upstream.rows.total, 100)
+    t.assert_ge(upstream.bytes.total, 100 * 100)
+    t.assert_type(upstream.rows.rps, 'number')
+    t.assert_type(upstream.bytes.rps, 'number')
+
+    t.helpers.retrying({}, function()
+        local downstream = cg.master:exec(function()
+            return box.info.replication[2].downstream.stat
+        end)
+        check_percentiles(downstream.lag)
+        t.assert_ge(downstream.rows.total, 100)
+        t.assert_ge(downstream.bytes.total, 100 * 100)
+    end)
+end
@@ -0,0 +1,139 @@
+local t = require('luatest')
+local cluster = require('test.luatest_helpers.cluster')
+local helpers = require('test.luatest_helpers')
+
+local g = t.group('space_filter')
+
+g.before_each(function(cg)
+    cg.cluster = cluster:new({})
+
+    local box_cfg = {
+        replication_timeout = 1,
+    }
+    cg.master = cg.cluster:build_server({alias = 'master', box_cfg = box_cfg})
+
+    box_cfg = {
+        replication = {
+            helpers.instance_uri('master'),
+        },
+        replication_timeout = 1,
+        replication_space_filter = {600, 602},
+        read_only = true,
+    }
+    cg.replica = cg.cluster:build_server({alias = 'replica',
+                                          box_cfg = box_cfg})
+
+    cg.cluster:add_server(cg.master)
+    cg.cluster:add_server(cg.replica)
+    cg.cluster:start()
+end)
+
+g.after_each(function(cg)
+    cg.cluster.servers = nil
+    cg.cluster:drop()
+end)
+
+g.test_cfg = function(cg)
+    cg.replica:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.cfg.replication_space_filter, {600, 602})
+        t.assert_error_msg_content_equals(
+            "Can't set option 'replication_space_filter' dynamically",
+            box.cfg, {replication_space_filter = 601})
+    end)
+end
+
+-- A replica that subscribed to a subset of spaces may lack data
+-- committed by the leader so it mustn't become a leader itself.
+g.test_election = function(cg)
+    cg.replica:exec(function()
+        local t = require('luatest')
+        for _, mode in ipairs({'candidate', 'manual'}) do
+            t.assert_error_msg_content_equals(
+                "Incorrect value for option 'election_mode': the value " ..
+                "must be 'off' or 'voter' when replication_space_filter " ..
+                "is set", box.cfg, {election_mode = mode})
+        end
+        box.cfg{election_mode = 'voter'}
+        t.assert_equals(box.cfg.election_mode, 'voter')
+        box.cfg{election_mode = 'off'}
+        t.assert_error_msg_content_equals(
+            "replication_space_filter does not support promotion",
+            box.ctl.promote)
+        t.assert_equals(box.info.synchro.queue.owner, 0)
+    end)
+end
+
+-- Only rows of the spaces listed in the filter must be applied on
+-- the replica, while the schema and the vclock must be the same as
+-- on the master.
+g.test_filter = function(cg)
+    cg.master:exec(function()
+        for id = 600, 602 do
+            local s = box.schema.space.create('test' .. id, {id = id})
+            s:create_index('pk')
+        end
+        for i = 1, 10 do
+            for id = 600, 602 do
+                box.space['test' .. id]:insert({i})
+            end
+        end
+        box.space.test601:delete(1)
+        box.space.test602:delete(1)
+    end)
+    local vclock = helpers:get_vclock(cg.master)
+    vclock[0] = nil
+    helpers:wait_vclock(cg.replica, vclock)
+
+    local function select_all(server)
+        return server:exec(function()
+            return {
+                box.space.test600:select(),
+                box.space.test601:select(),
+                box.space.test602:select(),
+            }
+        end)
+    end
+    local master = select_all(cg.master)
+    local replica = select_all(cg.replica)
+    t.assert_equals(replica[1], master[1])
+    t.assert_equals(replica[2], {})
+    t.assert_equals(replica[3], master[3])
+    cg.replica:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.info.replication[1].upstream.status, 'follow')
+    end)
+end
+
+-- A replica that subscribed to a subset of spaces may not store the
+-- rows of a synchronous transaction so its acks must not count.
+g.test_synchro_quorum = function(cg)
+    cg.master:exec(function()
+        local s = box.schema.space.create('test600', {id = 600,
+                                                      is_sync = true})
+        s:create_index('pk')
+        box.schema.space.create('test601', {id = 601, is_sync = true})
+        box.space.test601:create_index('pk')
+        box.ctl.promote()
+        box.cfg{replication_synchro_quorum = 2,
+                replication_synchro_timeout = 0.1}
+    end)
+    cg.master:exec(function()
+        local t = require('luatest')
+        t.assert_error_msg_content_equals(
+            'Quorum collection for a synchronous transaction is timed out',
+            box.space.test600.insert, box.space.test600, {1})
+        t.assert_error_msg_content_equals(
+            'Quorum collection for a synchronous transaction is timed out',
+            box.space.test601.insert, box.space.test601, {1})
+        box.cfg{replication_synchro_quorum = 1}
+        box.space.test600:insert({2})
+    end)
+    local vclock = helpers:get_vclock(cg.master)
+    vclock[0] = nil
+    helpers:wait_vclock(cg.replica, vclock)
+    cg.replica:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.space.test600:select(), {{2}})
+    end)
+end
@@ -0,0 +1,69 @@
+local t = require('luatest')
+local cluster = require('test.luatest_helpers.cluster')
+local helpers = require('test.luatest_helpers')
+
+local g = t.group('wal_ring')
+
+g.before_each(function(cg)
+    cg.cluster = cluster:new({})
+    local box_cfg = {
+        replication = {
+            helpers.instance_uri('server1'),
+            helpers.instance_uri('server2'),
+        },
+        replication_timeout = 0.1,
+        log_level = 6,
+    }
+    cg.server1 = cg.cluster:build_server({alias = 'server1',
+                                          box_cfg = box_cfg})
+    cg.server2 = cg.cluster:build_server({alias = 'server2',
+                                          box_cfg = box_cfg})
+    cg.cluster:add_server(cg.server1)
+    cg.cluster:add_server(cg.server2)
+    cg.cluster:start()
+end)
+
+g.after_each(function(cg)
+    cg.cluster.servers = nil
+    cg.cluster:drop()
+end)
+
+local function wait_sync(src, dst)
+    local vclock = helpers:get_vclock(src)
+    vclock[0] = nil
+    helpers:wait_vclock(dst, vclock)
+end
+
+-- Component 0 of the master and the own component of the replica
+-- mustn't prevent the relay from reading rows from the WAL ring
+-- when both masters write.
+g.test_master_master = function(cg)
+    cg.server1:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        local l = box.schema.space.create('loc', {is_local = true})
+        l:create_index('pk')
+        for i = 1, 10 do
+            l:insert({i})
+        end
+    end)
+    wait_sync(cg.server1, cg.server2)
+    -- The ring is reset to the vclock recovered on restart, which
+    -- has component 0 set.
+    cg.server1:restart()
+    for i = 1, 10 do
+        cg.server1:exec(function(i) box.space.test:insert({i}) end, {i})
+        cg.server2:exec(function(i) box.space.test:insert({i + 10}) end,
+                        {i})
+    end
+    wait_sync(cg.server1, cg.server2)
+    wait_sync(cg.server2, cg.server1)
+    t.assert(cg.server1:grep_log('relay caught up with the WAL ring'))
+    t.assert(cg.server2:grep_log('relay caught up with the WAL ring'))
+    for _, server in ipairs({cg.server1, cg.server2}) do
+        server:exec(function()
+            local t = require('luatest')
+            t.assert_equals(box.space.test:count(), 20)
+        end)
+    end
+end
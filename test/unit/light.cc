@@ -186,6 +186,32 @@ collision_test()
 	footer();
 }
 
+static void
+locality_test()
+{
+	header();
+
+	struct light_core ht;
+	light_create(&ht, light_extent_size,
+		     my_light_alloc, my_light_free, &extents_count, 0);
+	/*
+	 * Values 4 and 12 collide in slot 4 while the first empty
+	 * record is in slot 1. The collided value must be placed
+	 * next to the head of its chain.
+	 */
+	light_insert(&ht, 0, 0);
+	light_insert(&ht, 4, 4);
+	light_insert(&ht, 12, 12);
+	hash_t slot = light_find(&ht, 12, 12);
+	if (slot == light_end || slot / 4 != 4 / 4)
+		fail("collided value is placed far from its chain", "true");
+	if (light_selfcheck(&ht))
+		fail("internal test failed!", "true");
+	light_destroy(&ht);
+
+	footer();
+}
+
 static void
 iterator_test()
 {
@@ -323,6 +349,7 @@ main(int, const char**)
 	srand(time(0));
 	simple_test();
 	collision_test();
+	locality_test();
 	iterator_test();
 	iterator_freeze_check();
 	if (extents_count != 0)
@@ -1860,10 +1860,134 @@ raft_test_split_vote(void)
 	raft_finish_test();
 }
 
+static void
+raft_test_leader_lease_vote(void)
+{
+	raft_start_test(5);
+	struct raft_node node;
+	raft_node_create(&node);
+	raft_node_cfg_is_lease_enabled(&node, true);
+
+	is(raft_node_send_leader(&node,
+		2 /* Term. */,
+		2 /* Source. */
+	), 0, "leader notification");
+
+	/* The leader may hold a lease, a new term can't be started. */
+
+	raft_run_for(node.cfg_death_timeout / 2);
+	is(raft_node_send_vote_request(&node,
+		3 /* Term. */,
+		"{}" /* Vclock. */,
+		3 /* Source. */
+	), 0, "vote request from 3");
+	ok(raft_node_check_full_state(&node,
+		RAFT_STATE_FOLLOWER /* State. */,
+		2 /* Leader. */,
+		2 /* Term. */,
+		0 /* Vote. */,
+		2 /* Volatile term. */,
+		0 /* Volatile vote. */,
+		"{0: 1}" /* Vclock. */
+	), "vote request is ignored while the leader is alive");
+
+	/* Without the lease the vote is granted. */
+
+	raft_node_cfg_is_lease_enabled(&node, false);
+	is(raft_node_send_vote_request(&node,
+		3 /* Term. */,
+		"{}" /* Vclock. */,
+		3 /* Source. */
+	), 0, "vote request from 3");
+	ok(raft_node_check_full_state(&node,
+		RAFT_STATE_FOLLOWER /* State. */,
+		0 /* Leader. */,
+		3 /* Term. */,
+		3 /* Vote. */,
+		3 /* Volatile term. */,
+		3 /* Volatile vote. */,
+		"{0: 2}" /* Vclock. */
+	), "voted for 3 when the lease is disabled");
+
+	raft_node_destroy(&node);
+	raft_finish_test();
+}
+
+static void
+raft_test_leader_lease(void)
+{
+	raft_start_test(13);
+	struct raft_node node;
+	raft_node_create(&node);
+	raft_node_cfg_is_lease_enabled(&node, true);
+	double death_timeout = node.cfg_death_timeout;
+
+	raft_run_next_event();
+	ok(raft_node_check_full_state(&node,
+		RAFT_STATE_CANDIDATE /* State. */,
+		0 /* Leader. */,
+		2 /* Term. */,
+		1 /* Vote. */,
+		2 /* Volatile term. */,
+		1 /* Volatile vote. */,
+		"{0: 1}" /* Vclock. */
+	), "elections with a new term");
+	is(raft_node_send_vote_response(&node,
+		2 /* Term. */,
+		1 /* Vote. */,
+		2 /* Source. */
+	), 0, "vote response from 2");
+	is(raft_node_send_vote_response(&node,
+		2 /* Term. */,
+		1 /* Vote. */,
+		3 /* Source. */
+	), 0, "vote response from 3");
+	is(node.raft.state, RAFT_STATE_LEADER, "became leader");
+	ok(!raft_has_lease(&node.raft), "no lease without acks");
+
+	/* The followers could get these before learning about the leader. */
+
+	raft_process_ack(&node.raft, 2, raft_time());
+	raft_process_ack(&node.raft, 3, raft_time());
+	ok(!raft_has_lease(&node.raft), "acks of messages sent right after "
+	   "the election are ignored");
+
+	raft_run_for(death_timeout / 2);
+	double ts = raft_time();
+	raft_process_ack(&node.raft, 2, ts);
+	ok(!raft_has_lease(&node.raft), "no lease without a quorum");
+	raft_process_ack(&node.raft, 3, ts);
+	ok(raft_has_lease(&node.raft), "lease with a quorum");
+
+	/* The lease is held until the quorum can forget about the leader. */
+
+	raft_run_for(death_timeout / 4);
+	raft_process_ack(&node.raft, 2, raft_time());
+	ok(raft_has_lease(&node.raft), "lease is held");
+	raft_run_for(death_timeout / 4);
+	ok(!raft_has_lease(&node.raft), "lease expired");
+
+	/* The lease starts when the acknowledged messages were sent. */
+
+	ts = raft_time() - death_timeout / 8;
+	raft_process_ack(&node.raft, 2, ts);
+	raft_process_ack(&node.raft, 3, ts);
+	ok(raft_has_lease(&node.raft), "lease is prolonged");
+	raft_run_for(death_timeout * 3 / 8);
+	ok(!raft_has_lease(&node.raft), "lease expired after half of the "
+	   "death timeout since the messages were sent");
+
+	raft_node_cfg_election_quorum(&node, 1);
+	ok(raft_has_lease(&node.raft), "no acks are needed with quorum 1");
+
+	raft_node_destroy(&node);
+	raft_finish_test();
+}
+
 static int
 main_f(va_list ap)
 {
-	raft_start_test(16);
+	raft_start_test(18);
 
 	(void) ap;
 	fakeev_init();
@@ -1884,6 +2008,8 @@ main_f(va_list ap)
 	raft_test_promote_restore();
 	raft_test_bump_term_before_cfg();
 	raft_test_split_vote();
+	raft_test_leader_lease_vote();
+	raft_test_leader_lease();
 
 	fakeev_free();
 
@@ -59,6 +59,13 @@ raft_loop(void)
 	return fakeev_loop();
 }
 
+double
+raft_ev_monotonic_now(struct ev_loop *loop)
+{
+	(void)loop;
+	return fakeev_time();
+}
+
 static void
 raft_node_broadcast_f(struct raft *raft, const struct raft_msg *msg);
 
@@ -381,6 +388,7 @@ raft_node_cfg(struct raft_node *node)
 
 	raft_cfg_is_enabled(&node->raft, node->cfg_is_enabled);
 	raft_cfg_is_candidate(&node->raft, node->cfg_is_candidate);
+	raft_cfg_is_lease_enabled(&node->raft, node->cfg_is_lease_enabled);
 	raft_cfg_election_timeout(&node->raft, node->cfg_election_timeout);
 	raft_cfg_election_quorum(&node->raft, node->cfg_election_quorum);
 	raft_cfg_death_timeout(&node->raft, node->cfg_death_timeout);
@@ -444,6 +452,14 @@ raft_node_cfg_is_candidate(struct raft_node *node, bool value)
 	}
 }
 
+void
+raft_node_cfg_is_lease_enabled(struct raft_node *node, bool value)
+{
+	node->cfg_is_lease_enabled = value;
+	if (raft_node_is_started(node))
+		raft_cfg_is_lease_enabled(&node->raft, value);
+}
+
 void
 raft_node_cfg_cluster_size(struct raft_node *node, int value)
 {
@@ -102,6 +102,7 @@ struct raft_node {
 	 */
 	bool cfg_is_enabled;
 	bool cfg_is_candidate;
+	bool cfg_is_lease_enabled;
 	double cfg_election_timeout;
 	int cfg_election_quorum;
 	double cfg_death_timeout;
@@ -237,6 +238,9 @@ raft_node_cfg_is_enabled(struct raft_node *node, bool value);
 void
 raft_node_cfg_is_candidate(struct raft_node *node, bool value);
 
+void
+raft_node_cfg_is_lease_enabled(struct raft_node *node, bool value);
+
 void
 raft_node_cfg_cluster_size(struct raft_node *node, int value);
 
@@ -0,0 +1,254 @@
+#include "memory.h"
+#include "fiber.h"
+#include "msgpuck.h"
+#include "coll/coll.h"
+#include "coll_id.h"
+#include "coll_id_def.h"
+#include "coll_id_cache.h"
+#include "key_def.h"
+#include "tuple.h"
+#include "unit.h"
+#include <string.h>
+
+enum { TEST_COLL_ID = 1 };
+
+static struct coll_id *test_coll_id;
+
+static void
+test_coll_create(void)
+{
+	struct coll_id_def def;
+	memset(&def, 0, sizeof(def));
+	def.id = TEST_COLL_ID;
+	def.name = "unicode_ci";
+	def.name_len = strlen(def.name);
+	def.base.type = COLL_TYPE_ICU;
+	def.base.icu.strength = COLL_ICU_STRENGTH_PRIMARY;
+	test_coll_id = coll_id_new(&def);
+	fail_if(test_coll_id == NULL);
+	struct coll_id *replaced;
+	fail_if(coll_id_cache_replace(test_coll_id, &replaced) != 0);
+	fail_if(replaced != NULL);
+}
+
+static void
+test_coll_destroy(void)
+{
+	coll_id_cache_delete(test_coll_id);
+	coll_id_delete(test_coll_id);
+}
+
+/**
+ * Create a key definition with parts of the given types that
+ * index tuple fields starting from the second one.
+ */
+static struct key_def *
+test_key_def_new(const enum field_type *types, uint32_t part_count,
+		 bool is_nullable, uint32_t coll_id)
+{
+	struct key_part_def parts[2];
+	assert(part_count <= lengthof(parts));
+	for (uint32_t i = 0; i < part_count; i++) {
+		parts[i] = key_part_def_default;
+		parts[i].fieldno = i + 1;
+		parts[i].type = types[i];
+		parts[i].coll_id = coll_id;
+		if (is_nullable) {
+			parts[i].is_nullable = true;
+			parts[i].nullable_action = ON_CONFLICT_ACTION_NONE;
+		}
+	}
+	struct key_def *def = key_def_new(parts, part_count, false);
+	fail_if(def == NULL);
+	return def;
+}
+
+/** Create a tuple {0, <str>} or {0, nil} if str is NULL. */
+static struct tuple *
+test_tuple_new_str(const char *str)
+{
+	char buf[64];
+	char *data = mp_encode_array(buf, 2);
+	data = mp_encode_uint(data, 0);
+	if (str != NULL)
+		data = mp_encode_str0(data, str);
+	else
+		data = mp_encode_nil(data);
+	struct tuple *tuple = tuple_new(tuple_format_runtime, buf, data);
+	fail_if(tuple == NULL);
+	tuple_ref(tuple);
+	return tuple;
+}
+
+/** Create a tuple {0, <val>} or {0, nil} if val is negative. */
+static struct tuple *
+test_tuple_new_uint(int val)
+{
+	char buf[64];
+	char *data = mp_encode_array(buf, 2);
+	data = mp_encode_uint(data, 0);
+	if (val >= 0)
+		data = mp_encode_uint(data, val);
+	else
+		data = mp_encode_nil(data);
+	struct tuple *tuple = tuple_new(tuple_format_runtime, buf, data);
+	fail_if(tuple == NULL);
+	tuple_ref(tuple);
+	return tuple;
+}
+
+/**
+ * The type-specialized comparators have a separate instance per
+ * key part type while the generic ones don't depend on the type,
+ * so different comparators for keys of different types mean that
+ * the specialized comparators are used.
+ */
+static void
+test_specialization(void)
+{
+	header();
+	plan(6);
+
+	enum field_type unsigned_types[] = {FIELD_TYPE_UNSIGNED,
+					    FIELD_TYPE_UNSIGNED};
+	enum field_type string_types[] = {FIELD_TYPE_STRING,
+					  FIELD_TYPE_STRING};
+	enum field_type scalar_types[] = {FIELD_TYPE_SCALAR};
+
+	struct key_def *a = test_key_def_new(unsigned_types, 1, true,
+					     COLL_NONE);
+	struct key_def *b = test_key_def_new(string_types, 1, true,
+					     COLL_NONE);
+	ok(a->tuple_compare != b->tuple_compare,
+	   "nullable single-part key: tuple_compare");
+	ok(a->tuple_compare_with_key != b->tuple_compare_with_key,
+	   "nullable single-part key: tuple_compare_with_key");
+	key_def_delete(a);
+	key_def_delete(b);
+
+	a = test_key_def_new(string_types, 1, false, TEST_COLL_ID);
+	b = test_key_def_new(scalar_types, 1, false, TEST_COLL_ID);
+	ok(a->tuple_compare != b->tuple_compare,
+	   "collated single-part key: tuple_compare");
+	ok(a->tuple_compare_with_key != b->tuple_compare_with_key,
+	   "collated single-part key: tuple_compare_with_key");
+	key_def_delete(a);
+	key_def_delete(b);
+
+	a = test_key_def_new(unsigned_types, 2, true, COLL_NONE);
+	b = test_key_def_new(string_types, 2, true, COLL_NONE);
+	ok(a->tuple_compare == b->tuple_compare,
+	   "nullable multi-part key: tuple_compare");
+	ok(a->tuple_compare_with_key == b->tuple_compare_with_key,
+	   "nullable multi-part key: tuple_compare_with_key");
+	key_def_delete(a);
+	key_def_delete(b);
+
+	footer();
+	check_plan();
+}
+
+static void
+test_nullable(void)
+{
+	header();
+	plan(6);
+
+	enum field_type types[] = {FIELD_TYPE_UNSIGNED};
+	struct key_def *def = test_key_def_new(types, 1, true, COLL_NONE);
+	struct tuple *null = test_tuple_new_uint(-1);
+	struct tuple *one = test_tuple_new_uint(1);
+	struct tuple *two = test_tuple_new_uint(2);
+
+	ok(tuple_compare(null, HINT_NONE, one, HINT_NONE, def) < 0,
+	   "nil < 1");
+	ok(tuple_compare(two, HINT_NONE, one, HINT_NONE, def) > 0,
+	   "2 > 1");
+	ok(tuple_compare(null, HINT_NONE, null, HINT_NONE, def) == 0,
+	   "nil == nil");
+
+	char key[16];
+	mp_encode_uint(key, 1);
+	ok(tuple_compare_with_key(one, HINT_NONE, key, 1, HINT_NONE,
+				  def) == 0, "1 == key 1");
+	ok(tuple_compare_with_key(null, HINT_NONE, key, 1, HINT_NONE,
+				  def) < 0, "nil < key 1");
+	mp_encode_nil(key);
+	ok(tuple_compare_with_key(one, HINT_NONE, key, 1, HINT_NONE,
+				  def) > 0, "1 > key nil");
+
+	tuple_unref(null);
+	tuple_unref(one);
+	tuple_unref(two);
+	key_def_delete(def);
+
+	footer();
+	check_plan();
+}
+
+static void
+test_collation(void)
+{
+	header();
+	plan(4);
+
+	enum field_type types[] = {FIELD_TYPE_STRING};
+	struct key_def *def = test_key_def_new(types, 1, false,
+					       TEST_COLL_ID);
+	struct tuple *lower = test_tuple_new_str("a");
+	struct tuple *upper = test_tuple_new_str("A");
+	struct tuple *other = test_tuple_new_str("b");
+
+	ok(tuple_compare(lower, HINT_NONE, upper, HINT_NONE, def) == 0,
+	   "'a' == 'A'");
+	ok(tuple_compare(upper, HINT_NONE, other, HINT_NONE, def) < 0,
+	   "'A' < 'b'");
+
+	char key[16];
+	mp_encode_str0(key, "A");
+	ok(tuple_compare_with_key(lower, HINT_NONE, key, 1, HINT_NONE,
+				  def) == 0, "'a' == key 'A'");
+	ok(tuple_compare_with_key(other, HINT_NONE, key, 1, HINT_NONE,
+				  def) > 0, "'b' > key 'A'");
+
+	tuple_unref(lower);
+	tuple_unref(upper);
+	tuple_unref(other);
+	key_def_delete(def);
+
+	footer();
+	check_plan();
+}
+
+static int
+test_main(void)
+{
+	header();
+	plan(3);
+
+	test_specialization();
+	test_nullable();
+	test_collation();
+
+	footer();
+	return check_plan();
+}
+
+int
+main(void)
+{
+	coll_init();
+	memory_init();
+	fiber_init(fiber_c_invoke);
+	tuple_init(NULL);
+	test_coll_create();
+
+	int rc = test_main();
+
+	test_coll_destroy();
+	tuple_free();
+	fiber_free();
+	memory_free();
+	coll_free();
+	return rc;
+}
@@ -0,0 +1,302 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2022, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "box/iproto_constants.h"
+#include "box/xrow.h"
+#include "box/xrow_ring.h"
+#include "fiber.h"
+#include "memory.h"
+#include "msgpuck.h"
+#include "small/ibuf.h"
+#include "unit.h"
+
+enum {
+	RING_SIZE = 16 * 1024,
+	BODY_SIZE = 100,
+};
+
+static char body_buf[2 * RING_SIZE];
+
+/**
+ * Append a row of the given replica with the given LSN and body
+ * size to a ring.
+ */
+static int
+ring_append_from(struct xrow_ring *ring, uint32_t replica_id, int64_t lsn,
+		 size_t body_size)
+{
+	char *end = mp_encode_strl(body_buf, body_size);
+	memset(end, 'x', body_size);
+	end += body_size;
+	struct xrow_header row;
+	memset(&row, 0, sizeof(row));
+	row.type = IPROTO_INSERT;
+	row.replica_id = replica_id;
+	row.lsn = lsn;
+	row.bodycnt = 1;
+	row.body[0].iov_base = body_buf;
+	row.body[0].iov_len = end - body_buf;
+	return xrow_ring_append(ring, &row);
+}
+
+/** Append a row of replica 1 to a ring. */
+static int
+ring_append(struct xrow_ring *ring, int64_t lsn, size_t body_size)
+{
+	return ring_append_from(ring, 1, lsn, body_size);
+}
+
+/**
+ * Read all rows available at the given position and check that
+ * their LSNs go in order starting from the given one.
+ */
+static int
+ring_read_all(struct xrow_ring *ring, int64_t *pos, int64_t first_lsn,
+	      size_t max_size, bool *valid)
+{
+	*valid = true;
+	int total = 0;
+	int64_t lsn = first_lsn;
+	struct ibuf buf;
+	ibuf_create(&buf, &cord()->slabc, 1024);
+	while (true) {
+		ibuf_reset(&buf);
+		int count = xrow_ring_read(ring, pos, &buf, max_size);
+		if (count <= 0) {
+			if (count < 0)
+				total = -1;
+			break;
+		}
+		const char *data = buf.rpos;
+		for (int i = 0; i < count; i++) {
+			struct xrow_header row;
+			uint32_t len;
+			const char *raw = xrow_ring_row_data(data, &len);
+			if (xrow_ring_decode(&row, &data) != 0 ||
+			    row.lsn != lsn++ || row.bodycnt != 1 ||
+			    data != raw + len)
+				*valid = false;
+		}
+		if (data != buf.wpos)
+			*valid = false;
+		total += count;
+	}
+	ibuf_destroy(&buf);
+	return total;
+}
+
+static void
+test_basic(void)
+{
+	header();
+	plan(8);
+
+	struct xrow_ring ring;
+	xrow_ring_create(&ring, RING_SIZE);
+	struct vclock vclock;
+	vclock_create(&vclock);
+	int64_t pos;
+	bool valid;
+	is(xrow_ring_seek(&ring, &vclock, 0, &pos), 0, "seek in empty ring");
+	is(ring_read_all(&ring, &pos, 1, SIZE_MAX, &valid), 0,
+	   "nothing to read");
+
+	for (int64_t lsn = 1; lsn <= 5; lsn++)
+		ring_append(&ring, lsn, BODY_SIZE);
+	is(ring_read_all(&ring, &pos, 1, SIZE_MAX, &valid), 5,
+	   "read appended rows");
+	ok(valid, "rows are valid");
+
+	for (int64_t lsn = 6; lsn <= 10; lsn++)
+		ring_append(&ring, lsn, BODY_SIZE);
+	is(ring_read_all(&ring, &pos, 6, 1, &valid), 5,
+	   "read new rows one by one");
+	ok(valid, "rows are valid");
+
+	vclock_follow(&vclock, 1, 7);
+	is(xrow_ring_seek(&ring, &vclock, 0, &pos), 0, "seek in the middle");
+	is(ring_read_all(&ring, &pos, 1, SIZE_MAX, &valid), 10,
+	   "rows preceding the vclock aren't skipped by the ring");
+
+	xrow_ring_destroy(&ring);
+
+	check_plan();
+	footer();
+}
+
+static void
+test_wraparound(void)
+{
+	header();
+	plan(6);
+
+	struct xrow_ring ring;
+	xrow_ring_create(&ring, RING_SIZE);
+	struct vclock vclock;
+	vclock_create(&vclock);
+	int64_t pos = 0;
+	bool valid;
+	for (int64_t lsn = 1; lsn <= 1000; lsn++)
+		ring_append(&ring, lsn, BODY_SIZE);
+	is(xrow_ring_seek(&ring, &vclock, 0, &pos), -1,
+	   "old rows are discarded");
+	pos = 0;
+	is(ring_read_all(&ring, &pos, 1, SIZE_MAX, &valid), -1,
+	   "can't read discarded rows");
+
+	vclock_follow(&vclock, 1, 990);
+	is(xrow_ring_seek(&ring, &vclock, 0, &pos), 0, "seek recent rows");
+	ok(pos <= 990, "position precedes the vclock");
+	int64_t first_lsn = pos + 1;
+	int count = ring_read_all(&ring, &pos, first_lsn, 1024, &valid);
+	is(count, 1000 - first_lsn + 1, "read recent rows");
+	ok(valid, "rows are valid");
+
+	xrow_ring_destroy(&ring);
+
+	check_plan();
+	footer();
+}
+
+static void
+test_oversized(void)
+{
+	header();
+	plan(6);
+
+	struct xrow_ring ring;
+	xrow_ring_create(&ring, RING_SIZE);
+	struct vclock vclock;
+	vclock_create(&vclock);
+	int64_t pos;
+	bool valid;
+	for (int64_t lsn = 1; lsn <= 5; lsn++)
+		ring_append(&ring, lsn, BODY_SIZE);
+	is(ring_append(&ring, 6, RING_SIZE), 0, "append oversized row");
+	ring_append(&ring, 7, BODY_SIZE);
+
+	is(xrow_ring_seek(&ring, &vclock, 0, &pos), -1,
+	   "rows preceding oversized row are discarded");
+	vclock_follow(&vclock, 1, 5);
+	is(xrow_ring_seek(&ring, &vclock, 0, &pos), -1,
+	   "oversized row is discarded");
+	vclock_follow(&vclock, 1, 6);
+	is(xrow_ring_seek(&ring, &vclock, 0, &pos), 0,
+	   "seek past oversized row");
+	is(ring_read_all(&ring, &pos, 7, SIZE_MAX, &valid), 1,
+	   "read rows following oversized row");
+	ok(valid, "rows are valid");
+
+	xrow_ring_destroy(&ring);
+
+	check_plan();
+	footer();
+}
+
+static void
+test_reset(void)
+{
+	header();
+	plan(3);
+
+	struct xrow_ring ring;
+	xrow_ring_create(&ring, RING_SIZE);
+	struct vclock vclock;
+	vclock_create(&vclock);
+	int64_t pos;
+	bool valid;
+	for (int64_t lsn = 1; lsn <= 5; lsn++)
+		ring_append(&ring, lsn, BODY_SIZE);
+	vclock_follow(&vclock, 1, 100);
+	xrow_ring_reset(&ring, &vclock);
+	ring_append(&ring, 101, BODY_SIZE);
+
+	vclock_reset(&vclock, 1, 5);
+	is(xrow_ring_seek(&ring, &vclock, 0, &pos), -1,
+	   "rows preceding reset are discarded");
+	vclock_reset(&vclock, 1, 100);
+	is(xrow_ring_seek(&ring, &vclock, 0, &pos), 0, "seek after reset");
+	is(ring_read_all(&ring, &pos, 101, SIZE_MAX, &valid), 1,
+	   "read rows appended after reset");
+
+	xrow_ring_destroy(&ring);
+
+	check_plan();
+	footer();
+}
+
+/**
+ * In master-master replication the reader is usually ahead of
+ * the ring in its own component and component 0 is unrelated,
+ * so these components must not prevent it from using the ring.
+ */
+static void
+test_seek_master_master(void)
+{
+	header();
+	plan(5);
+
+	struct xrow_ring ring;
+	xrow_ring_create(&ring, RING_SIZE);
+	struct vclock vclock;
+	vclock_create(&vclock);
+	vclock_follow(&vclock, 0, 10);
+	vclock_follow(&vclock, 1, 100);
+	vclock_follow(&vclock, 2, 20);
+	xrow_ring_reset(&ring, &vclock);
+	for (int64_t i = 1; i <= 5; i++) {
+		ring_append_from(&ring, 1, 100 + i, BODY_SIZE);
+		ring_append_from(&ring, 2, 20 + i, BODY_SIZE);
+		ring_append_from(&ring, 0, 10 + i, BODY_SIZE);
+	}
+	int64_t pos;
+	bool valid;
+	vclock_create(&vclock);
+	vclock_follow(&vclock, 1, 100);
+	vclock_follow(&vclock, 2, 30);
+	is(xrow_ring_seek(&ring, &vclock, 2, &pos), 0,
+	   "component 0 and own component are ignored");
+	is(ring_read_all(&ring, &pos, 0, SIZE_MAX, &valid), 15,
+	   "all rows are read");
+
+	vclock_reset(&vclock, 1, 99);
+	is(xrow_ring_seek(&ring, &vclock, 2, &pos), -1,
+	   "rows needed by the reader are discarded");
+
+	vclock_reset(&vclock, 1, 100);
+	vclock_reset(&vclock, 2, 10);
+	is(xrow_ring_seek(&ring, &vclock, 3, &pos), -1,
+	   "components of other replicas are checked");
+	is(xrow_ring_seek(&ring, &vclock, 2, &pos), 0,
+	   "own component of the reader is ignored");
+
+	xrow_ring_destroy(&ring);
+
+	check_plan();
+	footer();
+}
+
+int
+main(void)
+{
+	memory_init();
+	fiber_init(fiber_c_invoke);
+
+	header();
+	plan(5);
+
+	test_basic();
+	test_wraparound();
+	test_oversized();
+	test_reset();
+	test_seek_master_master();
+
+	int rc = check_plan();
+	footer();
+
+	fiber_free();
+	memory_free();
+	return rc;
+}
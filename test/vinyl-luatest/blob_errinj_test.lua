@@ -0,0 +1,46 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all = function()
+    g.server = server:new({alias = 'master'})
+    g.server:start()
+end
+
+g.after_all = function()
+    g.server:stop()
+end
+
+g.after_each(function()
+    g.server:exec(function()
+        box.error.injection.set('ERRINJ_VY_LOG_FLUSH', false)
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+-- Checks that a blob file written by a dump that failed to commit
+-- its result to the metadata log is removed by garbage collection.
+g.test_blob_failed_dump = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local fio = require('fio')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk', {blob_threshold = 100})
+        local big = string.rep('x', 1000)
+        for i = 1, 10 do
+            s:replace({i, big .. i})
+        end
+        box.error.injection.set('ERRINJ_VY_LOG_FLUSH', true)
+        t.assert_error(box.snapshot)
+        box.error.injection.set('ERRINJ_VY_LOG_FLUSH', false)
+        box.snapshot()
+        box.snapshot()
+        local dir = fio.pathjoin(box.cfg.vinyl_dir, s.id, 0)
+        t.helpers.retrying({}, function()
+            t.assert_equals(#fio.glob(fio.pathjoin(dir, '*.blob*')), 1)
+        end)
+        t.assert_equals(s:get(5), {5, big .. 5})
+    end)
+end
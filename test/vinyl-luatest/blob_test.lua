@@ -0,0 +1,225 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all = function()
+    g.server = server:new({alias = 'master'})
+    g.server:start()
+end
+
+g.after_all = function()
+    g.server:stop()
+end
+
+g.after_each(function()
+    g.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_blob_opts = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        local pk = s:create_index('pk', {blob_threshold = 1024})
+        t.assert_equals(pk.options.blob_threshold, 1024)
+        pk:alter({blob_threshold = 4096})
+        t.assert_equals(pk.options.blob_threshold, 4096)
+        t.assert_error_msg_content_equals(
+            "Can't create or modify index 'sk' in space 'test': " ..
+            "blob_threshold is only supported by primary index",
+            s.create_index, s, 'sk',
+            {parts = {2, 'string'}, blob_threshold = 1024})
+        s:insert({1, 'a'})
+        t.assert_error_msg_content_equals(
+            "Vinyl does not support rebuilding the primary index " ..
+            "of a non-empty space",
+            pk.alter, pk, {blob_threshold = 0})
+    end)
+end
+
+g.test_blob_read = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk', {blob_threshold = 100})
+        s:create_index('sk', {parts = {2, 'unsigned'}})
+        local big = string.rep('x', 1000)
+        for i = 1, 10 do
+            s:replace({i, i * 10, big .. i, 'small'})
+        end
+        box.snapshot()
+        t.assert_equals(s:get(5), {5, 50, big .. 5, 'small'})
+        t.assert_equals(s.index.sk:get(70), {7, 70, big .. 7, 'small'})
+        t.assert_equals(#s:select(), 10)
+        t.assert_equals(s:select({3}, {iterator = 'le'})[1],
+                        {3, 30, big .. 3, 'small'})
+        -- UPSERT is turned into REPLACE so it can be applied to
+        -- a statement with separated fields.
+        s:upsert({1, 10, 'new'}, {{'=', 4, 'upserted'}})
+        box.snapshot()
+        t.assert_equals(s:get(1), {1, 10, big .. 1, 'upserted'})
+    end)
+end
+
+g.test_blob_compaction = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        local pk = s:create_index('pk', {blob_threshold = 100})
+        local big = string.rep('y', 500)
+        for i = 1, 20 do
+            s:replace({i, big .. i})
+        end
+        box.snapshot()
+        -- Overwrite most of the values so that the blob file
+        -- written by the first dump needs relocation.
+        for i = 1, 15 do
+            s:replace({i, 'z' .. i})
+        end
+        box.snapshot()
+        pk:compact()
+        t.helpers.retrying({}, function()
+            t.assert_equals(pk:stat().run_count, 1)
+        end)
+        for i = 1, 15 do
+            t.assert_equals(s:get(i), {i, 'z' .. i})
+        end
+        for i = 16, 20 do
+            t.assert_equals(s:get(i), {i, big .. i})
+        end
+        box.snapshot()
+        t.assert_equals(s:count(), 20)
+    end)
+end
+
+g.test_blob_scan = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk', {blob_threshold = 100, page_size = 1024})
+        local big = string.rep('v', 200)
+        for i = 1, 300 do
+            s:replace({i, big .. i})
+        end
+        box.snapshot()
+        -- Values are read in batches spanning many statements
+        -- so check that each statement gets its own value no
+        -- matter the iteration direction.
+        local res = s:select()
+        t.assert_equals(#res, 300)
+        for i, tuple in ipairs(res) do
+            t.assert_equals(tuple, {i, big .. i})
+        end
+        res = s:select({}, {iterator = 'le'})
+        t.assert_equals(#res, 300)
+        for i, tuple in ipairs(res) do
+            t.assert_equals(tuple, {301 - i, big .. (301 - i)})
+        end
+        t.assert_equals(s:select({150}, {iterator = 'ge', limit = 2}),
+                        {{150, big .. 150}, {151, big .. 151}})
+        t.assert_equals(s:select({150}, {iterator = 'lt', limit = 2}),
+                        {{149, big .. 149}, {148, big .. 148}})
+        -- Statements invisible from a read view are skipped.
+        for i = 1, 300, 2 do
+            s:replace({i, big .. -i})
+        end
+        box.snapshot()
+        res = s:select()
+        t.assert_equals(#res, 300)
+        for i, tuple in ipairs(res) do
+            t.assert_equals(tuple, {i, big .. (i % 2 == 1 and -i or i)})
+        end
+    end)
+end
+
+g.test_blob_build_index = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk', {blob_threshold = 100})
+        s:create_index('sk', {parts = {2, 'unsigned'}})
+        local big = string.rep('w', 200)
+        for i = 1, 10 do
+            s:replace({i, i * 10, big .. i})
+        end
+        box.snapshot()
+        -- The third field may be stored in a blob file.
+        t.assert_error_msg_content_equals(
+            "Vinyl does not support indexing fields that may be " ..
+            "stored in blob files",
+            s.create_index, s, 'sk2', {parts = {3, 'string'}})
+        -- Indexed fields are never moved to blob files.
+        local sk2 = s:create_index('sk2', {parts = {{2, 'unsigned'},
+                                                    {1, 'unsigned'}}})
+        t.assert_equals(sk2:get({50, 5}), {5, 50, big .. 5})
+        -- Any field may be indexed while the space is empty.
+        s:truncate()
+        local sk3 = s:create_index('sk3', {parts = {3, 'string'}})
+        s:replace({1, 10, big})
+        box.snapshot()
+        t.assert_equals(sk3:get(big), {1, 10, big})
+    end)
+end
+
+-- Checks that the size of garbage in a blob file is accounted
+-- by compaction and persists across restart so that the file
+-- is eventually rewritten.
+g.test_blob_garbage = function()
+    local function blob_files()
+        return g.server:exec(function()
+            local fio = require('fio')
+            local dir = fio.pathjoin(box.cfg.vinyl_dir,
+                                     box.space.test.id, 0)
+            local files = fio.glob(fio.pathjoin(dir, '*.blob'))
+            table.sort(files)
+            return files
+        end)
+    end
+    g.server:exec(function()
+        local t = require('luatest')
+        box.cfg{checkpoint_count = 1}
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        local pk = s:create_index('pk', {blob_threshold = 100})
+        local big = string.rep('g', 500)
+        for i = 1, 20 do
+            s:replace({i, big .. i})
+        end
+        box.snapshot()
+        for i = 1, 15 do
+            s:replace({i, 'z' .. i})
+        end
+        box.snapshot()
+        -- The blob file isn't known to be mostly garbage until
+        -- the first compaction so it is kept as is.
+        pk:compact()
+        t.helpers.retrying({}, function()
+            t.assert_equals(pk:stat().run_count, 1)
+        end)
+        box.snapshot()
+    end)
+    local files = blob_files()
+    t.assert_equals(#files, 1)
+    g.server:restart()
+    g.server:exec(function()
+        local t = require('luatest')
+        box.cfg{checkpoint_count = 1}
+        local s = box.space.test
+        s:replace({100, 'x'})
+        box.snapshot()
+        s.index.pk:compact()
+        t.helpers.retrying({}, function()
+            t.assert_equals(s.index.pk:stat().run_count, 1)
+        end)
+        box.snapshot()
+        t.assert_equals(s:count(), 21)
+        t.assert_equals(s:get(20), {20, string.rep('g', 500) .. 20})
+    end)
+    t.helpers.retrying({}, function()
+        local new_files = blob_files()
+        t.assert_equals(#new_files, 1)
+        t.assert_not_equals(new_files[1], files[1])
+    end)
+end
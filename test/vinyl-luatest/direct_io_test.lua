@@ -0,0 +1,84 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all = function()
+    g.server = server:new({
+        alias = 'master',
+        box_cfg = {
+            vinyl_direct_io = true,
+            vinyl_page_cache = 1024 * 1024,
+            vinyl_cache = 0,
+        },
+    })
+    g.server:start()
+end
+
+g.after_all = function()
+    g.server:stop()
+end
+
+g.after_each(function()
+    g.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_cfg = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.cfg.vinyl_direct_io, true)
+        t.assert_equals(box.cfg.vinyl_page_cache, 1024 * 1024)
+        box.cfg{vinyl_page_cache = 0}
+        t.assert_equals(box.cfg.vinyl_page_cache, 0)
+        box.cfg{vinyl_page_cache = 1024 * 1024}
+        t.assert_error_msg_content_equals(
+            "Can't set option 'vinyl_direct_io' dynamically",
+            box.cfg, {vinyl_direct_io = false})
+    end)
+end
+
+g.test_read = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        local pk = s:create_index('pk', {page_size = 1000})
+        local pad = string.rep('x', 333)
+        for i = 1, 1000 do
+            s:replace({i, pad})
+        end
+        box.snapshot()
+        local function check()
+            local result = s:select()
+            t.assert_equals(#result, 1000)
+            for i, tuple in ipairs(result) do
+                t.assert_equals(tuple, {i, pad})
+            end
+            t.assert_equals(s:get(500), {500, pad})
+        end
+        -- Read pages from disk.
+        check()
+        local pages = pk:stat().disk.iterator.read.pages
+        t.assert_gt(pages, 0)
+        -- Pages are now read from the page cache.
+        check()
+        t.assert_equals(pk:stat().disk.iterator.read.pages, pages)
+        -- Disabling the page cache makes us read pages from disk.
+        box.cfg{vinyl_page_cache = 0}
+        check()
+        t.assert_gt(pk:stat().disk.iterator.read.pages, pages)
+        box.cfg{vinyl_page_cache = 1024 * 1024}
+        -- Compaction reads and writes runs with direct IO, too.
+        for i = 1, 1000, 2 do
+            s:replace({i, pad})
+        end
+        box.snapshot()
+        pk:compact()
+        t.helpers.retrying({}, function()
+            t.assert_equals(pk:stat().run_count, 1)
+        end)
+        check()
+    end)
+end
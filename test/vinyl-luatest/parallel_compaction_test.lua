@@ -0,0 +1,70 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all = function()
+    g.server = server:new({
+        alias = 'master',
+        box_cfg = {vinyl_write_threads = 4},
+    })
+    g.server:start()
+end
+
+g.after_all = function()
+    g.server:stop()
+end
+
+g.after_each(function()
+    g.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_split_before_compaction = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        local pk = s:create_index('pk', {
+            page_size = 512, range_size = 8 * 1024,
+        })
+        local pad = string.rep('x', 100)
+        for i = 1, 1000 do
+            s:replace({i, pad})
+        end
+        box.snapshot()
+        t.assert_equals(pk:stat().range_count, 1)
+        -- The range is much bigger than range_size so it is split
+        -- before compaction and the parts are compacted in parallel.
+        pk:compact()
+        t.helpers.retrying({}, function()
+            local stat = pk:stat()
+            t.assert_ge(stat.range_count, 3)
+            t.assert_equals(stat.run_count, stat.range_count)
+        end)
+        t.assert_equals(s:count(), 1000)
+        for i = 1, 1000, 37 do
+            t.assert_equals(s:get(i), {i, pad})
+        end
+    end)
+end
+
+g.test_no_split_small_range = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        local pk = s:create_index('pk', {
+            page_size = 512, range_size = 64 * 1024,
+        })
+        for i = 1, 100 do
+            s:replace({i, string.rep('x', 100)})
+        end
+        box.snapshot()
+        pk:compact()
+        t.helpers.retrying({}, function()
+            t.assert_equals(pk:stat().run_count, 1)
+        end)
+        t.assert_equals(pk:stat().range_count, 1)
+    end)
+end
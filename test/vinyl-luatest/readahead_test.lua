@@ -0,0 +1,66 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all = function()
+    g.server = server:new({alias = 'master'})
+    g.server:start()
+end
+
+g.after_all = function()
+    g.server:stop()
+end
+
+g.after_each(function()
+    g.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_readahead_scan = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        local pk = s:create_index('pk', {page_size = 256})
+        local pad = string.rep('x', 100)
+        local count = 1000
+        for i = 1, count do
+            s:replace({i, pad})
+        end
+        box.snapshot()
+        local page_count = pk:stat().disk.pages
+        t.assert_gt(page_count, 100)
+
+        -- Forward scan.
+        local result = s:select({}, {iterator = 'ge'})
+        t.assert_equals(#result, count)
+        for i, tuple in ipairs(result) do
+            t.assert_equals(tuple[1], i)
+        end
+        -- Pages read ahead are only accounted when the iterator
+        -- uses them.
+        t.assert_equals(pk:stat().disk.iterator.read.pages, page_count)
+
+        -- Backward scan from the middle of the run.
+        box.cfg{vinyl_cache = 0}
+        result = s:select({count / 2}, {iterator = 'le'})
+        t.assert_equals(#result, count / 2)
+        for i, tuple in ipairs(result) do
+            t.assert_equals(tuple[1], count / 2 - i + 1)
+        end
+
+        -- Scan interrupted in the middle and an update followed
+        -- by another scan.
+        result = s:select({100}, {iterator = 'gt', limit = 100})
+        t.assert_equals(result[1][1], 101)
+        t.assert_equals(result[100][1], 200)
+        s:replace({500, 'y'})
+        box.snapshot()
+        t.assert_equals(s:select({499}, {iterator = 'ge', limit = 2}),
+                        {{499, pad}, {500, 'y'}})
+        t.assert_equals(s:count(), count)
+        box.cfg{vinyl_cache = 128 * 1024 * 1024}
+    end)
+end
@@ -0,0 +1,190 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all = function()
+    g.server = server:new({alias = 'master'})
+    g.server:start()
+end
+
+g.after_all = function()
+    g.server:stop()
+end
+
+g.after_each(function()
+    g.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_ttl_opts = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:format({{'id', 'unsigned'}, {'data', 'string'}, {'time', 'number'}})
+        local pk = s:create_index('pk', {ttl = 10, ttl_field = 'time'})
+        t.assert_equals(pk.options.ttl, 10)
+        t.assert_equals(pk.options.ttl_field, 3)
+        pk:alter({ttl = 20, ttl_field = 1})
+        t.assert_equals(pk.options.ttl, 20)
+        t.assert_equals(pk.options.ttl_field, 1)
+        t.assert_error_msg_content_equals(
+            "Can't create or modify index 'pk' in space 'test': " ..
+            "ttl_field must have a numeric type",
+            pk.alter, pk, {ttl_field = 'data'})
+        t.assert_error_msg_content_equals(
+            "Can't create or modify index 'sk' in space 'test': " ..
+            "ttl is not supported by spaces with secondary indexes",
+            s.create_index, s, 'sk', {parts = {2, 'string'}})
+        pk:alter({ttl = 0})
+        t.assert_equals(pk.options.ttl, nil)
+        t.assert_error_msg_content_equals(
+            "Wrong index options (field 4): " ..
+            "ttl must be greater than or equal to 0",
+            pk.alter, pk, {ttl = -1})
+        t.assert_error_msg_content_equals(
+            "Can't create or modify index 'sk' in space 'test': " ..
+            "ttl is only supported by primary index",
+            s.create_index, s, 'sk', {parts = {2, 'string'}, ttl = 10})
+        s:create_index('sk', {parts = {2, 'string'}})
+        t.assert_error_msg_content_equals(
+            "Can't create or modify index 'pk' in space 'test': " ..
+            "ttl is not supported by spaces with secondary indexes",
+            pk.alter, pk, {ttl = 10})
+        s:drop()
+        s = box.schema.space.create('test', {engine = 'vinyl'})
+        t.assert_error_msg_content_equals(
+            "Can't create or modify index 'pk' in space 'test': " ..
+            "ttl_field must be set along with ttl",
+            s.create_index, s, 'pk', {ttl = 10})
+    end)
+end
+
+g.test_ttl_memtx = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test')
+        t.assert_error_msg_content_equals(
+            "Can't create or modify index 'pk' in space 'test': " ..
+            "ttl is not supported by memtx engine",
+            s.create_index, s, 'pk', {ttl = 10, ttl_field = 2})
+        local pk = s:create_index('pk')
+        t.assert_error_msg_content_equals(
+            "Can't create or modify index 'pk' in space 'test': " ..
+            "ttl is not supported by memtx engine",
+            pk.alter, pk, {ttl = 10})
+    end)
+end
+
+g.test_ttl_alter_cache = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        local pk = s:create_index('pk', {ttl = 3600, ttl_field = 3})
+        local now = os.time()
+        s:insert({1, 'a', now})
+        s:insert({2, 'a', now - 7200})
+        s:insert({3, 'a', now})
+        box.snapshot()
+        -- Populate the cache.
+        t.assert_equals(s:select(), {{1, 'a', now}, {3, 'a', now}})
+        -- The expired tuple must reappear once ttl is increased.
+        pk:alter({ttl = 3 * 3600})
+        t.assert_equals(s:select(), {{1, 'a', now}, {2, 'a', now - 7200},
+                                     {3, 'a', now}})
+        pk:alter({ttl = 3600})
+        t.assert_equals(s:select(), {{1, 'a', now}, {3, 'a', now}})
+    end)
+end
+
+g.test_ttl_read = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk', {ttl = 3600, ttl_field = 3})
+        local now = os.time()
+        s:insert({1, 'a', now})
+        s:insert({2, 'a', now - 7200})
+        s:insert({3, 'b', now - 7200})
+        s:insert({4, 'b', now})
+        s:insert({5, 'c'})
+        t.assert_equals(s:get(1), {1, 'a', now})
+        t.assert_equals(s:get(2), nil)
+        t.assert_equals(s:select(), {{1, 'a', now}, {4, 'b', now}, {5, 'c'}})
+        box.snapshot()
+        t.assert_equals(s:get(3), nil)
+        t.assert_equals(s:select(), {{1, 'a', now}, {4, 'b', now}, {5, 'c'}})
+        -- An expired tuple doesn't prevent insertion of a new one.
+        s:insert({2, 'd', now})
+        t.assert_equals(s:get(2), {2, 'd', now})
+    end)
+end
+
+g.test_ttl_compaction = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        local pk = s:create_index('pk', {ttl = 3600, ttl_field = 2})
+        local now = os.time()
+        -- Expired tuples are dropped on dump if there are no runs.
+        s:replace({100, now - 7200})
+        for i = 1, 10 do
+            s:replace({i, now})
+        end
+        box.snapshot()
+        t.assert_equals(pk:stat().disk.rows, 10)
+        -- Expired tuples are kept on dump if there are older runs,
+        -- because they may overwrite tuples stored in them.
+        for i = 1, 10, 2 do
+            s:replace({i, now - 7200})
+        end
+        box.snapshot()
+        t.assert_equals(pk:stat().disk.rows, 15)
+        t.assert_equals(s:count(), 5)
+        -- An expired tuple isn't dropped by compaction if it is
+        -- overwritten by an UPSERT.
+        s:upsert({1, now}, {{'=', 2, now}})
+        box.snapshot()
+        pk:compact()
+        t.helpers.retrying({}, function()
+            t.assert_equals(pk:stat().run_count, 1)
+        end)
+        t.assert_equals(pk:stat().disk.rows, 6)
+        t.assert_equals(s:count(), 6)
+    end)
+end
+
+g.test_ttl_upsert = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        local pk = s:create_index('pk', {ttl = 3600, ttl_field = 2})
+        local now = os.time()
+        -- An UPSERT is applied to an expired tuple as to no tuple,
+        -- whether it is in memory, on disk or squashed by compaction.
+        s:insert({1, now - 7200, 10})
+        s:upsert({1, now, 0}, {{'+', 3, 1}})
+        t.assert_equals(s:get(1), {1, now, 0})
+        s:insert({2, now - 7200, 10})
+        box.snapshot()
+        s:upsert({2, now, 0}, {{'+', 3, 1}})
+        s:upsert({2, now, 0}, {{'+', 3, 1}})
+        t.assert_equals(s:get(2), {2, now, 1})
+        t.assert_equals(s:select(), {{1, now, 0}, {2, now, 1}})
+        box.snapshot()
+        pk:compact()
+        t.helpers.retrying({}, function()
+            t.assert_equals(pk:stat().run_count, 1)
+        end)
+        t.assert_equals(s:select(), {{1, now, 0}, {2, now, 1}})
+        -- An UPSERT doesn't resurrect an expired tuple within
+        -- a transaction either.
+        box.begin()
+        s:replace({3, now - 7200, 10})
+        s:upsert({3, now, 0}, {{'+', 3, 1}})
+        box.commit()
+        t.assert_equals(s:get(3), {3, now, 0})
+    end)
+end